@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ARRAY_GROUPBY_HPP_
+#define _DYND__ARRAY_GROUPBY_HPP_
+
+#include <string>
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/ckernel_deferred.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace nd {
+
+/**
+ * Reduces the 'data' values within each of the groups selected by 'by',
+ * in a single pass which accumulates straight into the result. Unlike
+ * reducing the result of nd::groupby, the values are never copied into
+ * per-group storage.
+ *
+ * The rows are split across up to ``ectx->thread_count`` threads when
+ * there are enough of them, each accumulating into its own partial
+ * results, which are then combined with the reduction itself. This
+ * requires its two types to be the same POD type, otherwise the
+ * reduction runs on one thread.
+ *
+ * \param data_values  A one-dimensional strided or fixed array.
+ * \param by  A one-dimensional array the same size as 'data_values'.
+ * \param reduction  A unary reduction ckernel_deferred, which accumulates its
+ *                   source into its destination, or a binary expr ckernel_deferred
+ *                   whose three types are the same. The 'data' values are
+ *                   converted to its source type a block at a time as needed.
+ *                   Its destination type must be POD.
+ * \param reduction_identity  Either a NULL nd::array, or the identity value of
+ *                            the reduction. When it's NULL, the first value of
+ *                            each group initializes its accumulator, and a group
+ *                            with no values is an error.
+ * \param groups  The categorical type of the groups. If not provided, it's
+ *                determined from 'by' in the same way as nd::groupby.
+ * \param ectx  The evaluation context.
+ *
+ * \returns  A one-dimensional array with one reduced value per category.
+ */
+array groupby_reduce(const array& data_values, const array& by,
+                const ckernel_deferred& reduction, const array& reduction_identity,
+                const ndt::type& groups = ndt::type(),
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+/**
+ * Reduces the 'data' values within each of the groups selected by 'by'
+ * with one of the named reductions "sum", "min", "max", "count" or "mean",
+ * as the ckernel_deferred version of groupby_reduce does. Count produces
+ * an int64, and mean a float64 (complex[float64] for complex values) which
+ * is NaN for empty groups. Min and max raise an error for empty groups.
+ */
+array groupby_reduce(const array& data_values, const array& by,
+                const std::string& reduction,
+                const ndt::type& groups = ndt::type(),
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+}} // namespace dynd::nd
+
+#endif // _DYND__ARRAY_GROUPBY_HPP_
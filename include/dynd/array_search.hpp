@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ARRAY_SEARCH_HPP_
+#define _DYND__ARRAY_SEARCH_HPP_
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+
+namespace dynd { namespace nd {
+
+/**
+ * Which insertion point searchsorted returns when the
+ * needle is equal to one or more sorted values.
+ */
+enum search_side_t {
+    /** The first suitable index, before any equal values */
+    search_side_left,
+    /** The last suitable index, after any equal values */
+    search_side_right
+};
+
+/**
+ * A prepared binary search over the first dimension of a sorted
+ * array. The comparison kernels are built once at construction, so
+ * repeated searches only pay for the comparisons themselves. Strided,
+ * fixed, and var leading dimensions are supported, and builtin
+ * integer and floating point types search without the kernels.
+ *
+ * The order is that of comparison_type_sorting_less, so NaNs sort
+ * after all other values.
+ */
+class binary_searcher {
+    // Holds a reference to the sorted data
+    nd::array m_sorted;
+    ndt::type m_element_tp;
+    const char *m_element_metadata;
+    const char *m_origin;
+    intptr_t m_stride, m_size;
+    comparison_ckernel_builder m_sorted_less_needle, m_needle_less_sorted;
+
+    // Non-copyable
+    binary_searcher(const binary_searcher&);
+    binary_searcher& operator=(const binary_searcher&);
+
+    void init(const char *needle_metadata);
+    void make_kernels(const char *needle_metadata,
+                    comparison_ckernel_builder& sorted_less_needle,
+                    comparison_ckernel_builder& needle_less_sorted) const;
+public:
+    /**
+     * Prepares a search of `sorted`, for needles whose metadata
+     * is the same as the elements of `sorted`.
+     */
+    binary_searcher(const nd::array& sorted);
+
+    /**
+     * Prepares a search of `sorted`, for needles of the same type
+     * as its elements, with metadata `needle_metadata`.
+     */
+    binary_searcher(const nd::array& sorted, const char *needle_metadata);
+
+    const ndt::type& get_element_type() const {
+        return m_element_tp;
+    }
+
+    intptr_t get_size() const {
+        return m_size;
+    }
+
+    /**
+     * Returns the index of an element equal to the needle,
+     * or -1 if there is none.
+     */
+    intptr_t find(const char *needle);
+
+    /**
+     * Returns the first index at which the needle could be
+     * inserted while keeping the order.
+     */
+    intptr_t lower_bound(const char *needle);
+
+    /**
+     * Returns the last index at which the needle could be
+     * inserted while keeping the order.
+     */
+    intptr_t upper_bound(const char *needle);
+
+    /**
+     * Finds the insertion points for all of the needles at once,
+     * returning an intptr array with the shape of `needles`. The
+     * needles are converted to the element type if necessary.
+     */
+    nd::array searchsorted(const nd::array& needles,
+                    search_side_t side = search_side_left);
+};
+
+}} // namespace dynd::nd
+
+#endif // _DYND__ARRAY_SEARCH_HPP_
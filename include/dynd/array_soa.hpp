@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ARRAY_SOA_HPP_
+#define _DYND__ARRAY_SOA_HPP_
+
+#include <dynd/array.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd {
+
+namespace ndt {
+    /**
+     * Makes the struct of arrays type for a struct type, a struct with
+     * the same field names whose fields are one-dimensional strided
+     * arrays of the original field types. For example, the struct of
+     * arrays type of ``{x: int32, y: float64}`` is
+     * ``{x: strided * int32, y: strided * float64}``.
+     */
+    ndt::type make_soa(const ndt::type& struct_tp);
+} // namespace ndt
+
+namespace nd {
+
+/**
+ * Allocates an uninitialized struct of arrays (SoA) with `dim_size`
+ * records of type `struct_tp`. Its type is ``ndt::make_soa(struct_tp)``,
+ * and each field is a contiguous column in one allocation, starting on
+ * a 64 byte boundary relative to the others. Accessing a field with
+ * ``p("name")`` gives a view of its contiguous column, so a scan or
+ * reduction over one field reads only that field's memory.
+ *
+ * \param dim_size  The number of records.
+ * \param struct_tp  The type of the records, a struct type.
+ */
+array empty_soa(intptr_t dim_size, const ndt::type& struct_tp);
+
+/**
+ * Converts an array of structs (AoS), a one-dimensional strided or
+ * fixed array of a struct type like ``N * {x: int32, y: float64}``, into
+ * a newly allocated struct of arrays like ``{x: N * int32, y: N * float64}``.
+ *
+ * The records are processed a block at a time, assigning each field of
+ * the block with a strided kernel, so every record is read from memory
+ * once no matter how many fields it has.
+ */
+array aos_to_soa(const array& a,
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+/**
+ * Converts a struct of arrays (SoA), a struct whose fields are all
+ * one-dimensional strided or fixed arrays of the same size, into a
+ * newly allocated array of structs. This is the inverse of aos_to_soa.
+ *
+ * \param a  The struct of arrays.
+ * \param struct_tp  The struct type of the result's records. If not
+ *                   provided, a cstruct with the element types of the
+ *                   fields is used. Its fields are matched by name.
+ * \param ectx  The evaluation context.
+ */
+array soa_to_aos(const array& a, const ndt::type& struct_tp = ndt::type(),
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+} // namespace nd
+
+} // namespace dynd
+
+#endif // _DYND__ARRAY_SOA_HPP_
@@ -0,0 +1,46 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ARRAY_SORT_HPP_
+#define _DYND__ARRAY_SORT_HPP_
+
+#include <dynd/array.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace nd {
+
+/**
+ * Returns a copy of the array with the values along the dimension `axis`
+ * sorted in the order of comparison_type_sorting_less, so NaNs sort
+ * after all other values. The sort is stable. All the dimensions must
+ * be strided or fixed, and any type with a sorting_less comparison
+ * kernel may be sorted.
+ *
+ * Builtin integer, floating point, bool, date and datetime values, and
+ * structs whose fields are all of those types, are sorted with an LSD
+ * radix sort. A struct sorts by its first field, then its second, and
+ * so on. Other types sort with their comparison kernel, and a large
+ * dimension is split across up to ``ectx->thread_count`` threads, whose
+ * sorted runs are merged in parallel.
+ *
+ * \param a  The array to sort.
+ * \param axis  The dimension to sort along. Negative values count
+ *              from the last dimension.
+ * \param ectx  The evaluation context.
+ */
+array sort(const array& a, intptr_t axis = -1,
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+/**
+ * Returns an array of int64 with the same shape as `a`, containing the
+ * indices along the dimension `axis` which would sort it. This is the
+ * permutation used by nd::sort, so equal values keep their order.
+ */
+array argsort(const array& a, intptr_t axis = -1,
+                const eval::eval_context *ectx = &eval::default_eval_context);
+
+}} // namespace dynd::nd
+
+#endif // _DYND__ARRAY_SORT_HPP_
@@ -28,6 +28,10 @@
 #  define DYND_CONSTEXPR
 #endif
 
+#if __cplusplus >= 201103L && __has_include(<thread>)
+#  define DYND_USE_STD_THREAD
+#endif
+
 # define DYND_USE_STDINT
 
 #include <cmath>
@@ -59,6 +63,10 @@ inline bool DYND_ISNAN(long double x) {
 // Use rvalue references on gcc >= 4.7
 #  define DYND_RVALUE_REFS
 #  define DYND_ISNAN(x) (std::isnan(x))
+// Use std::thread when compiling as C++11
+#  if __cplusplus >= 201103L
+#    define DYND_USE_STD_THREAD
+#  endif
 #else
 // Don't use constexpr on gcc < 4.7
 #  define DYND_CONSTEXPR
@@ -100,6 +108,8 @@ inline bool DYND_ISNAN(long double x) {
 #if _MSC_VER >= 1700
 // MSVC 2012 and later have the <atomic> header
 #define DYND_USE_STD_ATOMIC
+// MSVC 2012 and later have the <thread> header
+#define DYND_USE_STD_THREAD
 #endif
 
 // No DYND_CONSTEXPR yet, define it as nothing
@@ -138,6 +148,12 @@ public:
 #  define DYND_MOVE(x) (x)
 #endif
 
+// C++11 thread_local is available with std::thread, except
+// on MSVC before 2015
+#if defined(DYND_USE_STD_THREAD) && (!defined(_MSC_VER) || _MSC_VER >= 1900)
+#  define DYND_USE_THREAD_LOCAL
+#endif
+
 // If Initializer Lists are supported
 #ifdef DYND_INIT_LIST
 #include <initializer_list>
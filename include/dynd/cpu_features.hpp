@@ -0,0 +1,52 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__CPU_FEATURES_HPP_
+#define _DYND__CPU_FEATURES_HPP_
+
+#include <dynd/config.hpp>
+
+// DYND_X86_SIMD is defined when the SSE2 intrinsics are
+// always available, i.e. on x86-64 or on x86 built with SSE2.
+#if defined(__x86_64__) || defined(_M_X64) || \
+        (defined(__i386__) && defined(__SSE2__)) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define DYND_X86_SIMD
+#endif
+
+// DYND_AVX2_TARGET marks a function which uses AVX2 intrinsics,
+// so it can be compiled in a library which otherwise targets a
+// baseline x86 CPU. Such functions may only be called after
+// checking cpu_has_avx2(). DYND_X86_AVX2 is defined when the
+// compiler supports this.
+#if defined(DYND_X86_SIMD) && !defined(DYND_CUDA)
+# if defined(_MSC_VER)
+#  if _MSC_VER >= 1700
+#   define DYND_X86_AVX2
+#   define DYND_AVX2_TARGET
+#  endif
+# elif defined(__clang__) || (defined(__GNUC__) && \
+            (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#  define DYND_X86_AVX2
+#  define DYND_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+namespace dynd {
+
+/**
+ * Returns true if the CPU supports the SSE2 instruction set.
+ */
+bool cpu_has_sse2();
+
+/**
+ * Returns true if the CPU and the operating system support
+ * the AVX2 instruction set.
+ */
+bool cpu_has_avx2();
+
+} // namespace dynd
+
+#endif // _DYND__CPU_FEATURES_HPP_
@@ -30,6 +30,9 @@ struct eval_context {
     std::atomic<date_parse_order_t> date_parse_order;
     // Century selection for 2 digit years in date strings
     std::atomic<int> century_window;
+    // Maximum number of threads for parallel operations, 0 means
+    // one per hardware thread
+    std::atomic<int> thread_count;
 #else
     // Default error mode for computations
     assign_error_mode default_errmode;
@@ -39,12 +42,16 @@ struct eval_context {
     date_parse_order_t date_parse_order;
     // Century selection for 2 digit years in date strings
     int century_window;
+    // Maximum number of threads for parallel operations, 0 means
+    // one per hardware thread
+    int thread_count;
 #endif
 
     DYND_CONSTEXPR eval_context()
         : default_errmode(assign_error_fractional),
           default_cuda_device_errmode(assign_error_none),
-          date_parse_order(date_parse_no_ambig), century_window(70)
+          date_parse_order(date_parse_no_ambig), century_window(70),
+          thread_count(0)
     {
     }
 
@@ -53,7 +60,8 @@ struct eval_context {
         : default_errmode(rhs.default_errmode.load()),
           default_cuda_device_errmode(rhs.default_cuda_device_errmode.load()),
           date_parse_order(rhs.date_parse_order.load()),
-          century_window(rhs.century_window.load())
+          century_window(rhs.century_window.load()),
+          thread_count(rhs.thread_count.load())
     {
     }
 #endif
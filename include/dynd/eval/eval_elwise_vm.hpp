@@ -6,6 +6,8 @@
 #ifndef _DYND__EVAL_ELWISE_VM_HPP_
 #define _DYND__EVAL_ELWISE_VM_HPP_
 
+#include <vector>
+
 #include <dynd/config.hpp>
 #include <dynd/array.hpp>
 #include <dynd/memblock/memory_block.hpp>
@@ -14,9 +16,42 @@
 
 namespace dynd { namespace eval {
 
+/**
+ * If `a` is an elementwise expression whose kernel generator evaluates
+ * a VM program, such as a tree of arithmetic operations on builtin types,
+ * copies that program into `out_ep` and views of the expression's operands
+ * into `out_inputs`, returning true. Otherwise returns false.
+ */
+bool compile_elwise_expr(const nd::array& a, vm::elwise_program& out_ep,
+                    std::vector<nd::array>& out_inputs);
+
+/**
+ * Evaluates `src` into `out` with one fused VM program, if `src` is an
+ * expression tree of at least two VM operations with strided or fixed
+ * dimensions. Returns false, without touching `out`, if it isn't, so the
+ * caller can fall back to a regular assignment.
+ */
+bool evaluate_elwise_expr(const nd::array& out, const nd::array& src,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+/**
+ * Evaluates the elementwise program on the inputs, broadcasting them
+ * together, into a new strided array.
+ */
 nd::array evaluate_elwise_vm(const vm::elwise_program& ep, std::vector<nd::array> inputs,
                     const eval::eval_context *ectx = &eval::default_eval_context);
 
+/**
+ * Evaluates the elementwise program on the inputs into `out`, which must
+ * have strided or fixed dimensions the inputs broadcast to, and the type
+ * of the program's output register. The work is done a chunk of the
+ * innermost dimension at a time, with the temporaries held in cache-sized
+ * register buffers, and contiguous inputs and outputs used in place.
+ */
+void evaluate_elwise_vm(const vm::elwise_program& ep, const nd::array& out,
+                    const std::vector<nd::array>& inputs,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
 }} // namespace dynd::eval
 
 #endif // _DYND__EVAL_ELWISE_VM_HPP_
@@ -0,0 +1,42 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__PARALLEL_TASKS_HPP_
+#define _DYND__PARALLEL_TASKS_HPP_
+
+#include <dynd/config.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace eval {
+
+/**
+ * The function prototype for one task of a parallel operation.
+ * It is called once for each task index in [0, task_count).
+ */
+typedef void (*parallel_task_t)(intptr_t task_index, void *task_data);
+
+/**
+ * Returns the number of threads a parallel operation may use
+ * under the given evaluation context. This is always at least 1,
+ * and is exactly 1 if dynd was built without thread support.
+ */
+intptr_t get_parallel_thread_count(const eval_context *ectx);
+
+/**
+ * Runs ``task(i, task_data)`` for each i in [0, task_count), each on
+ * its own thread. Task 0 runs on the calling thread. This function
+ * returns once all the tasks have completed. If any task raises an
+ * exception, the exception of the lowest task index which raised is
+ * rethrown after all the tasks have completed.
+ *
+ * Tasks must not share mutable state, in particular ckernels are
+ * not threadsafe, so each task needs its own ckernel instance.
+ */
+void parallel_run_tasks(intptr_t task_count, parallel_task_t task,
+                        void *task_data);
+
+}} // namespace dynd::eval
+
+#endif // _DYND__PARALLEL_TASKS_HPP_
@@ -17,6 +17,17 @@ namespace dynd {
  */
 nd::array format_json(const nd::array& n);
 
+/**
+ * Formats the nd::array as JSON, writing it to the file descriptor
+ * `fd` in chunks of up to `buffer_size` bytes instead of building
+ * the whole output in memory.
+ *
+ * \param fd  The file descriptor to write to.
+ * \param n  The object to format as JSON.
+ * \param buffer_size  The size of the output buffer.
+ */
+void format_json(int fd, const nd::array& n, intptr_t buffer_size = 65536);
+
 } // namespace dynd
 
 #endif // _DYND__JSON_FORMATTER_HPP_
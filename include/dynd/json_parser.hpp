@@ -6,6 +6,8 @@
 #ifndef _DYND__JSON_PARSER_HPP_
 #define _DYND__JSON_PARSER_HPP_
 
+#include <vector>
+
 #include <dynd/array.hpp>
 
 namespace dynd {
@@ -41,6 +43,16 @@ nd::array parse_json(const ndt::type& tp, const char *json_begin, const char *js
  */
 void parse_json(nd::array& out, const char *json_begin, const char *json_end, const eval::eval_context *ectx);
 
+/**
+ * Parses a JSON array into `out`, which must have a leading var or fixed
+ * dimension. A SIMD scan first indexes where each array element begins and
+ * ends, then the elements are parsed in parallel using up to
+ * ``ectx->thread_count`` threads. parse_json does this automatically for
+ * large inputs of such types.
+ */
+void parse_json_parallel(nd::array& out, const char *json_begin, const char *json_end,
+                const eval::eval_context *ectx);
+
 /**
  * Parses the input json as the requested type. The input can be a string or a
  * bytes array. If the input is bytes, the parser assumes it is UTF-8 data.
@@ -90,6 +102,100 @@ parse_json(const char (&dt)[M], const char (&json)[N],
     return parse_json(ndt::type(dt, dt+M-1), json, json+N-1, ectx);
 }
 
+/**
+ * How a stream of JSON records is laid out.
+ */
+enum json_stream_format_t {
+    /** One JSON value per line (newline-delimited JSON) */
+    json_stream_lines,
+    /** A single top-level JSON array whose elements are the records */
+    json_stream_array
+};
+
+/**
+ * Called by json_stream_parser with each full batch of parsed
+ * records, and the final partial batch. The batch array is only
+ * valid during the call, its storage is reused for later batches.
+ */
+typedef void (*json_batch_callback_t)(const nd::array& batch, void *callback_data);
+
+/**
+ * A push-style JSON parser for streams of records which don't fit in
+ * memory. Chunks of UTF-8 bytes are fed in as they arrive, split at any
+ * position. Records are parsed into a preallocated batch array of the
+ * record type, which is passed to the callback every time it fills up.
+ * Only the bytes of one incomplete record are buffered between chunks,
+ * so memory use is bounded by the batch size and the largest record.
+ */
+class json_stream_parser {
+    ndt::type m_record_tp;
+    json_stream_format_t m_format;
+    json_batch_callback_t m_callback;
+    void *m_callback_data;
+    const eval::eval_context *m_ectx;
+
+    intptr_t m_batch_size, m_batch_count;
+    nd::array m_batch;
+    const char *m_record_metadata;
+    intptr_t m_record_stride;
+
+    // The start of a record which spans chunks
+    std::vector<char> m_pending;
+    // Structural state of the array format scan
+    int m_depth;
+    bool m_in_string, m_escape;
+    bool m_array_started, m_array_finished;
+    // Whether the array element being scanned follows a ','
+    bool m_after_comma;
+    intptr_t m_record_count;
+
+    // Non-copyable
+    json_stream_parser(const json_stream_parser&);
+    json_stream_parser& operator=(const json_stream_parser&);
+
+    void allocate_batch();
+    const char *find_record_end(const char *begin, const char *end);
+    void end_record(const char *begin, const char *end, char delimiter);
+    void parse_record(const char *begin, const char *end);
+    void emit_batch();
+public:
+    /**
+     * Constructs the parser.
+     *
+     * \param record_tp  The type of one record. It must have a fixed data size.
+     * \param batch_size  The number of records in each batch.
+     * \param callback  The function to receive the batches.
+     * \param callback_data  Passed through to the callback.
+     * \param format  Whether the records are newline-delimited, or a JSON array.
+     * \param ectx  An evaluation context.
+     */
+    json_stream_parser(const ndt::type& record_tp, intptr_t batch_size,
+                    json_batch_callback_t callback, void *callback_data,
+                    json_stream_format_t format = json_stream_lines,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+    /**
+     * Parses a chunk of the input. The chunk may end anywhere, including
+     * in the middle of a record or a UTF-8 sequence.
+     */
+    void feed(const char *begin, const char *end);
+
+    inline void feed(const std::string& chunk) {
+        feed(chunk.data(), chunk.data() + chunk.size());
+    }
+
+    /**
+     * Signals the end of the input, parsing any remaining record and
+     * passing the last partial batch to the callback.
+     */
+    void finish();
+
+    /** The number of records parsed so far */
+    intptr_t get_record_count() const {
+        return m_record_count;
+    }
+};
+
 } // namespace dynd
 
 #endif // _DYND__JSON_PARSER_HPP_
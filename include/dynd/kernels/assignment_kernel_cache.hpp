@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ASSIGNMENT_KERNEL_CACHE_HPP_
+#define _DYND__ASSIGNMENT_KERNEL_CACHE_HPP_
+
+#include <vector>
+#include <string>
+
+#include <dynd/kernels/assignment_kernels.hpp>
+
+namespace dynd {
+
+/**
+ * A small least-recently-used cache of assignment ckernels, keyed on
+ * (dst type, dst metadata, src type, src metadata, kernreq, errmode,
+ * ectx). Code which repeatedly assigns between the same pair of arrays
+ * can use it to skip rebuilding the kernel each time.
+ *
+ * Kernels keep pointers into the metadata they were built for, so a
+ * cached kernel only matches when the metadata is at the same address
+ * and has the same bytes as when the kernel was built.
+ *
+ * A cache is not thread-safe. get_thread_assignment_kernel_cache
+ * returns one for the calling thread.
+ */
+class assignment_kernel_cache {
+    struct entry {
+        ndt::type dst_tp, src_tp;
+        const char *dst_metadata, *src_metadata;
+        std::string dst_metadata_bytes, src_metadata_bytes;
+        kernel_request_t kernreq;
+        assign_error_mode errmode;
+        // The eval_context, and the settings in it kernels may depend on
+        const eval::eval_context *ectx;
+        assign_error_mode ectx_errmode, ectx_cuda_errmode;
+        date_parse_order_t ectx_date_parse_order;
+        int ectx_century_window;
+
+        ckernel_builder kernel;
+        uint64_t last_used;
+        // Set while a borrowed_kernel is using the entry
+        bool in_use;
+        // False for entries built because every match was in use
+        bool cached;
+
+        bool matches(const ndt::type& dst_tp, const char *dst_metadata,
+                        const ndt::type& src_tp, const char *src_metadata,
+                        kernel_request_t kernreq, assign_error_mode errmode,
+                        const eval::eval_context *ectx) const;
+    };
+
+    std::vector<entry *> m_entries;
+    size_t m_capacity;
+    uint64_t m_clock;
+    uint64_t m_hit_count, m_miss_count;
+
+    // Non-copyable
+    assignment_kernel_cache(const assignment_kernel_cache&);
+    assignment_kernel_cache& operator=(const assignment_kernel_cache&);
+
+    entry *acquire(const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx);
+    void release(entry *e);
+public:
+    explicit assignment_kernel_cache(size_t capacity = 16);
+    ~assignment_kernel_cache();
+
+    /** Destroys all the cached kernels */
+    void clear();
+
+    size_t get_capacity() const {
+        return m_capacity;
+    }
+
+    /** The number of lookups which reused a cached kernel */
+    uint64_t get_hit_count() const {
+        return m_hit_count;
+    }
+
+    /** The number of lookups which built a new kernel */
+    uint64_t get_miss_count() const {
+        return m_miss_count;
+    }
+
+    /**
+     * Borrows a ready-to-call kernel from the cache, building it if
+     * necessary, and gives it back when destroyed. A kernel which is
+     * already borrowed, for instance by a kernel that assigns the same
+     * values recursively, is never shared; a separate one is built.
+     */
+    class borrowed_kernel {
+        assignment_kernel_cache& m_cache;
+        entry *m_entry;
+
+        // Non-copyable
+        borrowed_kernel(const borrowed_kernel&);
+        borrowed_kernel& operator=(const borrowed_kernel&);
+    public:
+        borrowed_kernel(assignment_kernel_cache& cache,
+                        const ndt::type& dst_tp, const char *dst_metadata,
+                        const ndt::type& src_tp, const char *src_metadata,
+                        kernel_request_t kernreq, assign_error_mode errmode,
+                        const eval::eval_context *ectx)
+            : m_cache(cache), m_entry(cache.acquire(dst_tp, dst_metadata,
+                            src_tp, src_metadata, kernreq, errmode, ectx))
+        {
+        }
+
+        ~borrowed_kernel() {
+            m_cache.release(m_entry);
+        }
+
+        ckernel_prefix *get() const {
+            return m_entry->kernel.get();
+        }
+
+        /** Calls a kernel_request_single kernel */
+        inline void operator()(char *dst, const char *src) const {
+            ckernel_prefix *kdp = get();
+            kdp->get_function<unary_single_operation_t>()(dst, src, kdp);
+        }
+
+        /** Calls a kernel_request_strided kernel */
+        inline void operator()(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride, size_t count) const {
+            ckernel_prefix *kdp = get();
+            kdp->get_function<unary_strided_operation_t>()(dst, dst_stride,
+                            src, src_stride, count, kdp);
+        }
+    };
+};
+
+/**
+ * Returns the calling thread's assignment kernel cache, which
+ * typed_data_assign uses. Returns NULL when the platform lacks
+ * thread-local storage.
+ */
+assignment_kernel_cache *get_thread_assignment_kernel_cache();
+
+} // namespace dynd
+
+#endif // _DYND__ASSIGNMENT_KERNEL_CACHE_HPP_
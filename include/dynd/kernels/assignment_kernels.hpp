@@ -183,6 +183,26 @@ struct strided_assign_kernel_extra {
     static void destruct(ckernel_prefix *extra);
 };
 
+/**
+ * Creates an assignment kernel for the run of leading strided and
+ * fixed dimensions of `dst_tp`, along with the matching dimensions of
+ * `src_tp` (which may be missing or of size one, to broadcast). The
+ * dimensions are reordered so the loop over the largest stride is
+ * outermost, and adjacent dimensions which are contiguous in both
+ * operands are merged into one loop. Each remaining dimension gets a
+ * strided_assign_kernel_extra, followed by the element assignment kernel.
+ *
+ * The leading dimension of `dst_tp` must be strided or fixed, and
+ * `src_tp` must either have fewer dimensions or also lead with a strided
+ * or fixed dimension.
+ */
+size_t make_strided_dims_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
 #ifdef DYND_CUDA
 /**
  * Creates an assignment kernel for one data value from the
@@ -14,6 +14,26 @@
 
 namespace dynd {
 
+/**
+ * Rounds a requested ckernel_builder capacity up to the size
+ * ckernel_builder_pool_allocate will provide.
+ */
+intptr_t ckernel_builder_pool_round_capacity(intptr_t requested_capacity);
+
+/**
+ * Allocates memory for ckernel_builder data, reusing blocks released
+ * earlier on the same thread when possible. The capacity must come from
+ * ckernel_builder_pool_round_capacity. Returns NULL on failure.
+ */
+void *ckernel_builder_pool_allocate(intptr_t capacity);
+
+/**
+ * Releases memory from ckernel_builder_pool_allocate, keeping it in
+ * the calling thread's pool for reuse. Blocks may be released on a
+ * different thread than the one that allocated them.
+ */
+void ckernel_builder_pool_free(void *ptr, intptr_t capacity);
+
 /**
  * Function pointers + data for a hierarchical
  * kernel which operates on type/metadata in
@@ -45,8 +65,8 @@ class ckernel_builder {
                 data->destructor(data);
             }
             if (!using_static_data()) {
-                // Free the memory
-                free(data);
+                // Return the memory to the pool
+                ckernel_builder_pool_free(data, m_capacity);
             }
         }
     }
@@ -208,18 +228,15 @@ inline int ckernel_builder_ensure_capacity_leaf(void *ckb, intptr_t requested_ca
         if (requested_capacity < grown_capacity) {
             requested_capacity = grown_capacity;
         }
-        intptr_t *new_data;
-        if (ckb_ptr->using_static_data()) {
-            // If we were previously using the static data, do a malloc
-            new_data = reinterpret_cast<intptr_t *>(malloc(requested_capacity));
-            // If the allocation succeeded, copy the old data as the realloc would
-            if (new_data != NULL) {
-                memcpy(new_data, ckb_ptr->m_data, ckb_ptr->m_capacity);
+        requested_capacity = ckernel_builder_pool_round_capacity(requested_capacity);
+        intptr_t *new_data = reinterpret_cast<intptr_t *>(
+                        ckernel_builder_pool_allocate(requested_capacity));
+        if (new_data != NULL) {
+            // Copy the old data as a realloc would
+            memcpy(new_data, ckb_ptr->m_data, ckb_ptr->m_capacity);
+            if (!ckb_ptr->using_static_data()) {
+                ckernel_builder_pool_free(ckb_ptr->m_data, ckb_ptr->m_capacity);
             }
-        } else {
-            // Otherwise do a realloc
-            new_data = reinterpret_cast<intptr_t *>(realloc(
-                            ckb_ptr->m_data, requested_capacity));
         }
         if (new_data == NULL) {
             ckb_ptr->destroy();
@@ -17,6 +17,9 @@ namespace dynd {
 namespace ndt {
     class type;
 } // namespace ndt
+namespace vm {
+    class elwise_program;
+} // namespace vm
 class expr_kernel_generator;
 
 typedef void (*expr_single_operation_t)(
@@ -61,6 +64,16 @@ public:
     /** Used to print information about the kernel in the type */
     virtual void print_type(std::ostream& o) const = 0;
 
+    /**
+     * If the kernel evaluates an elementwise VM program, whose inputs
+     * are the expr type's operands with builtin value types, returns it,
+     * otherwise NULL. Expressions built from such expressions combine
+     * their programs, so the whole tree is evaluated in one pass.
+     */
+    virtual const vm::elwise_program *get_elwise_program() const {
+        return NULL;
+    }
+
     friend void expr_kernel_generator_incref(const expr_kernel_generator *ed);
     friend void expr_kernel_generator_decref(const expr_kernel_generator *ed);
 };
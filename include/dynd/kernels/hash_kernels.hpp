@@ -0,0 +1,197 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__HASH_KERNELS_HPP_
+#define _DYND__HASH_KERNELS_HPP_
+
+#include <vector>
+
+#include <dynd/types/type_id.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd {
+
+namespace ndt {
+    class type;
+} // namespace ndt
+
+/**
+ * The function prototype for a hash kernel. Values which are
+ * equivalent under the type's sorting_less comparison produce
+ * equal hashes, so for example 0.0 and -0.0 hash the same, as
+ * do all NaNs.
+ */
+typedef uint64_t (*hash_single_operation_t)(const char *src,
+                        ckernel_prefix *extra);
+
+/**
+ * See the ckernel_builder class documentation
+ * for details about how kernels can be built and
+ * used.
+ *
+ * This kernel type is for kernels which hash a
+ * single type/metadata value.
+ */
+class hash_ckernel_builder : public ckernel_builder {
+public:
+    hash_ckernel_builder()
+        : ckernel_builder()
+    {
+    }
+
+    inline hash_single_operation_t get_function() const {
+        return get()->get_function<hash_single_operation_t>();
+    }
+
+    /** Calls the function to do the hash */
+    inline uint64_t operator()(const char *src) {
+        ckernel_prefix *kdp = get();
+        hash_single_operation_t fn = kdp->get_function<hash_single_operation_t>();
+        return fn(src, kdp);
+    }
+};
+
+/**
+ * Mixes the bits of a 64-bit value, so that every input
+ * bit affects every output bit.
+ */
+inline uint64_t hash_mix64(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * Combines a hash into an accumulated hash, for
+ * hashing sequences of values.
+ */
+inline uint64_t hash_combine(uint64_t seed, uint64_t h)
+{
+    return hash_mix64(seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * Hashes a range of bytes.
+ */
+uint64_t hash_bytes(const char *data, size_t size);
+
+/**
+ * Returns true if make_hash_kernel supports the type. This
+ * is true for the builtin types except void, the string and
+ * fixedstring types, and struct/cstruct types whose fields
+ * are all supported.
+ */
+bool is_hash_kernel_supported(const ndt::type& tp);
+
+/**
+ * Creates a hash kernel for the type/metadata. This adds the
+ * kernel at the 'offset_out' position in 'out's data, as part
+ * of a hierarchy matching the type's hierarchy.
+ *
+ * \param out  The hierarchical hash kernel being constructed.
+ * \param offset_out  The offset within 'out'.
+ * \param tp  The dynd type to hash.
+ * \param metadata  The metadata of the data to hash.
+ * \param ectx  DyND evaluation context.
+ *
+ * \returns  The offset within 'out' immediately after the
+ *           created kernel.
+ */
+size_t make_hash_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& tp, const char *metadata,
+                const eval::eval_context *ectx);
+
+/**
+ * Creates a hash kernel for a builtin type.
+ */
+size_t make_builtin_type_hash_kernel(
+                ckernel_builder *out, size_t offset_out,
+                type_id_t tid);
+
+/**
+ * An open-addressing hash table with linear probing, which maps
+ * hashes to indices of values stored elsewhere. The table keeps
+ * the full hash of each entry, and the caller supplies an
+ * `equal(index)` functor to compare against the value at an index.
+ */
+class hash_index_table {
+    std::vector<uint64_t> m_hashes;
+    // The index for each slot, -1 for an empty slot
+    std::vector<intptr_t> m_indices;
+    size_t m_count;
+
+    void rehash(size_t slot_count);
+public:
+    hash_index_table()
+        : m_count(0)
+    {
+    }
+
+    /** Clears the table, making room for expected_count entries */
+    void reset(size_t expected_count);
+
+    size_t size() const {
+        return m_count;
+    }
+
+    bool empty() const {
+        return m_count == 0;
+    }
+
+    /**
+     * Returns the index of the entry with the given hash for
+     * which `equal(index)` is true, or -1 if there is none.
+     */
+    template<class Equal>
+    intptr_t find(uint64_t hash, const Equal& equal) const {
+        if (m_indices.empty()) {
+            return -1;
+        }
+        size_t mask = m_indices.size() - 1;
+        for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask) {
+            intptr_t index = m_indices[slot];
+            if (index < 0) {
+                return -1;
+            } else if (m_hashes[slot] == hash && equal(index)) {
+                return index;
+            }
+        }
+    }
+
+    /**
+     * If an entry equal to the one with the given hash is
+     * already in the table, returns its index, otherwise
+     * inserts `index` and returns -1.
+     */
+    template<class Equal>
+    intptr_t find_or_insert(uint64_t hash, intptr_t index, const Equal& equal) {
+        // Keep the load factor at or below 1/2
+        if (2 * (m_count + 1) > m_indices.size()) {
+            rehash(m_indices.empty() ? 16 : 2 * m_indices.size());
+        }
+        size_t mask = m_indices.size() - 1;
+        for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask) {
+            intptr_t existing = m_indices[slot];
+            if (existing < 0) {
+                m_hashes[slot] = hash;
+                m_indices[slot] = index;
+                ++m_count;
+                return -1;
+            } else if (m_hashes[slot] == hash && equal(existing)) {
+                return existing;
+            }
+        }
+    }
+};
+
+} // namespace dynd
+
+#endif // _DYND__HASH_KERNELS_HPP_
@@ -33,7 +33,10 @@ namespace dynd {
  *                            reduce. This can typically be derived from an
  *                            "axis=" parameter.
  * \param associative  Whether we can assume the reduction kernel is
- *                     associative.
+ *                     associative. When every dimension is reduced, an
+ *                     associative reduction may be split across threads
+ *                     along its outermost dimension, as controlled by
+ *                     ``ectx->thread_count``.
  * \param commutative  Whether we can assume the reduction kernel is
  *                     commutative.
  * \param right_associative  If true, the reduction is to be evaluated right to
@@ -9,17 +9,82 @@
 #include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/ckernel_deferred.hpp>
+#include <dynd/array.hpp>
 
 namespace dynd { namespace kernels {
 
+/**
+ * The builtin reduction operations. Sum, prod, min and max
+ * produce the same type as their input, any and all produce
+ * a bool, and count_nonzero produces an int64.
+ */
+enum builtin_reduction_t {
+    builtin_reduction_sum,
+    builtin_reduction_prod,
+    builtin_reduction_min,
+    builtin_reduction_max,
+    builtin_reduction_any,
+    builtin_reduction_all,
+    builtin_reduction_count_nonzero
+};
+
+/**
+ * Makes a unary reduction ckernel for the given builtin
+ * reduction operation and source type id. Sum and prod are
+ * not defined for bool, and prod is not defined for the 128-bit
+ * integers. Sum and prod are not defined for float128.
+ *
+ * On x86, the strided kernels for some of the types have a
+ * SIMD fast path for contiguous data reduced into a single
+ * value (dst_stride == 0), chosen based on the CPU.
+ */
+intptr_t make_builtin_reduction_ckernel(
+                ckernel_builder *out_ckb, intptr_t ckb_offset,
+                builtin_reduction_t op, type_id_t tid,
+                kernel_request_t kerntype);
+
+/**
+ * Makes a unary reduction ckernel_deferred for the given builtin
+ * reduction operation and source type id.
+ */
+void make_builtin_reduction_ckernel_deferred(
+                ckernel_deferred *out_ckd,
+                builtin_reduction_t op, type_id_t tid);
+
+/**
+ * Returns the identity of the builtin reduction operation for
+ * the given source type id, suitable for passing as the
+ * `reduction_identity` when lifting the reduction. Returns
+ * a NULL array for min and max, which have no identity.
+ */
+nd::array make_builtin_reduction_identity(
+                builtin_reduction_t op, type_id_t tid);
+
+/**
+ * The algorithms for a floating point sum reduction. These apply
+ * within each call of a strided kernel with dst_stride == 0, so
+ * the accuracy gain is over the innermost reduced dimension.
+ */
+enum sum_algorithm_t {
+    /** Independent accumulators, vectorized where possible */
+    sum_algorithm_default,
+    /** Pairwise summation, with O(log n) error growth */
+    sum_algorithm_pairwise,
+    /** Neumaier's variant of Kahan compensated summation */
+    sum_algorithm_kahan
+};
+
 /**
  * Makes a unary reduction ckernel which adds values for the
  * given type id. This is not defined for all type_id values.
+ * The summation algorithm only affects floating point and
+ * complex types, integer sums are always exact.
  */
 intptr_t make_builtin_sum_reduction_ckernel(
                 ckernel_builder *out_ckb, intptr_t ckb_offset,
                 type_id_t tid,
-                kernel_request_t kerntype);
+                kernel_request_t kerntype,
+                sum_algorithm_t algorithm = sum_algorithm_default);
 
 /**
  * Makes a unary reduction ckernel_deferred for the requested
@@ -27,7 +92,8 @@ intptr_t make_builtin_sum_reduction_ckernel(
  */
 void make_builtin_sum_reduction_ckernel_deferred(
                 ckernel_deferred *out_ckd,
-                type_id_t tid);
+                type_id_t tid,
+                sum_algorithm_t algorithm = sum_algorithm_default);
 
 }} // namespace dynd::kernels
 
@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__MEMORY_ALLOCATOR_HPP_
+#define _DYND__MEMORY_ALLOCATOR_HPP_
+
+#include <dynd/config.hpp>
+#include <dynd/memblock/memory_block.hpp>
+
+namespace dynd {
+
+/**
+ * Allocations of at least this many bytes are aligned to
+ * DYND_LARGE_ALLOCATION_ALIGNMENT, so SIMD kernels can use aligned
+ * loads and rows don't straddle cache lines.
+ */
+#define DYND_LARGE_ALLOCATION_SIZE ((size_t)4096)
+/** The alignment of large allocations, a cache line and an AVX-512 vector */
+#define DYND_LARGE_ALLOCATION_ALIGNMENT ((size_t)64)
+/**
+ * The size of a transparent huge page. When huge pages are enabled,
+ * allocations of at least this size are aligned to it and marked
+ * with ``madvise(MADV_HUGEPAGE)``.
+ */
+#define DYND_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+/**
+ * A pluggable allocator for the memory which memory blocks own. The
+ * array, fixed size POD, POD, zeroinit and objectarray memory blocks
+ * get their memory through the allocator set by set_memory_allocator.
+ */
+struct memory_allocator_api {
+    /**
+     * Allocates `size_bytes` of memory aligned to `alignment`, a power
+     * of two, returning NULL if the memory could not be allocated.
+     */
+    void *(*allocate)(size_t size_bytes, size_t alignment);
+    /**
+     * Frees memory returned by allocate. Must accept NULL.
+     */
+    void (*free)(void *ptr);
+};
+
+/**
+ * Returns the default allocator, which uses posix_memalign
+ * (or _aligned_malloc on Windows).
+ */
+const memory_allocator_api *get_default_memory_allocator();
+
+/**
+ * Returns the allocator currently used by memory blocks.
+ */
+const memory_allocator_api *get_memory_allocator();
+
+/**
+ * Sets the allocator used for new memory block allocations, returning
+ * the previous one. Passing NULL restores the default allocator.
+ * Memory which is already allocated is still freed by the allocator
+ * which allocated it, so this may be changed at any time.
+ */
+const memory_allocator_api *set_memory_allocator(const memory_allocator_api *api);
+
+/**
+ * Enables or disables transparent huge pages for allocations of at
+ * least DYND_HUGE_PAGE_SIZE bytes, returning the previous setting.
+ * This is disabled by default, and has no effect on platforms
+ * without ``madvise(MADV_HUGEPAGE)``.
+ */
+bool set_huge_pages_enabled(bool enabled);
+
+/**
+ * Returns whether transparent huge pages are enabled.
+ */
+bool get_huge_pages_enabled();
+
+/**
+ * Returns the alignment memory blocks use for an allocation of
+ * `size_bytes` which requires `alignment`.
+ */
+inline size_t get_allocation_alignment(size_t size_bytes, size_t alignment)
+{
+    if (size_bytes >= DYND_LARGE_ALLOCATION_SIZE && alignment < DYND_LARGE_ALLOCATION_ALIGNMENT) {
+        return DYND_LARGE_ALLOCATION_ALIGNMENT;
+    } else {
+        return alignment;
+    }
+}
+
+/**
+ * Allocates memory owned by a memory block of type `mbt` with the
+ * current allocator, updating the counters for `mbt`. The alignment
+ * is raised as described by get_allocation_alignment. When huge pages
+ * are enabled, huge allocations start on a huge page boundary, with
+ * the returned memory following a small header which records the
+ * allocator.
+ *
+ * Throws std::bad_alloc if the memory could not be allocated.
+ */
+char *allocate_memory_block_data(memory_block_type_t mbt, size_t size_bytes, size_t alignment);
+
+/**
+ * Frees memory returned by allocate_memory_block_data for a memory
+ * block of type `mbt`, using the allocator which allocated it.
+ * Accepts NULL.
+ */
+void free_memory_block_data(memory_block_type_t mbt, void *ptr);
+
+/**
+ * Sets the maximum number of threads first_touch_zeroinit uses,
+ * returning the previous setting. This is 1 by default, which zeroes
+ * memory with a plain memset on the calling thread.
+ */
+intptr_t set_first_touch_threads(intptr_t thread_count);
+
+/**
+ * Returns the maximum number of threads first_touch_zeroinit uses.
+ */
+intptr_t get_first_touch_threads();
+
+/**
+ * Zeroes newly allocated memory. When set_first_touch_threads has
+ * raised the thread count, large regions are zeroed by several
+ * threads, each writing a contiguous range of pages, so under a
+ * first-touch NUMA policy the pages are spread across the nodes the
+ * threads run on instead of all landing on the calling thread's node.
+ */
+void first_touch_zeroinit(char *data, size_t size_bytes);
+
+/**
+ * Counts of the memory allocated by one type of memory block.
+ */
+struct memory_allocation_counts {
+    /** The number of allocations */
+    uint64_t allocation_count;
+    /** The total number of bytes requested by all the allocations */
+    uint64_t allocated_bytes;
+    /** The number of allocations which have been freed */
+    uint64_t free_count;
+};
+
+/**
+ * Returns the allocation counts for memory blocks of type `mbt`
+ * since the program started or reset_memory_allocation_counts
+ * was last called.
+ */
+memory_allocation_counts get_memory_allocation_counts(memory_block_type_t mbt);
+
+/**
+ * Resets all the memory allocation counts to zero.
+ */
+void reset_memory_allocation_counts();
+
+} // namespace dynd
+
+#endif // _DYND__MEMORY_ALLOCATOR_HPP_
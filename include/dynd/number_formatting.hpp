@@ -0,0 +1,44 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// Direct formatting of numbers into character buffers, for
+// formatters which can't afford to go through iostreams.
+//
+
+#ifndef _DYND__NUMBER_FORMATTING_HPP_
+#define _DYND__NUMBER_FORMATTING_HPP_
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * The most characters any of the format_* functions writes.
+ */
+enum { max_formatted_number_size = 32 };
+
+/**
+ * Writes the decimal digits of the value to `out`, which must have
+ * room for max_formatted_number_size characters, and returns the
+ * pointer just past the last character written. No NUL terminator
+ * is written.
+ */
+char *format_uint64(char *out, uint64_t value);
+char *format_int64(char *out, int64_t value);
+
+/**
+ * Writes the shortest "%g"-style representation of the value which
+ * parses back to exactly the same value, always using '.' as the
+ * decimal point. Infinities and NaN are written as "inf", "-inf",
+ * and "nan", matching how dynd prints them.
+ *
+ * Like format_uint64, `out` must have room for
+ * max_formatted_number_size characters.
+ */
+char *format_float64(char *out, double value);
+char *format_float32(char *out, float value);
+
+} // namespace dynd
+
+#endif // _DYND__NUMBER_FORMATTING_HPP_
@@ -280,6 +280,44 @@ bool parse_4digit_int_no_ws(const char *&begin, const char *end,
 bool parse_6digit_int_no_ws(const char *&begin, const char *end,
                                    int &out_val);
 
+/**
+ * Parses eight characters packed into a 64-bit word, the first
+ * character in the lowest byte, as an integer with exactly eight digits.
+ * The digits are checked and combined with a few 64-bit operations
+ * (SWAR, SIMD within a register) instead of one at a time, for fixed
+ * width formats like "YYYY-MM-DD" whose digits can be gathered into
+ * one word.
+ *
+ * Example:
+ *     // Match "YYYYMMDD"
+ *     uint64_t chars = 0;
+ *     for (int i = 0; i < 8; ++i) {
+ *         chars |= (uint64_t)(unsigned char)begin[i] << (8 * i);
+ *     }
+ *     int ymd;
+ *     if (parse_8digit_packed_int(chars, ymd)) {
+ *         // Process ymd
+ *     }
+ */
+inline bool parse_8digit_packed_int(uint64_t chars, int &out_val)
+{
+    // Every byte is a digit exactly when its high nibble is 3, and
+    // adding 6 to it doesn't carry into the high nibble
+    if (((chars & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chars + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) !=
+                0x3333333333333333ULL) {
+        return false;
+    }
+    uint64_t val = chars - 0x3030303030303030ULL;
+    // Combine adjacent digits into 2 digit values in each 16-bit lane
+    val = val * 10 + (val >> 8);
+    // Combine those into the full value in the high 32 bits
+    val = ((val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) +
+            ((val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+    out_val = static_cast<int>(val);
+    return true;
+}
+
 /**
  * A helper class for matching a bunch of names and getting an integer.
  * Arrays of this struct should be in alphabetical order.
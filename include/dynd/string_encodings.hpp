@@ -98,6 +98,35 @@ typedef void (*append_unicode_codepoint_t)(uint32_t cp, char *&it, char *end);
 next_unicode_codepoint_t get_next_unicode_codepoint_function(string_encoding_t encoding, assign_error_mode errmode);
 append_unicode_codepoint_t get_append_unicode_codepoint_function(string_encoding_t encoding, assign_error_mode errmode);
 
+/**
+ * Returns the number of bytes the string [begin, end) of encoding
+ * `src_encoding` occupies once transcoded to `dst_encoding`. This decodes
+ * the whole input, so it also validates it according to `errmode`. Runs of
+ * ASCII characters are checked a SIMD block at a time.
+ */
+intptr_t get_transcoded_string_size(string_encoding_t dst_encoding,
+                string_encoding_t src_encoding, const char *begin, const char *end,
+                assign_error_mode errmode);
+
+/**
+ * Transcodes the string [src_begin, src_end) into the buffer `dst`, whose
+ * `dst_size` must be the size get_transcoded_string_size returned for the
+ * same input, which has then already been validated. Runs of ASCII
+ * characters are copied, widened or narrowed directly, and only the other
+ * characters are decoded one code point at a time. Returns the end of the
+ * output.
+ */
+char *transcode_string(string_encoding_t dst_encoding, char *dst, intptr_t dst_size,
+                string_encoding_t src_encoding, const char *src_begin, const char *src_end,
+                assign_error_mode errmode);
+
+/**
+ * Returns the end of the null-terminated string in the fixed-size buffer
+ * [begin, end), which is `end` if the buffer is full.
+ */
+const char *find_fixedstring_end(string_encoding_t encoding,
+                const char *begin, const char *end);
+
 /**
  * Converts a string buffer provided as a range of bytes into a std::string as UTF8.
  */
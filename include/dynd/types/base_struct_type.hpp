@@ -6,6 +6,8 @@
 #ifndef _DYND__BASE_STRUCT_TYPE_HPP_
 #define _DYND__BASE_STRUCT_TYPE_HPP_
 
+#include <vector>
+
 #include <dynd/types/base_type.hpp>
 
 namespace dynd {
@@ -19,6 +21,15 @@ namespace dynd {
 class base_struct_type : public base_type {
 protected:
     size_t m_field_count;
+    // Open addressing hash table from field names to field indices,
+    // with -1 in the empty slots
+    std::vector<intptr_t> m_field_name_table;
+
+    /**
+     * Builds the field name lookup table. Subclass constructors
+     * call this once the field names are set.
+     */
+    void init_field_name_lookup();
 public:
     inline base_struct_type(type_id_t type_id, size_t data_size,
                     size_t alignment, size_t field_count, flags_type flags, size_t metadata_size)
@@ -50,6 +61,15 @@ public:
      *           of the given name.
      */
     virtual intptr_t get_field_index(const std::string& field_name) const = 0;
+    /**
+     * Gets the field index for the name in [name_begin, name_end),
+     * using a hash table built when the type was constructed. This
+     * lets parsers look up names in place, without making a string.
+     *
+     * \returns  The field index, or -1 if there is not field
+     *           of the given name.
+     */
+    intptr_t get_field_index(const char *name_begin, const char *name_end) const;
 
     void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
                     const char *metadata, const char *data) const;
@@ -13,11 +13,13 @@
 #include <dynd/type.hpp>
 #include <dynd/array.hpp>
 #include <dynd/types/strided_dim_type.hpp>
+#include <dynd/kernels/hash_kernels.hpp>
 
 
 namespace {
 
 struct assign_to_same_category_type;
+struct category_to_categorical_kernel_extra;
 
 } // anonymous namespace
 
@@ -34,6 +36,9 @@ class categorical_type : public base_type {
     std::vector<intptr_t> m_category_index_to_value;
     // mapping from values to category indices
     std::vector<intptr_t> m_value_to_category_index;
+    // hash table from category values to category indices,
+    // empty if the category type isn't hashable
+    hash_index_table m_category_lookup;
 
 public:
     categorical_type(const nd::array& categories, bool presorted=false);
@@ -106,6 +111,7 @@ public:
                     size_t *out_count) const;
 
     friend struct assign_to_same_category_type;
+    friend struct ::category_to_categorical_kernel_extra;
     friend struct assign_from_same_category_type;
     friend struct assign_from_commensurate_category_type;
 };
@@ -35,6 +35,15 @@ namespace dynd {
 bool string_to_date(const char *begin, const char *end, date_ymd &out_ymd,
                     date_parse_order_t ambig, int century_window);
 
+/**
+ * Parses a date in the fixed width ISO 8601 form "YYYY-MM-DD", with
+ * nothing before or after it. This is a fast path for string_to_date,
+ * which produces the same date for every string accepted here, so
+ * false only means the caller should fall back to string_to_date.
+ */
+bool string_to_date_iso8601_fixed(const char *begin, const char *end,
+                                  date_ymd &out_ymd);
+
 namespace parse {
 
     /**
@@ -74,6 +83,19 @@ namespace parse {
     bool parse_iso8601_dashes_date(const char *&begin, const char *end,
                                    date_ymd &out_ymd);
 
+    /**
+     * Parses a date in the fixed width ISO 8601 form YYYY-MM-DD, checking
+     * and combining its eight digits together in one 64-bit word.
+     *
+     * \param begin  The start of a range of UTF-8 characters. This is modified
+     *               to point immediately after the parsed date if true is returned.
+     * \param end  The end of a range of UTF-8 characters.
+     * \param out_ymd  If true is returned, this has been filled with the parsed
+     *                 date.
+     */
+    bool parse_iso8601_fixed_date(const char *&begin, const char *end,
+                                  date_ymd &out_ymd);
+
     /**
      * Parses a string month: Jan == 1, Dec == 12.
      *
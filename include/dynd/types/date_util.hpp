@@ -160,6 +160,60 @@ struct date_ymd {
         }
     }
 
+    /**
+     * Converts a 1970 epoch days offset into year/month/day using
+     * only integer arithmetic by constants and masks, with no
+     * branches or table lookups, so loops over it vectorize. This
+     * produces the same values as set_from_days, including for
+     * DYND_DATE_NA, except that the year is not truncated to 16 bits.
+     *
+     * \param days  A days offset from January 1, 1970.
+     * \param out_year  The year is placed here.
+     * \param out_month  The month, 1 to 12, is placed here.
+     * \param out_day  The day, 1 to 31, is placed here.
+     */
+    static inline void days_to_ymd(int32_t days, int32_t& out_year,
+                    int32_t& out_month, int32_t& out_day) {
+        // Shift to days since 0000-03-01, so the leap day is last
+        int32_t z = static_cast<int32_t>(static_cast<uint32_t>(days) + 719468u);
+        // 400 year era, and the day within it (0 to 146096)
+        int32_t era = (z - (146097 - 1) * (z < 0)) / 146097;
+        int32_t doe = z - era * 146097;
+        // Year within the era (0 to 399), and the day within it
+        int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        // Month counting from March (0 to 11)
+        int32_t mp = (5 * doy + 2) / 153;
+        int32_t month = mp + 3 - 12 * (mp >= 10);
+        int32_t notna = -static_cast<int32_t>(days != DYND_DATE_NA);
+        out_year = (yoe + era * 400 + (month <= 2)) & notna;
+        out_month = (month & notna) | (-128 & ~notna);
+        out_day = (doy - (153 * mp + 2) / 5 + 1) & notna;
+    }
+
+    /**
+     * Converts a ticks-based datetime into a 1970 epoch days offset,
+     * rounding toward negative infinity, without branching. The
+     * datetime NA value becomes DYND_DATE_NA.
+     */
+    static inline int32_t ticks_to_days(int64_t ticks) {
+        int64_t days = ticks / DYND_TICKS_PER_DAY;
+        days -= (days * DYND_TICKS_PER_DAY > ticks);
+        int32_t notna = -static_cast<int32_t>(
+                        ticks != std::numeric_limits<int64_t>::min());
+        return (static_cast<int32_t>(days) & notna) | (DYND_DATE_NA & ~notna);
+    }
+
+    /**
+     * Gets the 0-based day of the week of a 1970 epoch days offset,
+     * where 0 is Monday, 6 is Sunday, without branching.
+     */
+    static inline int32_t days_to_weekday(int32_t days) {
+        // January 5, 1970 is Monday, so this is (days - 4) mod 7
+        int32_t weekday = days % 7 + 3;
+        return weekday + 7 * (weekday < 0) - 7 * (weekday >= 7);
+    }
+
     /**
      * Sets the year/month/day to NA.
      */
@@ -34,6 +34,17 @@ bool string_to_datetime(const char *begin, const char *end,
                         datetime_struct &out_dt, date_parse_order_t ambig,
                         int century_window);
 
+/**
+ * Parses a datetime in the ISO 8601 form "YYYY-MM-DDTHH:MM:SS.SSS",
+ * where a space may replace the "T" and the seconds and fraction are
+ * optional, with nothing before or after it. This is a fast path for
+ * string_to_datetime, which produces the same datetime for every string
+ * accepted here, so false only means the caller should fall back to
+ * string_to_datetime.
+ */
+bool string_to_datetime_iso8601_fixed(const char *begin, const char *end,
+                                      datetime_struct &out_dt);
+
 namespace parse {
 
     /**
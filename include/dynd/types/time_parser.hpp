@@ -23,6 +23,16 @@ struct time_hmst;
  */
 bool string_to_time(const char *begin, const char *end, time_hmst &out_hmst);
 
+/**
+ * Parses a time in the ISO 8601 form "HH:MM", "HH:MM:SS" or
+ * "HH:MM:SS.SSS", with nothing before or after it. This is a fast path
+ * for string_to_time, which produces the same time for every string
+ * accepted here, so false only means the caller should fall back to
+ * string_to_time.
+ */
+bool string_to_time_iso8601_fixed(const char *begin, const char *end,
+                                  time_hmst &out_hmst);
+
 namespace parse {
 
     /**
@@ -37,6 +47,21 @@ namespace parse {
      */
     bool parse_time(const char *&begin, const char *end, time_hmst &out_hmst);
 
+    /**
+     * Parses a time in the ISO 8601 form HH:MM, HH:MM:SS or HH:MM:SS.SSS,
+     * with a two digit hour and no AM/PM indicator, checking and combining
+     * the hour, minute and second digits together in one 64-bit word.
+     *
+     * \param begin  The start of a range of UTF-8 characters. This is modified
+     *               to point immediately after the parsed time if true is returned.
+     * \param end  The end of a range of UTF-8 characters.
+     * \param out_hmst  The time to fill.
+     *
+     * \returns  True if a time was parsed successfully, false otherwise.
+     */
+    bool parse_iso8601_fixed_time(const char *&begin, const char *end,
+                                  time_hmst &out_hmst);
+
     /**
      * Without skipping whitespace, parses an AM/PM indicator string and modifies
      * the provided hour appropriately. If the AM/PM is incompatible with the
@@ -0,0 +1,121 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__ELWISE_INTERPRETER_HPP_
+#define _DYND__ELWISE_INTERPRETER_HPP_
+
+#include <vector>
+
+#include <dynd/shortvector.hpp>
+#include <dynd/vm/elwise_program.hpp>
+#include <dynd/vm/register_allocation.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_deferred.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace vm {
+
+/**
+ * The number of elements, and the total bytes across all the registers,
+ * the VM processes at a time. This keeps the registers resident in the L2 cache.
+ */
+const intptr_t elwise_max_chunk_size = 4096;
+const intptr_t elwise_max_register_bytes = 128 * 1024;
+
+/**
+ * Applies an opcode to `count` contiguous elements. The source
+ * registers are given in order, and the destination may be the
+ * same buffer as one of the sources.
+ */
+typedef void (*elwise_opcode_function_t)(char *dst, const char * const *src, intptr_t count);
+
+/**
+ * Returns the function implementing `opcode` with a destination
+ * register of type `dst_tp` and source registers of the types in
+ * `src_tp`, or NULL if the VM doesn't support that combination.
+ *
+ * The arithmetic opcodes, min, max, abs, sqrt and muladd require all the
+ * registers to have the same type, the comparisons a bool destination,
+ * and select a bool condition. Cast converts between any of the
+ * supported real types and bool. The float32 and float64 versions
+ * use SSE2 where it's available.
+ */
+elwise_opcode_function_t get_elwise_opcode_function(opcode_t opcode,
+                const ndt::type& dst_tp, const ndt::type *src_tp);
+
+/**
+ * Runs an elementwise program over its inputs a block at a time, with
+ * the blocks sized so all the registers stay in the L2 cache. Inputs
+ * and outputs which are contiguous are used in place of their registers,
+ * and strided ones are copied through them.
+ */
+class elwise_interpreter {
+    elwise_program m_program;
+    std::vector<elwise_opcode_function_t> m_funcs;
+    register_allocation m_regs;
+    // The registers of the block being processed, which
+    // may point directly at the operands
+    std::vector<char *> m_reg_ptrs;
+    // Kernels converting the inputs which aren't of the register types
+    shortvector<assignment_strided_ckernel_builder> m_input_kernels;
+    shortvector<bool> m_converts_input;
+
+    // Non-copyable
+    elwise_interpreter(const elwise_interpreter&);
+    elwise_interpreter& operator=(const elwise_interpreter&);
+
+    void execute(intptr_t count);
+public:
+    /**
+     * Prepares to run the program, throwing if it uses an opcode
+     * the VM doesn't support for its register types.
+     *
+     * \param ep  The program, which is copied.
+     * \param src_tp  If not NULL, the types of the inputs. An input whose type
+     *                isn't its register type is converted as it's read.
+     * \param src_metadata  The metadata for `src_tp`.
+     * \param ectx  The evaluation context used for the input conversions.
+     */
+    elwise_interpreter(const elwise_program& ep, const ndt::type *src_tp = NULL,
+                    const char **src_metadata = NULL,
+                    const eval::eval_context *ectx = &eval::default_eval_context);
+
+    const elwise_program& get_program() const {
+        return m_program;
+    }
+
+    /** The number of elements processed at a time */
+    intptr_t get_block_size() const {
+        return m_regs.get_element_count();
+    }
+
+    /** Runs the program on one element */
+    void run_single(char *dst, const char * const *src);
+
+    /** Runs the program on `count` strided elements */
+    void run(char *dst, intptr_t dst_stride,
+                    const char * const *src, const intptr_t *src_stride, intptr_t count);
+};
+
+/**
+ * Creates an expr ckernel (expr_single_operation_t or expr_strided_operation_t,
+ * depending on kernreq) which evaluates the program. Its destination has the
+ * type of the output register, and its sources the types `src_tp`, whose
+ * value types are those of the input registers.
+ */
+size_t make_elwise_program_expr_kernel(ckernel_builder *out, size_t offset_out,
+                const elwise_program& ep, const ndt::type *src_tp, const char **src_metadata,
+                kernel_request_t kernreq, const eval::eval_context *ectx);
+
+/**
+ * Creates a deferred ckernel with the expr_operation_funcproto, which
+ * evaluates the program. Its data types are the types of the output
+ * register followed by the input registers.
+ */
+void make_elwise_program_ckernel_deferred(const elwise_program& ep, ckernel_deferred& out_ckd);
+
+}} // namespace dynd::vm
+
+#endif // _DYND__ELWISE_INTERPRETER_HPP_
@@ -17,9 +17,29 @@ enum opcode_t {
     opcode_add,
     opcode_subtract,
     opcode_multiply,
-    opcode_divide
+    opcode_divide,
+    opcode_min,
+    opcode_max,
+    opcode_abs,
+    opcode_sqrt,
+    // The comparisons write to a bool register
+    opcode_less,
+    opcode_less_equal,
+    opcode_equal,
+    opcode_not_equal,
+    opcode_greater_equal,
+    opcode_greater,
+    // dst = src0 ? src1 : src2, where src0 is a bool register
+    opcode_select,
+    // dst = src0 * src1 + src2, rounding the product and the sum separately
+    opcode_muladd,
+    // Converts between the types of the src and dst registers
+    opcode_cast
 };
-const int opcode_count = opcode_divide + 1;
+const int opcode_count = opcode_cast + 1;
+
+/** The largest arity of any opcode */
+const int max_opcode_arity = 3;
 
 struct opcode_info_t {
     const char *name;
@@ -66,6 +86,15 @@ public:
         m_input_count = input_count;
     }
 
+    /**
+     * Returns the position of the last instruction before position `ip`
+     * which writes to `reg`, or the program size if there is none.
+     */
+    size_t find_register_writer(int reg, size_t ip) const;
+
+    /** Prints the program as a nested expression, like "add(op0, multiply(op1, op2))" */
+    void print_expression(std::ostream& o) const;
+
     /** Debug printing of the elwise program */
     void debug_print(std::ostream& o, const std::string& indent = "") const;
 
@@ -93,6 +122,16 @@ public:
     }
 };
 
+/**
+ * Builds the program which applies `opcode` to the results of the
+ * operand programs, reusing temporary registers once their values
+ * are consumed. The inputs of the result are the inputs of each
+ * operand in order. A NULL operand stands for a single input of type
+ * `tp`, which is also the type of the output.
+ */
+void compose_elwise_program(opcode_t opcode, const ndt::type& tp,
+                const elwise_program * const *operands, elwise_program& out);
+
 }} // namespace dynd::vm
 
 #endif // _DYND__ELWISE_PROGRAM_HPP_
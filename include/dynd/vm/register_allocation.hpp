@@ -17,6 +17,7 @@ class register_allocation {
     std::vector<char *> m_registers;
     std::vector<memory_block_ptr> m_blockrefs;
     char *m_allocated_memory;
+    intptr_t m_element_count;
 public:
     register_allocation(const std::vector<ndt::type>& regtypes, intptr_t max_element_count, intptr_t max_byte_count);
     ~register_allocation();
@@ -28,6 +29,11 @@ public:
     const std::vector<char *>& get_registers() const {
         return m_registers;
     }
+
+    /** The number of elements each register holds */
+    intptr_t get_element_count() const {
+        return m_element_count;
+    }
 };
 
 }} // namespace dynd::vm
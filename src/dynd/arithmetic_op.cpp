@@ -16,6 +16,8 @@
 #include <dynd/types/expr_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/kernels/string_algorithm_kernels.hpp>
+#include <dynd/vm/elwise_interpreter.hpp>
+#include <dynd/eval/eval_elwise_vm.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -69,12 +71,26 @@ namespace {
         ndt::type m_rdt, m_op1dt, m_op2dt;
         expr_operation_pair m_op_pair;
         const char *m_name;
+        // The equivalent one instruction VM program, if there is one
+        vm::elwise_program m_program;
     public:
         arithmetic_op_kernel_generator(const ndt::type& rdt, const ndt::type& op1dt, const ndt::type& op2dt,
-                        const expr_operation_pair& op_pair, const char *name)
+                        const expr_operation_pair& op_pair, const char *name, int vm_opcode)
             : expr_kernel_generator(true), m_rdt(rdt), m_op1dt(op1dt), m_op2dt(op2dt),
-                            m_op_pair(op_pair), m_name(name)
+                            m_op_pair(op_pair), m_name(name), m_program()
         {
+            ndt::type src_tp[2] = {rdt, rdt};
+            if (vm_opcode >= 0 && op1dt == rdt && op2dt == rdt &&
+                            vm::get_elwise_opcode_function(static_cast<vm::opcode_t>(vm_opcode),
+                                rdt, src_tp) != NULL) {
+                vector<ndt::type> regtypes(3, rdt);
+                vector<int> program(4);
+                program[0] = vm_opcode;
+                program[1] = 0;
+                program[2] = 1;
+                program[3] = 2;
+                m_program.set(2, regtypes, program);
+            }
         }
 
         virtual ~arithmetic_op_kernel_generator() {
@@ -128,6 +144,67 @@ namespace {
         {
             o << m_name << "(op0, op1)";
         }
+
+        const vm::elwise_program *get_elwise_program() const
+        {
+            return m_program.get_instruction_count() > 0 ? &m_program : NULL;
+        }
+    };
+
+    /**
+     * The kernel generator of a fused tree of arithmetic operations,
+     * which evaluates it as one elementwise VM program whose inputs
+     * are the leaves of the tree.
+     */
+    class elwise_program_kernel_generator : public expr_kernel_generator {
+        vm::elwise_program m_program;
+    public:
+        elwise_program_kernel_generator(const vm::elwise_program& program)
+            : expr_kernel_generator(true), m_program(program)
+        {
+        }
+
+        virtual ~elwise_program_kernel_generator() {
+        }
+
+        size_t make_expr_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    size_t src_count, const ndt::type *src_tp, const char **src_metadata,
+                    kernel_request_t kernreq, const eval::eval_context *ectx) const
+        {
+            const vector<ndt::type>& regtypes = m_program.get_register_types();
+            if (src_count != (size_t)m_program.get_input_count()) {
+                stringstream ss;
+                ss << "The elwise program kernel requires " << m_program.get_input_count();
+                ss << " src operands, received " << src_count;
+                throw runtime_error(ss.str());
+            }
+            // The program kernel converts the scalar inputs itself
+            bool is_leaf = (dst_tp == regtypes[0]);
+            for (size_t i = 0; i < src_count && is_leaf; ++i) {
+                is_leaf = (src_tp[i].get_ndim() == 0 && src_tp[i].value_type() == regtypes[i + 1]);
+            }
+            if (!is_leaf) {
+                return make_elwise_dimension_expr_kernel(out, offset_out,
+                                dst_tp, dst_metadata,
+                                src_count, src_tp, src_metadata,
+                                kernreq, ectx,
+                                this);
+            }
+            return vm::make_elwise_program_expr_kernel(out, offset_out, m_program,
+                            src_tp, src_metadata, kernreq, ectx);
+        }
+
+        void print_type(std::ostream& o) const
+        {
+            m_program.print_expression(o);
+        }
+
+        const vm::elwise_program *get_elwise_program() const
+        {
+            return &m_program;
+        }
     };
 } // anonymous namespace
 
@@ -190,7 +267,7 @@ namespace {
     {&binary_single_kernel<operation<int32_t> >::func, &binary_strided_kernel<operation<int32_t> >::func}, \
     {&binary_single_kernel<operation<int64_t> >::func, &binary_strided_kernel<operation<int64_t> >::func}, \
     DYND_INT128_BINARY_OP_PAIR(operation), \
-    {&binary_single_kernel<operation<int32_t> >::func, &binary_strided_kernel<operation<uint32_t> >::func}, \
+    {&binary_single_kernel<operation<uint32_t> >::func, &binary_strided_kernel<operation<uint32_t> >::func}, \
     {&binary_single_kernel<operation<uint64_t> >::func, &binary_strided_kernel<operation<uint64_t> >::func}, \
     DYND_UINT128_BINARY_OP_PAIR(operation), \
     {&binary_single_kernel<operation<float> >::func, &binary_strided_kernel<operation<float> >::func}, \
@@ -223,11 +300,87 @@ static int compress_builtin_type_id[builtin_type_id_count] = {
                 9, 10, // complex<float32>, complex<float64>
                 -1};
 
+/**
+ * Gets the value dtype of an operand, which may be an arithmetic
+ * expression with its dimensions inside the expr type.
+ */
+static ndt::type get_value_dtype(const nd::array& a)
+{
+    return a.get_type().value_type().get_dtype().value_type();
+}
+
+// The elementwise dimension kernels handle up to this many operands
+static const size_t max_fused_operand_count = 6;
+
+/**
+ * If one of the operands is itself a fused arithmetic expression of type
+ * `rdt`, builds the expression applying `vm_opcode` to the operands as one
+ * VM program over all the leaves. Returns a NULL array otherwise.
+ */
+static nd::array fuse_binary_operator(const nd::array *ops, const dimvector& result_shape,
+                size_t ndim, const ndt::type& rdt, int vm_opcode)
+{
+    ndt::type src_tp[2] = {rdt, rdt};
+    if (vm::get_elwise_opcode_function(static_cast<vm::opcode_t>(vm_opcode), rdt, src_tp) == NULL) {
+        return nd::array();
+    }
+    vm::elwise_program op_programs[2];
+    vector<nd::array> op_inputs[2];
+    bool fused[2];
+    size_t leaf_count = 0;
+    for (int i = 0; i < 2; ++i) {
+        fused[i] = eval::compile_elwise_expr(ops[i], op_programs[i], op_inputs[i]) &&
+                        op_programs[i].get_register_types()[0] == rdt;
+        leaf_count += fused[i] ? op_inputs[i].size() : 1;
+    }
+    // While there are too many leaves for one expression, the fused
+    // operand with the most leaves gets evaluated on its own
+    bool evaluated[2] = {false, false};
+    while (leaf_count > max_fused_operand_count) {
+        int i = (!fused[1] || (fused[0] && op_inputs[0].size() >= op_inputs[1].size())) ? 0 : 1;
+        leaf_count -= op_inputs[i].size() - 1;
+        fused[i] = false;
+        evaluated[i] = true;
+    }
+    if (!fused[0] && !fused[1]) {
+        return nd::array();
+    }
+
+    vector<nd::array> leaves;
+    const vm::elwise_program *operands[2];
+    for (int i = 0; i < 2; ++i) {
+        if (evaluated[i]) {
+            leaves.push_back(ops[i].eval());
+        } else if (fused[i]) {
+            leaves.insert(leaves.end(), op_inputs[i].begin(), op_inputs[i].end());
+        } else if (ops[i].get_type().get_type_id() == expr_type_id) {
+            leaves.push_back(ops[i].eval().ucast(rdt));
+        } else {
+            leaves.push_back(ops[i].ucast(rdt));
+        }
+        operands[i] = fused[i] ? &op_programs[i] : NULL;
+    }
+    vm::elwise_program ep;
+    vm::compose_elwise_program(static_cast<vm::opcode_t>(vm_opcode), rdt, operands, ep);
+
+    vector<string> field_names(leaves.size());
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        stringstream ss;
+        ss << "arg" << i;
+        field_names[i] = ss.str();
+    }
+    nd::array result = combine_into_struct(leaves.size(), &field_names[0], &leaves[0]);
+    ndt::type edt = ndt::make_expr(ndt::make_type(ndim, result_shape.get(), rdt),
+                    result.get_type(), new elwise_program_kernel_generator(ep));
+    edt.swap(result.get_ndo()->m_type);
+    return result;
+}
+
 template<class KD>
 nd::array apply_binary_operator(const nd::array *ops,
                 const ndt::type& rdt, const ndt::type& op1dt, const ndt::type& op2dt,
                 expr_operation_pair expr_ops,
-                const char *name)
+                const char *name, int vm_opcode)
 {
     if (expr_ops.single == NULL) {
         stringstream ss;
@@ -250,18 +403,31 @@ nd::array apply_binary_operator(const nd::array *ops,
         }
     }
 
+    if (vm_opcode >= 0) {
+        // Trees of arithmetic get fused into one VM program
+        nd::array fused = fuse_binary_operator(ops, result_shape, ndim, rdt, vm_opcode);
+        if (!fused.is_empty()) {
+            return fused;
+        }
+    }
+
     // Assemble the destination value type
     ndt::type result_vdt = ndt::make_type(ndim, result_shape.get(), rdt);
 
     // Create the result
     string field_names[2] = {"arg0", "arg1"};
-    nd::array ops_as_dt[2] = {ops[0].ucast(op1dt), ops[1].ucast(op2dt)};
+    // Expressions can't be nested as operands, so any which weren't fused get evaluated
+    nd::array ops_as_dt[2];
+    for (int i = 0; i < 2; ++i) {
+        nd::array op = (ops[i].get_type().get_type_id() == expr_type_id) ? ops[i].eval() : ops[i];
+        ops_as_dt[i] = op.ucast(i == 0 ? op1dt : op2dt);
+    }
     nd::array result = combine_into_struct(2, field_names, ops_as_dt);
     // Because the expr type's operand is the result's type,
     // we can swap it in as the type
     ndt::type edt = ndt::make_expr(result_vdt,
                     result.get_type(),
-                    new arithmetic_op_kernel_generator<KD>(rdt, op1dt, op2dt, expr_ops, name));
+                    new arithmetic_op_kernel_generator<KD>(rdt, op1dt, op2dt, expr_ops, name, vm_opcode));
     edt.swap(result.get_ndo()->m_type);
     return result;
 }
@@ -270,8 +436,8 @@ nd::array nd::operator+(const nd::array& op1, const nd::array& op2)
 {
     nd::array ops[2] = {op1, op2};
     expr_operation_pair func_ptr;
-    ndt::type op1dt = op1.get_dtype().value_type();
-    ndt::type op2dt = op2.get_dtype().value_type();
+    ndt::type op1dt = get_value_dtype(op1);
+    ndt::type op2dt = get_value_dtype(op2);
     if (op1dt.is_builtin() && op1dt.is_builtin()) {
         ndt::type rdt = promote_types_arithmetic(op1dt, op2dt);
         int table_index = compress_builtin_type_id[rdt.get_type_id()];
@@ -283,14 +449,14 @@ nd::array nd::operator+(const nd::array& op1, const nd::array& op2)
         }
 
         // The signature is (T, T) -> T, so we don't use the original types
-        return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "addition");
+        return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "addition", vm::opcode_add);
     } else if (op1dt.get_kind() == string_kind && op2dt.get_kind() == string_kind) {
         ndt::type rdt = ndt::make_string();
         func_ptr.single = &kernels::string_concatenation_kernel::single;
         func_ptr.strided = &kernels::string_concatenation_kernel::strided;
         // The signature is (string, string) -> string, so we don't use the original types
         // NOTE: Using a different name for string concatenation in the generated expression
-        return apply_binary_operator<kernels::string_concatenation_kernel>(ops, rdt, rdt, rdt, func_ptr, "string_concat");
+        return apply_binary_operator<kernels::string_concatenation_kernel>(ops, rdt, rdt, rdt, func_ptr, "string_concat", -1);
     } else {
         stringstream ss;
         ss << "Addition is not supported for dynd types ";
@@ -303,8 +469,8 @@ nd::array nd::operator-(const nd::array& op1, const nd::array& op2)
 {
     ndt::type rdt;
     expr_operation_pair func_ptr;
-    ndt::type op1dt = op1.get_dtype().value_type();
-    ndt::type op2dt = op2.get_dtype().value_type();
+    ndt::type op1dt = get_value_dtype(op1);
+    ndt::type op2dt = get_value_dtype(op2);
     if (op1dt.is_builtin() && op1dt.is_builtin()) {
         rdt = promote_types_arithmetic(op1dt, op2dt);
         int table_index = compress_builtin_type_id[rdt.get_type_id()];
@@ -314,15 +480,15 @@ nd::array nd::operator-(const nd::array& op1, const nd::array& op2)
     }
 
     nd::array ops[2] = {op1, op2};
-    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "subtraction");
+    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "subtraction", vm::opcode_subtract);
 }
 
 nd::array nd::operator*(const nd::array& op1, const nd::array& op2)
 {
     ndt::type rdt;
     expr_operation_pair func_ptr;
-    ndt::type op1dt = op1.get_dtype().value_type();
-    ndt::type op2dt = op2.get_dtype().value_type();
+    ndt::type op1dt = get_value_dtype(op1);
+    ndt::type op2dt = get_value_dtype(op2);
     if (op1dt.is_builtin() && op1dt.is_builtin()) {
         rdt = promote_types_arithmetic(op1dt, op2dt);
         int table_index = compress_builtin_type_id[rdt.get_type_id()];
@@ -332,15 +498,15 @@ nd::array nd::operator*(const nd::array& op1, const nd::array& op2)
     }
 
     nd::array ops[2] = {op1, op2};
-    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "multiplication");
+    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "multiplication", vm::opcode_multiply);
 }
 
 nd::array nd::operator/(const nd::array& op1, const nd::array& op2)
 {
     ndt::type rdt;
     expr_operation_pair func_ptr;
-    ndt::type op1dt = op1.get_dtype().value_type();
-    ndt::type op2dt = op2.get_dtype().value_type();
+    ndt::type op1dt = get_value_dtype(op1);
+    ndt::type op2dt = get_value_dtype(op2);
     if (op1dt.is_builtin() && op1dt.is_builtin()) {
         rdt = promote_types_arithmetic(op1dt, op2dt);
         int table_index = compress_builtin_type_id[rdt.get_type_id()];
@@ -350,5 +516,5 @@ nd::array nd::operator/(const nd::array& op1, const nd::array& op2)
     }
 
     nd::array ops[2] = {op1, op2};
-    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "division");
+    return apply_binary_operator<ckernel_prefix>(ops, rdt, rdt, rdt, func_ptr, "division", vm::opcode_divide);
 }
@@ -5,6 +5,7 @@
 
 #include <dynd/array.hpp>
 #include <dynd/array_iter.hpp>
+#include <dynd/array_search.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -20,6 +21,7 @@
 #include <dynd/types/cuda_device_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/eval/eval_elwise_vm.hpp>
 #include <dynd/exceptions.hpp>
 #include <dynd/gfunc/callable.hpp>
 #include <dynd/gfunc/call_callable.hpp>
@@ -838,6 +840,20 @@ const gfunc::callable& nd::array::find_dynamic_function(const char *function_nam
     throw runtime_error(ss.str());
 }
 
+/**
+ * Assigns the value of the expression array `src` to the newly
+ * allocated `result`. Fused arithmetic trees over strided arrays
+ * are run by the VM directly, with the dimensions coalesced, rather
+ * than through the per-dimension expr kernels.
+ */
+static void assign_expression_value(nd::array& result, const nd::array& src,
+                const eval::eval_context *ectx)
+{
+    if (!eval::evaluate_elwise_expr(result, src, ectx)) {
+        result.val_assign(src, assign_error_default, ectx);
+    }
+}
+
 nd::array nd::array::eval(const eval::eval_context *ectx) const
 {
     const ndt::type& current_tp = get_type();
@@ -856,7 +872,7 @@ nd::array nd::array::eval(const eval::eval_context *ectx) const
                             dt.extended())->reorder_default_constructed_strides(
                                             result.get_ndo_meta(), get_type(), get_ndo_meta());
         }
-        result.val_assign(*this, assign_error_default, ectx);
+        assign_expression_value(result, *this, ectx);
         return result;
     }
 }
@@ -880,7 +896,7 @@ nd::array nd::array::eval_immutable(const eval::eval_context *ectx) const
                             dt.extended())->reorder_default_constructed_strides(
                                             result.get_ndo_meta(), get_type(), get_ndo_meta());
         }
-        result.val_assign(*this, assign_error_default, ectx);
+        assign_expression_value(result, *this, ectx);
         result.get_ndo()->m_flags = immutable_access_flag|read_access_flag;
         return result;
     }
@@ -1554,94 +1570,7 @@ nd::array nd::memmap(const std::string& filename,
 
 intptr_t nd::binary_search(const nd::array& n, const char *metadata, const char *data)
 {
-    if (n.get_ndim() == 0) {
-        stringstream ss;
-        ss << "cannot do a dynd binary_search on array with type " << n.get_type() << " without a leading array dimension";
-        throw runtime_error(ss.str());
-    }
-    const char *n_metadata = n.get_ndo_meta();
-    ndt::type element_tp = n.get_type().at_single(0, &n_metadata);
-    if (element_tp.get_metadata_size() == 0 || n_metadata == metadata ||
-                    memcmp(n_metadata, metadata, element_tp.get_metadata_size()) == 0) {
-        // First, a version where the metadata is identical, so we can
-        // make do with only a single comparison kernel
-        comparison_ckernel_builder k_n_less_d;
-        make_comparison_kernel(&k_n_less_d, 0,
-                        element_tp, n_metadata,
-                        element_tp, n_metadata,
-                        comparison_type_sorting_less,
-                        &eval::default_eval_context);
-
-        // TODO: support any type of array dimension
-        if (n.get_type().get_type_id() != strided_dim_type_id) {
-            stringstream ss;
-            ss << "TODO: binary_search on array with type " << n.get_type() << " is not implemented";
-            throw runtime_error(ss.str());
-        }
-
-        const char *n_data = n.get_readonly_originptr();
-        intptr_t n_stride = reinterpret_cast<const strided_dim_type_metadata *>(n.get_ndo_meta())->stride;
-        intptr_t first = 0, last = n.get_dim_size();
-        while (first < last) {
-            intptr_t trial = first + (last - first) / 2;
-            const char *trial_data = n_data + trial * n_stride;
-
-            // In order for the data to always match up with the metadata, need to have
-            // trial_data first and data second in the comparison operations.
-            if (k_n_less_d(data, trial_data)) {
-                // value < arr[trial]
-                last = trial;
-            } else if (k_n_less_d(trial_data, data)) {
-                // value > arr[trial]
-                first = trial + 1;
-            } else {
-                return trial;
-            }
-        }
-        return -1;
-    } else {
-        // Second, a version where the metadata are different, so
-        // we need to get a kernel for each comparison direction.
-        comparison_ckernel_builder k_n_less_d, k_d_less_n;
-        make_comparison_kernel(&k_n_less_d, 0,
-                        element_tp, n_metadata,
-                        element_tp, metadata,
-                        comparison_type_sorting_less,
-                        &eval::default_eval_context);
-        make_comparison_kernel(&k_d_less_n, 0,
-                        element_tp, metadata,
-                        element_tp, n_metadata,
-                        comparison_type_sorting_less,
-                        &eval::default_eval_context);
-
-        // TODO: support any type of array dimension
-        if (n.get_type().get_type_id() != strided_dim_type_id) {
-            stringstream ss;
-            ss << "TODO: binary_search on array with type " << n.get_type() << " is not implemented";
-            throw runtime_error(ss.str());
-        }
-
-        const char *n_data = n.get_readonly_originptr();
-        intptr_t n_stride = reinterpret_cast<const strided_dim_type_metadata *>(n.get_ndo_meta())->stride;
-        intptr_t first = 0, last = n.get_dim_size();
-        while (first < last) {
-            intptr_t trial = first + (last - first) / 2;
-            const char *trial_data = n_data + trial * n_stride;
-
-            // In order for the data to always match up with the metadata, need to have
-            // trial_data first and data second in the comparison operations.
-            if (k_d_less_n(data, trial_data)) {
-                // value < arr[trial]
-                last = trial;
-            } else if (k_n_less_d(trial_data, data)) {
-                // value > arr[trial]
-                first = trial + 1;
-            } else {
-                return trial;
-            }
-        }
-        return -1;
-    }
+    return binary_searcher(n, metadata).find(data);
 }
 
 nd::array nd::groupby(const nd::array& data_values, const nd::array& by_values, const dynd::ndt::type& groups)
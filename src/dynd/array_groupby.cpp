@@ -0,0 +1,440 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <limits>
+
+#include <dynd/array_groupby.hpp>
+#include <dynd/shortvector.hpp>
+#include <dynd/types/categorical_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_common_functions.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/eval/parallel_tasks.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /** The number of rows converted to the reduction's source type at a time */
+    const intptr_t groupby_reduce_block_size = 1024;
+
+    /**
+     * The minimum number of rows each thread of a parallel groupby
+     * reduction should process, so the cost of starting the threads
+     * and combining their partial results is small relative to the work.
+     */
+    const intptr_t groupby_reduce_min_rows_per_thread = 65536;
+
+    void get_1d_strided(const nd::array& a, const char *name, intptr_t& out_size,
+                    intptr_t& out_stride, ndt::type& out_el_tp, const char *&out_el_metadata)
+    {
+        const ndt::type& tp = a.get_type();
+        switch (tp.get_type_id()) {
+            case strided_dim_type_id: {
+                const strided_dim_type_metadata *md =
+                                reinterpret_cast<const strided_dim_type_metadata *>(a.get_ndo_meta());
+                out_size = md->size;
+                out_stride = md->stride;
+                out_el_tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+                out_el_metadata = a.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+                return;
+            }
+            case fixed_dim_type_id: {
+                const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+                out_size = fad->get_fixed_dim_size();
+                out_stride = fad->get_fixed_stride();
+                out_el_tp = fad->get_element_type();
+                out_el_metadata = a.get_ndo_meta();
+                return;
+            }
+            default: {
+                stringstream ss;
+                ss << "groupby_reduce: the '" << name << "' values must be a one-dimensional ";
+                ss << "strided or fixed array, not " << tp;
+                throw runtime_error(ss.str());
+            }
+        }
+    }
+
+    /** Reads a categorical value, which is the index of its category */
+    inline intptr_t get_group_index(const char *by, size_t by_size)
+    {
+        switch (by_size) {
+            case 1:
+                return *reinterpret_cast<const uint8_t *>(by);
+            case 2:
+                return *reinterpret_cast<const uint16_t *>(by);
+            default:
+                return *reinterpret_cast<const uint32_t *>(by);
+        }
+    }
+
+    void make_reduction_single_kernel(const ckernel_deferred *reduction,
+                    ckernel_builder& out_ckb, const char *src_metadata,
+                    const eval::eval_context *ectx)
+    {
+        const char *metadata[3] = {NULL, src_metadata, src_metadata};
+        intptr_t ckb_offset = 0;
+        if (reduction->ckernel_funcproto == expr_operation_funcproto) {
+            ckb_offset = kernels::wrap_binary_as_unary_reduction_ckernel(
+                            &out_ckb, ckb_offset, false, kernel_request_single);
+        }
+        reduction->instantiate_func(reduction->data_ptr, &out_ckb, ckb_offset,
+                        metadata, kernel_request_single, ectx);
+    }
+
+    struct groupby_reduce_task_data {
+        // The rows, split evenly across the tasks
+        intptr_t size, thread_count;
+        const char *data;
+        intptr_t data_stride;
+        ndt::type data_tp;
+        const char *data_metadata;
+        const char *by;
+        intptr_t by_stride;
+        size_t by_size;
+        intptr_t group_count;
+        // The reduction, or NULL if only counting
+        const ckernel_deferred *reduction;
+        ndt::type dst_tp, src_tp;
+        // The identity value, or NULL if there is none
+        const char *identity;
+        const eval::eval_context *ectx;
+        // The accumulators and counts of each task, where
+        // those of task 0 are the final results
+        char **accums;
+        int64_t **counts;
+    };
+
+    void groupby_reduce_task(intptr_t task_index, void *data)
+    {
+        const groupby_reduce_task_data *td = reinterpret_cast<const groupby_reduce_task_data *>(data);
+        intptr_t begin = td->size * task_index / td->thread_count;
+        intptr_t end = td->size * (task_index + 1) / td->thread_count;
+        char *accum = td->accums[task_index];
+        int64_t *counts = td->counts[task_index];
+        size_t by_size = td->by_size;
+        intptr_t by_stride = td->by_stride, group_count = td->group_count;
+
+        if (td->reduction == NULL) {
+            const char *by = td->by + begin * by_stride;
+            for (intptr_t i = begin; i < end; ++i, by += by_stride) {
+                intptr_t g = get_group_index(by, by_size);
+                if (g >= group_count) {
+                    throw runtime_error("groupby_reduce: a 'by' value is not a valid category");
+                }
+                ++counts[g];
+            }
+            return;
+        }
+
+        // Values which aren't of the reduction's source type are converted a block at a time
+        bool converting = (td->data_tp != td->src_tp);
+        const char *src_metadata = converting ? NULL : td->data_metadata;
+        intptr_t src_size = td->src_tp.get_data_size();
+        assignment_strided_ckernel_builder convert_kernel;
+        vector<char> buffer;
+        if (converting) {
+            make_assignment_kernel(&convert_kernel, 0, td->src_tp, NULL,
+                            td->data_tp, td->data_metadata, kernel_request_strided,
+                            assign_error_default, td->ectx);
+            buffer.resize(groupby_reduce_block_size * src_size);
+        }
+        ckernel_builder reduce_ckb;
+        make_reduction_single_kernel(td->reduction, reduce_ckb, src_metadata, td->ectx);
+        ckernel_prefix *reduce_ck = reduce_ckb.get();
+        unary_single_operation_t reduce = reduce_ck->get_function<unary_single_operation_t>();
+        // Without an identity, the first value of a group initializes its accumulator
+        assignment_ckernel_builder init_kernel;
+        if (td->identity == NULL) {
+            make_assignment_kernel(&init_kernel, 0, td->dst_tp, NULL, td->src_tp, src_metadata,
+                            kernel_request_single, assign_error_default, td->ectx);
+        }
+        intptr_t dst_size = td->dst_tp.get_data_size();
+
+        for (intptr_t pos = begin; pos < end; pos += groupby_reduce_block_size) {
+            intptr_t count = min(groupby_reduce_block_size, end - pos);
+            const char *by = td->by + pos * by_stride;
+            const char *src = td->data + pos * td->data_stride;
+            intptr_t src_stride = td->data_stride;
+            if (converting) {
+                convert_kernel(&buffer[0], src_size, src, src_stride, count);
+                src = &buffer[0];
+                src_stride = src_size;
+            }
+            for (intptr_t i = 0; i < count; ++i, by += by_stride, src += src_stride) {
+                intptr_t g = get_group_index(by, by_size);
+                if (g >= group_count) {
+                    throw runtime_error("groupby_reduce: a 'by' value is not a valid category");
+                }
+                char *dst = accum + g * dst_size;
+                if (counts[g]++ != 0) {
+                    reduce(dst, src, reduce_ck);
+                } else if (td->identity != NULL) {
+                    memcpy(dst, td->identity, dst_size);
+                    reduce(dst, src, reduce_ck);
+                } else {
+                    init_kernel(dst, src);
+                }
+            }
+        }
+    }
+
+    ndt::type get_groups_type(const nd::array& by, const ndt::type& groups)
+    {
+        // Determine the groups the same way as nd::groupby
+        if (groups.get_type_id() != uninitialized_type_id) {
+            return groups;
+        }
+        ndt::type by_dt = by.get_dtype();
+        if (by_dt.value_type().get_type_id() == categorical_type_id) {
+            return by_dt.value_type();
+        } else {
+            return ndt::factor_categorical(by);
+        }
+    }
+
+    /**
+     * Runs a groupby reduction, or counts the groups if `reduction` is NULL.
+     * The per-group counts are returned in `out_counts` if it isn't NULL.
+     */
+    nd::array groupby_reduce_impl(const nd::array& data_values, const nd::array& by,
+                    const ckernel_deferred *reduction, const nd::array& reduction_identity,
+                    const ndt::type& groups, const eval::eval_context *ectx,
+                    vector<int64_t> *out_counts)
+    {
+        groupby_reduce_task_data td;
+        td.identity = NULL;
+        intptr_t by_size;
+        ndt::type by_el_tp;
+        const char *el_metadata;
+        get_1d_strided(data_values, "data", td.size, td.data_stride, td.data_tp, td.data_metadata);
+        td.data = data_values.get_readonly_originptr();
+
+        // Make the categorical 'by' values, which are the indices of their categories
+        ndt::type groups_final = get_groups_type(by, groups);
+        if (groups_final.get_type_id() != categorical_type_id) {
+            stringstream ss;
+            ss << "groupby_reduce: the groups type must be categorical, not " << groups_final;
+            throw runtime_error(ss.str());
+        }
+        nd::array by_values = by.ucast(groups_final).eval();
+        get_1d_strided(by_values, "by", by_size, td.by_stride, by_el_tp, el_metadata);
+        if (by_size != td.size) {
+            stringstream ss;
+            ss << "groupby_reduce: the 'data' and 'by' values have different sizes, ";
+            ss << td.size << " and " << by_size;
+            throw runtime_error(ss.str());
+        }
+        td.by = by_values.get_readonly_originptr();
+        td.by_size = groups_final.get_data_size();
+        td.group_count = static_cast<const categorical_type *>(
+                        groups_final.extended())->get_category_count();
+
+        // Validate the reduction
+        nd::array identity;
+        td.reduction = reduction;
+        if (reduction != NULL) {
+            if (reduction->ckernel_funcproto == unary_operation_funcproto &&
+                            reduction->data_types_size == 2) {
+                td.dst_tp = reduction->data_dynd_types[0];
+                td.src_tp = reduction->data_dynd_types[1];
+            } else if (reduction->ckernel_funcproto == expr_operation_funcproto &&
+                            reduction->data_types_size == 3 &&
+                            reduction->data_dynd_types[0] == reduction->data_dynd_types[1] &&
+                            reduction->data_dynd_types[0] == reduction->data_dynd_types[2]) {
+                td.dst_tp = reduction->data_dynd_types[0];
+                td.src_tp = reduction->data_dynd_types[0];
+            } else {
+                throw runtime_error("groupby_reduce: the reduction must be a unary reduction, "
+                                "or a binary expr ckernel_deferred whose types are all the same");
+            }
+            if (!td.dst_tp.is_pod()) {
+                stringstream ss;
+                ss << "groupby_reduce: the reduction's destination type must be POD, not " << td.dst_tp;
+                throw runtime_error(ss.str());
+            }
+            if (!reduction_identity.is_empty()) {
+                identity = nd::empty(td.dst_tp);
+                identity.vals() = reduction_identity;
+                td.identity = identity.get_readonly_originptr();
+            }
+        }
+
+        // Split the rows across threads when the partial results can be combined
+        td.thread_count = 1;
+        if (reduction == NULL || td.dst_tp == td.src_tp) {
+            td.thread_count = min(eval::get_parallel_thread_count(ectx),
+                            td.size / groupby_reduce_min_rows_per_thread);
+            td.thread_count = max(td.thread_count, (intptr_t)1);
+        }
+        eval::eval_context child_ectx(*ectx);
+        child_ectx.thread_count = 1;
+        td.ectx = &child_ectx;
+
+        // Task 0 accumulates into the result, the others into temporary buffers
+        intptr_t dst_size = td.dst_tp.get_data_size();
+        nd::array result;
+        if (reduction != NULL) {
+            result = nd::empty(td.group_count, ndt::make_strided_dim(td.dst_tp));
+        }
+        vector<vector<char> > partial_accums(td.thread_count);
+        vector<vector<int64_t> > counts(td.thread_count);
+        shortvector<char *> accums(td.thread_count);
+        shortvector<int64_t *> counts_ptrs(td.thread_count);
+        for (intptr_t t = 0; t < td.thread_count; ++t) {
+            counts[t].resize(td.group_count + 1, 0);
+            counts_ptrs[t] = &counts[t][0];
+            if (reduction == NULL) {
+                accums[t] = NULL;
+            } else if (t == 0) {
+                // nd::empty gives a contiguous array
+                accums[t] = result.get_readwrite_originptr();
+            } else {
+                partial_accums[t].resize(td.group_count * dst_size + 1);
+                accums[t] = &partial_accums[t][0];
+            }
+        }
+        td.accums = accums.get();
+        td.counts = counts_ptrs.get();
+        if (td.thread_count > 1) {
+            eval::parallel_run_tasks(td.thread_count, &groupby_reduce_task, &td);
+        } else {
+            groupby_reduce_task(0, &td);
+        }
+
+        // Combine the partial results in order
+        int64_t *final_counts = counts_ptrs[0];
+        if (td.thread_count > 1) {
+            ckernel_builder combine_ckb;
+            ckernel_prefix *combine_ck = NULL;
+            unary_single_operation_t combine = NULL;
+            if (reduction != NULL) {
+                make_reduction_single_kernel(reduction, combine_ckb, NULL, &child_ectx);
+                combine_ck = combine_ckb.get();
+                combine = combine_ck->get_function<unary_single_operation_t>();
+            }
+            for (intptr_t t = 1; t < td.thread_count; ++t) {
+                for (intptr_t g = 0; g < td.group_count; ++g) {
+                    if (counts_ptrs[t][g] == 0) {
+                        continue;
+                    }
+                    if (reduction != NULL) {
+                        char *dst = accums[0] + g * dst_size;
+                        const char *src = accums[t] + g * dst_size;
+                        if (final_counts[g] == 0) {
+                            memcpy(dst, src, dst_size);
+                        } else {
+                            combine(dst, src, combine_ck);
+                        }
+                    }
+                    final_counts[g] += counts_ptrs[t][g];
+                }
+            }
+        }
+
+        if (reduction == NULL) {
+            result = nd::empty(td.group_count, ndt::make_strided_dim(ndt::make_type<int64_t>()));
+            memcpy(result.get_readwrite_originptr(), final_counts, td.group_count * sizeof(int64_t));
+        } else {
+            // Groups with no values get the identity
+            for (intptr_t g = 0; g < td.group_count; ++g) {
+                if (final_counts[g] == 0) {
+                    if (td.identity == NULL) {
+                        stringstream ss;
+                        ss << "groupby_reduce: group " << g << " has no values, and the ";
+                        ss << "reduction has no identity";
+                        throw runtime_error(ss.str());
+                    }
+                    memcpy(accums[0] + g * dst_size, td.identity, dst_size);
+                }
+            }
+        }
+        if (out_counts != NULL) {
+            out_counts->assign(final_counts, final_counts + td.group_count);
+        }
+        return result;
+    }
+
+    template<class T>
+    void divide_by_counts(char *data, const vector<int64_t>& counts)
+    {
+        T *values = reinterpret_cast<T *>(data);
+        for (size_t g = 0; g < counts.size(); ++g) {
+            if (counts[g] == 0) {
+                values[g] = T(numeric_limits<double>::quiet_NaN());
+            } else {
+                values[g] = values[g] / T(static_cast<double>(counts[g]));
+            }
+        }
+    }
+} // anonymous namespace
+
+nd::array nd::groupby_reduce(const nd::array& data_values, const nd::array& by,
+                const ckernel_deferred& reduction, const nd::array& reduction_identity,
+                const ndt::type& groups, const eval::eval_context *ectx)
+{
+    return groupby_reduce_impl(data_values, by, &reduction, reduction_identity,
+                    groups, ectx, NULL);
+}
+
+nd::array nd::groupby_reduce(const nd::array& data_values, const nd::array& by,
+                const std::string& reduction, const ndt::type& groups,
+                const eval::eval_context *ectx)
+{
+    if (reduction == "count") {
+        return groupby_reduce_impl(data_values, by, NULL, nd::array(), groups, ectx, NULL);
+    }
+
+    ndt::type data_tp = data_values.get_dtype().value_type();
+    if (!data_tp.is_builtin()) {
+        stringstream ss;
+        ss << "groupby_reduce: the \"" << reduction << "\" reduction requires builtin ";
+        ss << "values, not " << data_tp;
+        throw runtime_error(ss.str());
+    }
+    type_id_t tid = data_tp.get_type_id();
+    kernels::builtin_reduction_t op;
+    if (reduction == "sum") {
+        op = kernels::builtin_reduction_sum;
+    } else if (reduction == "min") {
+        op = kernels::builtin_reduction_min;
+    } else if (reduction == "max") {
+        op = kernels::builtin_reduction_max;
+    } else if (reduction == "mean") {
+        // Sum in double precision, then divide by the counts
+        op = kernels::builtin_reduction_sum;
+        if (tid == complex_float32_type_id || tid == complex_float64_type_id) {
+            tid = complex_float64_type_id;
+        } else {
+            tid = float64_type_id;
+        }
+    } else {
+        stringstream ss;
+        ss << "groupby_reduce: unrecognized reduction \"" << reduction << "\"";
+        throw runtime_error(ss.str());
+    }
+
+    ckernel_deferred ckd;
+    kernels::make_builtin_reduction_ckernel_deferred(&ckd, op, tid);
+    nd::array identity = kernels::make_builtin_reduction_identity(op, tid);
+    if (reduction != "mean") {
+        return groupby_reduce_impl(data_values, by, &ckd, identity, groups, ectx, NULL);
+    }
+    vector<int64_t> counts;
+    nd::array result = groupby_reduce_impl(data_values, by, &ckd, identity, groups, ectx, &counts);
+    if (tid == complex_float64_type_id) {
+        divide_by_counts<dynd_complex<double> >(result.get_readwrite_originptr(), counts);
+    } else {
+        divide_by_counts<double>(result.get_readwrite_originptr(), counts);
+    }
+    return result;
+}
@@ -0,0 +1,239 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+
+#include <dynd/array_search.hpp>
+#include <dynd/array_iter.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    // sorting_less for builtin values, comparing against a needle loaded once
+    template<class T>
+    struct builtin_search_less {
+        T m_needle;
+
+        builtin_search_less(const char *needle)
+            : m_needle(*reinterpret_cast<const T *>(needle)) {}
+        static inline bool less(T a, T b) {
+            return a < b;
+        }
+        inline bool sorted_less(const char *elem) const {
+            return less(*reinterpret_cast<const T *>(elem), m_needle);
+        }
+        inline bool needle_less(const char *elem) const {
+            return less(m_needle, *reinterpret_cast<const T *>(elem));
+        }
+    };
+
+    // NaNs sort after everything else
+    template<>
+    inline bool builtin_search_less<float>::less(float a, float b) {
+        return a < b || (b != b && a == a);
+    }
+
+    template<>
+    inline bool builtin_search_less<double>::less(double a, double b) {
+        return a < b || (b != b && a == a);
+    }
+
+    // sorting_less through comparison kernels
+    struct kernel_search_less {
+        const char *m_needle;
+        ckernel_prefix *m_sorted_less_needle, *m_needle_less_sorted;
+
+        kernel_search_less(const char *needle, ckernel_prefix *sorted_less_needle,
+                        ckernel_prefix *needle_less_sorted)
+            : m_needle(needle), m_sorted_less_needle(sorted_less_needle),
+              m_needle_less_sorted(needle_less_sorted) {}
+        inline bool sorted_less(const char *elem) const {
+            return m_sorted_less_needle->get_function<binary_single_predicate_t>()(
+                            elem, m_needle, m_sorted_less_needle) != 0;
+        }
+        inline bool needle_less(const char *elem) const {
+            return m_needle_less_sorted->get_function<binary_single_predicate_t>()(
+                            m_needle, elem, m_needle_less_sorted) != 0;
+        }
+    };
+
+    /**
+     * Finds the lower (Right == false) or upper (Right == true) bound
+     * of the needle. The loop only narrows the range by a data-dependent
+     * select, so for builtin types it compiles to conditional moves
+     * instead of branches.
+     */
+    template<bool Right, class Less>
+    inline intptr_t search_bound(const char *origin, intptr_t stride, intptr_t size,
+                    const Less& less)
+    {
+        if (size == 0) {
+            return 0;
+        }
+        intptr_t base = 0, n = size;
+        while (n > 1) {
+            intptr_t half = n / 2;
+            const char *trial = origin + (base + half) * stride;
+            bool before = Right ? !less.needle_less(trial) : less.sorted_less(trial);
+            base = before ? base + half : base;
+            n -= half;
+        }
+        const char *trial = origin + base * stride;
+        bool before = Right ? !less.needle_less(trial) : less.sorted_less(trial);
+        return base + (before ? 1 : 0);
+    }
+
+    template<bool Right>
+    intptr_t search_bound(type_id_t tid, const char *origin, intptr_t stride, intptr_t size,
+                    const char *needle, ckernel_prefix *sorted_less_needle,
+                    ckernel_prefix *needle_less_sorted)
+    {
+        switch (tid) {
+            case int8_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<int8_t>(needle));
+            case int16_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<int16_t>(needle));
+            case int32_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<int32_t>(needle));
+            case int64_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<int64_t>(needle));
+            case uint8_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<uint8_t>(needle));
+            case uint16_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<uint16_t>(needle));
+            case uint32_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<uint32_t>(needle));
+            case uint64_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<uint64_t>(needle));
+            case float32_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<float>(needle));
+            case float64_type_id:
+                return search_bound<Right>(origin, stride, size, builtin_search_less<double>(needle));
+            default:
+                return search_bound<Right>(origin, stride, size,
+                                kernel_search_less(needle, sorted_less_needle, needle_less_sorted));
+        }
+    }
+} // anonymous namespace
+
+void nd::binary_searcher::init(const char *needle_metadata)
+{
+    if (m_sorted.get_ndim() == 0) {
+        stringstream ss;
+        ss << "cannot do a dynd binary_search on array with type " << m_sorted.get_type() << " without a leading array dimension";
+        throw runtime_error(ss.str());
+    }
+    // TODO: support any type of array dimension
+    if (!m_sorted.get_type().extended()->is_strided()) {
+        stringstream ss;
+        ss << "TODO: binary_search on array with type " << m_sorted.get_type() << " is not implemented";
+        throw runtime_error(ss.str());
+    }
+    m_element_metadata = m_sorted.get_ndo_meta();
+    m_element_tp = m_sorted.get_type().at_single(0, &m_element_metadata);
+    ndt::type el_tp;
+    m_sorted.get_type().extended()->process_strided(m_sorted.get_ndo_meta(),
+                    m_sorted.get_readonly_originptr(), el_tp, m_origin, m_stride, m_size);
+
+    make_kernels(needle_metadata ? needle_metadata : m_element_metadata,
+                    m_sorted_less_needle, m_needle_less_sorted);
+}
+
+nd::binary_searcher::binary_searcher(const nd::array& sorted)
+    : m_sorted(sorted)
+{
+    init(NULL);
+}
+
+nd::binary_searcher::binary_searcher(const nd::array& sorted, const char *needle_metadata)
+    : m_sorted(sorted)
+{
+    init(needle_metadata);
+}
+
+void nd::binary_searcher::make_kernels(const char *needle_metadata,
+                comparison_ckernel_builder& sorted_less_needle,
+                comparison_ckernel_builder& needle_less_sorted) const
+{
+    make_comparison_kernel(&sorted_less_needle, 0,
+                    m_element_tp, m_element_metadata,
+                    m_element_tp, needle_metadata,
+                    comparison_type_sorting_less,
+                    &eval::default_eval_context);
+    // Built even when the metadata is identical, so the
+    // search loop can treat both directions the same way
+    make_comparison_kernel(&needle_less_sorted, 0,
+                    m_element_tp, needle_metadata,
+                    m_element_tp, m_element_metadata,
+                    comparison_type_sorting_less,
+                    &eval::default_eval_context);
+}
+
+intptr_t nd::binary_searcher::find(const char *needle)
+{
+    intptr_t i = lower_bound(needle);
+    if (i != m_size && !m_needle_less_sorted(needle, m_origin + i * m_stride)) {
+        return i;
+    } else {
+        return -1;
+    }
+}
+
+intptr_t nd::binary_searcher::lower_bound(const char *needle)
+{
+    return search_bound<false>(m_element_tp.get_type_id(), m_origin, m_stride, m_size,
+                    needle, m_sorted_less_needle.get(), m_needle_less_sorted.get());
+}
+
+intptr_t nd::binary_searcher::upper_bound(const char *needle)
+{
+    return search_bound<true>(m_element_tp.get_type_id(), m_origin, m_stride, m_size,
+                    needle, m_sorted_less_needle.get(), m_needle_less_sorted.get());
+}
+
+nd::array nd::binary_searcher::searchsorted(const nd::array& needles, search_side_t side)
+{
+    if (m_element_tp.get_ndim() != 0) {
+        stringstream ss;
+        ss << "searchsorted requires scalar elements, not " << m_element_tp;
+        throw runtime_error(ss.str());
+    }
+    nd::array n = needles;
+    if (n.get_dtype() != m_element_tp) {
+        n = n.ucast(m_element_tp);
+    }
+    n = n.eval();
+
+    intptr_t ndim = n.get_ndim();
+    vector<intptr_t> shape = n.get_shape();
+    nd::array result = nd::make_strided_array(ndt::make_type<intptr_t>(), ndim,
+                    ndim == 0 ? NULL : &shape[0], read_access_flag|write_access_flag, NULL);
+
+    array_iter<1, 1> iter(result, n);
+    if (iter.empty()) {
+        return result;
+    }
+    // All the needles share the same element metadata
+    comparison_ckernel_builder sorted_less_needle, needle_less_sorted;
+    make_kernels(iter.metadata<1>(), sorted_less_needle, needle_less_sorted);
+    type_id_t tid = m_element_tp.get_type_id();
+    if (side == search_side_left) {
+        do {
+            *reinterpret_cast<intptr_t *>(iter.data<0>()) = search_bound<false>(tid,
+                            m_origin, m_stride, m_size, iter.data<1>(),
+                            sorted_less_needle.get(), needle_less_sorted.get());
+        } while (iter.next());
+    } else {
+        do {
+            *reinterpret_cast<intptr_t *>(iter.data<0>()) = search_bound<true>(tid,
+                            m_origin, m_stride, m_size, iter.data<1>(),
+                            sorted_less_needle.get(), needle_less_sorted.get());
+        } while (iter.next());
+    }
+    return result;
+}
@@ -0,0 +1,291 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#include <dynd/array_soa.hpp>
+#include <dynd/shortvector.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /** The alignment of each column of a struct of arrays */
+    const size_t soa_column_alignment = 64;
+
+    /**
+     * The number of bytes of records converted at a time between AoS and
+     * SoA, small enough that a block of records stays in the cache while
+     * each of its fields is assigned.
+     */
+    const intptr_t soa_block_bytes = 32768;
+
+    const base_struct_type *get_struct_type(const ndt::type& tp, const char *funcname)
+    {
+        if (tp.get_kind() != struct_kind) {
+            stringstream ss;
+            ss << funcname << ": the type " << tp << " is not a struct type";
+            throw runtime_error(ss.str());
+        }
+        return static_cast<const base_struct_type *>(tp.extended());
+    }
+
+    void get_1d_strided(const ndt::type& tp, const char *metadata, const char *funcname,
+                    intptr_t& out_size, intptr_t& out_stride, ndt::type& out_el_tp,
+                    const char *&out_el_metadata)
+    {
+        switch (tp.get_type_id()) {
+            case strided_dim_type_id: {
+                const strided_dim_type_metadata *md =
+                                reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+                out_size = md->size;
+                out_stride = md->stride;
+                out_el_tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+                out_el_metadata = metadata + sizeof(strided_dim_type_metadata);
+                return;
+            }
+            case fixed_dim_type_id: {
+                const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+                out_size = fad->get_fixed_dim_size();
+                out_stride = fad->get_fixed_stride();
+                out_el_tp = fad->get_element_type();
+                out_el_metadata = metadata;
+                return;
+            }
+            default: {
+                stringstream ss;
+                ss << funcname << ": expected a one-dimensional strided or fixed array, not " << tp;
+                throw runtime_error(ss.str());
+            }
+        }
+    }
+
+    /**
+     * Assigns `count` records field by field, a block of records at a
+     * time. Field i goes from src_fields[i] with stride src_strides[i] to
+     * dst_fields[i] with stride dst_strides[i]. `record_stride` is the
+     * stride between the records on the array of structs side, which
+     * sizes the blocks.
+     */
+    void assign_fields_blockwise(size_t field_count,
+                    const assignment_strided_ckernel_builder *kernels,
+                    char **dst_fields, const intptr_t *dst_strides,
+                    const char **src_fields, const intptr_t *src_strides,
+                    intptr_t count, intptr_t record_stride)
+    {
+        intptr_t block_size = max(soa_block_bytes / max(record_stride, (intptr_t)1),
+                        (intptr_t)DYND_BUFFER_CHUNK_SIZE);
+        for (intptr_t start = 0; start < count; start += block_size) {
+            intptr_t block_count = min(block_size, count - start);
+            for (size_t i = 0; i != field_count; ++i) {
+                kernels[i](dst_fields[i] + start * dst_strides[i], dst_strides[i],
+                                src_fields[i] + start * src_strides[i], src_strides[i],
+                                block_count);
+            }
+        }
+    }
+} // anonymous namespace
+
+ndt::type ndt::make_soa(const ndt::type& struct_tp)
+{
+    const base_struct_type *sd = get_struct_type(struct_tp, "make_soa");
+    size_t field_count = sd->get_field_count();
+    vector<ndt::type> column_tps(field_count);
+    vector<string> field_names(sd->get_field_names(), sd->get_field_names() + field_count);
+    for (size_t i = 0; i != field_count; ++i) {
+        column_tps[i] = ndt::make_strided_dim(sd->get_field_types()[i]);
+    }
+    return ndt::make_struct(column_tps, field_names);
+}
+
+nd::array nd::empty_soa(intptr_t dim_size, const ndt::type& struct_tp)
+{
+    if (dim_size < 0) {
+        stringstream ss;
+        ss << "empty_soa: invalid dimension size " << dim_size;
+        throw runtime_error(ss.str());
+    }
+    ndt::type soa_tp = ndt::make_soa(struct_tp);
+    const struct_type *st = static_cast<const struct_type *>(soa_tp.extended());
+    size_t field_count = st->get_field_count();
+    const ndt::type *column_tps = st->get_field_types();
+
+    // Lay out the columns one after another
+    shortvector<size_t> column_offsets(field_count);
+    size_t data_size = 0, data_alignment = 1;
+    for (size_t i = 0; i != field_count; ++i) {
+        const ndt::type& el_tp = static_cast<const strided_dim_type *>(
+                        column_tps[i].extended())->get_element_type();
+        data_size = inc_to_alignment(data_size, soa_column_alignment);
+        column_offsets[i] = data_size;
+        data_size += el_tp.get_data_size() * dim_size;
+        data_alignment = max(data_alignment, el_tp.get_data_alignment());
+    }
+
+    char *data_ptr = NULL;
+    memory_block_ptr result = make_array_memory_block(soa_tp.get_metadata_size(),
+                    data_size, data_alignment, &data_ptr);
+    if (soa_tp.get_flags()&type_flag_zeroinit) {
+        memset(data_ptr, 0, data_size);
+    }
+
+    // Construct the struct metadata by hand, because each column gets
+    // the dimension size rather than the struct as a whole
+    array_preamble *preamble = reinterpret_cast<array_preamble *>(result.get());
+    char *metadata = reinterpret_cast<char *>(preamble + 1);
+    size_t *data_offsets = reinterpret_cast<size_t *>(metadata);
+    const size_t *metadata_offsets = st->get_metadata_offsets();
+    for (size_t i = 0; i != field_count; ++i) {
+        data_offsets[i] = column_offsets[i];
+        try {
+            column_tps[i].extended()->metadata_default_construct(
+                            metadata + metadata_offsets[i], 1, &dim_size);
+        } catch(...) {
+            // The type isn't set yet, so clean up the constructed columns here
+            for (size_t j = 0; j < i; ++j) {
+                column_tps[j].extended()->metadata_destruct(metadata + metadata_offsets[j]);
+            }
+            preamble->m_type = NULL;
+            throw;
+        }
+    }
+    preamble->m_type = ndt::type(soa_tp).release();
+    preamble->m_data_pointer = data_ptr;
+    preamble->m_data_reference = NULL;
+    preamble->m_flags = nd::read_access_flag|nd::write_access_flag;
+    return nd::array(result);
+}
+
+nd::array nd::aos_to_soa(const nd::array& a, const eval::eval_context *ectx)
+{
+    intptr_t dim_size, stride;
+    ndt::type struct_tp;
+    const char *struct_metadata;
+    get_1d_strided(a.get_type(), a.get_ndo_meta(), "aos_to_soa",
+                    dim_size, stride, struct_tp, struct_metadata);
+    const base_struct_type *sd = get_struct_type(struct_tp, "aos_to_soa");
+    size_t field_count = sd->get_field_count();
+
+    nd::array result = nd::empty_soa(dim_size, struct_tp);
+    const struct_type *result_st = static_cast<const struct_type *>(result.get_type().extended());
+
+    const ndt::type *field_tps = sd->get_field_types();
+    const size_t *data_offsets = sd->get_data_offsets(struct_metadata);
+    const size_t *metadata_offsets = sd->get_metadata_offsets();
+    const size_t *result_data_offsets = result_st->get_data_offsets(result.get_ndo_meta());
+    const size_t *result_metadata_offsets = result_st->get_metadata_offsets();
+
+    shortvector<assignment_strided_ckernel_builder> kernels(field_count);
+    shortvector<char *> dst_fields(field_count);
+    shortvector<intptr_t> dst_strides(field_count), src_strides(field_count);
+    shortvector<const char *> src_fields(field_count);
+    for (size_t i = 0; i != field_count; ++i) {
+        const char *column_metadata = result.get_ndo_meta() + result_metadata_offsets[i];
+        make_assignment_kernel(&kernels[i], 0,
+                        field_tps[i], column_metadata + sizeof(strided_dim_type_metadata),
+                        field_tps[i], struct_metadata + metadata_offsets[i],
+                        kernel_request_strided, assign_error_default, ectx);
+        dst_fields[i] = result.get_readwrite_originptr() + result_data_offsets[i];
+        dst_strides[i] = reinterpret_cast<const strided_dim_type_metadata *>(column_metadata)->stride;
+        src_fields[i] = a.get_readonly_originptr() + data_offsets[i];
+        src_strides[i] = stride;
+    }
+    assign_fields_blockwise(field_count, kernels.get(), dst_fields.get(), dst_strides.get(),
+                    src_fields.get(), src_strides.get(), dim_size, abs(stride));
+    return result;
+}
+
+nd::array nd::soa_to_aos(const nd::array& a, const ndt::type& struct_tp,
+                const eval::eval_context *ectx)
+{
+    const base_struct_type *src_sd = get_struct_type(a.get_type(), "soa_to_aos");
+    size_t field_count = src_sd->get_field_count();
+    const ndt::type *src_column_tps = src_sd->get_field_types();
+    const string *src_field_names = src_sd->get_field_names();
+    const size_t *src_data_offsets = src_sd->get_data_offsets(a.get_ndo_meta());
+    const size_t *src_metadata_offsets = src_sd->get_metadata_offsets();
+
+    // Get the columns of the struct of arrays
+    intptr_t dim_size = -1;
+    vector<ndt::type> src_el_tps(field_count);
+    shortvector<const char *> src_el_metadata(field_count), src_columns(field_count);
+    shortvector<intptr_t> src_strides(field_count);
+    for (size_t i = 0; i != field_count; ++i) {
+        intptr_t size;
+        get_1d_strided(src_column_tps[i], a.get_ndo_meta() + src_metadata_offsets[i], "soa_to_aos",
+                        size, src_strides[i], src_el_tps[i], src_el_metadata[i]);
+        if (dim_size != -1 && size != dim_size) {
+            stringstream ss;
+            ss << "soa_to_aos: the fields of " << a.get_type() << " have different sizes, ";
+            ss << dim_size << " and " << size;
+            throw runtime_error(ss.str());
+        }
+        dim_size = size;
+        src_columns[i] = a.get_readonly_originptr() + src_data_offsets[i];
+    }
+    if (dim_size == -1) {
+        dim_size = 0;
+    }
+
+    ndt::type dst_struct_tp = struct_tp;
+    if (dst_struct_tp.get_type_id() == uninitialized_type_id) {
+        dst_struct_tp = ndt::make_cstruct(field_count, field_count ? &src_el_tps[0] : NULL,
+                        src_field_names);
+    }
+    const base_struct_type *dst_sd = get_struct_type(dst_struct_tp, "soa_to_aos");
+    if (dst_sd->get_field_count() != field_count) {
+        stringstream ss;
+        ss << "soa_to_aos: cannot convert " << a.get_type() << " to records of type ";
+        ss << dst_struct_tp << " because they have different numbers of fields";
+        throw runtime_error(ss.str());
+    }
+
+    nd::array result = nd::empty(dim_size, ndt::make_strided_dim(dst_struct_tp));
+    const char *dst_struct_metadata = result.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+    intptr_t dst_stride = reinterpret_cast<const strided_dim_type_metadata *>(
+                    result.get_ndo_meta())->stride;
+    const ndt::type *dst_field_tps = dst_sd->get_field_types();
+    const string *dst_field_names = dst_sd->get_field_names();
+    const size_t *dst_data_offsets = dst_sd->get_data_offsets(dst_struct_metadata);
+    const size_t *dst_metadata_offsets = dst_sd->get_metadata_offsets();
+
+    shortvector<assignment_strided_ckernel_builder> kernels(field_count);
+    shortvector<char *> dst_fields(field_count);
+    shortvector<intptr_t> dst_strides(field_count), reordered_src_strides(field_count);
+    shortvector<const char *> reordered_src_columns(field_count);
+    for (size_t i = 0; i != field_count; ++i) {
+        const string *it = std::find(src_field_names, src_field_names + field_count, dst_field_names[i]);
+        if (it == src_field_names + field_count) {
+            stringstream ss;
+            ss << "soa_to_aos: cannot convert " << a.get_type() << " to records of type ";
+            ss << dst_struct_tp << " because they have different field names";
+            throw runtime_error(ss.str());
+        }
+        size_t i_src = it - src_field_names;
+        make_assignment_kernel(&kernels[i], 0,
+                        dst_field_tps[i], dst_struct_metadata + dst_metadata_offsets[i],
+                        src_el_tps[i_src], src_el_metadata[i_src],
+                        kernel_request_strided, assign_error_default, ectx);
+        dst_fields[i] = result.get_readwrite_originptr() + dst_data_offsets[i];
+        dst_strides[i] = dst_stride;
+        reordered_src_columns[i] = src_columns[i_src];
+        reordered_src_strides[i] = src_strides[i_src];
+    }
+    assign_fields_blockwise(field_count, kernels.get(), dst_fields.get(), dst_strides.get(),
+                    reordered_src_columns.get(), reordered_src_strides.get(),
+                    dim_size, dst_stride);
+    return result;
+}
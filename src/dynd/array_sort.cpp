@@ -0,0 +1,447 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+
+#include <dynd/array_sort.hpp>
+#include <dynd/shape_tools.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/eval/parallel_tasks.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /**
+     * The minimum number of elements each thread of a parallel
+     * comparison sort should process.
+     */
+    const intptr_t parallel_sort_min_elements_per_thread = 65536;
+
+    bool get_strided_dims(ndt::type tp, const char *metadata, intptr_t ndim,
+                    intptr_t *out_shape, intptr_t *out_strides,
+                    ndt::type& out_el_tp, const char *&out_el_metadata)
+    {
+        for (intptr_t i = 0; i < ndim; ++i) {
+            switch (tp.get_type_id()) {
+                case strided_dim_type_id: {
+                    const strided_dim_type_metadata *md =
+                                    reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+                    out_shape[i] = md->size;
+                    out_strides[i] = md->stride;
+                    tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+                    metadata += sizeof(strided_dim_type_metadata);
+                    break;
+                }
+                case fixed_dim_type_id: {
+                    const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+                    out_shape[i] = fad->get_fixed_dim_size();
+                    out_strides[i] = fad->get_fixed_stride();
+                    tp = fad->get_element_type();
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        out_el_tp = tp;
+        out_el_metadata = metadata;
+        return true;
+    }
+
+    /** How a value maps to an unsigned radix key with the same order */
+    enum radix_kind_t {
+        radix_unsigned,
+        radix_signed,
+        radix_float
+    };
+
+    struct radix_key_field {
+        radix_kind_t kind;
+        size_t size, offset;
+    };
+
+    bool get_radix_key_field(const ndt::type& tp, size_t offset, radix_key_field& out)
+    {
+        out.offset = offset;
+        out.size = tp.get_data_size();
+        switch (tp.get_type_id()) {
+            case bool_type_id:
+            case uint8_type_id:
+            case uint16_type_id:
+            case uint32_type_id:
+            case uint64_type_id:
+                out.kind = radix_unsigned;
+                return true;
+            case int8_type_id:
+            case int16_type_id:
+            case int32_type_id:
+            case int64_type_id:
+            // Dates and datetimes are stored as signed integers
+            case date_type_id:
+            case datetime_type_id:
+                out.kind = radix_signed;
+                return true;
+            case float32_type_id:
+            case float64_type_id:
+                out.kind = radix_float;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Gets the radix keys of the type, one per field of a struct with
+     * the most significant first. Returns false if it can't be radix sorted.
+     */
+    bool get_radix_key_fields(const ndt::type& tp, const char *metadata,
+                    vector<radix_key_field>& out_fields)
+    {
+        radix_key_field f;
+        if (get_radix_key_field(tp, 0, f)) {
+            out_fields.push_back(f);
+            return true;
+        }
+        if (tp.get_kind() != struct_kind) {
+            return false;
+        }
+        const base_struct_type *bsd = static_cast<const base_struct_type *>(tp.extended());
+        size_t field_count = bsd->get_field_count();
+        const ndt::type *field_types = bsd->get_field_types();
+        const size_t *offsets = bsd->get_data_offsets(metadata);
+        for (size_t i = 0; i != field_count; ++i) {
+            if (!get_radix_key_field(field_types[i], offsets[i], f)) {
+                return false;
+            }
+            out_fields.push_back(f);
+        }
+        return field_count > 0;
+    }
+
+    inline uint64_t make_radix_key(const char *ptr, const radix_key_field& f)
+    {
+        switch (f.kind) {
+            case radix_unsigned:
+                switch (f.size) {
+                    case 1:
+                        return *reinterpret_cast<const uint8_t *>(ptr);
+                    case 2:
+                        return *reinterpret_cast<const uint16_t *>(ptr);
+                    case 4:
+                        return *reinterpret_cast<const uint32_t *>(ptr);
+                    default:
+                        return *reinterpret_cast<const uint64_t *>(ptr);
+                }
+            case radix_signed:
+                // Flipping the sign bit orders the signed values as unsigned
+                switch (f.size) {
+                    case 1:
+                        return *reinterpret_cast<const uint8_t *>(ptr) ^ 0x80u;
+                    case 2:
+                        return *reinterpret_cast<const uint16_t *>(ptr) ^ 0x8000u;
+                    case 4:
+                        return *reinterpret_cast<const uint32_t *>(ptr) ^ 0x80000000u;
+                    default:
+                        return *reinterpret_cast<const uint64_t *>(ptr) ^ 0x8000000000000000ULL;
+                }
+            default:
+                // Negative floats have all their bits flipped, positive ones
+                // the sign bit. NaNs go last and -0.0 equals 0.0, as in sorting_less.
+                if (f.size == 4) {
+                    float v = *reinterpret_cast<const float *>(ptr);
+                    if (v != v) {
+                        return ~0ULL;
+                    } else if (v == 0) {
+                        return 0x80000000u;
+                    }
+                    uint32_t bits;
+                    memcpy(&bits, &v, sizeof(bits));
+                    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+                } else {
+                    double v = *reinterpret_cast<const double *>(ptr);
+                    if (v != v) {
+                        return ~0ULL;
+                    } else if (v == 0) {
+                        return 0x8000000000000000ULL;
+                    }
+                    uint64_t bits;
+                    memcpy(&bits, &v, sizeof(bits));
+                    return (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+                }
+        }
+    }
+
+    /**
+     * A stable LSD radix sort of the keys a byte at a time, carrying the
+     * indices along. Bytes which are the same in every key are skipped.
+     * The temporary buffers are passed in so repeated sorts reuse them.
+     */
+    void radix_sort_pairs(vector<uint64_t>& keys, vector<intptr_t>& perm,
+                    vector<uint64_t>& keys_tmp, vector<intptr_t>& perm_tmp,
+                    vector<size_t>& hist)
+    {
+        size_t n = keys.size();
+        if (n < 2) {
+            return;
+        }
+        keys_tmp.resize(n);
+        perm_tmp.resize(n);
+        // All the histograms are counted in one pass
+        hist.assign(8 * 256, 0);
+        for (size_t i = 0; i != n; ++i) {
+            uint64_t k = keys[i];
+            for (int d = 0; d < 8; ++d) {
+                ++hist[d * 256 + ((k >> (8 * d)) & 0xff)];
+            }
+        }
+        for (int d = 0; d < 8; ++d) {
+            size_t *h = &hist[d * 256];
+            int shift = 8 * d;
+            if (h[(keys[0] >> shift) & 0xff] == n) {
+                continue;
+            }
+            size_t offset = 0;
+            for (int b = 0; b < 256; ++b) {
+                size_t count = h[b];
+                h[b] = offset;
+                offset += count;
+            }
+            for (size_t i = 0; i != n; ++i) {
+                size_t pos = h[(keys[i] >> shift) & 0xff]++;
+                keys_tmp[pos] = keys[i];
+                perm_tmp[pos] = perm[i];
+            }
+            keys.swap(keys_tmp);
+            perm.swap(perm_tmp);
+        }
+    }
+
+    struct index_sorting_less {
+        const char *data;
+        intptr_t stride;
+        comparison_ckernel_builder *less;
+
+        inline bool operator()(intptr_t i, intptr_t j) const {
+            return (*less)(data + i * stride, data + j * stride);
+        }
+    };
+
+    struct parallel_sort_data {
+        const char *data;
+        intptr_t stride, size;
+        intptr_t chunk_count;
+        // One comparison kernel per task, because ckernels aren't threadsafe
+        comparison_ckernel_builder *kernels;
+        // The merge passes alternate between the two buffers
+        intptr_t *src, *dst;
+        intptr_t merge_width;
+
+        inline intptr_t chunk_begin(intptr_t i) const {
+            return size * min(i, chunk_count) / chunk_count;
+        }
+
+        inline index_sorting_less get_less(intptr_t task_index) {
+            index_sorting_less less = {data, stride, &kernels[task_index]};
+            return less;
+        }
+    };
+
+    void parallel_sort_chunk_task(intptr_t task_index, void *data)
+    {
+        parallel_sort_data *sd = reinterpret_cast<parallel_sort_data *>(data);
+        stable_sort(sd->src + sd->chunk_begin(task_index),
+                        sd->src + sd->chunk_begin(task_index + 1), sd->get_less(task_index));
+    }
+
+    void parallel_merge_task(intptr_t task_index, void *data)
+    {
+        parallel_sort_data *sd = reinterpret_cast<parallel_sort_data *>(data);
+        intptr_t w = sd->merge_width;
+        intptr_t begin = sd->chunk_begin(2 * w * task_index);
+        intptr_t mid = sd->chunk_begin(2 * w * task_index + w);
+        intptr_t end = sd->chunk_begin(2 * w * task_index + 2 * w);
+        merge(sd->src + begin, sd->src + mid, sd->src + mid, sd->src + end,
+                        sd->dst + begin, sd->get_less(task_index));
+    }
+
+    /**
+     * Sorts the indices of a dimension with the comparison kernels, one
+     * per thread, split into sorted runs on separate threads which are
+     * merged a level at a time.
+     */
+    void comparison_sort(vector<comparison_ckernel_builder>& kernels,
+                    const char *data, intptr_t stride, intptr_t size,
+                    vector<intptr_t>& perm)
+    {
+        intptr_t thread_count = (intptr_t)kernels.size();
+        if (thread_count == 1) {
+            index_sorting_less less = {data, stride, &kernels[0]};
+            stable_sort(perm.begin(), perm.end(), less);
+            return;
+        }
+
+        vector<intptr_t> buffer(size);
+        parallel_sort_data sd;
+        sd.data = data;
+        sd.stride = stride;
+        sd.size = size;
+        sd.chunk_count = thread_count;
+        sd.kernels = &kernels[0];
+        sd.src = &perm[0];
+        sd.dst = &buffer[0];
+        sd.merge_width = 1;
+        eval::parallel_run_tasks(thread_count, &parallel_sort_chunk_task, &sd);
+        for (; sd.merge_width < thread_count; sd.merge_width *= 2) {
+            intptr_t task_count = (thread_count + 2 * sd.merge_width - 1) / (2 * sd.merge_width);
+            eval::parallel_run_tasks(task_count, &parallel_merge_task, &sd);
+            swap(sd.src, sd.dst);
+        }
+        if (sd.src != &perm[0]) {
+            perm.swap(buffer);
+        }
+    }
+
+    /**
+     * Sorts an array along one of its dimensions, producing either
+     * the sorted values or the sorting indices.
+     */
+    nd::array sort_impl(const char *funcname, const nd::array& a_in, intptr_t axis,
+                    bool indices, const eval::eval_context *ectx)
+    {
+        nd::array a = a_in;
+        if (a.get_dtype().get_kind() == expression_kind) {
+            a = a.eval(ectx);
+        }
+        intptr_t ndim = a.get_ndim();
+        if (ndim == 0) {
+            stringstream ss;
+            ss << funcname << ": cannot sort a zero-dimensional array";
+            throw runtime_error(ss.str());
+        }
+        if (axis < -ndim || axis >= ndim) {
+            throw axis_out_of_bounds(axis, ndim);
+        }
+        if (axis < 0) {
+            axis += ndim;
+        }
+        dimvector shape(ndim), src_strides(ndim), dst_strides(ndim);
+        ndt::type el_tp, dst_el_tp;
+        const char *el_metadata, *dst_el_metadata;
+        if (!get_strided_dims(a.get_type(), a.get_ndo_meta(), ndim,
+                        shape.get(), src_strides.get(), el_tp, el_metadata)) {
+            stringstream ss;
+            ss << funcname << ": all the dimensions must be strided or fixed, not " << a.get_type();
+            throw runtime_error(ss.str());
+        }
+        nd::array result = nd::make_strided_array(indices ? ndt::make_type<int64_t>() : el_tp,
+                        ndim, shape.get(), nd::read_access_flag|nd::write_access_flag, NULL);
+        get_strided_dims(result.get_type(), result.get_ndo_meta(), ndim,
+                        shape.get(), dst_strides.get(), dst_el_tp, dst_el_metadata);
+        intptr_t size = shape[axis];
+        intptr_t lane_count = 1;
+        for (intptr_t i = 0; i < ndim; ++i) {
+            if (i != axis) {
+                lane_count *= shape[i];
+            }
+        }
+        if (size == 0 || lane_count == 0) {
+            return result;
+        }
+
+        vector<radix_key_field> key_fields;
+        bool use_radix = get_radix_key_fields(el_tp, el_metadata, key_fields);
+        eval::eval_context child_ectx(*ectx);
+        child_ectx.thread_count = 1;
+        // The comparison kernels are made once and reused for every lane
+        vector<comparison_ckernel_builder> compare_kernels;
+        if (!use_radix) {
+            intptr_t thread_count = min(eval::get_parallel_thread_count(ectx),
+                            size / parallel_sort_min_elements_per_thread);
+            thread_count = max(thread_count, (intptr_t)1);
+            compare_kernels.resize(thread_count);
+            for (intptr_t i = 0; i < thread_count; ++i) {
+                make_comparison_kernel(&compare_kernels[i], 0, el_tp, el_metadata,
+                                el_tp, el_metadata, comparison_type_sorting_less, &child_ectx);
+            }
+        }
+        assignment_ckernel_builder copy_kernel;
+        bool copy_pod = el_tp.is_pod();
+        if (!indices && !copy_pod) {
+            make_assignment_kernel(&copy_kernel, 0, dst_el_tp, dst_el_metadata,
+                            el_tp, el_metadata, kernel_request_single,
+                            assign_error_default, ectx);
+        }
+        size_t el_size = el_tp.get_data_size();
+
+        vector<intptr_t> perm(size), perm_tmp;
+        vector<uint64_t> keys, keys_tmp;
+        vector<size_t> hist;
+        for (intptr_t lane = 0; lane < lane_count; ++lane) {
+            // Find the start of the lane, with the last dimension varying fastest
+            const char *src = a.get_readonly_originptr();
+            char *dst = result.get_readwrite_originptr();
+            intptr_t remaining = lane;
+            for (intptr_t i = ndim - 1; i >= 0; --i) {
+                if (i != axis) {
+                    intptr_t index = remaining % shape[i];
+                    remaining /= shape[i];
+                    src += index * src_strides[i];
+                    dst += index * dst_strides[i];
+                }
+            }
+            intptr_t src_stride = src_strides[axis], dst_stride = dst_strides[axis];
+
+            for (intptr_t i = 0; i < size; ++i) {
+                perm[i] = i;
+            }
+            if (use_radix) {
+                // Sort by the least significant field first, relying on stability
+                keys.resize(size);
+                for (intptr_t f = (intptr_t)key_fields.size() - 1; f >= 0; --f) {
+                    const char *field_src = src + key_fields[f].offset;
+                    for (intptr_t i = 0; i < size; ++i) {
+                        keys[i] = make_radix_key(field_src + perm[i] * src_stride, key_fields[f]);
+                    }
+                    radix_sort_pairs(keys, perm, keys_tmp, perm_tmp, hist);
+                }
+            } else {
+                comparison_sort(compare_kernels, src, src_stride, size, perm);
+            }
+
+            if (indices) {
+                for (intptr_t i = 0; i < size; ++i, dst += dst_stride) {
+                    *reinterpret_cast<int64_t *>(dst) = perm[i];
+                }
+            } else if (copy_pod) {
+                for (intptr_t i = 0; i < size; ++i, dst += dst_stride) {
+                    memcpy(dst, src + perm[i] * src_stride, el_size);
+                }
+            } else {
+                for (intptr_t i = 0; i < size; ++i, dst += dst_stride) {
+                    copy_kernel(dst, src + perm[i] * src_stride);
+                }
+            }
+        }
+        return result;
+    }
+} // anonymous namespace
+
+nd::array nd::sort(const nd::array& a, intptr_t axis, const eval::eval_context *ectx)
+{
+    return sort_impl("nd::sort", a, axis, false, ectx);
+}
+
+nd::array nd::argsort(const nd::array& a, intptr_t axis, const eval::eval_context *ectx)
+{
+    return sort_impl("nd::argsort", a, axis, true, ectx);
+}
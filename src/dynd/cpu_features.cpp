@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/cpu_features.hpp>
+
+#if defined(DYND_X86_SIMD)
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    struct cpu_features {
+        bool sse2, avx2;
+
+        cpu_features()
+            : sse2(false), avx2(false)
+        {
+#if defined(DYND_X86_SIMD)
+            unsigned int regs[4];
+            get_cpuid(0, regs);
+            unsigned int max_leaf = regs[0];
+            if (max_leaf < 1) {
+                return;
+            }
+            get_cpuid(1, regs);
+            sse2 = (regs[3] & (1u << 26)) != 0;
+            bool osxsave = (regs[2] & (1u << 27)) != 0;
+            bool avx = (regs[2] & (1u << 28)) != 0;
+            // AVX state must be enabled by the OS (XCR0 bits 1 and 2)
+            if (max_leaf >= 7 && osxsave && avx && (get_xcr0() & 0x6) == 0x6) {
+                get_cpuid(7, regs);
+                avx2 = (regs[1] & (1u << 5)) != 0;
+            }
+#endif
+        }
+
+#if defined(DYND_X86_SIMD)
+        static void get_cpuid(unsigned int leaf, unsigned int *regs) {
+# if defined(_MSC_VER)
+            int iregs[4];
+            __cpuidex(iregs, (int)leaf, 0);
+            for (int i = 0; i < 4; ++i) {
+                regs[i] = (unsigned int)iregs[i];
+            }
+# else
+            __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+# endif
+        }
+
+        static unsigned long long get_xcr0() {
+# if defined(_MSC_VER)
+            return _xgetbv(0);
+# else
+            unsigned int eax, edx;
+            __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+            return ((unsigned long long)edx << 32) | eax;
+# endif
+        }
+#endif
+    };
+
+    const cpu_features& get_cpu_features() {
+        static cpu_features features;
+        return features;
+    }
+} // anonymous namespace
+
+bool dynd::cpu_has_sse2()
+{
+    return get_cpu_features().sse2;
+}
+
+bool dynd::cpu_has_avx2()
+{
+    return get_cpu_features().avx2;
+}
@@ -3,25 +3,281 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
 #include <dynd/eval/eval_elwise_vm.hpp>
-#include <dynd/vm/register_allocation.hpp>
+#include <dynd/vm/elwise_interpreter.hpp>
 #include <dynd/shape_tools.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/types/expr_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
+#include <dynd/types/pointer_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
 
 using namespace std;
 using namespace dynd;
 
-nd::array dynd::eval::evaluate_elwise_vm(const vm::elwise_program& ep, std::vector<nd::array> DYND_UNUSED(inputs),
-                    const eval::eval_context *DYND_UNUSED(ectx))
+/**
+ * Gets the shape and strides of the first `ndim` dimensions of the
+ * type, which must be strided or fixed, along with the type and metadata
+ * of the elements. Returns false if there is another kind of dimension.
+ */
+static bool get_strided_dims(ndt::type tp, const char *metadata, intptr_t ndim,
+                intptr_t *out_shape, intptr_t *out_strides,
+                ndt::type& out_el_tp, const char *&out_el_metadata)
 {
-    // Allocate contiguous registers for the VM
-    vm::register_allocation reg(ep.get_register_types(), 0x8000, 0x8000*16);
+    for (intptr_t i = 0; i < ndim; ++i) {
+        switch (tp.get_type_id()) {
+            case strided_dim_type_id: {
+                const strided_dim_type_metadata *md =
+                                reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+                out_shape[i] = md->size;
+                out_strides[i] = md->stride;
+                tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+                metadata += sizeof(strided_dim_type_metadata);
+                break;
+            }
+            case fixed_dim_type_id: {
+                const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+                out_shape[i] = fad->get_fixed_dim_size();
+                out_strides[i] = fad->get_fixed_stride();
+                tp = fad->get_element_type();
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    out_el_tp = tp;
+    out_el_metadata = metadata;
+    return true;
+}
+
+namespace {
+    /**
+     * Returns a view of the data which operand `i` of an
+     * expr_type array points at.
+     */
+    nd::array get_expr_operand(const nd::array& a, size_t i)
+    {
+        const expr_type *et = static_cast<const expr_type *>(a.get_type().extended());
+        const cstruct_type *fsd = static_cast<const cstruct_type *>(et->get_operand_type().extended());
+        const pointer_type_metadata *pmd = reinterpret_cast<const pointer_type_metadata *>(
+                        a.get_ndo_meta() + fsd->get_metadata_offsets()[i]);
+        const ndt::type& tp = static_cast<const pointer_type *>(
+                        fsd->get_field_types()[i].extended())->get_target_type();
+        char *data = *reinterpret_cast<char * const *>(
+                        a.get_readonly_originptr() + fsd->get_data_offsets()[i]) + pmd->offset;
+
+        nd::array result(make_array_memory_block(tp.get_metadata_size()));
+        if (tp.get_metadata_size() > 0) {
+            tp.extended()->metadata_copy_construct(result.get_ndo_meta(),
+                            reinterpret_cast<const char *>(pmd + 1), a.get_memblock().get());
+        }
+        result.get_ndo()->m_type = ndt::type(tp).release();
+        result.get_ndo()->m_data_pointer = data;
+        result.get_ndo()->m_data_reference = pmd->blockref ? pmd->blockref : a.get_memblock().get();
+        memory_block_incref(result.get_ndo()->m_data_reference);
+        result.get_ndo()->m_flags = a.get_ndo()->m_flags;
+        return result;
+    }
+
+    /** Whether the array can be read as an input of evaluate_elwise_vm */
+    bool is_elwise_vm_input(const nd::array& a)
+    {
+        intptr_t ndim = a.get_ndim();
+        dimvector shape(ndim), strides(ndim);
+        ndt::type el_tp;
+        const char *el_metadata;
+        return get_strided_dims(a.get_type(), a.get_ndo_meta(), ndim,
+                            shape.get(), strides.get(), el_tp, el_metadata);
+    }
+} // anonymous namespace
+
+bool dynd::eval::compile_elwise_expr(const nd::array& a, vm::elwise_program& out_ep,
+                    std::vector<nd::array>& out_inputs)
+{
+    if (a.get_type().get_type_id() != expr_type_id) {
+        return false;
+    }
+    const expr_type *et = static_cast<const expr_type *>(a.get_type().extended());
+    const vm::elwise_program *ep = et->get_kgen().get_elwise_program();
+    if (ep == NULL) {
+        return false;
+    }
+    out_ep = *ep;
+    out_inputs.resize(ep->get_input_count());
+    for (int i = 0; i < ep->get_input_count(); ++i) {
+        out_inputs[i] = get_expr_operand(a, i);
+    }
+    return true;
+}
+
+bool dynd::eval::evaluate_elwise_expr(const nd::array& out, const nd::array& src,
+                    const eval::eval_context *ectx)
+{
+    vm::elwise_program ep;
+    vector<nd::array> inputs;
+    if (!compile_elwise_expr(src, ep, inputs) || ep.get_instruction_count() < 2 ||
+                    !is_elwise_vm_input(out) || out.get_dtype() != ep.get_register_types()[0]) {
+        return false;
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!is_elwise_vm_input(inputs[i])) {
+            return false;
+        }
+    }
+    evaluate_elwise_vm(ep, out, inputs, ectx);
+    return true;
+}
+
+nd::array dynd::eval::evaluate_elwise_vm(const vm::elwise_program& ep, std::vector<nd::array> inputs,
+                    const eval::eval_context *ectx)
+{
+    if (inputs.empty()) {
+        throw runtime_error("evaluate_elwise_vm requires at least one input");
+    }
+    intptr_t ndim;
+    dimvector shape;
+    shortvector<int> axis_perm;
+    broadcast_input_shapes(inputs.size(), &inputs[0], ndim, shape, axis_perm);
+    nd::array result = nd::make_strided_array(ep.get_register_types()[0], ndim, shape.get(),
+                    nd::read_access_flag|nd::write_access_flag, axis_perm.get());
+    evaluate_elwise_vm(ep, result, inputs, ectx);
+    return result;
+}
+
+void dynd::eval::evaluate_elwise_vm(const vm::elwise_program& ep, const nd::array& out,
+                    const std::vector<nd::array>& inputs, const eval::eval_context *ectx)
+{
+    const vector<ndt::type>& regtypes = ep.get_register_types();
+    int input_count = ep.get_input_count();
+    if ((int)inputs.size() != input_count) {
+        stringstream ss;
+        ss << "evaluate_elwise_vm: the program requires " << input_count;
+        ss << " inputs, but " << inputs.size() << " were provided";
+        throw runtime_error(ss.str());
+    }
+
+    // The operands are the output followed by the inputs, with
+    // their strides broadcast to the output's shape
+    int nop = input_count + 1;
+    intptr_t ndim = out.get_ndim();
+    dimvector shape(ndim), strides(nop * ndim);
+    shortvector<char *> data(nop);
+    vector<ndt::type> in_tps(input_count);
+    shortvector<const char *> in_metadata(input_count);
+    ndt::type el_tp;
+    const char *el_metadata;
+    if (!get_strided_dims(out.get_type(), out.get_ndo_meta(), ndim,
+                    shape.get(), strides.get(), el_tp, el_metadata) || el_tp != regtypes[0]) {
+        stringstream ss;
+        ss << "evaluate_elwise_vm: cannot write a result of type " << regtypes[0];
+        ss << " to an array of type " << out.get_type();
+        throw runtime_error(ss.str());
+    }
+    data[0] = out.get_readwrite_originptr();
+    for (int i = 1; i < nop; ++i) {
+        const nd::array& in = inputs[i - 1];
+        intptr_t in_ndim = in.get_ndim();
+        dimvector in_shape(in_ndim), in_strides(in_ndim);
+        if (!get_strided_dims(in.get_type(), in.get_ndo_meta(), in_ndim,
+                        in_shape.get(), in_strides.get(), el_tp, el_metadata) ||
+                        el_tp.value_type() != regtypes[i]) {
+            stringstream ss;
+            ss << "evaluate_elwise_vm: cannot read input " << (i - 1) << " of type " << in.get_type();
+            ss << " into a register of type " << regtypes[i];
+            throw runtime_error(ss.str());
+        }
+        if (in_ndim > ndim) {
+            throw broadcast_error(ndim, shape.get(), in_ndim, in_shape.get());
+        }
+        broadcast_to_shape(ndim, shape.get(), in_ndim, in_shape.get(), in_strides.get(),
+                        strides.get() + i * ndim);
+        data[i] = const_cast<char *>(in.get_readonly_originptr());
+        in_tps[i - 1] = el_tp;
+        in_metadata[i - 1] = el_metadata;
+    }
+    for (intptr_t j = 0; j < ndim; ++j) {
+        if (shape[j] == 0) {
+            return;
+        }
+    }
 
-    // Determine the result broadcast shape
-    //int ndim;
-    //dimvector shape;
-    //broadcast_input_shapes(inputs, &ndim, &shape);
+    // Order the dimensions from the smallest strides to the largest, drop
+    // those of size one, and merge any that are contiguous with each other
+    shortvector<int> axis_perm(ndim);
+    if (ndim > 1) {
+        shortvector<const intptr_t *> operstrides(nop);
+        for (int i = 0; i < nop; ++i) {
+            operstrides[i] = strides.get() + i * ndim;
+        }
+        multistrides_to_axis_perm(ndim, nop, operstrides.get(), axis_perm.get());
+    } else if (ndim == 1) {
+        axis_perm[0] = 0;
+    }
+    intptr_t loop_ndim = 0;
+    dimvector loop_shape(ndim + 1), loop_strides(nop * (ndim + 1));
+    for (intptr_t k = 0; k < ndim; ++k) {
+        int j = axis_perm[k];
+        if (shape[j] == 1) {
+            continue;
+        }
+        bool merge = loop_ndim > 0;
+        for (int i = 0; i < nop && merge; ++i) {
+            merge = (strides[i * ndim + j] ==
+                            loop_strides[i * (ndim + 1) + loop_ndim - 1] * loop_shape[loop_ndim - 1]);
+        }
+        if (merge) {
+            loop_shape[loop_ndim - 1] *= shape[j];
+        } else {
+            loop_shape[loop_ndim] = shape[j];
+            for (int i = 0; i < nop; ++i) {
+                loop_strides[i * (ndim + 1) + loop_ndim] = strides[i * ndim + j];
+            }
+            ++loop_ndim;
+        }
+    }
+    if (loop_ndim == 0) {
+        // A single element
+        loop_shape[0] = 1;
+        for (int i = 0; i < nop; ++i) {
+            loop_strides[i * (ndim + 1)] = 0;
+        }
+        loop_ndim = 1;
+    }
 
+    vm::elwise_interpreter interp(ep, input_count > 0 ? &in_tps[0] : NULL, in_metadata.get(), ectx);
+    shortvector<intptr_t> inner_strides(nop);
+    for (int i = 0; i < nop; ++i) {
+        inner_strides[i] = loop_strides[i * (ndim + 1)];
+    }
 
-    
-    return nd::array();
+    intptr_t inner_size = loop_shape[0];
+    dimvector index(loop_ndim);
+    memset(index.get(), 0, loop_ndim * sizeof(intptr_t));
+    for (;;) {
+        interp.run(data[0], inner_strides[0], data.get() + 1, inner_strides.get() + 1, inner_size);
+        // Advance to the next inner loop
+        intptr_t k = 1;
+        for (; k < loop_ndim; ++k) {
+            for (int i = 0; i < nop; ++i) {
+                data[i] += loop_strides[i * (ndim + 1) + k];
+            }
+            if (++index[k] < loop_shape[k]) {
+                break;
+            }
+            for (int i = 0; i < nop; ++i) {
+                data[i] -= loop_shape[k] * loop_strides[i * (ndim + 1) + k];
+            }
+            index[k] = 0;
+        }
+        if (k >= loop_ndim) {
+            break;
+        }
+    }
 }
@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <vector>
+
+#include <dynd/eval/parallel_tasks.hpp>
+
+#ifdef DYND_USE_STD_THREAD
+#include <thread>
+#include <exception>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+intptr_t eval::get_parallel_thread_count(const eval_context *ectx)
+{
+#ifdef DYND_USE_STD_THREAD
+    intptr_t thread_count = ectx->thread_count;
+    if (thread_count <= 0) {
+        // hardware_concurrency returns 0 if it can't tell
+        thread_count = thread::hardware_concurrency();
+    }
+    return thread_count > 1 ? thread_count : 1;
+#else
+    (void)ectx;
+    return 1;
+#endif
+}
+
+#ifdef DYND_USE_STD_THREAD
+namespace {
+    struct parallel_task_runner {
+        eval::parallel_task_t task;
+        void *task_data;
+        vector<exception_ptr> *errors;
+
+        void operator()(intptr_t task_index) const {
+            try {
+                task(task_index, task_data);
+            } catch(...) {
+                (*errors)[task_index] = current_exception();
+            }
+        }
+    };
+} // anonymous namespace
+#endif
+
+void eval::parallel_run_tasks(intptr_t task_count, parallel_task_t task,
+                        void *task_data)
+{
+#ifdef DYND_USE_STD_THREAD
+    if (task_count > 1) {
+        vector<exception_ptr> errors(task_count);
+        parallel_task_runner runner = {task, task_data, &errors};
+        vector<thread> threads;
+        threads.reserve(task_count - 1);
+        try {
+            for (intptr_t i = 1; i < task_count; ++i) {
+                threads.push_back(thread(runner, i));
+            }
+        } catch(...) {
+            // If a thread couldn't be started, run its tasks here instead
+            for (intptr_t i = (intptr_t)threads.size() + 1; i < task_count; ++i) {
+                runner(i);
+            }
+        }
+        runner(0);
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+        for (intptr_t i = 0; i < task_count; ++i) {
+            if (errors[i]) {
+                rethrow_exception(errors[i]);
+            }
+        }
+        return;
+    }
+#endif
+    for (intptr_t i = 0; i < task_count; ++i) {
+        task(i, task_data);
+    }
+}
@@ -3,7 +3,20 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
 #include <dynd/json_formatter.hpp>
+#include <dynd/number_formatting.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/json_type.hpp>
 #include <dynd/types/date_type.hpp>
@@ -15,75 +28,131 @@
 using namespace std;
 using namespace dynd;
 
-struct output_data {
-    char *out_begin, *out_end, *out_capacity_end;
-    memory_block_pod_allocator_api *api;
-    memory_block_data *blockref;
+namespace {
+    struct output_data {
+        char *out_begin, *out_end, *out_capacity_end;
+        // Used when growing the output in a memory block
+        memory_block_pod_allocator_api *api;
+        memory_block_data *blockref;
+        // Used when streaming the output to a file descriptor,
+        // which is -1 otherwise
+        int fd;
+        // The buffer when streaming, or the growing output when
+        // there's neither a memory block nor a file descriptor
+        vector<char> *stream_buffer;
 
-    void ensure_capacity(intptr_t added_capacity) {
-        // If there's not enough space, double the capacity
-        if (out_capacity_end - out_end < added_capacity) {
+        void write_fd(const char *begin, const char *end) {
+            while (begin < end) {
+#ifdef _WIN32
+                int count = ::_write(fd, begin, (unsigned int)min<intptr_t>(end - begin, INT_MAX));
+#else
+                ssize_t count = ::write(fd, begin, end - begin);
+#endif
+                if (count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    stringstream ss;
+                    ss << "Error writing JSON output to file descriptor " << fd << ": " << strerror(errno);
+                    throw runtime_error(ss.str());
+                }
+                begin += count;
+            }
+        }
+
+        void flush() {
+            if (fd != -1) {
+                write_fd(out_begin, out_end);
+                out_end = out_begin;
+            }
+        }
+
+        void grow(intptr_t added_capacity) {
+            if (fd != -1) {
+                flush();
+                if (out_capacity_end - out_begin < added_capacity) {
+                    stream_buffer->resize(added_capacity);
+                    out_begin = out_end = &(*stream_buffer)[0];
+                    out_capacity_end = out_begin + added_capacity;
+                }
+                return;
+            }
+            // Double the capacity
             intptr_t current_size = out_end - out_begin;
             intptr_t new_capacity = 2 * (out_capacity_end - out_begin);
             // Make sure this adds the requested additional capacity
             if (new_capacity < current_size + added_capacity) {
                 new_capacity = current_size + added_capacity;
             }
-            api->resize(blockref, new_capacity, &out_begin, &out_capacity_end);
+            if (api != NULL) {
+                api->resize(blockref, new_capacity, &out_begin, &out_capacity_end);
+            } else {
+                stream_buffer->resize(new_capacity);
+                out_begin = &(*stream_buffer)[0];
+                out_capacity_end = out_begin + new_capacity;
+            }
             out_end = out_begin + current_size;
         }
-    }
 
-    inline void write(char c) {
-        ensure_capacity(1);
-        *out_end++ = c;
-    }
+        inline void ensure_capacity(intptr_t added_capacity) {
+            if (out_capacity_end - out_end < added_capacity) {
+                grow(added_capacity);
+            }
+        }
 
-    // Write a literal string
-    template<int N>
-    inline void write(const char (&str)[N]) {
-        ensure_capacity(N - 1);
-        memcpy(out_end, str, N - 1);
-        out_end += N - 1;
-    }
+        inline void write(char c) {
+            ensure_capacity(1);
+            *out_end++ = c;
+        }
 
-    // Write a std::string
-    inline void write(const std::string& s) {
-        ensure_capacity(s.size());
-        memcpy(out_end, s.data(), s.size());
-        out_end += s.size();
-    }
+        // Write a literal string
+        template<int N>
+        inline void write(const char (&str)[N]) {
+            ensure_capacity(N - 1);
+            memcpy(out_end, str, N - 1);
+            out_end += N - 1;
+        }
 
-    // Write a string-range
-    inline void write(const char *begin, const char *end) {
-        ensure_capacity(end - begin);
-        memcpy(out_end, begin, end - begin);
-        out_end += (end - begin);
-    }
-};
+        // Write a std::string
+        inline void write(const std::string& s) {
+            write(s.data(), s.data() + s.size());
+        }
+
+        // Write a string-range
+        inline void write(const char *begin, const char *end) {
+            intptr_t size = end - begin;
+            if (out_capacity_end - out_end < size) {
+                if (fd != -1 && size > (intptr_t)stream_buffer->size() / 2) {
+                    // Big ranges skip the buffer when streaming
+                    flush();
+                    write_fd(begin, end);
+                    return;
+                }
+                grow(size);
+            }
+            memcpy(out_end, begin, size);
+            out_end += size;
+        }
+    };
 
-static void format_json(output_data& out, const ndt::type& dt, const char *metadata, const char *data);
+    typedef void (*json_format_single_t)(output_data& out, const char *data, ckernel_prefix *extra);
 
-static void format_json_bool(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
-{
-    dynd_bool value = false;
-    if (dt.get_type_id() == bool_type_id) {
-        value = (*data != 0);
-    } else {
-        typed_data_assign(ndt::make_type<dynd_bool>(), NULL, reinterpret_cast<char *>(&value), dt, metadata, data);
+    inline void call_child(output_data& out, const char *data, ckernel_prefix *child)
+    {
+        child->get_function<json_format_single_t>()(out, data, child);
     }
-    if (value) {
-        out.write("true");
-    } else {
-        out.write("false");
+
+    inline void destroy_child(ckernel_prefix *child)
+    {
+        if (child->destructor) {
+            child->destructor(child);
+        }
     }
-}
+} // anonymous namespace
 
-static void format_json_number(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
+static inline bool needs_json_escape(unsigned char c)
 {
-    stringstream ss;
-    dt.print_data(ss, metadata, data);
-    out.write(ss.str());
+    return c < 0x20 || c == '\"' || c == '\\' || c == '/' || c == 0x7f;
 }
 
 static void print_escaped_unicode_codepoint(output_data& out, uint32_t cp, append_unicode_codepoint_t append_fn)
@@ -116,10 +185,15 @@ static void print_escaped_unicode_codepoint(output_data& out, uint32_t cp, appen
                 break;
             default:
                 if (cp < 0x20 || cp == 0x7f) {
-                    stringstream ss;
-                    ss << "\\u";
-                    hexadecimal_print(ss, static_cast<uint16_t>(cp));
-                    out.write(ss.str());
+                    static const char hexdigits[] = "0123456789abcdef";
+                    out.ensure_capacity(6);
+                    out.out_end[0] = '\\';
+                    out.out_end[1] = 'u';
+                    out.out_end[2] = '0';
+                    out.out_end[3] = '0';
+                    out.out_end[4] = hexdigits[cp >> 4];
+                    out.out_end[5] = hexdigits[cp & 0xf];
+                    out.out_end += 6;
                 } else {
                     out.write(static_cast<char>(cp));
                 }
@@ -130,176 +204,483 @@ static void print_escaped_unicode_codepoint(output_data& out, uint32_t cp, appen
         append_fn(cp, out.out_end, out.out_capacity_end);
     }
     // TODO: Could have an ASCII output mode where unicode is always escaped
-    /*
-    else if (cp < 0x10000) {
-        stringstream ss;
-        ss << "\\u";
-        hexadecimal_print(ss, static_cast<uint16_t>(cp));
-        out.write(ss.str());
-    } else {
-        stringstream ss;
-        ss << "\\U";
-        hexadecimal_print(ss, static_cast<uint32_t>(cp));
-        out.write(ss.str());
-    }
-    */
 }
 
 static void format_json_encoded_string(output_data& out, const char *begin, const char *end, string_encoding_t encoding)
 {
-    uint32_t cp;
-    next_unicode_codepoint_t next_fn;
-    append_unicode_codepoint_t append_fn;
-    next_fn = get_next_unicode_codepoint_function(encoding, assign_error_none);
-    append_fn = get_append_unicode_codepoint_function(string_encoding_utf_8, assign_error_none);
     out.write('\"');
-    while (begin < end) {
-        cp = next_fn(begin, end);
-        print_escaped_unicode_codepoint(out, cp, append_fn);
+    if (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii) {
+        // UTF-8 passes through unchanged, so copy the runs
+        // between the characters which need escaping
+        const char *run_begin = begin;
+        for (; begin < end; ++begin) {
+            unsigned char c = static_cast<unsigned char>(*begin);
+            if (needs_json_escape(c)) {
+                out.write(run_begin, begin);
+                print_escaped_unicode_codepoint(out, c, NULL);
+                run_begin = begin + 1;
+            }
+        }
+        out.write(run_begin, end);
+    } else {
+        uint32_t cp;
+        next_unicode_codepoint_t next_fn;
+        append_unicode_codepoint_t append_fn;
+        next_fn = get_next_unicode_codepoint_function(encoding, assign_error_none);
+        append_fn = get_append_unicode_codepoint_function(string_encoding_utf_8, assign_error_none);
+        while (begin < end) {
+            cp = next_fn(begin, end);
+            print_escaped_unicode_codepoint(out, cp, append_fn);
+        }
     }
     out.write('\"');
 }
 
-static void format_json_string(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
-{
-    if (dt.get_type_id() == json_type_id) {
-        // Copy the JSON data directly
-        const json_type_data *d = reinterpret_cast<const json_type_data *>(data);
-        out.write(d->begin, d->end);
-    } else {
-        const base_string_type *bsd = static_cast<const base_string_type *>(dt.extended());
-        string_encoding_t encoding = bsd->get_encoding();
-        const char *begin = NULL, *end = NULL;
-        bsd->get_string_range(&begin, &end, metadata, data);
-        format_json_encoded_string(out, begin, end, encoding);
-    }
-}
+/////////////////////////////////////////
+// The JSON formatting ckernels. These are built once for the
+// type and metadata being formatted, so the per-element work
+// doesn't need to switch on the type.
 
-static void format_json_datetime(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
-{
-    switch (dt.get_type_id()) {
-        case date_type_id: {
+namespace {
+    struct json_format_bool_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            if (*data != 0) {
+                out.write("true");
+            } else {
+                out.write("false");
+            }
+        }
+    };
+
+    template<class T>
+    struct json_format_integer_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            T value = *reinterpret_cast<const T *>(data);
+            out.ensure_capacity(max_formatted_number_size);
+            if (value < 0) {
+                out.out_end = format_int64(out.out_end, (int64_t)value);
+            } else {
+                out.out_end = format_uint64(out.out_end, (uint64_t)value);
+            }
+        }
+    };
+
+    struct json_format_float32_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            out.ensure_capacity(max_formatted_number_size);
+            out.out_end = format_float32(out.out_end, *reinterpret_cast<const float *>(data));
+        }
+    };
+
+    struct json_format_float64_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            out.ensure_capacity(max_formatted_number_size);
+            out.out_end = format_float64(out.out_end, *reinterpret_cast<const double *>(data));
+        }
+    };
+
+    // Formats a value through the type's print_data, for the
+    // types without a more direct formatter
+    struct json_format_print_kernel {
+        typedef json_format_print_kernel extra_type;
+
+        ckernel_prefix base;
+        const base_type *tp;
+        const char *metadata;
+        bool quoted;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
             stringstream ss;
-            dt.print_data(ss, metadata, data);
+            ndt::type(e->tp, true).print_data(ss, e->metadata, data);
             string s = ss.str();
-            format_json_encoded_string(out, s.data(), s.data() + s.size(), string_encoding_ascii);
-            break;
+            if (e->quoted) {
+                format_json_encoded_string(out, s.data(), s.data() + s.size(), string_encoding_utf_8);
+            } else {
+                out.write(s);
+            }
         }
-        default: {
-            stringstream ss;
-            ss << "Formatting dynd type " << dt << " as JSON is not implemented yet";
-            throw runtime_error(ss.str());
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->tp);
         }
-    }
+    };
+
+    struct json_format_utf8_string_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            const string_type_data *d = reinterpret_cast<const string_type_data *>(data);
+            format_json_encoded_string(out, d->begin, d->end, string_encoding_utf_8);
+        }
+    };
+
+    struct json_format_string_kernel {
+        typedef json_format_string_kernel extra_type;
+
+        ckernel_prefix base;
+        const base_string_type *tp;
+        const char *metadata;
+        string_encoding_t encoding;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const char *begin = NULL, *end = NULL;
+            e->tp->get_string_range(&begin, &end, e->metadata, data);
+            format_json_encoded_string(out, begin, end, e->encoding);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->tp);
+        }
+    };
+
+    struct json_format_json_kernel {
+        ckernel_prefix base;
+
+        static void single(output_data& out, const char *data, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            // Copy the JSON data directly
+            const json_type_data *d = reinterpret_cast<const json_type_data *>(data);
+            out.write(d->begin, d->end);
+        }
+    };
+
+    struct json_format_struct_kernel {
+        typedef json_format_struct_kernel extra_type;
+
+        ckernel_prefix base;
+        size_t field_count;
+        const size_t *data_offsets;
+        // The already escaped field names, as '"name":', with a ','
+        // before all but the first. It starts with field_count + 1
+        // offsets to where each one starts and ends.
+        char *keys;
+        // After this are field_count child kernel offsets
+
+        static void single(output_data& out, const char *data, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            size_t field_count = e->field_count;
+            const size_t *data_offsets = e->data_offsets;
+            const size_t *kernel_offsets = reinterpret_cast<const size_t *>(e + 1);
+            const size_t *key_offsets = reinterpret_cast<const size_t *>(e->keys);
+            out.write('{');
+            for (size_t i = 0; i != field_count; ++i) {
+                out.write(e->keys + key_offsets[i], e->keys + key_offsets[i + 1]);
+                call_child(out, data + data_offsets[i],
+                                reinterpret_cast<ckernel_prefix *>(eraw + kernel_offsets[i]));
+            }
+            out.write('}');
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const size_t *kernel_offsets = reinterpret_cast<const size_t *>(e + 1);
+            // The kernels are built in order, so stop at the
+            // first one which was never constructed
+            for (size_t i = 0; i != e->field_count && kernel_offsets[i] != 0; ++i) {
+                destroy_child(reinterpret_cast<ckernel_prefix *>(eraw + kernel_offsets[i]));
+            }
+            free(e->keys);
+        }
+    };
+
+    struct json_format_strided_kernel {
+        typedef json_format_strided_kernel extra_type;
+
+        ckernel_prefix base;
+        intptr_t size, stride;
+        // The element kernel follows
+
+        static void single(output_data& out, const char *data, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            json_format_single_t opchild = echild->get_function<json_format_single_t>();
+            intptr_t size = e->size, stride = e->stride;
+            out.write('[');
+            for (intptr_t i = 0; i < size; ++i, data += stride) {
+                if (i != 0) {
+                    out.write(',');
+                }
+                opchild(out, data, echild);
+            }
+            out.write(']');
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            destroy_child(&(e + 1)->base);
+        }
+    };
+
+    struct json_format_var_kernel {
+        typedef json_format_var_kernel extra_type;
+
+        ckernel_prefix base;
+        intptr_t stride, offset;
+        // The element kernel follows
+
+        static void single(output_data& out, const char *data, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            json_format_single_t opchild = echild->get_function<json_format_single_t>();
+            const var_dim_type_data *d = reinterpret_cast<const var_dim_type_data *>(data);
+            intptr_t size = d->size, stride = e->stride;
+            const char *begin = d->begin + e->offset;
+            out.write('[');
+            for (intptr_t i = 0; i < size; ++i, begin += stride) {
+                if (i != 0) {
+                    out.write(',');
+                }
+                opchild(out, begin, echild);
+            }
+            out.write(']');
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            destroy_child(&(e + 1)->base);
+        }
+    };
+} // anonymous namespace
+
+template<class K>
+static size_t make_json_format_leaf_kernel(ckernel_builder *out, size_t offset_out)
+{
+    out->ensure_capacity_leaf(offset_out + sizeof(K));
+    K *e = out->get_at<K>(offset_out);
+    e->base.template set_function<json_format_single_t>(&K::single);
+    return offset_out + sizeof(K);
+}
+
+static size_t make_json_format_print_kernel(ckernel_builder *out, size_t offset_out,
+                const ndt::type& dt, const char *metadata, bool quoted)
+{
+    out->ensure_capacity_leaf(offset_out + sizeof(json_format_print_kernel));
+    json_format_print_kernel *e = out->get_at<json_format_print_kernel>(offset_out);
+    e->base.set_function<json_format_single_t>(&json_format_print_kernel::single);
+    e->base.destructor = &json_format_print_kernel::destruct;
+    e->tp = ndt::type(dt).release();
+    e->metadata = metadata;
+    e->quoted = quoted;
+    return offset_out + sizeof(json_format_print_kernel);
 }
 
-static void format_json_struct(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
+static size_t make_json_format_kernel(ckernel_builder *out, size_t offset_out,
+                const ndt::type& dt, const char *metadata);
+
+static size_t make_json_format_struct_kernel(ckernel_builder *out, size_t offset_out,
+                const ndt::type& dt, const char *metadata)
 {
     const base_struct_type *bsd = static_cast<const base_struct_type *>(dt.extended());
     size_t field_count = bsd->get_field_count();
     const string *field_names = bsd->get_field_names();
     const ndt::type *field_types = bsd->get_field_types();
-    const size_t *data_offsets = bsd->get_data_offsets(metadata);
     const size_t *metadata_offsets = bsd->get_metadata_offsets();
 
-    out.write('{');
-    for (size_t i = 0; i < field_count; ++i) {
-        const string& fname = field_names[i];
-        format_json_encoded_string(out, fname.data(), fname.data() + fname.size(), string_encoding_utf_8);
-        out.write(':');
-        ::format_json(out, field_types[i], metadata + metadata_offsets[i], data + data_offsets[i]);
-        if (i != field_count - 1) {
-            out.write(',');
+    // Escape all the field names up front
+    vector<char> keys_buffer(256);
+    output_data keys_out;
+    keys_out.api = NULL;
+    keys_out.blockref = NULL;
+    keys_out.fd = -1;
+    keys_out.stream_buffer = &keys_buffer;
+    keys_out.out_begin = keys_out.out_end = &keys_buffer[0];
+    keys_out.out_capacity_end = keys_out.out_begin + keys_buffer.size();
+    vector<size_t> key_offsets(field_count + 1);
+    for (size_t i = 0; i != field_count; ++i) {
+        key_offsets[i] = keys_out.out_end - keys_out.out_begin;
+        if (i != 0) {
+            keys_out.write(',');
         }
+        const string& fname = field_names[i];
+        format_json_encoded_string(keys_out, fname.data(), fname.data() + fname.size(), string_encoding_utf_8);
+        keys_out.write(':');
+    }
+    size_t keys_size = keys_out.out_end - keys_out.out_begin;
+    key_offsets[field_count] = keys_size;
+    size_t offsets_size = (field_count + 1) * sizeof(size_t);
+    char *keys = reinterpret_cast<char *>(malloc(offsets_size + keys_size));
+    if (keys == NULL) {
+        throw bad_alloc();
     }
-    out.write('}');
+    // The offsets into 'keys' include the offset table itself
+    for (size_t i = 0; i <= field_count; ++i) {
+        key_offsets[i] += offsets_size;
+    }
+    memcpy(keys, &key_offsets[0], offsets_size);
+    memcpy(keys + offsets_size, keys_out.out_begin, keys_size);
+
+    size_t field_kernel_offset = offset_out + sizeof(json_format_struct_kernel) +
+                    field_count * sizeof(size_t);
+    out->ensure_capacity(field_kernel_offset);
+    json_format_struct_kernel *e = out->get_at<json_format_struct_kernel>(offset_out);
+    e->base.set_function<json_format_single_t>(&json_format_struct_kernel::single);
+    e->base.destructor = &json_format_struct_kernel::destruct;
+    e->field_count = field_count;
+    e->data_offsets = bsd->get_data_offsets(metadata);
+    e->keys = keys;
+    size_t *field_kernel_offsets = reinterpret_cast<size_t *>(e + 1);
+    memset(field_kernel_offsets, 0, field_count * sizeof(size_t));
+    for (size_t i = 0; i != field_count; ++i) {
+        // Reserve space for the child, and save the offset to this
+        // field kernel. Have to re-get the pointer because creating
+        // the field kernel may move the memory.
+        out->ensure_capacity(field_kernel_offset);
+        e = out->get_at<json_format_struct_kernel>(offset_out);
+        field_kernel_offsets = reinterpret_cast<size_t *>(e + 1);
+        field_kernel_offsets[i] = field_kernel_offset - offset_out;
+        field_kernel_offset = make_json_format_kernel(out, field_kernel_offset,
+                        field_types[i], metadata + metadata_offsets[i]);
+    }
+    return field_kernel_offset;
 }
 
-static void format_json_uniform_dim(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
+static size_t make_json_format_kernel(ckernel_builder *out, size_t offset_out,
+                const ndt::type& dt, const char *metadata)
 {
-    out.write('[');
     switch (dt.get_type_id()) {
+        case bool_type_id:
+            return make_json_format_leaf_kernel<json_format_bool_kernel>(out, offset_out);
+        case int8_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<int8_t> >(out, offset_out);
+        case int16_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<int16_t> >(out, offset_out);
+        case int32_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<int32_t> >(out, offset_out);
+        case int64_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<int64_t> >(out, offset_out);
+        case uint8_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<uint8_t> >(out, offset_out);
+        case uint16_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<uint16_t> >(out, offset_out);
+        case uint32_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<uint32_t> >(out, offset_out);
+        case uint64_type_id:
+            return make_json_format_leaf_kernel<json_format_integer_kernel<uint64_t> >(out, offset_out);
+        case float32_type_id:
+            return make_json_format_leaf_kernel<json_format_float32_kernel>(out, offset_out);
+        case float64_type_id:
+            return make_json_format_leaf_kernel<json_format_float64_kernel>(out, offset_out);
+        case json_type_id:
+            return make_json_format_leaf_kernel<json_format_json_kernel>(out, offset_out);
+        case string_type_id: {
+            const base_string_type *bsd = static_cast<const base_string_type *>(dt.extended());
+            if (bsd->get_encoding() == string_encoding_utf_8 ||
+                            bsd->get_encoding() == string_encoding_ascii) {
+                return make_json_format_leaf_kernel<json_format_utf8_string_kernel>(out, offset_out);
+            }
+            break;
+        }
         case strided_dim_type_id: {
             const strided_dim_type *sad = static_cast<const strided_dim_type *>(dt.extended());
             const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(metadata);
-            ndt::type element_tp = sad->get_element_type();
-            intptr_t size = md->size, stride = md->stride;
-            metadata += sizeof(strided_dim_type_metadata);
-            for (intptr_t i = 0; i < size; ++i) {
-                ::format_json(out, element_tp, metadata, data + i * stride);
-                if (i != size - 1) {
-                    out.write(',');
-                }
-            }
-            break;
+            out->ensure_capacity(offset_out + sizeof(json_format_strided_kernel));
+            json_format_strided_kernel *e = out->get_at<json_format_strided_kernel>(offset_out);
+            e->base.set_function<json_format_single_t>(&json_format_strided_kernel::single);
+            e->base.destructor = &json_format_strided_kernel::destruct;
+            e->size = md->size;
+            e->stride = md->stride;
+            return make_json_format_kernel(out, offset_out + sizeof(json_format_strided_kernel),
+                            sad->get_element_type(), metadata + sizeof(strided_dim_type_metadata));
         }
         case fixed_dim_type_id: {
             const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(dt.extended());
-            ndt::type element_tp = fad->get_element_type();
-            intptr_t size = (intptr_t)fad->get_fixed_dim_size(), stride = fad->get_fixed_stride();
-            for (intptr_t i = 0; i < size; ++i) {
-                ::format_json(out, element_tp, metadata, data + i * stride);
-                if (i != size - 1) {
-                    out.write(',');
-                }
-            }
-            break;
+            out->ensure_capacity(offset_out + sizeof(json_format_strided_kernel));
+            json_format_strided_kernel *e = out->get_at<json_format_strided_kernel>(offset_out);
+            e->base.set_function<json_format_single_t>(&json_format_strided_kernel::single);
+            e->base.destructor = &json_format_strided_kernel::destruct;
+            e->size = (intptr_t)fad->get_fixed_dim_size();
+            e->stride = fad->get_fixed_stride();
+            return make_json_format_kernel(out, offset_out + sizeof(json_format_strided_kernel),
+                            fad->get_element_type(), metadata);
         }
         case var_dim_type_id: {
             const var_dim_type *vad = static_cast<const var_dim_type *>(dt.extended());
             const var_dim_type_metadata *md = reinterpret_cast<const var_dim_type_metadata *>(metadata);
-            const var_dim_type_data *d = reinterpret_cast<const var_dim_type_data *>(data);
-            ndt::type element_tp = vad->get_element_type();
-            intptr_t size = d->size, stride = md->stride;
-            const char *begin = d->begin + md->offset;
-            metadata += sizeof(var_dim_type_metadata);
-            for (intptr_t i = 0; i < size; ++i) {
-                ::format_json(out, element_tp, metadata, begin + i * stride);
-                if (i != size - 1) {
-                    out.write(',');
-                }
-            }
-            break;
-        }
-        default: {
-            stringstream ss;
-            ss << "Formatting dynd type " << dt << " as JSON is not implemented yet";
-            throw runtime_error(ss.str());
+            out->ensure_capacity(offset_out + sizeof(json_format_var_kernel));
+            json_format_var_kernel *e = out->get_at<json_format_var_kernel>(offset_out);
+            e->base.set_function<json_format_single_t>(&json_format_var_kernel::single);
+            e->base.destructor = &json_format_var_kernel::destruct;
+            e->stride = md->stride;
+            e->offset = md->offset;
+            return make_json_format_kernel(out, offset_out + sizeof(json_format_var_kernel),
+                            vad->get_element_type(), metadata + sizeof(var_dim_type_metadata));
         }
+        default:
+            break;
     }
-    out.write(']');
-}
 
-static void format_json(output_data& out, const ndt::type& dt, const char *metadata, const char *data)
-{
     switch (dt.get_kind()) {
         case bool_kind:
-            format_json_bool(out, dt, metadata, data);
-            break;
         case int_kind:
         case uint_kind:
         case real_kind:
         case complex_kind:
-            format_json_number(out, dt, metadata, data);
-            break;
-        case string_kind:
-            format_json_string(out, dt, metadata, data);
-            break;
+            return make_json_format_print_kernel(out, offset_out, dt, metadata, false);
+        case string_kind: {
+            out->ensure_capacity_leaf(offset_out + sizeof(json_format_string_kernel));
+            json_format_string_kernel *e = out->get_at<json_format_string_kernel>(offset_out);
+            e->base.set_function<json_format_single_t>(&json_format_string_kernel::single);
+            e->base.destructor = &json_format_string_kernel::destruct;
+            e->tp = static_cast<const base_string_type *>(ndt::type(dt).release());
+            e->metadata = metadata;
+            e->encoding = e->tp->get_encoding();
+            return offset_out + sizeof(json_format_string_kernel);
+        }
         case datetime_kind:
-            format_json_datetime(out, dt, metadata, data);
+            if (dt.get_type_id() == date_type_id) {
+                return make_json_format_print_kernel(out, offset_out, dt, metadata, true);
+            }
             break;
         case struct_kind:
-            format_json_struct(out, dt, metadata, data);
-            break;
-        case uniform_dim_kind:
-            format_json_uniform_dim(out, dt, metadata, data);
+            return make_json_format_struct_kernel(out, offset_out, dt, metadata);
+        default:
             break;
-        default: {
-            stringstream ss;
-            ss << "Formatting dynd type " << dt << " as JSON is not implemented yet";
-            throw runtime_error(ss.str());
-        }
     }
+
+    stringstream ss;
+    ss << "Formatting dynd type " << dt << " as JSON is not implemented yet";
+    throw runtime_error(ss.str());
+}
+
+static void format_json(output_data& out, const nd::array& n)
+{
+    nd::array tmp = n;
+    if (tmp.get_type().is_expression()) {
+        tmp = n.eval();
+    }
+    ckernel_builder k;
+    make_json_format_kernel(&k, 0, tmp.get_type(), tmp.get_ndo_meta());
+    ckernel_prefix *kdp = k.get();
+    kdp->get_function<json_format_single_t>()(out, tmp.get_readonly_originptr(), kdp);
 }
 
 nd::array dynd::format_json(const nd::array& n)
@@ -313,13 +694,10 @@ nd::array dynd::format_json(const nd::array& n)
     out.api = get_memory_block_pod_allocator_api(out.blockref);
     out.api->allocate(out.blockref, 1024, 1, &out.out_begin, &out.out_capacity_end);
     out.out_end = out.out_begin;
+    out.fd = -1;
+    out.stream_buffer = NULL;
 
-    if (!n.get_type().is_expression()) {
-        ::format_json(out, n.get_type(), n.get_ndo_meta(), n.get_readonly_originptr());
-    } else {
-        nd::array tmp = n.eval();
-        ::format_json(out, tmp.get_type(), tmp.get_ndo_meta(), tmp.get_readonly_originptr());
-    }
+    ::format_json(out, n);
 
     // Shrink the memory to fit, and set the pointers in the output
     string_type_data *d = reinterpret_cast<string_type_data *>(result.get_readwrite_originptr());
@@ -333,3 +711,18 @@ nd::array dynd::format_json(const nd::array& n)
 
     return result;
 }
+
+void dynd::format_json(int fd, const nd::array& n, intptr_t buffer_size)
+{
+    vector<char> buffer(max<intptr_t>(buffer_size, 64));
+    output_data out;
+    out.api = NULL;
+    out.blockref = NULL;
+    out.fd = fd;
+    out.stream_buffer = &buffer;
+    out.out_begin = out.out_end = &buffer[0];
+    out.out_capacity_end = out.out_begin + buffer.size();
+
+    ::format_json(out, n);
+    out.flush();
+}
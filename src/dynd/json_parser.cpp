@@ -4,6 +4,9 @@
 //
 
 #include <dynd/json_parser.hpp>
+#include <dynd/cpu_features.hpp>
+#include <dynd/eval/parallel_tasks.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/types/base_bytes_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/json_type.hpp>
@@ -11,8 +14,16 @@
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/cstruct_type.hpp>
 #include <dynd/types/date_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
 #include <dynd/kernels/string_numeric_assignment_kernels.hpp>
 
+#if defined(DYND_X86_SIMD)
+#include <emmintrin.h>
+#endif
+#if defined(DYND_X86_AVX2)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 using namespace dynd;
 
@@ -405,6 +416,38 @@ static void parse_var_dim_json(const ndt::type& tp, const char *metadata, char *
     out->size = size;
 }
 
+/**
+ * Parses a JSON object key, returning its UTF-8 bytes in
+ * [out_name_begin, out_name_end). Keys without escapes, which is
+ * nearly all of them, point directly into the input. Otherwise the
+ * key is unescaped into `escaped_buffer`.
+ */
+static bool parse_json_field_name(const char *&begin, const char *end,
+                const char *&out_name_begin, const char *&out_name_end,
+                string& escaped_buffer)
+{
+    const char *pos = skip_whitespace(begin, end);
+    if (pos == end || *pos != '"') {
+        return false;
+    }
+    const char *name_begin = ++pos;
+    while (pos < end && *pos != '"' && *pos != '\\') {
+        ++pos;
+    }
+    if (pos < end && *pos == '"') {
+        out_name_begin = name_begin;
+        out_name_end = pos;
+        begin = pos + 1;
+        return true;
+    }
+    if (!parse_json_string(begin, end, escaped_buffer)) {
+        return false;
+    }
+    out_name_begin = escaped_buffer.data();
+    out_name_end = out_name_begin + escaped_buffer.size();
+    return true;
+}
+
 static void parse_struct_json(const ndt::type& tp, const char *metadata, char *out_data,
                 const char *&begin, const char *end, const eval::eval_context *ectx)
 {
@@ -416,7 +459,7 @@ static void parse_struct_json(const ndt::type& tp, const char *metadata, char *o
     const size_t *metadata_offsets = fsd->get_metadata_offsets();
 
     // Keep track of which fields we've seen
-    shortvector<bool> populated_fields(field_count);
+    shortvector<bool, 32> populated_fields(field_count);
     memset(populated_fields.get(), 0, sizeof(bool) * field_count);
 
     const char *saved_begin = begin;
@@ -425,15 +468,27 @@ static void parse_struct_json(const ndt::type& tp, const char *metadata, char *o
     }
     // If it's not an empty object, start the loop parsing the elements
     if (!parse_token(begin, end, "}")) {
+        // Only used for names containing escapes
+        string escaped_name;
+        // The field which follows the previous one, usually the next key
+        size_t next_field = 0;
         for (;;) {
-            string name;
-            if (!parse_json_string(begin, end, name)) {
+            const char *name_begin, *name_end;
+            if (!parse_json_field_name(begin, end, name_begin, name_end, escaped_name)) {
                 throw json_parse_error(begin, "expected string for name in object dict", tp);
             }
             if (!parse_token(begin, end, ":")) {
                 throw json_parse_error(begin, "expected ':' separating name from value in object dict", tp);
             }
-            intptr_t i = fsd->get_field_index(name);
+            intptr_t i;
+            size_t name_size = name_end - name_begin;
+            if (next_field < field_count && field_names[next_field].size() == name_size &&
+                            memcmp(field_names[next_field].data(), name_begin, name_size) == 0) {
+                // Fast path for objects with the fields in the declared order
+                i = next_field;
+            } else {
+                i = fsd->get_field_index(name_begin, name_end);
+            }
             if (i == -1) {
                 // TODO: Add an error policy to this parser of whether to throw an error
                 //       or not. For now, just throw away fields not in the destination.
@@ -442,6 +497,7 @@ static void parse_struct_json(const ndt::type& tp, const char *metadata, char *o
                 parse_json(field_types[i], metadata + metadata_offsets[i],
                            out_data + data_offsets[i], begin, end, ectx);
                 populated_fields[i] = true;
+                next_field = i + 1;
             }
             if (!parse_token(begin, end, ",")) {
                 break;
@@ -703,6 +759,345 @@ void print_json_parse_error_marker(std::ostream& o, const std::string& line_prev
     }
 }
 
+/////////////////////////////////////////
+// structural index for parallel parsing
+
+// Inputs at least this large are parsed in parallel by parse_json
+static const intptr_t parallel_json_min_size = 1 << 20;
+// The fewest array elements to give each thread
+static const intptr_t parallel_json_min_elements = 64;
+// The number of input bytes indexed at a time
+static const intptr_t structural_block_size = 4096;
+
+static inline bool is_json_structural(char c)
+{
+    return c == '"' || c == '\\' || c == '[' || c == ']' ||
+           c == '{' || c == '}' || c == ',';
+}
+
+/**
+ * Sets bit (i % 64) of out[i / 64] for each position i in [0, size) of the
+ * data holding a quote, backslash, bracket, brace or comma. Every
+ * character which can affect the nesting structure is one of these.
+ */
+static void structural_bitmap_scalar(const char *data, intptr_t size, uint64_t *out)
+{
+    for (intptr_t word = 0; word * 64 < size; ++word) {
+        uint64_t bits = 0;
+        intptr_t n = min<intptr_t>(64, size - word * 64);
+        const char *p = data + word * 64;
+        for (intptr_t i = 0; i < n; ++i) {
+            if (is_json_structural(p[i])) {
+                bits |= uint64_t(1) << i;
+            }
+        }
+        out[word] = bits;
+    }
+}
+
+#if defined(DYND_X86_SIMD)
+static inline uint32_t structural_mask_sse2(const char *p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i m = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+    // '[' and '{' differ only in bit 0x20, as do ']' and '}'
+    __m128i v_lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(v_lower, _mm_set1_epi8('{')),
+                                     _mm_cmpeq_epi8(v_lower, _mm_set1_epi8('}'))));
+    return (uint32_t)_mm_movemask_epi8(m);
+}
+
+static void structural_bitmap_sse2(const char *data, intptr_t size, uint64_t *out)
+{
+    intptr_t words = size / 64;
+    for (intptr_t word = 0; word < words; ++word) {
+        const char *p = data + word * 64;
+        out[word] = uint64_t(structural_mask_sse2(p)) |
+                    (uint64_t(structural_mask_sse2(p + 16)) << 16) |
+                    (uint64_t(structural_mask_sse2(p + 32)) << 32) |
+                    (uint64_t(structural_mask_sse2(p + 48)) << 48);
+    }
+    if (words * 64 < size) {
+        structural_bitmap_scalar(data + words * 64, size - words * 64, out + words);
+    }
+}
+#endif
+
+#if defined(DYND_X86_AVX2)
+DYND_AVX2_TARGET static inline uint32_t structural_mask_avx2(const char *p)
+{
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    __m256i m = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))),
+                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')));
+    __m256i v_lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(v_lower, _mm256_set1_epi8('{')),
+                                           _mm256_cmpeq_epi8(v_lower, _mm256_set1_epi8('}'))));
+    return (uint32_t)_mm256_movemask_epi8(m);
+}
+
+DYND_AVX2_TARGET static void structural_bitmap_avx2(const char *data, intptr_t size, uint64_t *out)
+{
+    intptr_t words = size / 64;
+    for (intptr_t word = 0; word < words; ++word) {
+        const char *p = data + word * 64;
+        out[word] = uint64_t(structural_mask_avx2(p)) |
+                    (uint64_t(structural_mask_avx2(p + 32)) << 32);
+    }
+    if (words * 64 < size) {
+        structural_bitmap_scalar(data + words * 64, size - words * 64, out + words);
+    }
+}
+#endif
+
+typedef void (*structural_bitmap_t)(const char *data, intptr_t size, uint64_t *out);
+
+static structural_bitmap_t get_structural_bitmap_function()
+{
+#if defined(DYND_X86_AVX2)
+    if (cpu_has_avx2()) {
+        return &structural_bitmap_avx2;
+    }
+#endif
+#if defined(DYND_X86_SIMD)
+    return &structural_bitmap_sse2;
+#else
+    return &structural_bitmap_scalar;
+#endif
+}
+
+static inline int count_trailing_zeros(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int n = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Builds the index of the elements of the top-level JSON array in
+ * [begin, end), as [begin, end) ranges of their text. The structural
+ * characters are located with SIMD, and only those positions are
+ * visited to track strings and nesting. The element values themselves
+ * are validated later, when they are parsed.
+ */
+static void index_json_array_elements(const char *begin, const char *end,
+                vector<pair<const char *, const char *> >& out_elements)
+{
+    out_elements.clear();
+    const char *pos = skip_whitespace(begin, end);
+    if (pos == end || *pos != '[') {
+        throw json_parse_error(pos, "expected array starting with '['", ndt::type());
+    }
+    ++pos;
+
+    structural_bitmap_t structural_bitmap = get_structural_bitmap_function();
+    uint64_t bitmap[structural_block_size / 64];
+    const char *element_begin = pos, *escaped = NULL;
+    intptr_t depth = 1;
+    bool in_string = false;
+    for (const char *block = pos; block < end; block += structural_block_size) {
+        intptr_t block_size = min<intptr_t>(structural_block_size, end - block);
+        structural_bitmap(block, block_size, bitmap);
+        for (intptr_t word = 0; word * 64 < block_size; ++word) {
+            uint64_t bits = bitmap[word];
+            while (bits != 0) {
+                const char *p = block + word * 64 + count_trailing_zeros(bits);
+                bits &= bits - 1;
+                if (p == escaped) {
+                    continue;
+                }
+                char c = *p;
+                if (in_string) {
+                    if (c == '\\') {
+                        escaped = p + 1;
+                    } else if (c == '"') {
+                        in_string = false;
+                    }
+                    continue;
+                }
+                switch (c) {
+                    case '"':
+                        in_string = true;
+                        break;
+                    case '[':
+                    case '{':
+                        ++depth;
+                        break;
+                    case ']':
+                    case '}':
+                        if (--depth == 0) {
+                            if (c != ']') {
+                                throw json_parse_error(p, "expected array separator ',' or terminator ']'", ndt::type());
+                            }
+                            if (skip_whitespace(element_begin, p) != p) {
+                                out_elements.push_back(make_pair(element_begin, p));
+                            } else if (!out_elements.empty()) {
+                                throw json_parse_error(p, "expected an array element after ','", ndt::type());
+                            }
+                            const char *trailing = skip_whitespace(p + 1, end);
+                            if (trailing != end) {
+                                throw json_parse_error(trailing, "unexpected trailing JSON text", ndt::type());
+                            }
+                            return;
+                        }
+                        break;
+                    case ',':
+                        if (depth == 1) {
+                            if (skip_whitespace(element_begin, p) == p) {
+                                throw json_parse_error(p, "expected an array element before ','", ndt::type());
+                            }
+                            out_elements.push_back(make_pair(element_begin, p));
+                            element_begin = p + 1;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+    throw json_parse_error(skip_whitespace(begin, end), "array has no terminating ']'", ndt::type());
+}
+
+namespace {
+    struct parallel_json_parse_data {
+        const vector<pair<const char *, const char *> > *elements;
+        intptr_t task_count;
+        ndt::type element_tp;
+        // Where to put the elements. For POD elements, these
+        // are the final output, otherwise each task parses into
+        // its own array, to be copied afterwards.
+        const char *element_metadata;
+        char *out_data;
+        intptr_t out_stride;
+        vector<nd::array> *task_outputs;
+        const eval::eval_context *ectx;
+
+        void get_range(intptr_t task_index, intptr_t& out_begin, intptr_t& out_end) const {
+            intptr_t count = (intptr_t)elements->size();
+            out_begin = count * task_index / task_count;
+            out_end = count * (task_index + 1) / task_count;
+        }
+    };
+
+    void parallel_json_parse_task(intptr_t task_index, void *task_data)
+    {
+        parallel_json_parse_data *d = reinterpret_cast<parallel_json_parse_data *>(task_data);
+        intptr_t i_begin, i_end;
+        d->get_range(task_index, i_begin, i_end);
+        const char *metadata = d->element_metadata;
+        char *out_data = d->out_data + i_begin * d->out_stride;
+        intptr_t stride = d->out_stride;
+        if (d->task_outputs != NULL) {
+            nd::array& tmp = (*d->task_outputs)[task_index];
+            tmp = nd::make_strided_array(i_end - i_begin, d->element_tp);
+            metadata = tmp.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+            out_data = tmp.get_readwrite_originptr();
+            stride = reinterpret_cast<const strided_dim_type_metadata *>(tmp.get_ndo_meta())->stride;
+        }
+        for (intptr_t i = i_begin; i < i_end; ++i, out_data += stride) {
+            const char *begin = (*d->elements)[i].first, *end = (*d->elements)[i].second;
+            ::parse_json(d->element_tp, metadata, out_data, begin, end, d->ectx);
+            begin = skip_whitespace(begin, end);
+            if (begin != end) {
+                throw json_parse_error(begin, "expected array separator ',' or terminator ']'", d->element_tp);
+            }
+        }
+    }
+} // anonymous namespace
+
+static void parse_json_parallel_impl(const ndt::type& tp, const char *metadata, char *out_data,
+                const char *json_begin, const char *json_end, const eval::eval_context *ectx)
+{
+    vector<pair<const char *, const char *> > elements;
+    index_json_array_elements(json_begin, json_end, elements);
+    intptr_t count = (intptr_t)elements.size();
+
+    parallel_json_parse_data d;
+    d.elements = &elements;
+    d.ectx = ectx;
+    switch (tp.get_type_id()) {
+        case var_dim_type_id: {
+            const var_dim_type *vad = static_cast<const var_dim_type *>(tp.extended());
+            const var_dim_type_metadata *md = reinterpret_cast<const var_dim_type_metadata *>(metadata);
+            d.element_tp = vad->get_element_type();
+            d.element_metadata = metadata + sizeof(var_dim_type_metadata);
+            d.out_stride = md->stride;
+            var_dim_type_data *out = reinterpret_cast<var_dim_type_data *>(out_data);
+            char *out_end = NULL;
+            memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(md->blockref);
+            allocator->allocate(md->blockref, count * md->stride,
+                            d.element_tp.get_data_alignment(), &out->begin, &out_end);
+            out->size = count;
+            d.out_data = out->begin;
+            break;
+        }
+        case fixed_dim_type_id: {
+            const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+            intptr_t dim_size = (intptr_t)fad->get_fixed_dim_size();
+            if (dim_size != count) {
+                const char *pos = json_end;
+                if (count > dim_size) {
+                    pos = elements[dim_size].first;
+                }
+                throw json_parse_error(pos, count < dim_size ?
+                                "array is too short" : "array is too long", tp);
+            }
+            d.element_tp = fad->get_element_type();
+            d.element_metadata = metadata;
+            d.out_stride = fad->get_fixed_stride();
+            d.out_data = out_data;
+            break;
+        }
+        default: {
+            stringstream ss;
+            ss << "parse_json_parallel: the type must have a leading var or fixed dimension, not " << tp;
+            throw runtime_error(ss.str());
+        }
+    }
+
+    d.task_count = min(eval::get_parallel_thread_count(ectx),
+                    max<intptr_t>(1, count / parallel_json_min_elements));
+    // Memory blocks aren't threadsafe, so elements which allocate
+    // memory are parsed into an array per task, then copied
+    vector<nd::array> task_outputs;
+    bool pod = d.element_tp.is_pod();
+    if (!pod) {
+        task_outputs.resize(d.task_count);
+        d.task_outputs = &task_outputs;
+    } else {
+        d.task_outputs = NULL;
+    }
+    eval::parallel_run_tasks(d.task_count, &parallel_json_parse_task, &d);
+
+    if (!pod) {
+        for (intptr_t task_index = 0; task_index < d.task_count; ++task_index) {
+            const nd::array& tmp = task_outputs[task_index];
+            intptr_t i_begin, i_end;
+            d.get_range(task_index, i_begin, i_end);
+            assignment_strided_ckernel_builder k;
+            make_assignment_kernel(&k, 0, d.element_tp, d.element_metadata,
+                            d.element_tp, tmp.get_ndo_meta() + sizeof(strided_dim_type_metadata),
+                            kernel_request_strided, assign_error_none, ectx);
+            k(d.out_data + i_begin * d.out_stride, d.out_stride,
+                            tmp.get_readonly_originptr(),
+                            reinterpret_cast<const strided_dim_type_metadata *>(tmp.get_ndo_meta())->stride,
+                            i_end - i_begin);
+        }
+    }
+}
+
 void dynd::validate_json(const char *json_begin, const char *json_end)
 {
     try {
@@ -731,6 +1126,14 @@ void dynd::parse_json(nd::array &out, const char *json_begin,
     try {
         const char *begin = json_begin, *end = json_end;
         ndt::type tp = out.get_type();
+        if (json_end - json_begin >= parallel_json_min_size &&
+                        (tp.get_type_id() == var_dim_type_id ||
+                         tp.get_type_id() == fixed_dim_type_id) &&
+                        eval::get_parallel_thread_count(ectx) > 1) {
+            parse_json_parallel_impl(tp, out.get_ndo_meta(), out.get_readwrite_originptr(),
+                            json_begin, json_end, ectx);
+            return;
+        }
         ::parse_json(tp, out.get_ndo_meta(), out.get_readwrite_originptr(), begin, end, ectx);
         begin = skip_whitespace(begin, end);
         if (begin != end) {
@@ -752,6 +1155,28 @@ void dynd::parse_json(nd::array &out, const char *json_begin,
     }
 }
 
+void dynd::parse_json_parallel(nd::array &out, const char *json_begin,
+                      const char *json_end, const eval::eval_context *ectx)
+{
+    try {
+        parse_json_parallel_impl(out.get_type(), out.get_ndo_meta(), out.get_readwrite_originptr(),
+                        json_begin, json_end, ectx);
+    } catch (const json_parse_error& e) {
+        stringstream ss;
+        string line_prev, line_cur;
+        int line, column;
+        get_error_line_column(json_begin, json_end, e.get_position(),
+                        line_prev, line_cur, line, column);
+        ss << "Error parsing JSON at line " << line << ", column " << column << "\n";
+        if (e.get_type().get_type_id() != uninitialized_type_id) {
+            ss << "DType: " << e.get_type() << "\n";
+        }
+        ss << "Message: " << e.get_message() << "\n";
+        print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
+        throw runtime_error(ss.str());
+    }
+}
+
 nd::array dynd::parse_json(const ndt::type &tp, const char *json_begin,
                            const char *json_end, const eval::eval_context *ectx)
 {
@@ -770,3 +1195,226 @@ nd::array dynd::parse_json(const ndt::type &tp, const char *json_begin,
         throw runtime_error(ss.str());
     }
 }
+
+dynd::json_stream_parser::json_stream_parser(const ndt::type& record_tp, intptr_t batch_size,
+                json_batch_callback_t callback, void *callback_data,
+                json_stream_format_t format, const eval::eval_context *ectx)
+    : m_record_tp(record_tp), m_format(format), m_callback(callback),
+      m_callback_data(callback_data), m_ectx(ectx),
+      m_batch_size(batch_size), m_batch_count(0),
+      m_record_metadata(NULL), m_record_stride(0),
+      m_depth(0), m_in_string(false), m_escape(false),
+      m_array_started(false), m_array_finished(false), m_after_comma(false),
+      m_record_count(0)
+{
+    if (record_tp.get_data_size() == 0) {
+        stringstream ss;
+        ss << "The dynd type provided to json_stream_parser, " << record_tp << ", cannot be used because it requires additional shape information";
+        throw runtime_error(ss.str());
+    }
+    if (batch_size <= 0) {
+        throw runtime_error("json_stream_parser requires a positive batch size");
+    }
+    if (callback == NULL) {
+        throw runtime_error("json_stream_parser requires a batch callback");
+    }
+    allocate_batch();
+}
+
+void dynd::json_stream_parser::allocate_batch()
+{
+    m_batch = nd::make_strided_array(m_batch_size, m_record_tp);
+    m_record_metadata = m_batch.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+    m_record_stride = reinterpret_cast<const strided_dim_type_metadata *>(m_batch.get_ndo_meta())->stride;
+}
+
+const char *dynd::json_stream_parser::find_record_end(const char *begin, const char *end)
+{
+    if (m_format == json_stream_lines) {
+        return reinterpret_cast<const char *>(memchr(begin, '\n', end - begin));
+    }
+
+    // Track strings and nesting to find the ',' or ']' ending an element
+    for (const char *pos = begin; pos != end; ++pos) {
+        char c = *pos;
+        if (m_in_string) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_in_string = false;
+            }
+        } else {
+            switch (c) {
+                case '"':
+                    m_in_string = true;
+                    break;
+                case '[':
+                case '{':
+                    ++m_depth;
+                    break;
+                case ']':
+                case '}':
+                    if (--m_depth == 0) {
+                        return pos;
+                    }
+                    break;
+                case ',':
+                    if (m_depth == 1) {
+                        return pos;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return NULL;
+}
+
+void dynd::json_stream_parser::end_record(const char *begin, const char *end, char delimiter)
+{
+    bool empty = (skip_whitespace(begin, end) == end);
+    if (m_format == json_stream_lines) {
+        // Blank lines are skipped
+        if (!empty) {
+            parse_record(begin, end);
+        }
+        return;
+    }
+
+    stringstream ss;
+    switch (delimiter) {
+        case ',':
+            if (empty) {
+                ss << "Error parsing JSON stream: expected an array element before ',' at record " << m_record_count;
+                throw runtime_error(ss.str());
+            }
+            parse_record(begin, end);
+            m_after_comma = true;
+            break;
+        case ']':
+            m_array_finished = true;
+            if (!empty) {
+                parse_record(begin, end);
+            } else if (m_after_comma) {
+                ss << "Error parsing JSON stream: expected an array element after ',' at record " << m_record_count;
+                throw runtime_error(ss.str());
+            }
+            break;
+        default:
+            ss << "Error parsing JSON stream: the top-level array was terminated with '" << delimiter << "'";
+            throw runtime_error(ss.str());
+    }
+}
+
+void dynd::json_stream_parser::parse_record(const char *begin, const char *end)
+{
+    char *out_data = m_batch.get_readwrite_originptr() + m_batch_count * m_record_stride;
+    try {
+        const char *pos = begin;
+        ::parse_json(m_record_tp, m_record_metadata, out_data, pos, end, m_ectx);
+        pos = skip_whitespace(pos, end);
+        if (pos != end) {
+            throw json_parse_error(pos, "unexpected trailing JSON text", m_record_tp);
+        }
+    } catch (const json_parse_error& e) {
+        stringstream ss;
+        string line_prev, line_cur;
+        int line, column;
+        get_error_line_column(begin, end, e.get_position(),
+                        line_prev, line_cur, line, column);
+        ss << "Error parsing JSON record " << m_record_count << " at line " << line << ", column " << column << "\n";
+        if (e.get_type().get_type_id() != uninitialized_type_id) {
+            ss << "DType: " << e.get_type() << "\n";
+        }
+        ss << "Message: " << e.get_message() << "\n";
+        print_json_parse_error_marker(ss, line_prev, line_cur, line, column);
+        throw runtime_error(ss.str());
+    }
+    ++m_record_count;
+    if (++m_batch_count == m_batch_size) {
+        emit_batch();
+    }
+}
+
+void dynd::json_stream_parser::emit_batch()
+{
+    if (m_batch_count == 0) {
+        return;
+    }
+    bool pod = m_record_tp.is_pod();
+    if (!pod) {
+        m_batch.get_type().extended()->metadata_finalize_buffers(m_batch.get_ndo_meta());
+    }
+    if (m_batch_count == m_batch_size) {
+        m_callback(m_batch, m_callback_data);
+    } else {
+        m_callback(m_batch(irange(0, m_batch_count)), m_callback_data);
+    }
+    m_batch_count = 0;
+    if (!pod) {
+        // Start from fresh memory blocks, so the variable-sized
+        // data of earlier batches can be freed
+        allocate_batch();
+    }
+}
+
+void dynd::json_stream_parser::feed(const char *begin, const char *end)
+{
+    while (begin != end) {
+        if (m_format == json_stream_array) {
+            if (!m_array_started) {
+                begin = skip_whitespace(begin, end);
+                if (begin == end) {
+                    return;
+                }
+                if (*begin != '[') {
+                    throw runtime_error("Error parsing JSON stream: expected an array starting with '['");
+                }
+                ++begin;
+                m_depth = 1;
+                m_array_started = true;
+                continue;
+            } else if (m_array_finished) {
+                if (skip_whitespace(begin, end) != end) {
+                    throw runtime_error("Error parsing JSON stream: unexpected trailing JSON text after the array");
+                }
+                return;
+            }
+        }
+
+        const char *delim = find_record_end(begin, end);
+        if (delim == NULL) {
+            // Save the incomplete record for the next chunk
+            m_pending.insert(m_pending.end(), begin, end);
+            return;
+        }
+        if (m_pending.empty()) {
+            // Parse directly from the chunk
+            end_record(begin, delim, *delim);
+        } else {
+            m_pending.insert(m_pending.end(), begin, delim);
+            end_record(&m_pending[0], &m_pending[0] + m_pending.size(), *delim);
+            m_pending.clear();
+        }
+        begin = delim + 1;
+    }
+}
+
+void dynd::json_stream_parser::finish()
+{
+    if (m_format == json_stream_lines) {
+        // The last line may not have a newline
+        if (!m_pending.empty()) {
+            end_record(&m_pending[0], &m_pending[0] + m_pending.size(), '\n');
+            m_pending.clear();
+        }
+    } else if (!m_array_started) {
+        throw runtime_error("Error parsing JSON stream: expected an array starting with '['");
+    } else if (!m_array_finished) {
+        throw runtime_error("Error parsing JSON stream: the array is missing its terminator ']'");
+    }
+    emit_batch();
+}
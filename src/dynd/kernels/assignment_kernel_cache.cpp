@@ -0,0 +1,166 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+
+#include <dynd/kernels/assignment_kernel_cache.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static inline bool metadata_matches(const char *metadata, const string& bytes)
+{
+    return bytes.empty() || memcmp(metadata, bytes.data(), bytes.size()) == 0;
+}
+
+static inline string copy_metadata(const ndt::type& tp, const char *metadata)
+{
+    if (metadata == NULL || tp.is_builtin()) {
+        return string();
+    }
+    return string(metadata, tp.get_metadata_size());
+}
+
+bool assignment_kernel_cache::entry::matches(const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx) const
+{
+    // The cheap comparisons first
+    if (this->dst_metadata != dst_metadata || this->src_metadata != src_metadata ||
+                    this->kernreq != kernreq || this->errmode != errmode ||
+                    this->ectx != ectx) {
+        return false;
+    }
+    if (this->dst_tp != dst_tp || this->src_tp != src_tp) {
+        return false;
+    }
+    if (ectx != NULL && (ectx_errmode != ectx->default_errmode ||
+                    ectx_cuda_errmode != ectx->default_cuda_device_errmode ||
+                    ectx_date_parse_order != ectx->date_parse_order ||
+                    ectx_century_window != ectx->century_window)) {
+        return false;
+    }
+    return metadata_matches(dst_metadata, dst_metadata_bytes) &&
+           metadata_matches(src_metadata, src_metadata_bytes);
+}
+
+assignment_kernel_cache::assignment_kernel_cache(size_t capacity)
+    : m_capacity(capacity), m_clock(0), m_hit_count(0), m_miss_count(0)
+{
+}
+
+assignment_kernel_cache::~assignment_kernel_cache()
+{
+    clear();
+}
+
+void assignment_kernel_cache::clear()
+{
+    // Borrowed entries are deleted when they are released
+    for (size_t i = 0, i_end = m_entries.size(); i != i_end; ++i) {
+        if (m_entries[i]->in_use) {
+            m_entries[i]->cached = false;
+        } else {
+            delete m_entries[i];
+        }
+    }
+    m_entries.clear();
+}
+
+assignment_kernel_cache::entry *assignment_kernel_cache::acquire(
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx)
+{
+    ++m_clock;
+    for (size_t i = 0, i_end = m_entries.size(); i != i_end; ++i) {
+        entry *e = m_entries[i];
+        if (!e->in_use && e->matches(dst_tp, dst_metadata, src_tp, src_metadata,
+                        kernreq, errmode, ectx)) {
+            ++m_hit_count;
+            e->in_use = true;
+            e->last_used = m_clock;
+            return e;
+        }
+    }
+
+    ++m_miss_count;
+    entry *e = new entry;
+    try {
+        make_assignment_kernel(&e->kernel, 0, dst_tp, dst_metadata,
+                        src_tp, src_metadata, kernreq, errmode, ectx);
+    } catch(...) {
+        delete e;
+        throw;
+    }
+    e->dst_tp = dst_tp;
+    e->src_tp = src_tp;
+    e->dst_metadata = dst_metadata;
+    e->src_metadata = src_metadata;
+    e->dst_metadata_bytes = copy_metadata(dst_tp, dst_metadata);
+    e->src_metadata_bytes = copy_metadata(src_tp, src_metadata);
+    e->kernreq = kernreq;
+    e->errmode = errmode;
+    e->ectx = ectx;
+    if (ectx != NULL) {
+        e->ectx_errmode = ectx->default_errmode;
+        e->ectx_cuda_errmode = ectx->default_cuda_device_errmode;
+        e->ectx_date_parse_order = ectx->date_parse_order;
+        e->ectx_century_window = ectx->century_window;
+    }
+    e->last_used = m_clock;
+    e->in_use = true;
+    e->cached = false;
+
+    if (m_capacity == 0) {
+        return e;
+    }
+    if (m_entries.size() < m_capacity) {
+        e->cached = true;
+        m_entries.push_back(e);
+        return e;
+    }
+    // Replace the least recently used entry which isn't borrowed
+    size_t lru = m_entries.size();
+    for (size_t i = 0, i_end = m_entries.size(); i != i_end; ++i) {
+        if (!m_entries[i]->in_use &&
+                        (lru == m_entries.size() || m_entries[i]->last_used < m_entries[lru]->last_used)) {
+            lru = i;
+        }
+    }
+    if (lru != m_entries.size()) {
+        delete m_entries[lru];
+        e->cached = true;
+        m_entries[lru] = e;
+    }
+    return e;
+}
+
+void assignment_kernel_cache::release(entry *e)
+{
+    if (e->cached) {
+        e->in_use = false;
+    } else {
+        delete e;
+    }
+}
+
+#ifdef DYND_USE_THREAD_LOCAL
+namespace {
+    thread_local assignment_kernel_cache thread_cache;
+} // anonymous namespace
+
+assignment_kernel_cache *dynd::get_thread_assignment_kernel_cache()
+{
+    return &thread_cache;
+}
+#else
+assignment_kernel_cache *dynd::get_thread_assignment_kernel_cache()
+{
+    return NULL;
+}
+#endif
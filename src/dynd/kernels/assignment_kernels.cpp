@@ -5,6 +5,9 @@
 
 #include <dynd/type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/shape_tools.hpp>
 #include "single_assigner_builtin.hpp"
 
 using namespace std;
@@ -309,6 +312,184 @@ static unary_single_operation_t assign_table_single_kernel[builtin_type_id_count
 };
 
 namespace {
+    // The number of elements validated at once by the contiguous
+    // checked assignment path
+    enum { checked_assign_block_size = 256 };
+
+    template<bool is_signed>
+    struct sign_test {
+        template<class T>
+        static bool is_negative(T v) {
+            return v < T(0);
+        }
+    };
+    template<>
+    struct sign_test<false> {
+        template<class T>
+        static bool is_negative(T DYND_UNUSED(v)) {
+            return false;
+        }
+    };
+
+    /**
+     * A block-level version of the checks done by single_assigner_builtin.
+     * any_invalid() returns true if any value in the block might raise an
+     * error when assigned. It may be conservative, because the caller
+     * redoes a flagged block one element at a time to report the value,
+     * but it must never miss a value which would raise. The predicates
+     * are accumulated without branches, so the loops vectorize.
+     */
+    template<class dst_type, class src_type, type_kind_t dst_kind, type_kind_t src_kind,
+                    assign_error_mode errmode>
+    struct block_assign_check_base {
+        enum { enabled = false };
+        static bool any_invalid(const src_type *DYND_UNUSED(src), size_t DYND_UNUSED(count)) {
+            return true;
+        }
+    };
+
+    // Integer -> integer, checking that each value is representable
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_int {
+        enum { enabled = true };
+        static bool any_invalid(const src_type *src, size_t count) {
+            bool invalid = false;
+            for (size_t i = 0; i != count; ++i) {
+                src_type s = src[i];
+                dst_type d = static_cast<dst_type>(s);
+                invalid |= (static_cast<src_type>(d) != s) |
+                    (sign_test<std::numeric_limits<src_type>::is_signed>::is_negative(s) !=
+                        sign_test<std::numeric_limits<dst_type>::is_signed>::is_negative(d));
+            }
+            return invalid;
+        }
+    };
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, int_kind, int_kind, errmode>
+        : public block_assign_check_int<dst_type, src_type, errmode> {};
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, int_kind, uint_kind, errmode>
+        : public block_assign_check_int<dst_type, src_type, errmode> {};
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, uint_kind, int_kind, errmode>
+        : public block_assign_check_int<dst_type, src_type, errmode> {};
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, uint_kind, uint_kind, errmode>
+        : public block_assign_check_int<dst_type, src_type, errmode> {};
+
+    // Floating point -> integer, checking the range, and with fractional or
+    // inexact checking also that each value is integral
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_real_to_int {
+        enum { enabled = true };
+        static bool any_invalid(const src_type *src, size_t count) {
+            const src_type lo = static_cast<src_type>(std::numeric_limits<dst_type>::min());
+            const src_type hi = static_cast<src_type>(std::numeric_limits<dst_type>::max());
+            bool invalid = false;
+            if (errmode == assign_error_overflow) {
+                for (size_t i = 0; i != count; ++i) {
+                    src_type s = src[i];
+                    invalid |= (s < lo) | (hi < s);
+                }
+            } else {
+                for (size_t i = 0; i != count; ++i) {
+                    src_type s = src[i];
+                    invalid |= (s < lo) | (hi < s) | (std::floor(s) != s);
+                }
+            }
+            return invalid;
+        }
+    };
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, int_kind, real_kind, errmode>
+        : public block_assign_check_real_to_int<dst_type, src_type, errmode> {};
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check_base<dst_type, src_type, uint_kind, real_kind, errmode>
+        : public block_assign_check_real_to_int<dst_type, src_type, errmode> {};
+
+    // Integer -> floating point with inexact checking, by round trip
+    template<class dst_type, class src_type>
+    struct block_assign_check_int_to_real {
+        enum { enabled = true };
+        static bool any_invalid(const src_type *src, size_t count) {
+            bool invalid = false;
+            for (size_t i = 0; i != count; ++i) {
+                src_type s = src[i];
+                invalid |= (static_cast<src_type>(static_cast<dst_type>(s)) != s);
+            }
+            return invalid;
+        }
+    };
+    template<class dst_type, class src_type>
+    struct block_assign_check_base<dst_type, src_type, real_kind, int_kind, assign_error_inexact>
+        : public block_assign_check_int_to_real<dst_type, src_type> {};
+    template<class dst_type, class src_type>
+    struct block_assign_check_base<dst_type, src_type, real_kind, uint_kind, assign_error_inexact>
+        : public block_assign_check_int_to_real<dst_type, src_type> {};
+
+    // double -> float, flagging every value outside the finite float range,
+    // and with inexact checking every value which doesn't round trip
+    template<assign_error_mode errmode>
+    struct block_assign_check_base<float, double, real_kind, real_kind, errmode> {
+        enum { enabled = true };
+        static bool any_invalid(const double *src, size_t count) {
+            const double hi = std::numeric_limits<float>::max();
+            bool invalid = false;
+            if (errmode == assign_error_inexact) {
+                for (size_t i = 0; i != count; ++i) {
+                    double s = src[i];
+                    invalid |= (s < -hi) | (hi < s) | (static_cast<double>(static_cast<float>(s)) != s);
+                }
+            } else {
+                for (size_t i = 0; i != count; ++i) {
+                    double s = src[i];
+                    invalid |= (s < -hi) | (hi < s);
+                }
+            }
+            return invalid;
+        }
+    };
+
+    // Only the native integer and floating point types have block checks
+    template<class T> struct is_block_checked_type { enum { value = false }; };
+    template<> struct is_block_checked_type<int8_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<int16_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<int32_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<int64_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<uint8_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<uint16_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<uint32_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<uint64_t> { enum { value = true }; };
+    template<> struct is_block_checked_type<float> { enum { value = true }; };
+    template<> struct is_block_checked_type<double> { enum { value = true }; };
+
+    template<class dst_type, class src_type, assign_error_mode errmode,
+                    bool native = is_block_checked_type<dst_type>::value &&
+                                  is_block_checked_type<src_type>::value>
+    struct block_assign_check
+        : public block_assign_check_base<dst_type, src_type,
+                    dynd_kind_of<dst_type>::value, dynd_kind_of<src_type>::value, errmode> {};
+    template<class dst_type, class src_type, assign_error_mode errmode>
+    struct block_assign_check<dst_type, src_type, errmode, false>
+        : public block_assign_check_base<dst_type, src_type, void_kind, void_kind, errmode> {};
+
+    // Converts a validated block without checking, only instantiated
+    // for the types which have block checks
+    template<class dst_type, class src_type, bool enabled>
+    struct block_assign_convert {
+        static void convert(dst_type *dst, const src_type *src, size_t count) {
+            for (size_t i = 0; i != count; ++i) {
+                dst[i] = static_cast<dst_type>(src[i]);
+            }
+        }
+    };
+    template<class dst_type, class src_type>
+    struct block_assign_convert<dst_type, src_type, false> {
+        static void convert(dst_type *DYND_UNUSED(dst), const src_type *DYND_UNUSED(src),
+                        size_t DYND_UNUSED(count)) {
+        }
+    };
+
     template<typename dst_type, typename src_type, assign_error_mode errmode>
     struct multiple_assignment_builtin {
         static void strided_assign(
@@ -316,6 +497,33 @@ namespace {
                         const char *src, intptr_t src_stride,
                         size_t count, ckernel_prefix *DYND_UNUSED(extra))
         {
+            typedef block_assign_check<dst_type, src_type, errmode> check;
+            if (check::enabled && dst_stride == (intptr_t)sizeof(dst_type) &&
+                            src_stride == (intptr_t)sizeof(src_type)) {
+                // Contiguous data is validated a block at a time, then converted
+                // without any per-element checks. Only a block which fails the
+                // check goes element by element, to raise the error for the
+                // offending value.
+                dst_type *dst_ptr = reinterpret_cast<dst_type *>(dst);
+                const src_type *src_ptr = reinterpret_cast<const src_type *>(src);
+                while (count > 0) {
+                    size_t block_count = count < (size_t)checked_assign_block_size
+                                    ? count : (size_t)checked_assign_block_size;
+                    if (!check::any_invalid(src_ptr, block_count)) {
+                        block_assign_convert<dst_type, src_type, check::enabled>::convert(
+                                        dst_ptr, src_ptr, block_count);
+                    } else {
+                        for (size_t i = 0; i != block_count; ++i) {
+                            single_assigner_builtin<dst_type, src_type, errmode>::assign(
+                                            dst_ptr + i, src_ptr + i, NULL);
+                        }
+                    }
+                    dst_ptr += block_count;
+                    src_ptr += block_count;
+                    count -= block_count;
+                }
+                return;
+            }
             for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
                 single_assigner_builtin<dst_type, src_type, errmode>::assign(
                                 reinterpret_cast<dst_type *>(dst),
@@ -507,3 +715,151 @@ void dynd::strided_assign_kernel_extra::destruct(
         echild->destructor(echild);
     }
 }
+
+/**
+ * If `tp` is a strided or fixed dimension, gets its size and stride,
+ * and moves `tp` and `metadata` to its element.
+ */
+static bool get_leading_strided_dim(ndt::type& tp, const char *&metadata,
+                intptr_t& out_size, intptr_t& out_stride)
+{
+    switch (tp.get_type_id()) {
+        case strided_dim_type_id: {
+            const strided_dim_type_metadata *md =
+                            reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+            out_size = md->size;
+            out_stride = md->stride;
+            tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+            metadata += sizeof(strided_dim_type_metadata);
+            return true;
+        }
+        case fixed_dim_type_id: {
+            const fixed_dim_type *fad = static_cast<const fixed_dim_type *>(tp.extended());
+            out_size = fad->get_fixed_dim_size();
+            out_stride = fad->get_fixed_stride();
+            tp = fad->get_element_type();
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+size_t dynd::make_strided_dims_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx)
+{
+    // Gather the leading strided and fixed dimensions of both operands
+    intptr_t max_ndim = dst_tp.get_ndim();
+    dimvector shape(max_ndim), dst_strides(max_ndim), src_strides(max_ndim);
+    ndt::type dst_el_tp = dst_tp, src_el_tp = src_tp;
+    const char *dst_el_metadata = dst_metadata, *src_el_metadata = src_metadata;
+    intptr_t ndim = 0;
+    bool empty = false;
+    for (;;) {
+        ndt::type next_dst_tp = dst_el_tp, next_src_tp = src_el_tp;
+        const char *next_dst_metadata = dst_el_metadata, *next_src_metadata = src_el_metadata;
+        intptr_t dst_size, dst_stride, src_size, src_stride;
+        if (!get_leading_strided_dim(next_dst_tp, next_dst_metadata, dst_size, dst_stride)) {
+            break;
+        }
+        if (src_el_tp.get_ndim() < dst_el_tp.get_ndim()) {
+            // If the src has fewer dimensions, broadcast it across this one
+            src_stride = 0;
+        } else if (get_leading_strided_dim(next_src_tp, next_src_metadata, src_size, src_stride)) {
+            // Check for a broadcasting error
+            if (src_size != 1 && dst_size != src_size) {
+                throw broadcast_error(dst_tp, dst_metadata, src_tp, src_metadata);
+            }
+            if (src_size == 1) {
+                src_stride = 0;
+            }
+        } else {
+            // Let the element kernel handle any other kind of src dimension
+            break;
+        }
+        shape[ndim] = dst_size;
+        dst_strides[ndim] = dst_stride;
+        src_strides[ndim] = src_stride;
+        empty = empty || (dst_size == 0);
+        ++ndim;
+        dst_el_tp = next_dst_tp;
+        dst_el_metadata = next_dst_metadata;
+        src_el_tp = next_src_tp;
+        src_el_metadata = next_src_metadata;
+    }
+    if (ndim == 0) {
+        stringstream ss;
+        ss << "make_strided_dims_assignment_kernel: cannot assign from " << src_tp << " to " << dst_tp;
+        throw runtime_error(ss.str());
+    }
+
+    // Order the loops from the largest stride to the smallest, keeping
+    // the declared order where the operands disagree
+    shortvector<int> axis_perm(ndim);
+    const intptr_t *operstrides[2] = {dst_strides.get(), src_strides.get()};
+    multistrides_to_axis_perm(ndim, 2, operstrides, axis_perm.get());
+    dimvector loop_shape(ndim), loop_dst_strides(ndim), loop_src_strides(ndim);
+    intptr_t loop_ndim = 0;
+    if (empty) {
+        // Nothing gets assigned, a single empty loop is enough
+        loop_shape[0] = 0;
+        loop_dst_strides[0] = 0;
+        loop_src_strides[0] = 0;
+        loop_ndim = 1;
+    } else {
+        for (intptr_t i = ndim - 1; i >= 0; --i) {
+            int axis = axis_perm[i];
+            intptr_t size = shape[axis];
+            if (size == 1) {
+                // A dimension of size one doesn't need a loop
+                continue;
+            }
+            if (loop_ndim > 0 &&
+                        loop_dst_strides[loop_ndim - 1] == dst_strides[axis] * size &&
+                        loop_src_strides[loop_ndim - 1] == src_strides[axis] * size) {
+                // Merge with the enclosing loop, which steps over this
+                // whole dimension in both operands
+                loop_shape[loop_ndim - 1] *= size;
+                loop_dst_strides[loop_ndim - 1] = dst_strides[axis];
+                loop_src_strides[loop_ndim - 1] = src_strides[axis];
+            } else {
+                loop_shape[loop_ndim] = size;
+                loop_dst_strides[loop_ndim] = dst_strides[axis];
+                loop_src_strides[loop_ndim] = src_strides[axis];
+                ++loop_ndim;
+            }
+        }
+    }
+
+    for (intptr_t i = 0; i < loop_ndim; ++i) {
+        out->ensure_capacity(offset_out + sizeof(strided_assign_kernel_extra));
+        strided_assign_kernel_extra *e = out->get_at<strided_assign_kernel_extra>(offset_out);
+        switch (kernreq) {
+            case kernel_request_single:
+                e->base.set_function<unary_single_operation_t>(&strided_assign_kernel_extra::single);
+                break;
+            case kernel_request_strided:
+                e->base.set_function<unary_strided_operation_t>(&strided_assign_kernel_extra::strided);
+                break;
+            default: {
+                stringstream ss;
+                ss << "make_strided_dims_assignment_kernel: unrecognized request " << (int)kernreq;
+                throw runtime_error(ss.str());
+            }
+        }
+        e->base.destructor = strided_assign_kernel_extra::destruct;
+        e->size = loop_shape[i];
+        e->dst_stride = loop_dst_strides[i];
+        e->src_stride = loop_src_strides[i];
+        offset_out += sizeof(strided_assign_kernel_extra);
+        kernreq = kernel_request_strided;
+    }
+    return ::make_assignment_kernel(out, offset_out,
+                    dst_el_tp, dst_el_metadata,
+                    src_el_tp, src_el_metadata,
+                    kernreq, errmode, ectx);
+}
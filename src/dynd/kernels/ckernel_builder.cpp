@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <cstring>
+
+#include <dynd/kernels/ckernel_builder.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// The pool is per-thread, so needs thread_local
+#ifdef DYND_USE_THREAD_LOCAL
+# define DYND_CKERNEL_BUILDER_POOL
+#endif
+
+namespace {
+    // The pooled block sizes are the powers of two from
+    // 2^pool_min_shift up to 2^(pool_min_shift + pool_class_count - 1).
+    // Bigger kernels go directly to malloc.
+    enum {
+        pool_min_shift = 8,
+        pool_class_count = 9,
+        // The most blocks each size class keeps for reuse
+        pool_max_blocks = 8
+    };
+
+    inline int pool_class_of(intptr_t capacity)
+    {
+        int cls = 0;
+        while (((intptr_t)1 << (pool_min_shift + cls)) < capacity) {
+            ++cls;
+        }
+        return cls;
+    }
+
+#ifdef DYND_CKERNEL_BUILDER_POOL
+    struct ckernel_builder_pool {
+        void *blocks[pool_class_count][pool_max_blocks];
+        int counts[pool_class_count];
+        // Kernels destroyed during thread shutdown, after the
+        // pool itself, bypass it
+        bool alive;
+
+        ckernel_builder_pool() : alive(true) {
+            memset(counts, 0, sizeof(counts));
+        }
+
+        ~ckernel_builder_pool() {
+            for (int cls = 0; cls < pool_class_count; ++cls) {
+                for (int i = 0; i < counts[cls]; ++i) {
+                    free(blocks[cls][i]);
+                }
+                counts[cls] = 0;
+            }
+            alive = false;
+        }
+    };
+
+    thread_local ckernel_builder_pool pool;
+#endif
+} // anonymous namespace
+
+intptr_t dynd::ckernel_builder_pool_round_capacity(intptr_t requested_capacity)
+{
+    int cls = pool_class_of(requested_capacity);
+    if (cls < pool_class_count) {
+        return (intptr_t)1 << (pool_min_shift + cls);
+    } else {
+        return requested_capacity;
+    }
+}
+
+void *dynd::ckernel_builder_pool_allocate(intptr_t capacity)
+{
+#ifdef DYND_CKERNEL_BUILDER_POOL
+    int cls = pool_class_of(capacity);
+    if (cls < pool_class_count && pool.alive && pool.counts[cls] > 0) {
+        return pool.blocks[cls][--pool.counts[cls]];
+    }
+#endif
+    return malloc(capacity);
+}
+
+void dynd::ckernel_builder_pool_free(void *ptr, intptr_t capacity)
+{
+#ifdef DYND_CKERNEL_BUILDER_POOL
+    int cls = pool_class_of(capacity);
+    // Only exact class sizes come from the pool
+    if (cls < pool_class_count && ((intptr_t)1 << (pool_min_shift + cls)) == capacity &&
+                    pool.alive && pool.counts[cls] < pool_max_blocks) {
+        pool.blocks[cls][pool.counts[cls]++] = ptr;
+        return;
+    }
+#else
+    (void)capacity;
+#endif
+    free(ptr);
+}
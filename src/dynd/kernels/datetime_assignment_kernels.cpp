@@ -7,7 +7,9 @@
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/types/cstruct_type.hpp>
 #include <dynd/types/datetime_type.hpp>
+#include <dynd/types/datetime_parser.hpp>
 #include <datetime_strings.h>
+#include "string_to_temporal_parse.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -27,18 +29,47 @@ namespace {
         date_parse_order_t date_parse_order;
         int century_window;
 
+        // Whether the string bytes are UTF-8, so can be parsed in place
+        bool src_utf8;
+        // How often the fixed width ISO 8601 fast path has matched
+        intptr_t iso8601_hits, iso8601_misses;
+
+        typedef datetime_struct value_type;
+
+        static const char *type_name() {
+            return "datetime";
+        }
+
+        inline bool parse_iso8601_fixed(const char *begin, const char *end, datetime_struct& value) const {
+            return string_to_datetime_iso8601_fixed(begin, end, value);
+        }
+
+        inline bool parse_general(const char *begin, const char *end, datetime_struct& value) const {
+            return string_to_datetime(begin, end, value, date_parse_order, century_window);
+        }
+
+        inline void store(char *dst, const datetime_struct& value) const {
+            *reinterpret_cast<int64_t *>(dst) = value.to_ticks();
+        }
+
+        inline void parse(char *dst, const char *src)
+        {
+            detail::parse_temporal_string(this, dst, src);
+        }
+
         static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            reinterpret_cast<extra_type *>(extra)->parse(dst, src);
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
-            const string& s = e->src_string_dt->get_utf8_string(e->src_metadata, src, e->errmode);
-            datetime_struct dts;
-            // TODO: properly distinguish "date" and "option[date]" with respect to NA support
-            if (s == "NA") {
-                dts.set_to_na();
-            } else {
-                dts.set_from_str(s, e->date_parse_order, e->century_window);
+            for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                e->parse(dst, src);
             }
-            *reinterpret_cast<int64_t *>(dst) = dts.to_ticks();
         }
 
         static void destruct(ckernel_prefix *extra)
@@ -63,10 +94,21 @@ size_t dynd::make_string_to_datetime_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
-    out->ensure_capacity(offset_out + sizeof(string_to_datetime_kernel_extra));
+    out->ensure_capacity_leaf(offset_out + sizeof(string_to_datetime_kernel_extra));
     string_to_datetime_kernel_extra *e = out->get_at<string_to_datetime_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&string_to_datetime_kernel_extra::single);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(&string_to_datetime_kernel_extra::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(&string_to_datetime_kernel_extra::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_string_to_datetime_assignment_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
     e->base.destructor = &string_to_datetime_kernel_extra::destruct;
     // The kernel data owns a reference to this type
     e->dst_datetime_dt = static_cast<const datetime_type *>(ndt::type(dst_datetime_dt).release());
@@ -76,6 +118,10 @@ size_t dynd::make_string_to_datetime_assignment_kernel(
     e->errmode = errmode;
     e->date_parse_order = ectx->date_parse_order;
     e->century_window = ectx->century_window;
+    string_encoding_t encoding = e->src_string_dt->get_encoding();
+    e->src_utf8 = (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii);
+    e->iso8601_hits = 0;
+    e->iso8601_misses = 0;
     return offset_out + sizeof(string_to_datetime_kernel_extra);
 }
 
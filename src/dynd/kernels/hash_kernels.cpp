@@ -0,0 +1,386 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <cstring>
+
+#include <dynd/type.hpp>
+#include <dynd/kernels/hash_kernels.hpp>
+#include <dynd/types/base_struct_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+uint64_t dynd::hash_bytes(const char *data, size_t size)
+{
+    // MurmurHash64A by Austin Appleby (public domain), with
+    // unaligned loads done through memcpy
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = 0x8445d61a4e774912ULL ^ (size * m);
+
+    const char *end = data + (size & ~(size_t)7);
+    for (; data != end; data += 8) {
+        uint64_t k;
+        memcpy(&k, data, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7) {
+        case 7: h ^= uint64_t((unsigned char)data[6]) << 48;
+                // fall through
+        case 6: h ^= uint64_t((unsigned char)data[5]) << 40;
+                // fall through
+        case 5: h ^= uint64_t((unsigned char)data[4]) << 32;
+                // fall through
+        case 4: h ^= uint64_t((unsigned char)data[3]) << 24;
+                // fall through
+        case 3: h ^= uint64_t((unsigned char)data[2]) << 16;
+                // fall through
+        case 2: h ^= uint64_t((unsigned char)data[1]) << 8;
+                // fall through
+        case 1: h ^= uint64_t((unsigned char)data[0]);
+                h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+/////////////////////////////////////////
+// builtin type hashing
+
+namespace {
+    // All NaNs are equivalent under sorting_less, so they share a hash
+    const uint64_t nan_hash = 0x7ff8000000000000ULL;
+
+    template<class T>
+    struct builtin_hash_kernel {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            return hash_mix64(static_cast<uint64_t>(*reinterpret_cast<const T *>(src)));
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<dynd_bool> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            return hash_mix64(*reinterpret_cast<const dynd_bool *>(src) ? 1 : 0);
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<dynd_int128> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            const dynd_int128& v = *reinterpret_cast<const dynd_int128 *>(src);
+            return hash_combine(hash_mix64(v.m_lo), v.m_hi);
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<dynd_uint128> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            const dynd_uint128& v = *reinterpret_cast<const dynd_uint128 *>(src);
+            return hash_combine(hash_mix64(v.m_lo), v.m_hi);
+        }
+    };
+
+    inline uint64_t hash_float64(double v) {
+        if (v != v) {
+            return nan_hash;
+        } else if (v == 0) {
+            // Both signed zeros
+            return 0;
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            return hash_mix64(bits);
+        }
+    }
+
+    template<>
+    struct builtin_hash_kernel<float> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            return hash_float64(*reinterpret_cast<const float *>(src));
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<double> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            return hash_float64(*reinterpret_cast<const double *>(src));
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<dynd_float16> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            return hash_float64(static_cast<float>(*reinterpret_cast<const dynd_float16 *>(src)));
+        }
+    };
+
+    template<>
+    struct builtin_hash_kernel<dynd_float128> {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            const dynd_float128& v = *reinterpret_cast<const dynd_float128 *>(src);
+            if (v.isnan_()) {
+                return nan_hash;
+            } else if (v.iszero()) {
+                return 0;
+            } else {
+                return hash_combine(hash_mix64(v.m_lo), v.m_hi);
+            }
+        }
+    };
+
+    template<class T>
+    struct builtin_hash_kernel<dynd_complex<T> > {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            const dynd_complex<T>& v = *reinterpret_cast<const dynd_complex<T> *>(src);
+            return hash_combine(hash_float64(v.real()), hash_float64(v.imag()));
+        }
+    };
+} // anonymous namespace
+
+size_t dynd::make_builtin_type_hash_kernel(
+                ckernel_builder *out, size_t offset_out,
+                type_id_t tid)
+{
+    static hash_single_operation_t builtin_hash_table[builtin_type_id_count] = {
+        NULL,
+        &builtin_hash_kernel<dynd_bool>::hash,
+        &builtin_hash_kernel<int8_t>::hash,
+        &builtin_hash_kernel<int16_t>::hash,
+        &builtin_hash_kernel<int32_t>::hash,
+        &builtin_hash_kernel<int64_t>::hash,
+        &builtin_hash_kernel<dynd_int128>::hash,
+        &builtin_hash_kernel<uint8_t>::hash,
+        &builtin_hash_kernel<uint16_t>::hash,
+        &builtin_hash_kernel<uint32_t>::hash,
+        &builtin_hash_kernel<uint64_t>::hash,
+        &builtin_hash_kernel<dynd_uint128>::hash,
+        &builtin_hash_kernel<dynd_float16>::hash,
+        &builtin_hash_kernel<float>::hash,
+        &builtin_hash_kernel<double>::hash,
+        &builtin_hash_kernel<dynd_float128>::hash,
+        &builtin_hash_kernel<dynd_complex<float> >::hash,
+        &builtin_hash_kernel<dynd_complex<double> >::hash,
+        NULL
+    };
+    if (0 <= tid && tid < builtin_type_id_count && builtin_hash_table[tid] != NULL) {
+        out->ensure_capacity_leaf(offset_out + sizeof(ckernel_prefix));
+        ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
+        e->set_function<hash_single_operation_t>(builtin_hash_table[tid]);
+        return offset_out + sizeof(ckernel_prefix);
+    } else {
+        stringstream ss;
+        ss << "make_builtin_type_hash_kernel: cannot hash type " << ndt::type(tid);
+        throw type_error(ss.str());
+    }
+}
+
+/////////////////////////////////////////
+// string hashing
+
+namespace {
+    struct string_hash_kernel {
+        static uint64_t hash(const char *src, ckernel_prefix *DYND_UNUSED(extra)) {
+            const string_type_data *d = reinterpret_cast<const string_type_data *>(src);
+            return hash_bytes(d->begin, d->end - d->begin);
+        }
+    };
+
+    struct fixedstring_hash_kernel_extra {
+        ckernel_prefix base;
+        size_t data_size;
+
+        // The one-byte encodings compare with strncmp, so
+        // only hash up to the first NUL
+        static uint64_t hash_nul_terminated(const char *src, ckernel_prefix *extra) {
+            size_t data_size = reinterpret_cast<fixedstring_hash_kernel_extra *>(extra)->data_size;
+            const char *end = reinterpret_cast<const char *>(memchr(src, 0, data_size));
+            return hash_bytes(src, end != NULL ? end - src : data_size);
+        }
+
+        static uint64_t hash(const char *src, ckernel_prefix *extra) {
+            size_t data_size = reinterpret_cast<fixedstring_hash_kernel_extra *>(extra)->data_size;
+            return hash_bytes(src, data_size);
+        }
+    };
+
+    struct struct_hash_kernel {
+        typedef struct_hash_kernel extra_type;
+
+        ckernel_prefix base;
+        size_t field_count;
+        const size_t *src_data_offsets;
+        // After this are field_count hash kernel offsets
+
+        static uint64_t hash(const char *src, ckernel_prefix *extra) {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            size_t field_count = e->field_count;
+            const size_t *src_data_offsets = e->src_data_offsets;
+            const size_t *kernel_offsets = reinterpret_cast<const size_t *>(e + 1);
+            uint64_t h = field_count;
+            for (size_t i = 0; i != field_count; ++i) {
+                ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(eraw + kernel_offsets[i]);
+                hash_single_operation_t opchild = echild->get_function<hash_single_operation_t>();
+                h = hash_combine(h, opchild(src + src_data_offsets[i], echild));
+            }
+            return h;
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const size_t *kernel_offsets = reinterpret_cast<const size_t *>(e + 1);
+            size_t field_count = e->field_count;
+            ckernel_prefix *echild;
+            for (size_t i = 0; i != field_count; ++i) {
+                echild = reinterpret_cast<ckernel_prefix *>(eraw + kernel_offsets[i]);
+                if (echild->destructor) {
+                    echild->destructor(echild);
+                }
+            }
+        }
+    };
+} // anonymous namespace
+
+bool dynd::is_hash_kernel_supported(const ndt::type& tp)
+{
+    switch (tp.get_type_id()) {
+        case void_type_id:
+            return false;
+        case string_type_id:
+        case fixedstring_type_id:
+            return true;
+        case struct_type_id:
+        case cstruct_type_id: {
+            const base_struct_type *bsd = static_cast<const base_struct_type *>(tp.extended());
+            size_t field_count = bsd->get_field_count();
+            const ndt::type *field_types = bsd->get_field_types();
+            for (size_t i = 0; i != field_count; ++i) {
+                if (!is_hash_kernel_supported(field_types[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default:
+            return tp.is_builtin();
+    }
+}
+
+size_t dynd::make_hash_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& tp, const char *metadata,
+                const eval::eval_context *ectx)
+{
+    if (tp.is_builtin()) {
+        return make_builtin_type_hash_kernel(out, offset_out, tp.get_type_id());
+    }
+
+    switch (tp.get_type_id()) {
+        case string_type_id: {
+            out->ensure_capacity_leaf(offset_out + sizeof(ckernel_prefix));
+            ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
+            e->set_function<hash_single_operation_t>(&string_hash_kernel::hash);
+            return offset_out + sizeof(ckernel_prefix);
+        }
+        case fixedstring_type_id: {
+            const fixedstring_type *fst = static_cast<const fixedstring_type *>(tp.extended());
+            out->ensure_capacity_leaf(offset_out + sizeof(fixedstring_hash_kernel_extra));
+            fixedstring_hash_kernel_extra *e = out->get_at<fixedstring_hash_kernel_extra>(offset_out);
+            switch (fst->get_encoding()) {
+                case string_encoding_ascii:
+                case string_encoding_utf_8:
+                case string_encoding_latin1:
+                    e->base.set_function<hash_single_operation_t>(
+                                    &fixedstring_hash_kernel_extra::hash_nul_terminated);
+                    break;
+                default:
+                    e->base.set_function<hash_single_operation_t>(
+                                    &fixedstring_hash_kernel_extra::hash);
+                    break;
+            }
+            e->data_size = fst->get_data_size();
+            return offset_out + sizeof(fixedstring_hash_kernel_extra);
+        }
+        case struct_type_id:
+        case cstruct_type_id: {
+            const base_struct_type *bsd = static_cast<const base_struct_type *>(tp.extended());
+            size_t field_count = bsd->get_field_count();
+            size_t field_kernel_offset = offset_out + sizeof(struct_hash_kernel) +
+                            field_count * sizeof(size_t);
+            out->ensure_capacity(field_kernel_offset);
+            struct_hash_kernel *e = out->get_at<struct_hash_kernel>(offset_out);
+            e->base.set_function<hash_single_operation_t>(&struct_hash_kernel::hash);
+            e->base.destructor = &struct_hash_kernel::destruct;
+            e->field_count = field_count;
+            e->src_data_offsets = bsd->get_data_offsets(metadata);
+            const size_t *metadata_offsets = bsd->get_metadata_offsets();
+            const ndt::type *field_types = bsd->get_field_types();
+            for (size_t i = 0; i != field_count; ++i) {
+                // Reserve space for the child, and save the offset to this
+                // field hash kernel. Have to re-get the pointer because
+                // creating the field hash kernel may move the memory.
+                out->ensure_capacity(field_kernel_offset);
+                e = out->get_at<struct_hash_kernel>(offset_out);
+                reinterpret_cast<size_t *>(e + 1)[i] = field_kernel_offset - offset_out;
+                field_kernel_offset = make_hash_kernel(out, field_kernel_offset,
+                                field_types[i], metadata + metadata_offsets[i], ectx);
+            }
+            return field_kernel_offset;
+        }
+        default: {
+            stringstream ss;
+            ss << "make_hash_kernel: cannot hash type " << tp;
+            throw type_error(ss.str());
+        }
+    }
+}
+
+/////////////////////////////////////////
+// hash_index_table
+
+void hash_index_table::reset(size_t expected_count)
+{
+    size_t slot_count = 16;
+    while (slot_count < 2 * expected_count) {
+        slot_count *= 2;
+    }
+    m_hashes.assign(slot_count, 0);
+    m_indices.assign(slot_count, -1);
+    m_count = 0;
+}
+
+void hash_index_table::rehash(size_t slot_count)
+{
+    vector<uint64_t> hashes(slot_count, 0);
+    vector<intptr_t> indices(slot_count, -1);
+    size_t mask = slot_count - 1;
+    for (size_t i = 0, i_end = m_indices.size(); i != i_end; ++i) {
+        if (m_indices[i] >= 0) {
+            size_t slot = (size_t)m_hashes[i] & mask;
+            while (indices[slot] >= 0) {
+                slot = (slot + 1) & mask;
+            }
+            hashes[slot] = m_hashes[i];
+            indices[slot] = m_indices[i];
+        }
+    }
+    m_hashes.swap(hashes);
+    m_indices.swap(indices);
+}
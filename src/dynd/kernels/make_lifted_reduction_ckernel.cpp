@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <vector>
+
 #include <dynd/kernels/make_lifted_reduction_ckernel.hpp>
 #include <dynd/kernels/ckernel_builder.hpp>
 #include <dynd/types/strided_dim_type.hpp>
@@ -10,6 +12,7 @@
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/kernels/expr_kernel_generator.hpp>
 #include <dynd/kernels/ckernel_common_functions.hpp>
+#include <dynd/eval/parallel_tasks.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -406,6 +409,11 @@ struct strided_inner_reduction_kernel_extra {
         unary_strided_operation_t opchild_reduce = echild_reduce->get_function<unary_strided_operation_t>();
         intptr_t inner_size = e->size;
         intptr_t inner_src_stride = e->src_stride;
+        if (inner_size == 1) {
+            // With a single inner element, this is one strided accumulation
+            opchild_reduce(dst, dst_stride, src, src_stride, count, &echild_reduce->base());
+            return;
+        }
         for (size_t i = 0; i != count; ++i) {
             opchild_reduce(dst, 0, src, inner_src_stride, inner_size, &echild_reduce->base());
             dst += dst_stride;
@@ -601,8 +609,241 @@ struct strided_inner_broadcast_kernel_extra {
     }
 };
 
+/**
+ * PARALLEL OUTER REDUCTION DIMENSION
+ * This ckernel handles the outermost dimension of a reduction which
+ * reduces all of its dimensions, where:
+ *  - It's a reduction dimension, so dst_stride is zero.
+ *  - The dimension is split into thread_count chunks, each reduced
+ *    on its own thread. The first chunk accumulates directly into
+ *    "dst", the others into temporary accumulators which are then
+ *    combined into "dst" in order. This requires associativity, but
+ *    not commutativity.
+ *  - The source data is strided.
+ *
+ * Requirements:
+ *  - There are thread_count copies of the child ckernel, each of
+ *    child_size bytes, one after the other following this ckernel.
+ *    Ckernels are not threadsafe, so each thread uses its own copy.
+ *  - The child first_call function must be *single*.
+ *  - The child followup_call function must be *strided*.
+ *  - The combine kernel must be a *strided* reduction of the dst
+ *    element type into itself.
+ */
+struct parallel_outer_reduction_kernel_extra {
+    typedef parallel_outer_reduction_kernel_extra extra_type;
+
+    ckernel_reduction_prefix ckpbase;
+    // The code assumes that size >= thread_count
+    intptr_t size;
+    intptr_t src_stride;
+    intptr_t thread_count;
+    size_t child_size;
+    size_t combine_kernel_offset;
+    // Layout of the temporary accumulators
+    size_t accum_stride, accum_alignment;
+
+    inline ckernel_prefix& base() {
+        return ckpbase.base();
+    }
+
+    inline ckernel_reduction_prefix *get_child(intptr_t i) {
+        return reinterpret_cast<ckernel_reduction_prefix *>(
+                        reinterpret_cast<char *>(this + 1) + i * child_size);
+    }
+
+    struct task_data {
+        extra_type *e;
+        char *dst;
+        char *accum;
+        const char *src;
+        bool first;
+    };
+
+    static void reduce_chunk_task(intptr_t task_index, void *data)
+    {
+        const task_data *td = reinterpret_cast<const task_data *>(data);
+        extra_type *e = td->e;
+        ckernel_reduction_prefix *echild = e->get_child(task_index);
+        intptr_t begin = e->size * task_index / e->thread_count;
+        intptr_t end = e->size * (task_index + 1) / e->thread_count;
+        const char *src = td->src + begin * e->src_stride;
+        unary_strided_operation_t opchild_followup_call = echild->get_followup_call_function();
+        if (task_index == 0 && !td->first) {
+            // The first chunk accumulates onto the existing "dst" value
+            opchild_followup_call(td->dst, 0, src, e->src_stride,
+                            end - begin, &echild->base());
+        } else {
+            char *dst = (task_index == 0) ? td->dst
+                            : td->accum + (task_index - 1) * e->accum_stride;
+            unary_single_operation_t opchild_first_call = echild->get_first_call_function<unary_single_operation_t>();
+            opchild_first_call(dst, src, &echild->base());
+            if (end - begin > 1) {
+                opchild_followup_call(dst, 0, src + e->src_stride, e->src_stride,
+                                end - begin - 1, &echild->base());
+            }
+        }
+    }
+
+    /**
+     * Reduces the whole dimension into "dst", which gets initialized
+     * if "first" is true.
+     */
+    inline void reduce(char *dst, const char *src, char *accum, bool first)
+    {
+        task_data td = {this, dst, accum, src, first};
+        eval::parallel_run_tasks(thread_count, &reduce_chunk_task, &td);
+        // Combine the partial results in order
+        ckernel_prefix *echild_combine = reinterpret_cast<ckernel_prefix *>(
+                            reinterpret_cast<char *>(this) + combine_kernel_offset);
+        unary_strided_operation_t opchild_combine = echild_combine->get_function<unary_strided_operation_t>();
+        opchild_combine(dst, 0, accum, accum_stride, thread_count - 1, echild_combine);
+    }
+
+    inline char *get_accum(vector<char>& accum_buffer)
+    {
+        accum_buffer.resize((thread_count - 1) * accum_stride + accum_alignment);
+        return inc_to_alignment(&accum_buffer[0], accum_alignment);
+    }
+
+    static void single_first(char *dst, const char *src,
+                    ckernel_prefix *extra)
+    {
+        extra_type *e = reinterpret_cast<extra_type *>(extra);
+        vector<char> accum_buffer;
+        e->reduce(dst, src, e->get_accum(accum_buffer), true);
+    }
+
+    static void strided_first(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride,
+                    size_t count, ckernel_prefix *extra)
+    {
+        extra_type *e = reinterpret_cast<extra_type *>(extra);
+        vector<char> accum_buffer;
+        char *accum = e->get_accum(accum_buffer);
+        // With a zero stride, only the first iteration is "first",
+        // with a non-zero stride, each iteration of the outer loop is "first"
+        for (size_t i = 0; i != count; ++i) {
+            e->reduce(dst, src, accum, i == 0 || dst_stride != 0);
+            dst += dst_stride;
+            src += src_stride;
+        }
+    }
+
+    static void strided_followup(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride,
+                    size_t count, ckernel_prefix *extra)
+    {
+        extra_type *e = reinterpret_cast<extra_type *>(extra);
+        vector<char> accum_buffer;
+        char *accum = e->get_accum(accum_buffer);
+        for (size_t i = 0; i != count; ++i) {
+            e->reduce(dst, src, accum, false);
+            dst += dst_stride;
+            src += src_stride;
+        }
+    }
+
+    static void destruct(ckernel_prefix *extra)
+    {
+        extra_type *e = reinterpret_cast<extra_type *>(extra);
+        // The per-thread copies of the child ckernel
+        for (intptr_t i = 0; i < e->thread_count; ++i) {
+            ckernel_prefix *echild = &e->get_child(i)->base();
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+        // The kernel combining the partial results
+        if (e->combine_kernel_offset != 0) {
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(
+                        reinterpret_cast<char *>(extra) + e->combine_kernel_offset);
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+    }
+};
+
 } // anonymous namespace
 
+/**
+ * Gets the striding parameters for the outermost dimension of the
+ * reduction source, advancing the type and metadata past it.
+ */
+static void get_reduction_src_dim(ndt::type &src_tp, const char *&src_meta,
+                                  intptr_t &out_src_stride,
+                                  intptr_t &out_src_size)
+{
+    switch (src_tp.get_type_id()) {
+        case fixed_dim_type_id: {
+            const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(src_tp.extended());
+            out_src_stride = fdt->get_fixed_stride();
+            out_src_size = fdt->get_fixed_dim_size();
+            src_tp = fdt->get_element_type();
+            break;
+        }
+        case strided_dim_type_id: {
+            const strided_dim_type *sdt = static_cast<const strided_dim_type *>(src_tp.extended());
+            const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(src_meta);
+            out_src_stride = md->stride;
+            out_src_size = md->size;
+            src_tp = sdt->get_element_type();
+            src_meta += sizeof(strided_dim_type_metadata);
+            break;
+        }
+        default: {
+            stringstream ss;
+            ss << "make_lifted_reduction_ckernel: type " << src_tp << " not supported as source";
+            throw type_error(ss.str());
+        }
+    }
+}
+
+/**
+ * Advances the type and metadata past the outermost dimension of the
+ * reduction destination, for a dimension being reduced with the
+ * reduced dimensions being kept.
+ */
+static void skip_kept_reduction_dst_dim(ndt::type &dst_tp, const char *&dst_meta)
+{
+    // If the dimensions are being kept, the output should be a
+    // a strided dimension of size one
+    switch (dst_tp.get_type_id()) {
+        case fixed_dim_type_id: {
+            const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(dst_tp.extended());
+            if (fdt->get_fixed_dim_size() != 1 || fdt->get_fixed_stride() != 0) {
+                stringstream ss;
+                ss << "make_lifted_reduction_ckernel: destination of a reduction dimension ";
+                ss << "must have size 1, not " << dst_tp;
+                throw type_error(ss.str());
+            }
+            dst_tp = fdt->get_element_type();
+            break;
+        }
+        case strided_dim_type_id: {
+            const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(dst_meta);
+            const strided_dim_type *sdt = static_cast<const strided_dim_type *>(dst_tp.extended());
+            if (md->size != 1 || md->stride != 0) {
+                stringstream ss;
+                ss << "make_lifted_reduction_ckernel: destination of a reduction dimension ";
+                ss << "must have size 1, not size" << md->size << "/stride " << md->stride;
+                ss << " in type " << dst_tp;
+                throw type_error(ss.str());
+            }
+            dst_tp = sdt->get_element_type();
+            dst_meta += sizeof(strided_dim_type_metadata);
+            break;
+        }
+        default: {
+            stringstream ss;
+            ss << "make_lifted_reduction_ckernel: type " << dst_tp;
+            ss << " not supported the destination of a dimension being reduced";
+            throw type_error(ss.str());
+        }
+    }
+}
+
 /**
  * Adds a ckernel layer for processing one dimension of the reduction.
  * This is for a strided dimension which is being reduced, and is not
@@ -937,6 +1178,150 @@ static size_t make_strided_inner_broadcast_dimension_kernel(
     return ckb_end;
 }
 
+/**
+ * The minimum number of elements each thread of a parallel
+ * reduction should process, so the cost of starting the
+ * threads is small relative to the work.
+ */
+static const intptr_t parallel_reduction_min_elements_per_thread = 65536;
+
+/**
+ * Returns how many threads to split the outermost dimension of
+ * a reduction of all the source dimensions across, based on the
+ * total number of source elements. Returns 1 if the reduction
+ * should run on a single thread.
+ */
+static intptr_t get_parallel_reduction_thread_count(
+    ndt::type src_tp, const char *src_meta, intptr_t reduction_ndim,
+    const eval::eval_context *ectx)
+{
+    intptr_t thread_count = eval::get_parallel_thread_count(ectx);
+    if (thread_count <= 1) {
+        return 1;
+    }
+    intptr_t outer_size = 0, element_count = 1;
+    for (intptr_t i = 0; i < reduction_ndim; ++i) {
+        intptr_t src_stride, src_size;
+        switch (src_tp.get_type_id()) {
+            case fixed_dim_type_id:
+            case strided_dim_type_id:
+                get_reduction_src_dim(src_tp, src_meta, src_stride, src_size);
+                break;
+            default:
+                // Leave the error reporting to the single-threaded path
+                return 1;
+        }
+        if (i == 0) {
+            outer_size = src_size;
+        }
+        element_count *= src_size;
+    }
+    thread_count = min(thread_count, outer_size);
+    thread_count = min(thread_count,
+                    element_count / parallel_reduction_min_elements_per_thread);
+    return thread_count > 1 ? thread_count : 1;
+}
+
+/**
+ * Adds a ckernel layer for processing the outermost dimension of a
+ * reduction which reduces all of its dimensions, splitting it across
+ * threads. The remaining dimensions are processed by thread_count
+ * copies of the single-threaded lifted reduction ckernel.
+ */
+static size_t make_parallel_outer_reduction_dimension_kernel(
+    const ckernel_deferred *elwise_reduction,
+    const ckernel_deferred *dst_initialization, ckernel_builder *out_ckb,
+    size_t ckb_offset, intptr_t thread_count, const ndt::type *lifted_types,
+    const char *const *dynd_metadata, intptr_t reduction_ndim,
+    const bool *reduction_dimflags, bool keep_dims, bool associative,
+    bool commutative, const nd::array &reduction_identity,
+    kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+    ndt::type dst_tp = lifted_types[0], src_tp = lifted_types[1];
+    const char *dst_meta = dynd_metadata[0], *src_meta = dynd_metadata[1];
+    intptr_t src_stride, src_size;
+    get_reduction_src_dim(src_tp, src_meta, src_stride, src_size);
+    if (keep_dims) {
+        skip_kept_reduction_dst_dim(dst_tp, dst_meta);
+    }
+
+    intptr_t ckb_end = ckb_offset + sizeof(parallel_outer_reduction_kernel_extra);
+    out_ckb->ensure_capacity(ckb_end);
+    parallel_outer_reduction_kernel_extra *e =
+                    out_ckb->get_at<parallel_outer_reduction_kernel_extra>(ckb_offset);
+    e->base().destructor = &parallel_outer_reduction_kernel_extra::destruct;
+    // Get the function pointer for the first_call
+    if (kernreq == kernel_request_single) {
+        e->ckpbase.set_first_call_function(&parallel_outer_reduction_kernel_extra::single_first);
+    } else if (kernreq == kernel_request_strided) {
+        e->ckpbase.set_first_call_function(&parallel_outer_reduction_kernel_extra::strided_first);
+    } else {
+        stringstream ss;
+        ss << "make_lifted_reduction_ckernel: unrecognized request " << (int)kernreq;
+        throw runtime_error(ss.str());
+    }
+    // The function pointer for followup accumulation calls
+    e->ckpbase.set_followup_call_function(&parallel_outer_reduction_kernel_extra::strided_followup);
+    // The striding parameters
+    e->src_stride = src_stride;
+    e->size = src_size;
+    const ndt::type& dst_el_tp = elwise_reduction->data_dynd_types[0];
+    e->accum_alignment = dst_el_tp.get_data_alignment();
+    e->accum_stride = inc_to_alignment(dst_el_tp.get_data_size(), e->accum_alignment);
+
+    // The child ckernels must not try to use threads themselves
+    eval::eval_context child_ectx(*ectx);
+    child_ectx.thread_count = 1;
+    ndt::type child_types[2] = {dst_tp, src_tp};
+    const char *child_meta[2] = {dst_meta, src_meta};
+    for (intptr_t i = 0; i < thread_count; ++i) {
+        // Count the child before creating it, so it gets destroyed
+        // if an error occurs partway through
+        e->thread_count = i + 1;
+        intptr_t child_offset = ckb_end;
+        if (reduction_ndim == 1) {
+            // Reduce each element of the chunk as a dimension of size one
+            ckb_end = make_strided_inner_reduction_dimension_kernel(
+                elwise_reduction, dst_initialization, out_ckb, ckb_end,
+                0, 1, dst_tp, dst_meta, src_tp, src_meta, false,
+                reduction_identity, kernel_request_single, &child_ectx);
+        } else {
+            ckb_end = make_lifted_reduction_ckernel(
+                elwise_reduction, dst_initialization, out_ckb, ckb_end,
+                child_types, child_meta, reduction_ndim - 1,
+                reduction_dimflags + 1, associative, commutative, false,
+                reduction_identity, kernel_request_single, &child_ectx);
+        }
+        // Need to retrieve 'e' again because it may have moved
+        e = out_ckb->get_at<parallel_outer_reduction_kernel_extra>(ckb_offset);
+        if (i == 0) {
+            e->child_size = ckb_end - child_offset;
+        } else if (e->child_size != (size_t)(ckb_end - child_offset)) {
+            throw runtime_error("make_lifted_reduction_ckernel: internal error, "
+                                "parallel child ckernels have different sizes");
+        }
+    }
+
+    // The kernel combining partial results operates on the dst element,
+    // so skip past any remaining kept dimensions
+    if (keep_dims) {
+        for (intptr_t i = 1; i < reduction_ndim; ++i) {
+            skip_kept_reduction_dst_dim(dst_tp, dst_meta);
+        }
+    }
+    out_ckb->ensure_capacity(ckb_end);
+    e = out_ckb->get_at<parallel_outer_reduction_kernel_extra>(ckb_offset);
+    e->combine_kernel_offset = ckb_end - ckb_offset;
+    const char *combine_meta[2] = {dst_meta, dst_meta};
+    if (elwise_reduction->ckernel_funcproto == expr_operation_funcproto) {
+        ckb_end = kernels::wrap_binary_as_unary_reduction_ckernel(
+                        out_ckb, ckb_end, false, kernel_request_strided);
+    }
+    return elwise_reduction->instantiate_func(
+        elwise_reduction->data_ptr, out_ckb, ckb_end, combine_meta,
+        kernel_request_strided, ectx);
+}
+
 size_t dynd::make_lifted_reduction_ckernel(
                 const ckernel_deferred *elwise_reduction,
                 const ckernel_deferred *dst_initialization,
@@ -1017,32 +1402,27 @@ size_t dynd::make_lifted_reduction_ckernel(
         throw runtime_error(ss.str());
     }
 
+    // When every dimension is reduced, an associative reduction can be
+    // split across threads along the outermost dimension. The partial
+    // results are combined with the reduction kernel itself, so its
+    // dst and src types must match.
+    if (associative && reducedim_count == reduction_ndim &&
+            dst_el_tp == src_el_tp && dst_el_tp.is_pod()) {
+        intptr_t thread_count = get_parallel_reduction_thread_count(
+                        src_tp, src_meta, reduction_ndim, ectx);
+        if (thread_count > 1) {
+            return make_parallel_outer_reduction_dimension_kernel(
+                elwise_reduction, dst_initialization, out_ckb, ckb_offset,
+                thread_count, lifted_types, dynd_metadata, reduction_ndim,
+                reduction_dimflags, keep_dims, associative, commutative,
+                reduction_identity, kernreq, ectx);
+        }
+    }
+
     for (intptr_t i = 0; i < reduction_ndim; ++i) {
         intptr_t dst_stride, dst_size, src_stride, src_size;
         // Get the striding parameters for the source dimension
-        switch (src_tp.get_type_id()) {
-            case fixed_dim_type_id: {
-                const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(src_tp.extended());
-                src_stride = fdt->get_fixed_stride();
-                src_size = fdt->get_fixed_dim_size();
-                src_tp = fdt->get_element_type();
-                break;
-            }
-            case strided_dim_type_id: {
-                const strided_dim_type *sdt = static_cast<const strided_dim_type *>(src_tp.extended());
-                const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(src_meta);
-                src_stride = md->stride;
-                src_size = md->size;
-                src_tp = sdt->get_element_type();
-                src_meta += sizeof(strided_dim_type_metadata);
-                break;
-            }
-            default: {
-                stringstream ss;
-                ss << "make_lifted_reduction_ckernel: type " << src_tp << " not supported as source";
-                throw type_error(ss.str());
-            }
-        }
+        get_reduction_src_dim(src_tp, src_meta, src_stride, src_size);
         if (reduction_dimflags[i]) {
             // This dimension is being reduced
             if (src_size == 0 && reduction_identity.is_empty()) {
@@ -1054,41 +1434,7 @@ size_t dynd::make_lifted_reduction_ckernel(
                 throw invalid_argument(ss.str());
             }
             if (keep_dims) {
-                // If the dimensions are being kept, the output should be a
-                // a strided dimension of size one
-                switch (dst_tp.get_type_id()) {
-                    case fixed_dim_type_id: {
-                        const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(dst_tp.extended());
-                        if (fdt->get_fixed_dim_size() != 1 || fdt->get_fixed_stride() != 0) {
-                            stringstream ss;
-                            ss << "make_lifted_reduction_ckernel: destination of a reduction dimension ";
-                            ss << "must have size 1, not " << dst_tp;
-                            throw type_error(ss.str());
-                        }
-                        dst_tp = fdt->get_element_type();
-                        break;
-                    }
-                    case strided_dim_type_id: {
-                        const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(dst_meta);
-                        const strided_dim_type *sdt = static_cast<const strided_dim_type *>(dst_tp.extended());
-                        if (md->size != 1 || md->stride != 0) {
-                            stringstream ss;
-                            ss << "make_lifted_reduction_ckernel: destination of a reduction dimension ";
-                            ss << "must have size 1, not size" << md->size << "/stride " << md->stride;
-                            ss << " in type " << dst_tp;
-                            throw type_error(ss.str());
-                        }
-                        dst_tp = sdt->get_element_type();
-                        dst_meta += sizeof(strided_dim_type_metadata);
-                        break;
-                    }
-                    default: {
-                        stringstream ss;
-                        ss << "make_lifted_reduction_ckernel: type " << dst_tp;
-                        ss << " not supported the destination of a dimension being reduced";
-                        throw type_error(ss.str());
-                    }
-                }
+                skip_kept_reduction_dst_dim(dst_tp, dst_meta);
             }
             if (i < reduction_ndim - 1) {
                 // An initial dimension being reduced
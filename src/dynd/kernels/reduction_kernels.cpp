@@ -3,7 +3,19 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
 #include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/cpu_features.hpp>
+
+#if defined(DYND_X86_SIMD)
+#include <emmintrin.h>
+#endif
+#if defined(DYND_X86_AVX2)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 using namespace dynd;
@@ -30,13 +42,271 @@ static ndt::type builtin_type_pairs[builtin_type_id_count][2] = {
     {ndt::type((type_id_t)18), ndt::type((type_id_t)18)},
 };
 
+// The (dst, src) pairs for any/all, which produce a bool
+static ndt::type bool_builtin_type_pairs[builtin_type_id_count][2] = {
+    {ndt::type(bool_type_id), ndt::type((type_id_t)0)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)1)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)2)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)3)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)4)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)5)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)6)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)7)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)8)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)9)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)10)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)11)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)12)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)13)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)14)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)15)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)16)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)17)},
+    {ndt::type(bool_type_id), ndt::type((type_id_t)18)},
+};
+
+// The (dst, src) pairs for count_nonzero, which produces an int64
+static ndt::type int64_builtin_type_pairs[builtin_type_id_count][2] = {
+    {ndt::type(int64_type_id), ndt::type((type_id_t)0)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)1)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)2)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)3)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)4)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)5)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)6)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)7)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)8)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)9)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)10)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)11)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)12)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)13)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)14)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)15)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)16)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)17)},
+    {ndt::type(int64_type_id), ndt::type((type_id_t)18)},
+};
+
 namespace {
+    template<bool Cond, class TrueType, class FalseType>
+    struct select_type {
+        typedef TrueType type;
+    };
+    template<class TrueType, class FalseType>
+    struct select_type<false, TrueType, FalseType> {
+        typedef FalseType type;
+    };
+
+    template<class T>
+    inline bool is_nan_value(const T& DYND_UNUSED(v)) {
+        return false;
+    }
+    template<>
+    inline bool is_nan_value(const float& v) {
+        return v != v;
+    }
+    template<>
+    inline bool is_nan_value(const double& v) {
+        return v != v;
+    }
+    template<>
+    inline bool is_nan_value(const dynd_float128& v) {
+        return v.isnan_();
+    }
+
+    template<class T>
+    inline bool is_nonzero(const T& v) {
+        return v != T(0);
+    }
+    template<>
+    inline bool is_nonzero(const dynd_bool& v) {
+        return v;
+    }
+
+    /**
+     * Each reduction operation is described by a policy with
+     *   load(dst) -> accumulator
+     *   store(accumulator) -> dst
+     *   first(src) -> accumulator
+     *   merge(accumulator, accumulator) -> accumulator
+     *   done(accumulator) -> bool, for short circuiting any/all
+     * where merge must be associative, so the strided loops
+     * may use several independent accumulators.
+     */
+    template<class T, class Accum>
+    struct value_reduction_op {
+        typedef T dst_type;
+        typedef T src_type;
+        typedef Accum accum_type;
+        enum { short_circuit = 0 };
+
+        static inline Accum load(const T& v) {
+            return static_cast<Accum>(v);
+        }
+        static inline T store(const Accum& a) {
+            return static_cast<T>(a);
+        }
+        static inline Accum first(const T& v) {
+            return static_cast<Accum>(v);
+        }
+        static inline bool done(const Accum& DYND_UNUSED(a)) {
+            return false;
+        }
+    };
+
+    template<class T, class Accum>
+    struct sum_op : public value_reduction_op<T, Accum> {
+        static inline Accum merge(const Accum& a, const Accum& b) {
+            return static_cast<Accum>(a + b);
+        }
+    };
+
     template<class T, class Accum>
-    struct sum_reduction {
+    struct prod_op : public value_reduction_op<T, Accum> {
+        static inline Accum merge(const Accum& a, const Accum& b) {
+            return static_cast<Accum>(a * b);
+        }
+    };
+
+    // min and max propagate NaN
+    template<class T, class Accum>
+    struct min_op : public value_reduction_op<T, Accum> {
+        static inline Accum merge(const Accum& a, const Accum& b) {
+            return (b < a || is_nan_value(b)) ? b : a;
+        }
+    };
+
+    template<class T, class Accum>
+    struct max_op : public value_reduction_op<T, Accum> {
+        static inline Accum merge(const Accum& a, const Accum& b) {
+            return (a < b || is_nan_value(b)) ? b : a;
+        }
+    };
+
+    template<class T>
+    struct any_op {
+        typedef dynd_bool dst_type;
+        typedef T src_type;
+        typedef bool accum_type;
+        enum { short_circuit = 1 };
+
+        static inline bool load(const dynd_bool& v) {
+            return v;
+        }
+        static inline dynd_bool store(bool a) {
+            return a;
+        }
+        static inline bool first(const T& v) {
+            return is_nonzero(v);
+        }
+        static inline bool merge(bool a, bool b) {
+            return a || b;
+        }
+        static inline bool done(bool a) {
+            return a;
+        }
+    };
+
+    template<class T>
+    struct all_op {
+        typedef dynd_bool dst_type;
+        typedef T src_type;
+        typedef bool accum_type;
+        enum { short_circuit = 1 };
+
+        static inline bool load(const dynd_bool& v) {
+            return v;
+        }
+        static inline dynd_bool store(bool a) {
+            return a;
+        }
+        static inline bool first(const T& v) {
+            return is_nonzero(v);
+        }
+        static inline bool merge(bool a, bool b) {
+            return a && b;
+        }
+        static inline bool done(bool a) {
+            return !a;
+        }
+    };
+
+    template<class T>
+    struct count_nonzero_op {
+        typedef int64_t dst_type;
+        typedef T src_type;
+        typedef int64_t accum_type;
+        enum { short_circuit = 0 };
+
+        static inline int64_t load(int64_t v) {
+            return v;
+        }
+        static inline int64_t store(int64_t a) {
+            return a;
+        }
+        static inline int64_t first(const T& v) {
+            return is_nonzero(v) ? 1 : 0;
+        }
+        static inline int64_t merge(int64_t a, int64_t b) {
+            return a + b;
+        }
+        static inline bool done(int64_t DYND_UNUSED(a)) {
+            return false;
+        }
+    };
+
+    /**
+     * Reduces `count` strided source values into the accumulator.
+     */
+    template<class Op>
+    typename Op::accum_type reduce_strided(typename Op::accum_type a0,
+                    const char *src, intptr_t src_stride, size_t count)
+    {
+        typedef typename Op::src_type S;
+        typedef typename Op::accum_type A;
+        size_t i = 0;
+        if (Op::short_circuit) {
+            for (; i < count && !Op::done(a0); ++i) {
+                a0 = Op::merge(a0, Op::first(*reinterpret_cast<const S *>(src)));
+                src += src_stride;
+            }
+            return a0;
+        }
+        if (count >= 8) {
+            // Independent accumulators break the dependency
+            // chain between loop iterations
+            A a1 = Op::first(*reinterpret_cast<const S *>(src));
+            A a2 = Op::first(*reinterpret_cast<const S *>(src + src_stride));
+            A a3 = Op::first(*reinterpret_cast<const S *>(src + 2 * src_stride));
+            src += 3 * src_stride;
+            for (i = 3; i + 4 <= count; i += 4) {
+                a0 = Op::merge(a0, Op::first(*reinterpret_cast<const S *>(src)));
+                a1 = Op::merge(a1, Op::first(*reinterpret_cast<const S *>(src + src_stride)));
+                a2 = Op::merge(a2, Op::first(*reinterpret_cast<const S *>(src + 2 * src_stride)));
+                a3 = Op::merge(a3, Op::first(*reinterpret_cast<const S *>(src + 3 * src_stride)));
+                src += 4 * src_stride;
+            }
+            a0 = Op::merge(Op::merge(a0, a1), Op::merge(a2, a3));
+        }
+        for (; i < count; ++i) {
+            a0 = Op::merge(a0, Op::first(*reinterpret_cast<const S *>(src)));
+            src += src_stride;
+        }
+        return a0;
+    }
+
+    template<class Op>
+    struct reduction_kernel {
+        typedef typename Op::dst_type D;
+        typedef typename Op::src_type S;
+
         static void single(char *dst, const char *src,
                         ckernel_prefix *DYND_UNUSED(ckp))
         {
-            *reinterpret_cast<T *>(dst) = *reinterpret_cast<T *>(dst) + *reinterpret_cast<const T *>(src);
+            D *d = reinterpret_cast<D *>(dst);
+            *d = Op::store(Op::merge(Op::load(*d),
+                            Op::first(*reinterpret_cast<const S *>(src))));
         }
 
         static void strided(char *dst, intptr_t dst_stride,
@@ -44,116 +314,1305 @@ namespace {
                         size_t count, ckernel_prefix *DYND_UNUSED(ckp))
         {
             if (dst_stride == 0) {
-                Accum s = 0;
-                for (size_t i = 0; i < count; ++i) {
-                    s = s + *reinterpret_cast<const T *>(src);
-                    src += src_stride;
-                }
-                *reinterpret_cast<T *>(dst) = static_cast<T>(*reinterpret_cast<const T *>(dst) + s);
+                D *d = reinterpret_cast<D *>(dst);
+                *d = Op::store(reduce_strided<Op>(Op::load(*d), src, src_stride, count));
             } else {
                 for (size_t i = 0; i < count; ++i) {
-                    *reinterpret_cast<T *>(dst) = *reinterpret_cast<T *>(dst) + *reinterpret_cast<const T *>(src);
+                    D *d = reinterpret_cast<D *>(dst);
+                    *d = Op::store(Op::merge(Op::load(*d),
+                                    Op::first(*reinterpret_cast<const S *>(src))));
                     dst += dst_stride;
                     src += src_stride;
                 }
             }
         }
     };
+
+    /**
+     * A reduction kernel whose contiguous dst_stride == 0 case
+     * is handled by the SIMD loop `Simd::reduce`.
+     */
+    template<class Op, class Simd>
+    struct simd_reduction_kernel {
+        typedef typename Op::dst_type D;
+        typedef typename Op::src_type S;
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *ckp)
+        {
+            if (dst_stride == 0 && src_stride == (intptr_t)sizeof(S)) {
+                D *d = reinterpret_cast<D *>(dst);
+                *d = Op::store(Simd::reduce(Op::load(*d),
+                                reinterpret_cast<const S *>(src), count));
+            } else {
+                reduction_kernel<Op>::strided(dst, dst_stride, src, src_stride, count, ckp);
+            }
+        }
+    };
+
+#if defined(DYND_X86_SIMD)
+    struct sse2_sum_float64 {
+        static double reduce(double init, const double *src, size_t count)
+        {
+            __m128d s0 = _mm_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                s0 = _mm_add_pd(s0, _mm_loadu_pd(src + i));
+                s1 = _mm_add_pd(s1, _mm_loadu_pd(src + i + 2));
+                s2 = _mm_add_pd(s2, _mm_loadu_pd(src + i + 4));
+                s3 = _mm_add_pd(s3, _mm_loadu_pd(src + i + 6));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3)));
+            return reduce_strided<sum_op<double, double> >(
+                            init + (lanes[0] + lanes[1]),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(double), count - i);
+        }
+    };
+
+    struct sse2_sum_float32 {
+        static double reduce(double init, const float *src, size_t count)
+        {
+            __m128d s0 = _mm_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128 a = _mm_loadu_ps(src + i), b = _mm_loadu_ps(src + i + 4);
+                s0 = _mm_add_pd(s0, _mm_cvtps_pd(a));
+                s1 = _mm_add_pd(s1, _mm_cvtps_pd(_mm_movehl_ps(a, a)));
+                s2 = _mm_add_pd(s2, _mm_cvtps_pd(b));
+                s3 = _mm_add_pd(s3, _mm_cvtps_pd(_mm_movehl_ps(b, b)));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, _mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3)));
+            return reduce_strided<sum_op<float, double> >(
+                            init + (lanes[0] + lanes[1]),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(float), count - i);
+        }
+    };
+
+    // Integer sums wrap around, so signed and unsigned share the loop
+    template<class T>
+    struct sse2_sum_int32 {
+        static T reduce(T init, const T *src, size_t count)
+        {
+            __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                s0 = _mm_add_epi32(s0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+                s1 = _mm_add_epi32(s1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4)));
+                s2 = _mm_add_epi32(s2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8)));
+                s3 = _mm_add_epi32(s3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12)));
+            }
+            uint32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes),
+                            _mm_add_epi32(_mm_add_epi32(s0, s1), _mm_add_epi32(s2, s3)));
+            uint32_t total = static_cast<uint32_t>(init) + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            return reduce_strided<sum_op<T, T> >(static_cast<T>(total),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(T), count - i);
+        }
+    };
+
+    template<class T>
+    struct sse2_sum_int64 {
+        static T reduce(T init, const T *src, size_t count)
+        {
+            __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                s0 = _mm_add_epi64(s0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+                s1 = _mm_add_epi64(s1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 2)));
+                s2 = _mm_add_epi64(s2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4)));
+                s3 = _mm_add_epi64(s3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 6)));
+            }
+            uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes),
+                            _mm_add_epi64(_mm_add_epi64(s0, s1), _mm_add_epi64(s2, s3)));
+            uint64_t total = static_cast<uint64_t>(init) + lanes[0] + lanes[1];
+            return reduce_strided<sum_op<T, T> >(static_cast<T>(total),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(T), count - i);
+        }
+    };
+
+    // The min/max instructions don't propagate NaN, so NaN is
+    // tracked separately with an unordered comparison
+    template<bool IsMax>
+    struct sse2_minmax_float64 {
+        typedef typename select_type<IsMax, max_op<double, double>,
+                        min_op<double, double> >::type op;
+
+        static double reduce(double init, const double *src, size_t count)
+        {
+            size_t i = 0;
+            if (count >= 8) {
+                __m128d m0 = _mm_loadu_pd(src), m1 = _mm_loadu_pd(src + 2);
+                __m128d nan = _mm_or_pd(_mm_cmpunord_pd(m0, m0), _mm_cmpunord_pd(m1, m1));
+                for (i = 4; i + 4 <= count; i += 4) {
+                    __m128d x0 = _mm_loadu_pd(src + i), x1 = _mm_loadu_pd(src + i + 2);
+                    nan = _mm_or_pd(nan, _mm_or_pd(_mm_cmpunord_pd(x0, x0), _mm_cmpunord_pd(x1, x1)));
+                    m0 = IsMax ? _mm_max_pd(m0, x0) : _mm_min_pd(m0, x0);
+                    m1 = IsMax ? _mm_max_pd(m1, x1) : _mm_min_pd(m1, x1);
+                }
+                if (_mm_movemask_pd(nan) != 0) {
+                    return op::merge(init, numeric_limits<double>::quiet_NaN());
+                }
+                double lanes[2];
+                _mm_storeu_pd(lanes, IsMax ? _mm_max_pd(m0, m1) : _mm_min_pd(m0, m1));
+                init = op::merge(op::merge(init, lanes[0]), lanes[1]);
+            }
+            return reduce_strided<op>(init, reinterpret_cast<const char *>(src + i),
+                            sizeof(double), count - i);
+        }
+    };
+
+    template<bool IsMax>
+    struct sse2_minmax_float32 {
+        typedef typename select_type<IsMax, max_op<float, float>,
+                        min_op<float, float> >::type op;
+
+        static float reduce(float init, const float *src, size_t count)
+        {
+            size_t i = 0;
+            if (count >= 16) {
+                __m128 m0 = _mm_loadu_ps(src), m1 = _mm_loadu_ps(src + 4);
+                __m128 nan = _mm_or_ps(_mm_cmpunord_ps(m0, m0), _mm_cmpunord_ps(m1, m1));
+                for (i = 8; i + 8 <= count; i += 8) {
+                    __m128 x0 = _mm_loadu_ps(src + i), x1 = _mm_loadu_ps(src + i + 4);
+                    nan = _mm_or_ps(nan, _mm_or_ps(_mm_cmpunord_ps(x0, x0), _mm_cmpunord_ps(x1, x1)));
+                    m0 = IsMax ? _mm_max_ps(m0, x0) : _mm_min_ps(m0, x0);
+                    m1 = IsMax ? _mm_max_ps(m1, x1) : _mm_min_ps(m1, x1);
+                }
+                if (_mm_movemask_ps(nan) != 0) {
+                    return op::merge(init, numeric_limits<float>::quiet_NaN());
+                }
+                float lanes[4];
+                _mm_storeu_ps(lanes, IsMax ? _mm_max_ps(m0, m1) : _mm_min_ps(m0, m1));
+                for (int k = 0; k < 4; ++k) {
+                    init = op::merge(init, lanes[k]);
+                }
+            }
+            return reduce_strided<op>(init, reinterpret_cast<const char *>(src + i),
+                            sizeof(float), count - i);
+        }
+    };
+
+    // For one-byte types (bool, int8, uint8), counts the zero bytes
+    // in per-byte counters, which are flushed before they overflow
+    template<class T>
+    struct sse2_count_nonzero_int8 {
+        static int64_t reduce(int64_t init, const T *src, size_t count)
+        {
+            const char *p = reinterpret_cast<const char *>(src);
+            const __m128i zero = _mm_setzero_si128();
+            __m128i total = zero;
+            size_t i = 0, vec_end = count - count % 16;
+            while (i < vec_end) {
+                size_t block_end = (min)(vec_end, i + 255 * 16);
+                __m128i zeros = zero;
+                for (; i < block_end; i += 16) {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                    zeros = _mm_sub_epi8(zeros, _mm_cmpeq_epi8(x, zero));
+                }
+                total = _mm_add_epi64(total, _mm_sad_epu8(zeros, zero));
+            }
+            int64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), total);
+            return reduce_strided<count_nonzero_op<T> >(
+                            init + static_cast<int64_t>(i) - (lanes[0] + lanes[1]),
+                            p + i, 1, count - i);
+        }
+    };
+
+    template<class T>
+    struct sse2_any_int8 {
+        static bool reduce(bool init, const T *src, size_t count)
+        {
+            if (init) {
+                return true;
+            }
+            const char *p = reinterpret_cast<const char *>(src);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 64 <= count; i += 64) {
+                __m128i x = _mm_or_si128(
+                    _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 16))),
+                    _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 32)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 48))));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)) != 0xffff) {
+                    return true;
+                }
+            }
+            return reduce_strided<any_op<T> >(false, p + i, 1, count - i);
+        }
+    };
+
+    template<class T>
+    struct sse2_all_int8 {
+        static bool reduce(bool init, const T *src, size_t count)
+        {
+            if (!init) {
+                return false;
+            }
+            const char *p = reinterpret_cast<const char *>(src);
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 64 <= count; i += 64) {
+                // The unsigned byte minimum is zero iff some byte is zero
+                __m128i x = _mm_min_epu8(
+                    _mm_min_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 16))),
+                    _mm_min_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 32)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i + 48))));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero)) != 0) {
+                    return false;
+                }
+            }
+            return reduce_strided<all_op<T> >(true, p + i, 1, count - i);
+        }
+    };
+#endif // DYND_X86_SIMD
+
+#if defined(DYND_X86_AVX2)
+    struct avx2_sum_float64 {
+        DYND_AVX2_TARGET static double reduce(double init, const double *src, size_t count)
+        {
+            __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                s0 = _mm256_add_pd(s0, _mm256_loadu_pd(src + i));
+                s1 = _mm256_add_pd(s1, _mm256_loadu_pd(src + i + 4));
+                s2 = _mm256_add_pd(s2, _mm256_loadu_pd(src + i + 8));
+                s3 = _mm256_add_pd(s3, _mm256_loadu_pd(src + i + 12));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+            return reduce_strided<sum_op<double, double> >(
+                            init + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(double), count - i);
+        }
+    };
+
+    struct avx2_sum_float32 {
+        DYND_AVX2_TARGET static double reduce(double init, const float *src, size_t count)
+        {
+            __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                s0 = _mm256_add_pd(s0, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+                s1 = _mm256_add_pd(s1, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+                s2 = _mm256_add_pd(s2, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 8)));
+                s3 = _mm256_add_pd(s3, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 12)));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+            return reduce_strided<sum_op<float, double> >(
+                            init + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(float), count - i);
+        }
+    };
+
+    template<class T>
+    struct avx2_sum_int32 {
+        DYND_AVX2_TARGET static T reduce(T init, const T *src, size_t count)
+        {
+            __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                s0 = _mm256_add_epi32(s0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+                s1 = _mm256_add_epi32(s1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 8)));
+                s2 = _mm256_add_epi32(s2, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 16)));
+                s3 = _mm256_add_epi32(s3, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 24)));
+            }
+            uint32_t lanes[8];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes),
+                            _mm256_add_epi32(_mm256_add_epi32(s0, s1), _mm256_add_epi32(s2, s3)));
+            uint32_t total = static_cast<uint32_t>(init);
+            for (int k = 0; k < 8; ++k) {
+                total += lanes[k];
+            }
+            return reduce_strided<sum_op<T, T> >(static_cast<T>(total),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(T), count - i);
+        }
+    };
+
+    template<class T>
+    struct avx2_sum_int64 {
+        DYND_AVX2_TARGET static T reduce(T init, const T *src, size_t count)
+        {
+            __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                s0 = _mm256_add_epi64(s0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+                s1 = _mm256_add_epi64(s1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 4)));
+                s2 = _mm256_add_epi64(s2, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 8)));
+                s3 = _mm256_add_epi64(s3, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 12)));
+            }
+            uint64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes),
+                            _mm256_add_epi64(_mm256_add_epi64(s0, s1), _mm256_add_epi64(s2, s3)));
+            uint64_t total = static_cast<uint64_t>(init) + lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            return reduce_strided<sum_op<T, T> >(static_cast<T>(total),
+                            reinterpret_cast<const char *>(src + i),
+                            sizeof(T), count - i);
+        }
+    };
+
+    template<bool IsMax>
+    struct avx2_minmax_float64 {
+        typedef typename select_type<IsMax, max_op<double, double>,
+                        min_op<double, double> >::type op;
+
+        DYND_AVX2_TARGET static double reduce(double init, const double *src, size_t count)
+        {
+            size_t i = 0;
+            if (count >= 16) {
+                __m256d m0 = _mm256_loadu_pd(src), m1 = _mm256_loadu_pd(src + 4);
+                __m256d nan = _mm256_or_pd(_mm256_cmp_pd(m0, m0, _CMP_UNORD_Q),
+                                _mm256_cmp_pd(m1, m1, _CMP_UNORD_Q));
+                for (i = 8; i + 8 <= count; i += 8) {
+                    __m256d x0 = _mm256_loadu_pd(src + i), x1 = _mm256_loadu_pd(src + i + 4);
+                    nan = _mm256_or_pd(nan, _mm256_or_pd(_mm256_cmp_pd(x0, x0, _CMP_UNORD_Q),
+                                    _mm256_cmp_pd(x1, x1, _CMP_UNORD_Q)));
+                    m0 = IsMax ? _mm256_max_pd(m0, x0) : _mm256_min_pd(m0, x0);
+                    m1 = IsMax ? _mm256_max_pd(m1, x1) : _mm256_min_pd(m1, x1);
+                }
+                if (_mm256_movemask_pd(nan) != 0) {
+                    return op::merge(init, numeric_limits<double>::quiet_NaN());
+                }
+                double lanes[4];
+                _mm256_storeu_pd(lanes, IsMax ? _mm256_max_pd(m0, m1) : _mm256_min_pd(m0, m1));
+                for (int k = 0; k < 4; ++k) {
+                    init = op::merge(init, lanes[k]);
+                }
+            }
+            return reduce_strided<op>(init, reinterpret_cast<const char *>(src + i),
+                            sizeof(double), count - i);
+        }
+    };
+
+    template<bool IsMax>
+    struct avx2_minmax_float32 {
+        typedef typename select_type<IsMax, max_op<float, float>,
+                        min_op<float, float> >::type op;
+
+        DYND_AVX2_TARGET static float reduce(float init, const float *src, size_t count)
+        {
+            size_t i = 0;
+            if (count >= 32) {
+                __m256 m0 = _mm256_loadu_ps(src), m1 = _mm256_loadu_ps(src + 8);
+                __m256 nan = _mm256_or_ps(_mm256_cmp_ps(m0, m0, _CMP_UNORD_Q),
+                                _mm256_cmp_ps(m1, m1, _CMP_UNORD_Q));
+                for (i = 16; i + 16 <= count; i += 16) {
+                    __m256 x0 = _mm256_loadu_ps(src + i), x1 = _mm256_loadu_ps(src + i + 8);
+                    nan = _mm256_or_ps(nan, _mm256_or_ps(_mm256_cmp_ps(x0, x0, _CMP_UNORD_Q),
+                                    _mm256_cmp_ps(x1, x1, _CMP_UNORD_Q)));
+                    m0 = IsMax ? _mm256_max_ps(m0, x0) : _mm256_min_ps(m0, x0);
+                    m1 = IsMax ? _mm256_max_ps(m1, x1) : _mm256_min_ps(m1, x1);
+                }
+                if (_mm256_movemask_ps(nan) != 0) {
+                    return op::merge(init, numeric_limits<float>::quiet_NaN());
+                }
+                float lanes[8];
+                _mm256_storeu_ps(lanes, IsMax ? _mm256_max_ps(m0, m1) : _mm256_min_ps(m0, m1));
+                for (int k = 0; k < 8; ++k) {
+                    init = op::merge(init, lanes[k]);
+                }
+            }
+            return reduce_strided<op>(init, reinterpret_cast<const char *>(src + i),
+                            sizeof(float), count - i);
+        }
+    };
+
+    template<class T, bool IsMax>
+    struct avx2_minmax_int32 {
+        typedef typename select_type<IsMax, max_op<T, T>, min_op<T, T> >::type op;
+
+        DYND_AVX2_TARGET static inline __m256i minmax(__m256i a, __m256i b)
+        {
+            if (numeric_limits<T>::is_signed) {
+                return IsMax ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+            } else {
+                return IsMax ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+            }
+        }
+
+        DYND_AVX2_TARGET static T reduce(T init, const T *src, size_t count)
+        {
+            size_t i = 0;
+            if (count >= 32) {
+                __m256i m0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+                __m256i m1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 8));
+                for (i = 16; i + 16 <= count; i += 16) {
+                    m0 = minmax(m0, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)));
+                    m1 = minmax(m1, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 8)));
+                }
+                T lanes[8];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), minmax(m0, m1));
+                for (int k = 0; k < 8; ++k) {
+                    init = op::merge(init, lanes[k]);
+                }
+            }
+            return reduce_strided<op>(init, reinterpret_cast<const char *>(src + i),
+                            sizeof(T), count - i);
+        }
+    };
+
+    template<class T>
+    struct avx2_count_nonzero_int8 {
+        DYND_AVX2_TARGET static int64_t reduce(int64_t init, const T *src, size_t count)
+        {
+            const char *p = reinterpret_cast<const char *>(src);
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i total = zero;
+            size_t i = 0, vec_end = count - count % 32;
+            while (i < vec_end) {
+                size_t block_end = (min)(vec_end, i + 255 * 32);
+                __m256i zeros = zero;
+                for (; i < block_end; i += 32) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                    zeros = _mm256_sub_epi8(zeros, _mm256_cmpeq_epi8(x, zero));
+                }
+                total = _mm256_add_epi64(total, _mm256_sad_epu8(zeros, zero));
+            }
+            int64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+            return reduce_strided<count_nonzero_op<T> >(
+                            init + static_cast<int64_t>(i) -
+                                ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])),
+                            p + i, 1, count - i);
+        }
+    };
+#endif // DYND_X86_AVX2
+
+    template<class Op>
+    void set_reduction_function(ckernel_prefix *ckp, kernel_request_t kerntype)
+    {
+        if (kerntype == kernel_request_single) {
+            ckp->set_function<unary_single_operation_t>(&reduction_kernel<Op>::single);
+        } else if (kerntype == kernel_request_strided) {
+            ckp->set_function<unary_strided_operation_t>(&reduction_kernel<Op>::strided);
+        } else {
+            throw runtime_error("unsupported kernel request in make_builtin_reduction_ckernel");
+        }
+    }
+
+    template<class Op, class Simd>
+    void set_simd_reduction_function(ckernel_prefix *ckp, kernel_request_t kerntype)
+    {
+        if (kerntype == kernel_request_strided) {
+            ckp->set_function<unary_strided_operation_t>(&simd_reduction_kernel<Op, Simd>::strided);
+        } else {
+            set_reduction_function<Op>(ckp, kerntype);
+        }
+    }
 } // anonymous namespace
 
+// Within the set_*_function functions below, these macros pick a SIMD
+// variant of the kernel if the CPU supports it. `Op` and `Simd` must
+// be typedefs, so they don't contain commas.
+#if defined(DYND_X86_AVX2)
+# define DYND_TRY_AVX2_REDUCTION(Op, Simd) \
+    if (cpu_has_avx2()) { \
+        set_simd_reduction_function<Op, Simd>(ckp, kerntype); \
+        return true; \
+    }
+#else
+# define DYND_TRY_AVX2_REDUCTION(Op, Simd)
+#endif
+#if defined(DYND_X86_SIMD)
+# define DYND_TRY_SSE2_REDUCTION(Op, Simd) \
+    if (cpu_has_sse2()) { \
+        set_simd_reduction_function<Op, Simd>(ckp, kerntype); \
+        return true; \
+    }
+#else
+# define DYND_TRY_SSE2_REDUCTION(Op, Simd)
+#endif
 
-intptr_t kernels::make_builtin_sum_reduction_ckernel(
+static bool set_sum_function(ckernel_prefix *ckp, type_id_t tid, kernel_request_t kerntype)
+{
+    switch (tid) {
+        case int8_type_id:
+            set_reduction_function<sum_op<int8_t, int8_t> >(ckp, kerntype);
+            return true;
+        case int16_type_id:
+            set_reduction_function<sum_op<int16_t, int16_t> >(ckp, kerntype);
+            return true;
+        case int32_type_id: {
+            typedef sum_op<int32_t, int32_t> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_int32<int32_t> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_int32<int32_t> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int64_type_id: {
+            typedef sum_op<int64_t, int64_t> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_int64<int64_t> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_int64<int64_t> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int128_type_id:
+            set_reduction_function<sum_op<dynd_int128, dynd_int128> >(ckp, kerntype);
+            return true;
+        case uint8_type_id:
+            set_reduction_function<sum_op<uint8_t, uint8_t> >(ckp, kerntype);
+            return true;
+        case uint16_type_id:
+            set_reduction_function<sum_op<uint16_t, uint16_t> >(ckp, kerntype);
+            return true;
+        case uint32_type_id: {
+            typedef sum_op<uint32_t, uint32_t> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_int32<uint32_t> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_int32<uint32_t> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint64_type_id: {
+            typedef sum_op<uint64_t, uint64_t> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_int64<uint64_t> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_int64<uint64_t> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint128_type_id:
+            set_reduction_function<sum_op<dynd_uint128, dynd_uint128> >(ckp, kerntype);
+            return true;
+        case float16_type_id:
+            // Accumulate float16 as float32
+            set_reduction_function<sum_op<dynd_float16, float> >(ckp, kerntype);
+            return true;
+        case float32_type_id: {
+            // For float32, use float64 as the accumulator for a touch more accuracy
+            typedef sum_op<float, double> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_float32 sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_float32 avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case float64_type_id: {
+            typedef sum_op<double, double> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_sum_float64 sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_sum_float64 avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case complex_float32_type_id:
+            set_reduction_function<sum_op<dynd_complex<float>, dynd_complex<double> > >(ckp, kerntype);
+            return true;
+        case complex_float64_type_id:
+            set_reduction_function<sum_op<dynd_complex<double>, dynd_complex<double> > >(ckp, kerntype);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool set_prod_function(ckernel_prefix *ckp, type_id_t tid, kernel_request_t kerntype)
+{
+    switch (tid) {
+        case int8_type_id:
+            set_reduction_function<prod_op<int8_t, int8_t> >(ckp, kerntype);
+            return true;
+        case int16_type_id:
+            set_reduction_function<prod_op<int16_t, int16_t> >(ckp, kerntype);
+            return true;
+        case int32_type_id:
+            set_reduction_function<prod_op<int32_t, int32_t> >(ckp, kerntype);
+            return true;
+        case int64_type_id:
+            set_reduction_function<prod_op<int64_t, int64_t> >(ckp, kerntype);
+            return true;
+        case uint8_type_id:
+            set_reduction_function<prod_op<uint8_t, uint32_t> >(ckp, kerntype);
+            return true;
+        case uint16_type_id:
+            // Accumulate unsigned types narrower than int as uint32, so
+            // the multiplication doesn't promote to a signed int
+            set_reduction_function<prod_op<uint16_t, uint32_t> >(ckp, kerntype);
+            return true;
+        case uint32_type_id:
+            set_reduction_function<prod_op<uint32_t, uint32_t> >(ckp, kerntype);
+            return true;
+        case uint64_type_id:
+            set_reduction_function<prod_op<uint64_t, uint64_t> >(ckp, kerntype);
+            return true;
+        case float16_type_id:
+            set_reduction_function<prod_op<dynd_float16, float> >(ckp, kerntype);
+            return true;
+        case float32_type_id:
+            set_reduction_function<prod_op<float, double> >(ckp, kerntype);
+            return true;
+        case float64_type_id:
+            set_reduction_function<prod_op<double, double> >(ckp, kerntype);
+            return true;
+        case complex_float32_type_id:
+            set_reduction_function<prod_op<dynd_complex<float>, dynd_complex<double> > >(ckp, kerntype);
+            return true;
+        case complex_float64_type_id:
+            set_reduction_function<prod_op<dynd_complex<double>, dynd_complex<double> > >(ckp, kerntype);
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<bool IsMax>
+static bool set_minmax_function(ckernel_prefix *ckp, type_id_t tid, kernel_request_t kerntype)
+{
+#define DYND_MINMAX_OP(T, Accum) \
+    typename select_type<IsMax, max_op<T, Accum>, min_op<T, Accum> >::type
+    switch (tid) {
+        case bool_type_id: {
+            typedef DYND_MINMAX_OP(dynd_bool, bool) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int8_type_id: {
+            typedef DYND_MINMAX_OP(int8_t, int8_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int16_type_id: {
+            typedef DYND_MINMAX_OP(int16_t, int16_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int32_type_id: {
+            typedef DYND_MINMAX_OP(int32_t, int32_t) op;
+#if defined(DYND_X86_AVX2)
+            typedef avx2_minmax_int32<int32_t, IsMax> avx2_simd;
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int64_type_id: {
+            typedef DYND_MINMAX_OP(int64_t, int64_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case int128_type_id: {
+            typedef DYND_MINMAX_OP(dynd_int128, dynd_int128) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint8_type_id: {
+            typedef DYND_MINMAX_OP(uint8_t, uint8_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint16_type_id: {
+            typedef DYND_MINMAX_OP(uint16_t, uint16_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint32_type_id: {
+            typedef DYND_MINMAX_OP(uint32_t, uint32_t) op;
+#if defined(DYND_X86_AVX2)
+            typedef avx2_minmax_int32<uint32_t, IsMax> avx2_simd;
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint64_type_id: {
+            typedef DYND_MINMAX_OP(uint64_t, uint64_t) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case uint128_type_id: {
+            typedef DYND_MINMAX_OP(dynd_uint128, dynd_uint128) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case float16_type_id: {
+            // Compare float16 as float32, which also handles NaN
+            typedef DYND_MINMAX_OP(dynd_float16, float) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case float32_type_id: {
+            typedef DYND_MINMAX_OP(float, float) op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_minmax_float32<IsMax> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_minmax_float32<IsMax> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case float64_type_id: {
+            typedef DYND_MINMAX_OP(double, double) op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_minmax_float64<IsMax> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_minmax_float64<IsMax> avx2_simd;
+# endif
+#endif
+            DYND_TRY_AVX2_REDUCTION(op, avx2_simd);
+            DYND_TRY_SSE2_REDUCTION(op, sse2_simd);
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        case float128_type_id: {
+            typedef DYND_MINMAX_OP(dynd_float128, dynd_float128) op;
+            set_reduction_function<op>(ckp, kerntype);
+            return true;
+        }
+        default:
+            return false;
+    }
+#undef DYND_MINMAX_OP
+}
+
+/**
+ * Sets the function for one of the any/all/count_nonzero
+ * reductions, all of which accept any builtin type.
+ */
+template<template<class> class Op>
+static bool set_nonzero_function(ckernel_prefix *ckp, type_id_t tid, kernel_request_t kerntype)
+{
+    switch (tid) {
+        case bool_type_id:
+            set_reduction_function<Op<dynd_bool> >(ckp, kerntype);
+            return true;
+        case int8_type_id:
+            set_reduction_function<Op<int8_t> >(ckp, kerntype);
+            return true;
+        case int16_type_id:
+            set_reduction_function<Op<int16_t> >(ckp, kerntype);
+            return true;
+        case int32_type_id:
+            set_reduction_function<Op<int32_t> >(ckp, kerntype);
+            return true;
+        case int64_type_id:
+            set_reduction_function<Op<int64_t> >(ckp, kerntype);
+            return true;
+        case int128_type_id:
+            set_reduction_function<Op<dynd_int128> >(ckp, kerntype);
+            return true;
+        case uint8_type_id:
+            set_reduction_function<Op<uint8_t> >(ckp, kerntype);
+            return true;
+        case uint16_type_id:
+            set_reduction_function<Op<uint16_t> >(ckp, kerntype);
+            return true;
+        case uint32_type_id:
+            set_reduction_function<Op<uint32_t> >(ckp, kerntype);
+            return true;
+        case uint64_type_id:
+            set_reduction_function<Op<uint64_t> >(ckp, kerntype);
+            return true;
+        case uint128_type_id:
+            set_reduction_function<Op<dynd_uint128> >(ckp, kerntype);
+            return true;
+        case float16_type_id:
+            set_reduction_function<Op<dynd_float16> >(ckp, kerntype);
+            return true;
+        case float32_type_id:
+            set_reduction_function<Op<float> >(ckp, kerntype);
+            return true;
+        case float64_type_id:
+            set_reduction_function<Op<double> >(ckp, kerntype);
+            return true;
+        case float128_type_id:
+            set_reduction_function<Op<dynd_float128> >(ckp, kerntype);
+            return true;
+        case complex_float32_type_id:
+            set_reduction_function<Op<dynd_complex<float> > >(ckp, kerntype);
+            return true;
+        case complex_float64_type_id:
+            set_reduction_function<Op<dynd_complex<double> > >(ckp, kerntype);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * The one-byte types get SIMD loops for any/all/count_nonzero.
+ */
+template<class T>
+static void set_int8_nonzero_function(ckernel_prefix *ckp, kernels::builtin_reduction_t op,
+                kernel_request_t kerntype)
+{
+    switch (op) {
+        case kernels::builtin_reduction_any: {
+            typedef any_op<T> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_any_int8<T> sse2_simd;
+            if (cpu_has_sse2()) {
+                set_simd_reduction_function<op, sse2_simd>(ckp, kerntype);
+                return;
+            }
+#endif
+            set_reduction_function<op>(ckp, kerntype);
+            return;
+        }
+        case kernels::builtin_reduction_all: {
+            typedef all_op<T> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_all_int8<T> sse2_simd;
+            if (cpu_has_sse2()) {
+                set_simd_reduction_function<op, sse2_simd>(ckp, kerntype);
+                return;
+            }
+#endif
+            set_reduction_function<op>(ckp, kerntype);
+            return;
+        }
+        default: {
+            typedef count_nonzero_op<T> op;
+#if defined(DYND_X86_SIMD)
+            typedef sse2_count_nonzero_int8<T> sse2_simd;
+# if defined(DYND_X86_AVX2)
+            typedef avx2_count_nonzero_int8<T> avx2_simd;
+            if (cpu_has_avx2()) {
+                set_simd_reduction_function<op, avx2_simd>(ckp, kerntype);
+                return;
+            }
+# endif
+            if (cpu_has_sse2()) {
+                set_simd_reduction_function<op, sse2_simd>(ckp, kerntype);
+                return;
+            }
+#endif
+            set_reduction_function<op>(ckp, kerntype);
+            return;
+        }
+    }
+}
+
+#undef DYND_TRY_AVX2_REDUCTION
+#undef DYND_TRY_SSE2_REDUCTION
+
+static const char *builtin_reduction_name(kernels::builtin_reduction_t op)
+{
+    switch (op) {
+        case kernels::builtin_reduction_sum:
+            return "sum";
+        case kernels::builtin_reduction_prod:
+            return "prod";
+        case kernels::builtin_reduction_min:
+            return "min";
+        case kernels::builtin_reduction_max:
+            return "max";
+        case kernels::builtin_reduction_any:
+            return "any";
+        case kernels::builtin_reduction_all:
+            return "all";
+        case kernels::builtin_reduction_count_nonzero:
+            return "count_nonzero";
+        default:
+            return "<invalid>";
+    }
+}
+
+intptr_t kernels::make_builtin_reduction_ckernel(
                 dynd::ckernel_builder *out_ckb, intptr_t ckb_offset,
-                type_id_t tid,
+                builtin_reduction_t op, type_id_t tid,
                 kernel_request_t kerntype)
 {
     ckernel_prefix *ckp = out_ckb->get_at<ckernel_prefix>(ckb_offset);
-    if (kerntype == kernel_request_single) {
-        switch (tid) {
-            case int32_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<int32_t, int32_t>::single);
-                break;
-            case int64_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<int64_t, int64_t>::single);
-                break;
-            case float32_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<float, double>::single);
-                break;
-            case float64_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<double, double>::single);
-                break;
-            case complex_float32_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<dynd_complex<float>, dynd_complex<double> >::single);
-                break;
-            case complex_float64_type_id:
-                ckp->set_function<unary_single_operation_t>(&sum_reduction<dynd_complex<double>, dynd_complex<double> >::single);
-                break;
-            default: {
-                stringstream ss;
-                ss << "make_builtin_sum_reduction_ckernel: data type ";
-                ss << ndt::type(tid) << " is not supported";
-                throw type_error(ss.str());
-            }
-        }
-    } else if (kerntype == kernel_request_strided) {
-        switch (tid) {
-            case int32_type_id:
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<int32_t, int32_t>::strided);
-                break;
-            case int64_type_id:
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<int64_t, int64_t>::strided);
-                break;
-            case float32_type_id:
-                // For float32, use float64 as the accumulator in the strided loop for a touch more accuracy
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<float, double>::strided);
-                break;
-            case float64_type_id:
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<double, double>::strided);
-                break;
-            case complex_float32_type_id:
-                // For float32, use float64 as the accumulator in the strided loop for a touch more accuracy
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<dynd_complex<float>, dynd_complex<double> >::strided);
-                break;
-            case complex_float64_type_id:
-                ckp->set_function<unary_strided_operation_t>(&sum_reduction<dynd_complex<double>, dynd_complex<double> >::strided);
-                break;
-            default: {
-                stringstream ss;
-                ss << "make_builtin_sum_reduction_ckernel: data type ";
-                ss << ndt::type(tid) << " is not supported";
-                throw type_error(ss.str());
-            }
-        }
-    } else {
-        throw runtime_error("unsupported kernel request in make_builtin_sum_reduction_ckernel");
+    bool supported = false;
+    switch (op) {
+        case builtin_reduction_sum:
+            supported = set_sum_function(ckp, tid, kerntype);
+            break;
+        case builtin_reduction_prod:
+            supported = set_prod_function(ckp, tid, kerntype);
+            break;
+        case builtin_reduction_min:
+            supported = set_minmax_function<false>(ckp, tid, kerntype);
+            break;
+        case builtin_reduction_max:
+            supported = set_minmax_function<true>(ckp, tid, kerntype);
+            break;
+        case builtin_reduction_any:
+        case builtin_reduction_all:
+        case builtin_reduction_count_nonzero:
+            if (tid == bool_type_id) {
+                set_int8_nonzero_function<dynd_bool>(ckp, op, kerntype);
+                supported = true;
+            } else if (tid == int8_type_id) {
+                set_int8_nonzero_function<int8_t>(ckp, op, kerntype);
+                supported = true;
+            } else if (tid == uint8_type_id) {
+                set_int8_nonzero_function<uint8_t>(ckp, op, kerntype);
+                supported = true;
+            } else if (op == builtin_reduction_any) {
+                supported = set_nonzero_function<any_op>(ckp, tid, kerntype);
+            } else if (op == builtin_reduction_all) {
+                supported = set_nonzero_function<all_op>(ckp, tid, kerntype);
+            } else {
+                supported = set_nonzero_function<count_nonzero_op>(ckp, tid, kerntype);
+            }
+            break;
+        default:
+            break;
+    }
+    if (!supported) {
+        stringstream ss;
+        ss << "make_builtin_reduction_ckernel: " << builtin_reduction_name(op);
+        ss << " of data type " << ndt::type(tid) << " is not supported";
+        throw type_error(ss.str());
     }
 
     return ckb_offset + sizeof(ckernel_prefix);
 }
 
-static intptr_t instantiate_builtin_sum_reduction_ckernel_deferred(
+namespace {
+    /**
+     * Pairwise summation of a strided array. Blocks of up to
+     * pairwise_sum_block_size elements are added with eight
+     * independent accumulators, and the blocks are combined
+     * as a binary tree.
+     */
+    enum { pairwise_sum_block_size = 128 };
+
+    template<class T, class Accum>
+    Accum pairwise_sum(const char *src, intptr_t src_stride, size_t count)
+    {
+        if (count < 8) {
+            Accum s = 0;
+            for (size_t i = 0; i < count; ++i) {
+                s = s + static_cast<Accum>(*reinterpret_cast<const T *>(src));
+                src += src_stride;
+            }
+            return s;
+        } else if (count <= pairwise_sum_block_size) {
+            Accum r[8];
+            for (int k = 0; k < 8; ++k) {
+                r[k] = static_cast<Accum>(*reinterpret_cast<const T *>(src + k * src_stride));
+            }
+            size_t i = 8;
+            src += 8 * src_stride;
+            for (; i + 8 <= count; i += 8) {
+                for (int k = 0; k < 8; ++k) {
+                    r[k] = r[k] + static_cast<Accum>(*reinterpret_cast<const T *>(src + k * src_stride));
+                }
+                src += 8 * src_stride;
+            }
+            Accum s = ((r[0] + r[1]) + (r[2] + r[3])) + ((r[4] + r[5]) + (r[6] + r[7]));
+            for (; i < count; ++i) {
+                s = s + static_cast<Accum>(*reinterpret_cast<const T *>(src));
+                src += src_stride;
+            }
+            return s;
+        } else {
+            // Split at a multiple of 8 so the blocks stay unrolled
+            size_t half = count / 2;
+            half -= half % 8;
+            return pairwise_sum<T, Accum>(src, src_stride, half) +
+                   pairwise_sum<T, Accum>(src + half * src_stride, src_stride, count - half);
+        }
+    }
+
+    /**
+     * Neumaier's compensated summation, which also handles
+     * an added value larger than the running sum. Once the sum
+     * is inf or NaN, the compensation is left alone, so it
+     * doesn't turn an inf result into NaN.
+     */
+    struct compensated_sum {
+        double sum, compensation;
+
+        compensated_sum(double init)
+            : sum(init), compensation(0)
+        {
+        }
+
+        inline void add(double x) {
+            double t = sum + x;
+            if (isfinite(t)) {
+                if (fabs(sum) >= fabs(x)) {
+                    compensation += (sum - t) + x;
+                } else {
+                    compensation += (x - t) + sum;
+                }
+            }
+            sum = t;
+        }
+
+        inline double result() const {
+            return isfinite(sum) ? sum + compensation : sum;
+        }
+    };
+
+    template<class T, class Accum>
+    struct kahan_sum {
+        static Accum sum(Accum init, const char *src, intptr_t src_stride, size_t count)
+        {
+            compensated_sum s(init);
+            for (size_t i = 0; i < count; ++i) {
+                s.add(static_cast<double>(*reinterpret_cast<const T *>(src)));
+                src += src_stride;
+            }
+            return static_cast<Accum>(s.result());
+        }
+    };
+
+    // Complex values are compensated per component
+    template<class T>
+    struct kahan_sum<dynd_complex<T>, dynd_complex<double> > {
+        static dynd_complex<double> sum(dynd_complex<double> init,
+                        const char *src, intptr_t src_stride, size_t count)
+        {
+            compensated_sum re(init.real()), im(init.imag());
+            for (size_t i = 0; i < count; ++i) {
+                const dynd_complex<T>& v = *reinterpret_cast<const dynd_complex<T> *>(src);
+                re.add(v.real());
+                im.add(v.imag());
+                src += src_stride;
+            }
+            return dynd_complex<double>(re.result(), im.result());
+        }
+    };
+
+    template<class T, class Accum>
+    struct pairwise_sum_kernel {
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *ckp)
+        {
+            if (dst_stride == 0) {
+                T *d = reinterpret_cast<T *>(dst);
+                *d = static_cast<T>(static_cast<Accum>(*d) +
+                                pairwise_sum<T, Accum>(src, src_stride, count));
+            } else {
+                reduction_kernel<sum_op<T, Accum> >::strided(dst, dst_stride,
+                                src, src_stride, count, ckp);
+            }
+        }
+    };
+
+    template<class T, class Accum>
+    struct kahan_sum_kernel {
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *ckp)
+        {
+            if (dst_stride == 0) {
+                T *d = reinterpret_cast<T *>(dst);
+                *d = static_cast<T>(kahan_sum<T, Accum>::sum(static_cast<Accum>(*d),
+                                src, src_stride, count));
+            } else {
+                reduction_kernel<sum_op<T, Accum> >::strided(dst, dst_stride,
+                                src, src_stride, count, ckp);
+            }
+        }
+    };
+
+    template<class T, class Accum>
+    void set_sum_algorithm_function(ckernel_prefix *ckp, kernel_request_t kerntype,
+                    kernels::sum_algorithm_t algorithm)
+    {
+        if (kerntype == kernel_request_strided) {
+            if (algorithm == kernels::sum_algorithm_pairwise) {
+                ckp->set_function<unary_strided_operation_t>(&pairwise_sum_kernel<T, Accum>::strided);
+            } else {
+                ckp->set_function<unary_strided_operation_t>(&kahan_sum_kernel<T, Accum>::strided);
+            }
+        } else {
+            // A single addition has nothing to compensate
+            set_reduction_function<sum_op<T, Accum> >(ckp, kerntype);
+        }
+    }
+} // anonymous namespace
+
+intptr_t kernels::make_builtin_sum_reduction_ckernel(
+                dynd::ckernel_builder *out_ckb, intptr_t ckb_offset,
+                type_id_t tid,
+                kernel_request_t kerntype,
+                sum_algorithm_t algorithm)
+{
+    if (algorithm != sum_algorithm_pairwise && algorithm != sum_algorithm_kahan) {
+        if (algorithm != sum_algorithm_default) {
+            stringstream ss;
+            ss << "make_builtin_sum_reduction_ckernel: invalid summation algorithm " << (int)algorithm;
+            throw runtime_error(ss.str());
+        }
+        return make_builtin_reduction_ckernel(out_ckb, ckb_offset,
+                        builtin_reduction_sum, tid, kerntype);
+    }
+
+    ckernel_prefix *ckp = out_ckb->get_at<ckernel_prefix>(ckb_offset);
+    switch (tid) {
+        case float16_type_id:
+            set_sum_algorithm_function<dynd_float16, float>(ckp, kerntype, algorithm);
+            break;
+        case float32_type_id:
+            set_sum_algorithm_function<float, double>(ckp, kerntype, algorithm);
+            break;
+        case float64_type_id:
+            set_sum_algorithm_function<double, double>(ckp, kerntype, algorithm);
+            break;
+        case complex_float32_type_id:
+            set_sum_algorithm_function<dynd_complex<float>, dynd_complex<double> >(
+                            ckp, kerntype, algorithm);
+            break;
+        case complex_float64_type_id:
+            set_sum_algorithm_function<dynd_complex<double>, dynd_complex<double> >(
+                            ckp, kerntype, algorithm);
+            break;
+        default:
+            // Other types sum exactly, or aren't supported
+            return make_builtin_reduction_ckernel(out_ckb, ckb_offset,
+                            builtin_reduction_sum, tid, kerntype);
+    }
+    return ckb_offset + sizeof(ckernel_prefix);
+}
+
+static intptr_t instantiate_builtin_reduction_ckernel_deferred(
     void *self_data_ptr, dynd::ckernel_builder *out_ckb, intptr_t ckb_offset,
     const char *const *DYND_UNUSED(dynd_metadata), uint32_t kerntype,
     const eval::eval_context *DYND_UNUSED(ectx))
 {
-    type_id_t tid = static_cast<type_id_t>(reinterpret_cast<uintptr_t>(self_data_ptr));
-    return kernels::make_builtin_sum_reduction_ckernel(out_ckb, ckb_offset, tid, (kernel_request_t)kerntype);
+    // The op and the type id are packed into the data pointer
+    uintptr_t packed = reinterpret_cast<uintptr_t>(self_data_ptr);
+    kernels::builtin_reduction_t op = static_cast<kernels::builtin_reduction_t>(packed >> 8);
+    type_id_t tid = static_cast<type_id_t>(packed & 0xff);
+    return kernels::make_builtin_reduction_ckernel(out_ckb, ckb_offset, op, tid,
+                    (kernel_request_t)kerntype);
 }
 
-void kernels::make_builtin_sum_reduction_ckernel_deferred(
+void kernels::make_builtin_reduction_ckernel_deferred(
                 ckernel_deferred *out_ckd,
-                type_id_t tid)
+                builtin_reduction_t op, type_id_t tid)
 {
     if (tid < 0 || tid >= builtin_type_id_count) {
         stringstream ss;
-        ss << "make_builtin_sum_reduction_ckernel: data type ";
-        ss << ndt::type(tid) << " is not supported";
+        ss << "make_builtin_reduction_ckernel_deferred: " << builtin_reduction_name(op);
+        ss << " of data type " << ndt::type(tid) << " is not supported";
         throw type_error(ss.str());
     }
+    // Raise the error for unsupported combinations here instead
+    // of at instantiation
+    ckernel_builder ckb;
+    make_builtin_reduction_ckernel(&ckb, 0, op, tid, kernel_request_single);
+
     out_ckd->ckernel_funcproto = unary_operation_funcproto;
     out_ckd->data_types_size = 2;
-    out_ckd->data_dynd_types = builtin_type_pairs[tid];
-    out_ckd->data_ptr = reinterpret_cast<void *>(tid);
-    out_ckd->instantiate_func = &instantiate_builtin_sum_reduction_ckernel_deferred;
+    switch (op) {
+        case builtin_reduction_any:
+        case builtin_reduction_all:
+            out_ckd->data_dynd_types = bool_builtin_type_pairs[tid];
+            break;
+        case builtin_reduction_count_nonzero:
+            out_ckd->data_dynd_types = int64_builtin_type_pairs[tid];
+            break;
+        default:
+            out_ckd->data_dynd_types = builtin_type_pairs[tid];
+            break;
+    }
+    out_ckd->data_ptr = reinterpret_cast<void *>((static_cast<uintptr_t>(op) << 8) |
+                    static_cast<uintptr_t>(tid));
+    out_ckd->instantiate_func = &instantiate_builtin_reduction_ckernel_deferred;
     out_ckd->free_func = NULL;
 }
+
+static intptr_t instantiate_builtin_sum_reduction_ckernel_deferred(
+    void *self_data_ptr, dynd::ckernel_builder *out_ckb, intptr_t ckb_offset,
+    const char *const *DYND_UNUSED(dynd_metadata), uint32_t kerntype,
+    const eval::eval_context *DYND_UNUSED(ectx))
+{
+    // The algorithm and the type id are packed into the data pointer
+    uintptr_t packed = reinterpret_cast<uintptr_t>(self_data_ptr);
+    kernels::sum_algorithm_t algorithm = static_cast<kernels::sum_algorithm_t>(packed >> 8);
+    type_id_t tid = static_cast<type_id_t>(packed & 0xff);
+    return kernels::make_builtin_sum_reduction_ckernel(out_ckb, ckb_offset, tid,
+                    (kernel_request_t)kerntype, algorithm);
+}
+
+void kernels::make_builtin_sum_reduction_ckernel_deferred(
+                ckernel_deferred *out_ckd,
+                type_id_t tid,
+                sum_algorithm_t algorithm)
+{
+    make_builtin_reduction_ckernel_deferred(out_ckd, builtin_reduction_sum, tid);
+    if (algorithm != sum_algorithm_default) {
+        // Validate the algorithm here instead of at instantiation
+        ckernel_builder ckb;
+        make_builtin_sum_reduction_ckernel(&ckb, 0, tid, kernel_request_single, algorithm);
+        out_ckd->data_ptr = reinterpret_cast<void *>((static_cast<uintptr_t>(algorithm) << 8) |
+                        static_cast<uintptr_t>(tid));
+        out_ckd->instantiate_func = &instantiate_builtin_sum_reduction_ckernel_deferred;
+    }
+}
+
+nd::array kernels::make_builtin_reduction_identity(
+                builtin_reduction_t op, type_id_t tid)
+{
+    nd::array result;
+    switch (op) {
+        case builtin_reduction_sum:
+            result = nd::empty(ndt::type(tid));
+            result.vals() = 0;
+            break;
+        case builtin_reduction_prod:
+            result = nd::empty(ndt::type(tid));
+            result.vals() = 1;
+            break;
+        case builtin_reduction_any:
+            result = nd::array(false);
+            break;
+        case builtin_reduction_all:
+            result = nd::array(true);
+            break;
+        case builtin_reduction_count_nonzero:
+            result = nd::array(static_cast<int64_t>(0));
+            break;
+        default:
+            // min and max have no identity
+            break;
+    }
+    return result;
+}
@@ -18,6 +18,44 @@ using namespace dynd;
 // fixedstring to fixedstring assignment
 
 namespace {
+    /**
+     * Copies code points from [src, src_end) to [dst, dst_end) until either
+     * runs out, null-padding the destination. This is the slow path for
+     * strings which get truncated.
+     */
+    void truncating_fixedstring_assign(char *dst, char *dst_end,
+                    const char *src, const char *src_end,
+                    next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn)
+    {
+        while (src < src_end && dst < dst_end) {
+            append_fn(next_fn(src, src_end), dst, dst_end);
+        }
+        if (dst < dst_end) {
+            memset(dst, 0, dst_end - dst);
+        }
+    }
+
+    /**
+     * Transcodes [src, src_end) into the null-padded fixed-size buffer
+     * [dst, dst_end), sizing the output before writing it so the common
+     * case where it fits needs no per-character bounds checks.
+     */
+    void assign_to_fixedstring(char *dst, intptr_t dst_data_size, string_encoding_t dst_encoding,
+                    const char *src, const char *src_end, string_encoding_t src_encoding,
+                    next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn,
+                    assign_error_mode errmode)
+    {
+        intptr_t size = get_transcoded_string_size(dst_encoding, src_encoding, src, src_end, errmode);
+        if (size <= dst_data_size) {
+            transcode_string(dst_encoding, dst, size, src_encoding, src, src_end, errmode);
+            memset(dst + size, 0, dst_data_size - size);
+        } else if (errmode != assign_error_none) {
+            throw std::runtime_error("Input string is too large to convert to destination fixed-size string");
+        } else {
+            truncating_fixedstring_assign(dst, dst + dst_data_size, src, src_end, next_fn, append_fn);
+        }
+    }
+
     struct fixedstring_assign_kernel_extra {
         typedef fixedstring_assign_kernel_extra extra_type;
 
@@ -25,36 +63,18 @@ namespace {
         next_unicode_codepoint_t next_fn;
         append_unicode_codepoint_t append_fn;
         intptr_t dst_data_size, src_data_size;
-        bool overflow_check;
+        string_encoding_t dst_encoding, src_encoding;
+        assign_error_mode errmode;
 
         static void single(char *dst, const char *src,
                         ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
-            char *dst_end = dst + e->dst_data_size;
-            const char *src_end = src + e->src_data_size;
-            next_unicode_codepoint_t next_fn = e->next_fn;
-            append_unicode_codepoint_t append_fn = e->append_fn;
-            uint32_t cp = 0;
-
-            while (src < src_end && dst < dst_end) {
-                cp = next_fn(src, src_end);
-                // The fixedstring type uses null-terminated strings
-                if (cp == 0) {
-                    // Null-terminate the destination string, and we're done
-                    memset(dst, 0, dst_end - dst);
-                    return;
-                } else {
-                    append_fn(cp, dst, dst_end);
-                }
-            }
-            if (src < src_end) {
-                if (e->overflow_check) {
-                    throw std::runtime_error("Input string is too large to convert to destination fixed-size string");
-                }
-            } else if (dst < dst_end) {
-                memset(dst, 0, dst_end - dst);
-            }
+            // The fixedstring type uses null-terminated strings
+            const char *src_end = find_fixedstring_end(e->src_encoding, src, src + e->src_data_size);
+            assign_to_fixedstring(dst, e->dst_data_size, e->dst_encoding,
+                            src, src_end, e->src_encoding,
+                            e->next_fn, e->append_fn, e->errmode);
         }
     };
 } // anonymous namespace
@@ -74,7 +94,9 @@ size_t dynd::make_fixedstring_assignment_kernel(
     e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_data_size = dst_data_size;
     e->src_data_size = src_data_size;
-    e->overflow_check = (errmode != assign_error_none);
+    e->dst_encoding = dst_encoding;
+    e->src_encoding = src_encoding;
+    e->errmode = errmode;
     return offset_out + sizeof(fixedstring_assign_kernel_extra);
 }
 
@@ -82,13 +104,76 @@ size_t dynd::make_fixedstring_assignment_kernel(
 // blockref string to blockref string assignment
 
 namespace {
+    // The number of strings measured for each allocation in the strided kernels
+    const size_t blockref_string_chunk_size = 128;
+
+    /**
+     * Assigns `count` strided source strings, either blockref strings
+     * or null-terminated fixed-size strings of size `src_fixed_size`, to
+     * blockref strings. Each chunk of strings is measured and validated
+     * first, then transcoded into a single allocation from the destination
+     * memory block.
+     */
+    template<bool src_fixed>
+    void strided_assign_to_blockref_strings(
+                    char *dst, intptr_t dst_stride, const string_type_metadata *dst_md,
+                    string_encoding_t dst_encoding,
+                    const char *src, intptr_t src_stride, intptr_t src_fixed_size,
+                    string_encoding_t src_encoding,
+                    size_t count, assign_error_mode errmode)
+    {
+        memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(dst_md->blockref);
+        intptr_t dst_charsize = string_encoding_char_size_table[dst_encoding];
+        const char *src_begins[blockref_string_chunk_size], *src_ends[blockref_string_chunk_size];
+        intptr_t sizes[blockref_string_chunk_size];
+        while (count > 0) {
+            size_t chunk_count = count < blockref_string_chunk_size ? count : blockref_string_chunk_size;
+            intptr_t total_size = 0;
+            char *chunk_dst = dst;
+            const char *chunk_src = src;
+            for (size_t i = 0; i != chunk_count; ++i, chunk_dst += dst_stride, chunk_src += src_stride) {
+                if (reinterpret_cast<const string_type_data *>(chunk_dst)->begin != NULL) {
+                    throw runtime_error("Cannot assign to an already initialized dynd string");
+                }
+                if (src_fixed) {
+                    src_begins[i] = chunk_src;
+                    src_ends[i] = find_fixedstring_end(src_encoding, chunk_src, chunk_src + src_fixed_size);
+                } else {
+                    const string_type_data *src_d = reinterpret_cast<const string_type_data *>(chunk_src);
+                    src_begins[i] = src_d->begin;
+                    src_ends[i] = src_d->end;
+                }
+                if (src_begins[i] != NULL) {
+                    sizes[i] = get_transcoded_string_size(dst_encoding, src_encoding,
+                                    src_begins[i], src_ends[i], errmode);
+                    total_size += sizes[i];
+                }
+            }
+
+            char *dst_begin = NULL, *dst_end = NULL;
+            allocator->allocate(dst_md->blockref, total_size, dst_charsize, &dst_begin, &dst_end);
+            for (size_t i = 0; i != chunk_count; ++i, dst += dst_stride) {
+                // Uninitialized source strings stay uninitialized
+                if (src_begins[i] != NULL) {
+                    string_type_data *dst_d = reinterpret_cast<string_type_data *>(dst);
+                    transcode_string(dst_encoding, dst_begin, sizes[i],
+                                    src_encoding, src_begins[i], src_ends[i], errmode);
+                    dst_d->begin = dst_begin;
+                    dst_begin += sizes[i];
+                    dst_d->end = dst_begin;
+                }
+            }
+            src = chunk_src;
+            count -= chunk_count;
+        }
+    }
+
     struct blockref_string_assign_kernel_extra {
         typedef blockref_string_assign_kernel_extra extra_type;
 
         ckernel_prefix base;
         string_encoding_t dst_encoding, src_encoding;
-        next_unicode_codepoint_t next_fn;
-        append_unicode_codepoint_t append_fn;
+        assign_error_mode errmode;
         const string_type_metadata *dst_metadata, *src_metadata;
 
         static void single(char *dst, const char *src,
@@ -99,7 +184,6 @@ namespace {
             const string_type_metadata *src_md = e->src_metadata;
             string_type_data *dst_d = reinterpret_cast<string_type_data *>(dst);
             const string_type_data *src_d = reinterpret_cast<const string_type_data *>(src);
-            intptr_t src_charsize = string_encoding_char_size_table[e->src_encoding];
             intptr_t dst_charsize = string_encoding_char_size_table[e->dst_encoding];
 
             if (dst_d->begin != NULL) {
@@ -112,37 +196,17 @@ namespace {
 
             // If the blockrefs are different, require a copy operation
             if (dst_md->blockref != src_md->blockref) {
-                char *dst_begin = NULL, *dst_current, *dst_end = NULL;
+                char *dst_begin = NULL, *dst_end = NULL;
                 const char *src_begin = src_d->begin;
                 const char *src_end = src_d->end;
-                next_unicode_codepoint_t next_fn = e->next_fn;
-                append_unicode_codepoint_t append_fn = e->append_fn;
-                uint32_t cp;
 
+                // Size the output exactly, validating the input, before writing it
+                intptr_t size = get_transcoded_string_size(e->dst_encoding, e->src_encoding,
+                                src_begin, src_end, e->errmode);
                 memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(dst_md->blockref);
-
-                // Allocate the initial output as the src number of characters + some padding
-                // TODO: Don't add padding if the output is not a multi-character encoding
-                allocator->allocate(dst_md->blockref, ((src_end - src_begin) / src_charsize + 16) * dst_charsize * 1124 / 1024,
-                                dst_charsize, &dst_begin, &dst_end);
-
-                dst_current = dst_begin;
-                while (src_begin < src_end) {
-                    cp = next_fn(src_begin, src_end);
-                    // Append the codepoint, or increase the allocated memory as necessary
-                    if (dst_end - dst_current >= 8) {
-                        append_fn(cp, dst_current, dst_end);
-                    } else {
-                        char *dst_begin_saved = dst_begin;
-                        allocator->resize(dst_md->blockref, 2 * (dst_end - dst_begin), &dst_begin, &dst_end);
-                        dst_current = dst_begin + (dst_current - dst_begin_saved);
-
-                        append_fn(cp, dst_current, dst_end);
-                    }
-                }
-
-                // Shrink-wrap the memory to just fit the string
-                allocator->resize(dst_md->blockref, dst_current - dst_begin, &dst_begin, &dst_end);
+                allocator->allocate(dst_md->blockref, size, dst_charsize, &dst_begin, &dst_end);
+                transcode_string(e->dst_encoding, dst_begin, size,
+                                e->src_encoding, src_begin, src_end, e->errmode);
 
                 // Set the output
                 dst_d->begin = dst_begin;
@@ -154,6 +218,23 @@ namespace {
                 throw runtime_error("Attempted to reference source data when changing string encoding");
             }
         }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            if (e->dst_metadata->blockref == e->src_metadata->blockref) {
+                // Zero-copy, the strings share the source memory
+                for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                    single(dst, src, extra);
+                }
+            } else {
+                strided_assign_to_blockref_strings<false>(dst, dst_stride, e->dst_metadata,
+                                e->dst_encoding, src, src_stride, 0, e->src_encoding,
+                                count, e->errmode);
+            }
+        }
     };
 } // anonymous namespace
 
@@ -164,14 +245,24 @@ size_t dynd::make_blockref_string_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity_leaf(offset_out + sizeof(blockref_string_assign_kernel_extra));
     blockref_string_assign_kernel_extra *e = out->get_at<blockref_string_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&blockref_string_assign_kernel_extra::single);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(&blockref_string_assign_kernel_extra::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(&blockref_string_assign_kernel_extra::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_blockref_string_assignment_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
     e->dst_encoding = dst_encoding;
     e->src_encoding = src_encoding;
-    e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
-    e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
+    e->errmode = errmode;
     e->dst_metadata = reinterpret_cast<const string_type_metadata *>(dst_metadata);
     e->src_metadata = reinterpret_cast<const string_type_metadata *>(src_metadata);
     return offset_out + sizeof(blockref_string_assign_kernel_extra);
@@ -186,9 +277,8 @@ namespace {
 
         ckernel_prefix base;
         string_encoding_t dst_encoding, src_encoding;
+        assign_error_mode errmode;
         intptr_t src_element_size;
-        next_unicode_codepoint_t next_fn;
-        append_unicode_codepoint_t append_fn;
         const string_type_metadata *dst_metadata;
 
         static void single(char *dst, const char *src,
@@ -197,53 +287,38 @@ namespace {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
             const string_type_metadata *dst_md = e->dst_metadata;
             string_type_data *dst_d = reinterpret_cast<string_type_data *>(dst);
-            intptr_t src_charsize = string_encoding_char_size_table[e->src_encoding];
             intptr_t dst_charsize = string_encoding_char_size_table[e->dst_encoding];
 
             if (dst_d->begin != NULL) {
                 throw runtime_error("Cannot assign to an already initialized dynd string");
             }
 
-            char *dst_begin = NULL, *dst_current, *dst_end = NULL;
-            const char *src_begin = src;
-            const char *src_end = src + e->src_element_size;
-            next_unicode_codepoint_t next_fn = e->next_fn;
-            append_unicode_codepoint_t append_fn = e->append_fn;
-            uint32_t cp;
+            char *dst_begin = NULL, *dst_end = NULL;
+            // The fixedstring type uses null-terminated strings
+            const char *src_end = find_fixedstring_end(e->src_encoding, src, src + e->src_element_size);
 
+            // Size the output exactly, validating the input, before writing it
+            intptr_t size = get_transcoded_string_size(e->dst_encoding, e->src_encoding,
+                            src, src_end, e->errmode);
             memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(dst_md->blockref);
-
-            // Allocate the initial output as the src number of characters + some padding
-            // TODO: Don't add padding if the output is not a multi-character encoding
-            allocator->allocate(dst_md->blockref, ((src_end - src_begin) / src_charsize + 16) * dst_charsize * 1124 / 1024,
-                            dst_charsize, &dst_begin, &dst_end);
-
-            dst_current = dst_begin;
-            while (src_begin < src_end) {
-                cp = next_fn(src_begin, src_end);
-                // Append the codepoint, or increase the allocated memory as necessary
-                if (cp != 0) {
-                    if (dst_end - dst_current >= 8) {
-                        append_fn(cp, dst_current, dst_end);
-                    } else {
-                        char *dst_begin_saved = dst_begin;
-                        allocator->resize(dst_md->blockref, 2 * (dst_end - dst_begin), &dst_begin, &dst_end);
-                        dst_current = dst_begin + (dst_current - dst_begin_saved);
-
-                        append_fn(cp, dst_current, dst_end);
-                    }
-                } else {
-                    break;
-                }
-            }
-
-            // Shrink-wrap the memory to just fit the string
-            allocator->resize(dst_md->blockref, dst_current - dst_begin, &dst_begin, &dst_end);
+            allocator->allocate(dst_md->blockref, size, dst_charsize, &dst_begin, &dst_end);
+            transcode_string(e->dst_encoding, dst_begin, size,
+                            e->src_encoding, src, src_end, e->errmode);
 
             // Set the output
             dst_d->begin = dst_begin;
             dst_d->end = dst_end;
         }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            strided_assign_to_blockref_strings<true>(dst, dst_stride, e->dst_metadata,
+                            e->dst_encoding, src, src_stride, e->src_element_size,
+                            e->src_encoding, count, e->errmode);
+        }
     };
 } // anonymous namespace
 
@@ -254,18 +329,30 @@ size_t dynd::make_fixedstring_to_blockref_string_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
-    out->ensure_capacity_leaf(offset_out + sizeof(blockref_string_assign_kernel_extra));
+    out->ensure_capacity_leaf(offset_out + sizeof(fixedstring_to_blockref_string_assign_kernel_extra));
     fixedstring_to_blockref_string_assign_kernel_extra *e =
                     out->get_at<fixedstring_to_blockref_string_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&fixedstring_to_blockref_string_assign_kernel_extra::single);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(
+                            &fixedstring_to_blockref_string_assign_kernel_extra::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(
+                            &fixedstring_to_blockref_string_assign_kernel_extra::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_fixedstring_to_blockref_string_assignment_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
     e->dst_encoding = dst_encoding;
     e->src_encoding = src_encoding;
+    e->errmode = errmode;
     e->src_element_size = src_element_size;
-    e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
-    e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_metadata = reinterpret_cast<const string_type_metadata *>(dst_metadata);
-    return offset_out + sizeof(blockref_string_assign_kernel_extra);
+    return offset_out + sizeof(fixedstring_to_blockref_string_assign_kernel_extra);
 }
 
 /////////////////////////////////////////
@@ -278,32 +365,18 @@ namespace {
         ckernel_prefix base;
         next_unicode_codepoint_t next_fn;
         append_unicode_codepoint_t append_fn;
-        intptr_t dst_data_size, src_element_size;
-        bool overflow_check;
+        intptr_t dst_data_size;
+        string_encoding_t dst_encoding, src_encoding;
+        assign_error_mode errmode;
 
         static void single(char *dst, const char *src,
                         ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
-            char *dst_end = dst + e->dst_data_size;
             const string_type_data *src_d = reinterpret_cast<const string_type_data *>(src);
-            const char *src_begin = src_d->begin;
-            const char *src_end = src_d->end;
-            next_unicode_codepoint_t next_fn = e->next_fn;
-            append_unicode_codepoint_t append_fn = e->append_fn;
-            uint32_t cp;
-
-            while (src_begin < src_end && dst < dst_end) {
-                cp = next_fn(src_begin, src_end);
-                append_fn(cp, dst, dst_end);
-            }
-            if (src_begin < src_end) {
-                if (e->overflow_check) {
-                    throw std::runtime_error("Input string is too large to convert to destination fixed-size string");
-                }
-            } else if (dst < dst_end) {
-                memset(dst, 0, dst_end - dst);
-            }
+            assign_to_fixedstring(dst, e->dst_data_size, e->dst_encoding,
+                            src_d->begin, src_d->end, e->src_encoding,
+                            e->next_fn, e->append_fn, e->errmode);
         }
     };
 } // anonymous namespace
@@ -322,6 +395,8 @@ size_t dynd::make_blockref_string_to_fixedstring_assignment_kernel(
     e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
     e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_data_size = dst_data_size;
-    e->overflow_check = (errmode != assign_error_none);
+    e->dst_encoding = dst_encoding;
+    e->src_encoding = src_encoding;
+    e->errmode = errmode;
     return offset_out + sizeof(blockref_string_to_fixedstring_assign_kernel_extra);
 }
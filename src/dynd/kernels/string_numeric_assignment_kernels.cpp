@@ -5,182 +5,188 @@
 
 #include <stdexcept>
 #include <sstream>
-#include <cctype>
+#include <cstring>
+#include <cfloat>
 
 #include <dynd/type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/diagnostics.hpp>
+#include <dynd/number_formatting.hpp>
 #include <dynd/kernels/string_numeric_assignment_kernels.hpp>
 #include "single_assigner_builtin.hpp"
 
 using namespace std;
 using namespace dynd;
 
-// Trim taken from boost string algorithms library
-template< typename ForwardIteratorT>
-inline ForwardIteratorT trim_begin( 
-    ForwardIteratorT InBegin, 
-    ForwardIteratorT InEnd )
-{
-    ForwardIteratorT It=InBegin;
-    for(; It!=InEnd; ++It )
-    {
-        if (!isspace(*It))
-            return It;
-    }
+// The parsing below works directly on the UTF-8 bytes of the string,
+// without any heap allocation. Only the ASCII range matters for
+// numbers, so ASCII strings are handled the same way.
 
-    return It;
-}
-template< typename ForwardIteratorT>
-inline ForwardIteratorT trim_end( 
-    ForwardIteratorT InBegin, 
-    ForwardIteratorT InEnd )
-{
-    for( ForwardIteratorT It=InEnd; It!=InBegin;  )
-    {
-        if ( !isspace(*(--It)) )
-            return ++It;
-    }
-
-    return InBegin;
-}
-template<typename SequenceT>
-inline void trim_left_if(SequenceT& Input)
-{
-    Input.erase( 
-        Input.begin(),
-        trim_begin( 
-            Input.begin(), 
-            Input.end() )
-        );
-}
-template<typename SequenceT>
-inline void trim_right_if(SequenceT& Input)
-{
-    Input.erase(
-        trim_end( 
-            Input.begin(), 
-            Input.end() ),
-        Input.end()
-        );
-}
-template<typename SequenceT>
-inline void trim(SequenceT& Input)
+static inline bool is_space(char c)
 {
-    trim_right_if( Input );
-    trim_left_if( Input );
+    return c == ' ' || (c >= '\t' && c <= '\r');
 }
-// End trim taken from boost string algorithms
-void to_lower(std::string& s)
+
+static inline void trim_range(const char *&begin, const char *&end)
 {
-    for (size_t i = 0, i_end = s.size(); i != i_end; ++i) {
-        s[i] = tolower(s[i]);
+    while (begin < end && is_space(*begin)) {
+        ++begin;
+    }
+    while (begin < end && is_space(end[-1])) {
+        --end;
     }
 }
 
-namespace {
-    struct string_to_builtin_auxdata {
-        ndt::type src_string_tp;
-        assign_error_mode errmode;
-    };
-
-    struct string_to_builtin_kernel_extra {
-        typedef string_to_builtin_kernel_extra extra_type;
-
-        ckernel_prefix base;
-        const base_string_type *src_string_tp;
-        assign_error_mode errmode;
-        const char *src_metadata;
-
-        static void destruct(ckernel_prefix *extra)
-        {
-            extra_type *e = reinterpret_cast<extra_type *>(extra);
-            if (e->src_string_tp) {
-                base_type_decref(e->src_string_tp);
-            }
+/**
+ * Compares the string range against a lowercase ASCII literal,
+ * ignoring the case of the range.
+ */
+static inline bool equals_lowercase(const char *begin, const char *end, const char *lower)
+{
+    for (; begin < end; ++begin, ++lower) {
+        char c = *begin;
+        if ('A' <= c && c <= 'Z') {
+            c = c - 'A' + 'a';
         }
-    };
-} // anonymous namespace
-
-/////////////////////////////////////////
-// builtin to string assignment
+        if (c != *lower) {
+            return false;
+        }
+    }
+    return *lower == '\0';
+}
 
-static void raise_string_cast_error(const ndt::type& dst_tp, const ndt::type& string_tp, const char *metadata, const char *data)
+static void raise_string_cast_error(const ndt::type& dst_tp, const char *begin, const char *end)
 {
     stringstream ss;
     ss << "cannot cast string ";
-    string_tp.print_data(ss, metadata, data);
+    print_escaped_utf8_string(ss, begin, end);
     ss << " to " << dst_tp;
     throw runtime_error(ss.str());
 }
 
-static void raise_string_cast_overflow_error(const ndt::type& dst_tp, const ndt::type& string_tp, const char *metadata, const char *data)
+static void raise_string_cast_overflow_error(const ndt::type& dst_tp, const char *begin, const char *end)
 {
     stringstream ss;
     ss << "overflow converting string ";
-    string_tp.print_data(ss, metadata, data);
+    print_escaped_utf8_string(ss, begin, end);
     ss << " to " << dst_tp;
     throw runtime_error(ss.str());
 }
 
-static void string_to_bool_single(char *dst, const char *src,
-                        ckernel_prefix *extra)
+static void string_to_bool(char *dst, const char *begin, const char *end, assign_error_mode errmode)
 {
-    string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
-    // Get the string from the source
-    string s = e->src_string_tp->get_utf8_string(e->src_metadata, src, e->errmode);
-    trim(s);
-    to_lower(s);
-    if (e->errmode == assign_error_none) {
-        if (s.empty() || s == "0" || s == "false" || s == "no" || s == "off" || s == "f" || s == "n") {
-            *dst = 0;
-        } else {
-            *dst = 1;
-        }
+    const char *str_begin = begin, *str_end = end;
+    trim_range(begin, end);
+    bool is_false = equals_lowercase(begin, end, "0") || equals_lowercase(begin, end, "false") ||
+                    equals_lowercase(begin, end, "no") || equals_lowercase(begin, end, "off") ||
+                    equals_lowercase(begin, end, "f") || equals_lowercase(begin, end, "n");
+    if (errmode == assign_error_none) {
+        *dst = (begin == end || is_false) ? 0 : 1;
+    } else if (is_false) {
+        *dst = 0;
+    } else if (equals_lowercase(begin, end, "1") || equals_lowercase(begin, end, "true") ||
+                    equals_lowercase(begin, end, "yes") || equals_lowercase(begin, end, "on") ||
+                    equals_lowercase(begin, end, "t") || equals_lowercase(begin, end, "y")) {
+        *dst = 1;
     } else {
-        if (s == "0" || s == "false" || s == "no" || s == "off" || s == "f" || s == "n") {
-            *dst = 0;
-        } else if (s == "1" || s == "true" || s == "yes" || s == "on" || s == "t" || s == "y") {
-            *dst = 1;
-        } else {
-            raise_string_cast_error(ndt::make_type<dynd_bool>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+        raise_string_cast_error(ndt::make_type<dynd_bool>(), str_begin, str_end);
+    }
+}
+
+/**
+ * Parses eight ASCII digits at once, returning false if
+ * any of them is not a digit.
+ */
+static inline bool parse_8_digits(const char *s, uint32_t& out)
+{
+#if !defined(DYND_BIG_ENDIAN)
+    uint64_t v;
+    memcpy(&v, s, 8);
+    // Every byte must be in 0x30..0x39
+    if ((v & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL ||
+                    ((v + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL) {
+        return false;
+    }
+    v -= 0x3030303030303030ULL;
+    // Combine adjacent digits into pairs, then the pairs into the value
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >> 32;
+    out = static_cast<uint32_t>(v);
+    return true;
+#else
+    uint32_t result = 0;
+    for (int i = 0; i < 8; ++i) {
+        unsigned d = static_cast<unsigned char>(s[i]) - '0';
+        if (d > 9) {
+            return false;
         }
+        result = result * 10 + d;
     }
+    out = result;
+    return true;
+#endif
 }
 
-static uint64_t parse_uint64_noerror(const std::string& s)
+/**
+ * Parses the decimal digits in [begin, end) as an unsigned integer.
+ * On a non-digit character, sets out_badparse and returns the
+ * value of the digits before it.
+ */
+static uint64_t parse_uint64(const char *begin, const char *end, bool& out_overflow, bool& out_badparse)
 {
     uint64_t result = 0;
-    size_t pos = 0, end = s.size();
-    while (pos < end) {
-        char c = s[pos];
-        if ('0' <= c && c <= '9') {
-            result = (result * 10) + (c - '0');
-        } else {
-            break;
+    while (begin < end && *begin == '0') {
+        ++begin;
+    }
+    // Up to 19 digits can't overflow
+    const char *nocheck_end = (end - begin > 19) ? begin + 19 : end;
+    uint32_t eight;
+    while (nocheck_end - begin >= 8 && parse_8_digits(begin, eight)) {
+        result = result * 100000000ULL + eight;
+        begin += 8;
+    }
+    for (; begin < nocheck_end; ++begin) {
+        unsigned d = static_cast<unsigned char>(*begin) - '0';
+        if (d > 9) {
+            out_badparse = true;
+            return result;
+        }
+        result = result * 10 + d;
+    }
+    for (; begin < end; ++begin) {
+        unsigned d = static_cast<unsigned char>(*begin) - '0';
+        if (d > 9) {
+            out_badparse = true;
+            return result;
+        }
+        if (result > (numeric_limits<uint64_t>::max() - d) / 10) {
+            out_overflow = true;
         }
-        ++pos;
+        result = result * 10 + d;
     }
     return result;
 }
 
-static uint64_t parse_uint64(const std::string& s, bool& out_overflow, bool& out_badparse)
+/**
+ * Parses the decimal digits in [begin, end) as a 128-bit unsigned integer,
+ * in the same manner as parse_uint64.
+ */
+static dynd_uint128 parse_uint128(const char *begin, const char *end, bool& out_overflow, bool& out_badparse)
 {
-    uint64_t result = 0, prev_result = 0;
-    size_t pos = 0, end = s.size();
-    while (pos < end) {
-        char c = s[pos];
-        if ('0' <= c && c <= '9') {
-            result = (result * 10) + (c - '0');
-            if (result < prev_result) {
-                out_overflow = true;
-            }
-        } else {
+    // max / 10 == 0x1999...9, with a remainder of 5
+    const dynd_uint128 max_div_10(0x1999999999999999ULL, 0x9999999999999999ULL);
+    dynd_uint128 result(0ULL);
+    for (; begin < end; ++begin) {
+        unsigned d = static_cast<unsigned char>(*begin) - '0';
+        if (d > 9) {
             out_badparse = true;
-            break;
+            return result;
         }
-        ++pos;
-        prev_result = result;
+        if (result > max_div_10 || (result == max_div_10 && d > 5)) {
+            out_overflow = true;
+        }
+        result = result * 10u + dynd_uint128(d);
     }
     return result;
 }
@@ -212,58 +218,49 @@ template <> struct overflow_check<uint64_t> { inline static bool is_overflow(uin
 }};
 
 namespace { template<typename T> struct string_to_int {
-    static void single(char *dst, const char *src, 
-                        ckernel_prefix *extra)
+    static void parse(char *dst, const char *begin, const char *end, assign_error_mode errmode)
     {
-        string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
-        string s = e->src_string_tp->get_utf8_string(e->src_metadata, src, e->errmode);
-        trim(s);
+        const char *str_begin = begin, *str_end = end;
+        trim_range(begin, end);
         bool negative = false;
-        if (!s.empty() && s[0] == '-') {
-            s.erase(0, 1);
+        if (begin < end && *begin == '-') {
+            ++begin;
             negative = true;
         }
-        T result;
-        if (e->errmode == assign_error_none) {
-            uint64_t value = parse_uint64_noerror(s);
-            result = negative ? static_cast<T>(-static_cast<int64_t>(value)) : static_cast<T>(value);
-        } else {
-            bool overflow = false, badparse = false;
-            uint64_t value = parse_uint64(s, overflow, badparse);
+        bool overflow = false, badparse = false;
+        uint64_t value = parse_uint64(begin, end, overflow, badparse);
+        if (errmode != assign_error_none) {
             if (badparse) {
-                raise_string_cast_error(ndt::make_type<T>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+                raise_string_cast_error(ndt::make_type<T>(), str_begin, str_end);
             } else if (overflow || overflow_check<T>::is_overflow(value, negative)) {
-                raise_string_cast_overflow_error(ndt::make_type<T>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+                raise_string_cast_overflow_error(ndt::make_type<T>(), str_begin, str_end);
             }
-            result = negative ? static_cast<T>(-static_cast<int64_t>(value)) : static_cast<T>(value);
         }
-        *reinterpret_cast<T *>(dst) = result;
+        *reinterpret_cast<T *>(dst) = negative ? static_cast<T>(-static_cast<int64_t>(value))
+                                               : static_cast<T>(value);
     }
 };}
 
 namespace { template<typename T> struct string_to_uint {
-    static void single(char *dst, const char *src, 
-                        ckernel_prefix *extra)
+    static void parse(char *dst, const char *begin, const char *end, assign_error_mode errmode)
     {
-        string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
-        string s = e->src_string_tp->get_utf8_string(e->src_metadata, src, e->errmode);
-        trim(s);
+        const char *str_begin = begin, *str_end = end;
+        trim_range(begin, end);
         bool negative = false;
-        if (!s.empty() && s[0] == '-') {
-            s.erase(0, 1);
+        if (begin < end && *begin == '-') {
+            ++begin;
             negative = true;
         }
+        bool overflow = false, badparse = false;
+        uint64_t value = parse_uint64(begin, end, overflow, badparse);
         T result;
-        if (e->errmode == assign_error_none) {
-            uint64_t value = parse_uint64_noerror(s);
+        if (errmode == assign_error_none) {
             result = negative ? static_cast<T>(0) : static_cast<T>(value);
         } else {
-            bool overflow = false, badparse = false;
-            uint64_t value = parse_uint64(s, overflow, badparse);
             if (badparse) {
-                raise_string_cast_error(ndt::make_type<T>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+                raise_string_cast_error(ndt::make_type<T>(), str_begin, str_end);
             } else if (negative || overflow || overflow_check<T>::is_overflow(value)) {
-                raise_string_cast_overflow_error(ndt::make_type<T>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+                raise_string_cast_overflow_error(ndt::make_type<T>(), str_begin, str_end);
             }
             result = static_cast<T>(value);
         }
@@ -271,159 +268,464 @@ namespace { template<typename T> struct string_to_uint {
     }
 };}
 
-static void string_to_int128_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                        ckernel_prefix *DYND_UNUSED(extra))
+static void string_to_int128(char *dst, const char *begin, const char *end, assign_error_mode errmode)
 {
-    throw std::runtime_error("TODO: implement string_to_int128_single");
+    const char *str_begin = begin, *str_end = end;
+    trim_range(begin, end);
+    bool negative = false;
+    if (begin < end && *begin == '-') {
+        ++begin;
+        negative = true;
+    }
+    bool overflow = false, badparse = false;
+    dynd_uint128 value = parse_uint128(begin, end, overflow, badparse);
+    if (errmode != assign_error_none) {
+        if (badparse) {
+            raise_string_cast_error(ndt::make_type<dynd_int128>(), str_begin, str_end);
+        } else if (overflow || ((value.m_hi & 0x8000000000000000ULL) != 0 &&
+                        !(negative && value == dynd_uint128(0x8000000000000000ULL, 0ULL)))) {
+            raise_string_cast_overflow_error(ndt::make_type<dynd_int128>(), str_begin, str_end);
+        }
+    }
+    dynd_int128 result(value.m_hi, value.m_lo);
+    *reinterpret_cast<dynd_int128 *>(dst) = negative ? -result : result;
 }
 
-static void string_to_uint128_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                        ckernel_prefix *DYND_UNUSED(extra))
+static void string_to_uint128(char *dst, const char *begin, const char *end, assign_error_mode errmode)
 {
-    throw std::runtime_error("TODO: implement string_to_uint128_single");
+    const char *str_begin = begin, *str_end = end;
+    trim_range(begin, end);
+    bool negative = false;
+    if (begin < end && *begin == '-') {
+        ++begin;
+        negative = true;
+    }
+    bool overflow = false, badparse = false;
+    dynd_uint128 value = parse_uint128(begin, end, overflow, badparse);
+    if (errmode == assign_error_none) {
+        if (negative) {
+            value = dynd_uint128(0ULL);
+        }
+    } else {
+        if (badparse) {
+            raise_string_cast_error(ndt::make_type<dynd_uint128>(), str_begin, str_end);
+        } else if (negative || overflow) {
+            raise_string_cast_overflow_error(ndt::make_type<dynd_uint128>(), str_begin, str_end);
+        }
+    }
+    *reinterpret_cast<dynd_uint128 *>(dst) = value;
 }
 
-static void string_to_float32_single(char *dst, const char *src,
-                        ckernel_prefix *extra)
+enum special_float_t {
+    special_float_none,
+    special_float_nan,
+    special_float_neg_nan,
+    special_float_inf,
+    special_float_neg_inf,
+    special_float_na
+};
+
+static special_float_t get_special_float(const char *begin, const char *end)
 {
-    string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
-    // Get the string from the source
-    string s = e->src_string_tp->get_utf8_string(e->src_metadata, src,e->errmode);
-    trim(s);
-    to_lower(s);
-    // Handle special values
-    if (s == "nan" || s == "1.#qnan") {
-        *reinterpret_cast<uint32_t *>(dst) = 0x7fc00000;
-        return;
-    } else if (s == "-nan" || s == "-1.#ind") {
-        *reinterpret_cast<uint32_t *>(dst) = 0xffc00000;
-        return;
-    } else if (s == "inf" || s == "infinity" || s == "1.#inf") {
-        *reinterpret_cast<uint32_t *>(dst) = 0x7f800000;
-        return;
-    } else if (s == "-inf" || s == "-infinity" || s == "-1.#inf") {
-        *reinterpret_cast<uint32_t *>(dst) = 0xff800000;
-        return;
-    } else if (s == "na") {
-        // A 32-bit version of R's special NA NaN
-        *reinterpret_cast<uint32_t *>(dst) = 0x7f8007a2;
-        return;
+    // All the special values start with a letter, '1.#' or a sign
+    if (begin == end || ('0' <= *begin && *begin <= '9' && !(end - begin > 2 && begin[2] == '#'))) {
+        return special_float_none;
     }
-    char *end_ptr;
-    // TODO: use a different parsing code that's guaranteed to round correctly in a cross-platform fashion
-    double value = strtod(s.c_str(), &end_ptr);
-    if (e->errmode != assign_error_none && (size_t)(end_ptr - s.c_str()) != s.size()) {
-        raise_string_cast_error(ndt::make_type<float>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+    if (equals_lowercase(begin, end, "nan") || equals_lowercase(begin, end, "1.#qnan")) {
+        return special_float_nan;
+    } else if (equals_lowercase(begin, end, "-nan") || equals_lowercase(begin, end, "-1.#ind")) {
+        return special_float_neg_nan;
+    } else if (equals_lowercase(begin, end, "inf") || equals_lowercase(begin, end, "infinity") ||
+                    equals_lowercase(begin, end, "1.#inf")) {
+        return special_float_inf;
+    } else if (equals_lowercase(begin, end, "-inf") || equals_lowercase(begin, end, "-infinity") ||
+                    equals_lowercase(begin, end, "-1.#inf")) {
+        return special_float_neg_inf;
+    } else if (equals_lowercase(begin, end, "na")) {
+        return special_float_na;
     } else {
-        // Assign double -> float according to the error mode
-        switch (e->errmode) {
-            case assign_error_none:
-                single_assigner_builtin<float, double, assign_error_none>::assign(
-                                reinterpret_cast<float *>(dst), &value, NULL);
-                break;
-            case assign_error_overflow:
-                single_assigner_builtin<float, double, assign_error_overflow>::assign(
-                                reinterpret_cast<float *>(dst), &value, NULL);
-                break;
-            case assign_error_fractional:
-                single_assigner_builtin<float, double, assign_error_fractional>::assign(
-                                reinterpret_cast<float *>(dst), &value, NULL);
-                break;
-            case assign_error_inexact:
-                single_assigner_builtin<float, double, assign_error_inexact>::assign(
-                                reinterpret_cast<float *>(dst), &value, NULL);
-                break;
-            default:
-                single_assigner_builtin<float, double, assign_error_fractional>::assign(
-                                reinterpret_cast<float *>(dst), &value, NULL);
-                break;
-        }
+        return special_float_none;
     }
 }
 
-static void string_to_float64_single(char *dst, const char *src,
-                        ckernel_prefix *extra)
+// Powers of ten which are exactly representable as doubles
+static const double exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Parses a trimmed decimal number. Returns true if the whole range was
+ * a number. When it returns false, `out` holds the value of the longest
+ * prefix which is a number, as strtod would give.
+ *
+ * Numbers with at most 15 significant digits and a small decimal exponent
+ * are computed exactly with one floating point multiply or divide, which
+ * is correctly rounded. Everything else goes to strtod, from a stack
+ * buffer when the string is short enough.
+ */
+static bool parse_float64(const char *begin, const char *end, double& out)
 {
-    string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
-    // Get the string from the source
-    string s = e->src_string_tp->get_utf8_string(e->src_metadata, src, e->errmode);
-    trim(s);
-    to_lower(s);
-    // Handle special values
-    if (s == "nan" || s == "1.#qnan") {
-        *reinterpret_cast<uint64_t *>(dst) = 0x7ff8000000000000ULL;
-        return;
-    } else if (s == "-nan" || s == "-1.#ind") {
-        *reinterpret_cast<uint64_t *>(dst) = 0xfff8000000000000ULL;
-        return;
-    } else if (s == "inf" || s == "infinity" || s == "1.#inf") {
-        *reinterpret_cast<uint64_t *>(dst) = 0x7ff0000000000000ULL;
-        return;
-    } else if (s == "-inf" || s == "-infinity" || s == "-1.#inf") {
-        *reinterpret_cast<uint64_t *>(dst) = 0xfff0000000000000ULL;
-        return;
-    } else if (s == "na") {
-        // R's special NA NaN
-        *reinterpret_cast<uint64_t *>(dst) = 0x7ff00000000007a2ULL;
-        return;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
     }
+    uint64_t mantissa = 0;
+    int digit_count = 0, exponent = 0;
+    bool any_digits = false;
+    while (p < end && '0' <= *p && *p <= '9') {
+        any_digits = true;
+        if (mantissa != 0 || *p != '0') {
+            if (digit_count < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+            } else {
+                ++exponent;
+            }
+            ++digit_count;
+        }
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && '0' <= *p && *p <= '9') {
+            any_digits = true;
+            if (mantissa != 0 || *p != '0') {
+                if (digit_count < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    --exponent;
+                }
+                ++digit_count;
+            } else {
+                --exponent;
+            }
+            ++p;
+        }
+    }
+    if (any_digits && p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            ++p;
+        }
+        int exp_value = 0;
+        bool any_exp_digits = false;
+        while (p < end && '0' <= *p && *p <= '9') {
+            any_exp_digits = true;
+            if (exp_value < 100000) {
+                exp_value = exp_value * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        if (!any_exp_digits) {
+            // Let strtod deal with a dangling exponent
+            any_digits = false;
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+    if (any_digits && p == end) {
+        if (mantissa == 0) {
+            out = negative ? -0.0 : 0.0;
+            return true;
+        } else if (digit_count <= 15 && -22 <= exponent && exponent <= 22) {
+            double value = static_cast<double>(static_cast<int64_t>(mantissa));
+            if (exponent < 0) {
+                value /= exact_powers_of_ten[-exponent];
+            } else {
+                value *= exact_powers_of_ten[exponent];
+            }
+            out = negative ? -value : value;
+            return true;
+        }
+    }
+#endif // FLT_EVAL_METHOD == 0
+
+    // Fall back to strtod, which needs a NUL-terminated string
+    char buf[128];
     char *end_ptr;
-    // TODO: use a different parsing code that's guaranteed to round correctly in a cross-platform fashion
-    double value = strtod(s.c_str(), &end_ptr);
-    if (e->errmode != assign_error_none && (size_t)(end_ptr - s.c_str()) != s.size()) {
-        raise_string_cast_error(ndt::make_type<double>(), ndt::type(e->src_string_tp, true), e->src_metadata, src);
+    intptr_t size = end - begin;
+    if (size < (intptr_t)sizeof(buf)) {
+        memcpy(buf, begin, size);
+        buf[size] = '\0';
+        out = strtod(buf, &end_ptr);
+        return end_ptr == buf + size;
     } else {
-        *reinterpret_cast<double *>(dst) = value;
+        string s(begin, end);
+        out = strtod(s.c_str(), &end_ptr);
+        return (size_t)(end_ptr - s.c_str()) == s.size();
+    }
+}
+
+static void assign_float64_to_float32(float *dst, double value, assign_error_mode errmode)
+{
+    // Assign double -> float according to the error mode
+    switch (errmode) {
+        case assign_error_none:
+            single_assigner_builtin<float, double, assign_error_none>::assign(dst, &value, NULL);
+            break;
+        case assign_error_overflow:
+            single_assigner_builtin<float, double, assign_error_overflow>::assign(dst, &value, NULL);
+            break;
+        case assign_error_fractional:
+            single_assigner_builtin<float, double, assign_error_fractional>::assign(dst, &value, NULL);
+            break;
+        case assign_error_inexact:
+            single_assigner_builtin<float, double, assign_error_inexact>::assign(dst, &value, NULL);
+            break;
+        default:
+            single_assigner_builtin<float, double, assign_error_fractional>::assign(dst, &value, NULL);
+            break;
+    }
+}
+
+static void string_to_float32(char *dst, const char *begin, const char *end, assign_error_mode errmode)
+{
+    const char *str_begin = begin, *str_end = end;
+    trim_range(begin, end);
+    // Handle special values
+    switch (get_special_float(begin, end)) {
+        case special_float_nan:
+            *reinterpret_cast<uint32_t *>(dst) = 0x7fc00000;
+            return;
+        case special_float_neg_nan:
+            *reinterpret_cast<uint32_t *>(dst) = 0xffc00000;
+            return;
+        case special_float_inf:
+            *reinterpret_cast<uint32_t *>(dst) = 0x7f800000;
+            return;
+        case special_float_neg_inf:
+            *reinterpret_cast<uint32_t *>(dst) = 0xff800000;
+            return;
+        case special_float_na:
+            // A 32-bit version of R's special NA NaN
+            *reinterpret_cast<uint32_t *>(dst) = 0x7f8007a2;
+            return;
+        default:
+            break;
+    }
+    double value;
+    if (!parse_float64(begin, end, value) && errmode != assign_error_none) {
+        raise_string_cast_error(ndt::make_type<float>(), str_begin, str_end);
+    }
+    assign_float64_to_float32(reinterpret_cast<float *>(dst), value, errmode);
+}
+
+static void string_to_float64(char *dst, const char *begin, const char *end, assign_error_mode errmode)
+{
+    const char *str_begin = begin, *str_end = end;
+    trim_range(begin, end);
+    // Handle special values
+    switch (get_special_float(begin, end)) {
+        case special_float_nan:
+            *reinterpret_cast<uint64_t *>(dst) = 0x7ff8000000000000ULL;
+            return;
+        case special_float_neg_nan:
+            *reinterpret_cast<uint64_t *>(dst) = 0xfff8000000000000ULL;
+            return;
+        case special_float_inf:
+            *reinterpret_cast<uint64_t *>(dst) = 0x7ff0000000000000ULL;
+            return;
+        case special_float_neg_inf:
+            *reinterpret_cast<uint64_t *>(dst) = 0xfff0000000000000ULL;
+            return;
+        case special_float_na:
+            // R's special NA NaN
+            *reinterpret_cast<uint64_t *>(dst) = 0x7ff00000000007a2ULL;
+            return;
+        default:
+            break;
+    }
+    double value;
+    if (!parse_float64(begin, end, value) && errmode != assign_error_none) {
+        raise_string_cast_error(ndt::make_type<double>(), str_begin, str_end);
     }
+    *reinterpret_cast<double *>(dst) = value;
 }
 
-static void string_to_float16_single(char *dst, const char *src,
-                        ckernel_prefix *extra)
+static void string_to_float16(char *dst, const char *begin, const char *end, assign_error_mode errmode)
 {
-    string_to_builtin_kernel_extra *e = reinterpret_cast<string_to_builtin_kernel_extra *>(extra);
     double tmp;
-    string_to_float64_single(reinterpret_cast<char *>(&tmp), src, extra);
-    *reinterpret_cast<dynd_float16 *>(dst) = dynd_float16(tmp, e->errmode);
+    string_to_float64(reinterpret_cast<char *>(&tmp), begin, end, errmode);
+    *reinterpret_cast<dynd_float16 *>(dst) = dynd_float16(tmp, errmode);
 }
 
-static void string_to_float128_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                        ckernel_prefix *DYND_UNUSED(extra))
+static void string_to_float128(char *DYND_UNUSED(dst), const char *DYND_UNUSED(begin),
+                const char *DYND_UNUSED(end), assign_error_mode DYND_UNUSED(errmode))
 {
-    throw std::runtime_error("TODO: implement string_to_float128_single");
+    throw std::runtime_error("TODO: implement string_to_float128");
 }
 
-static void string_to_complex_float32_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                ckernel_prefix *DYND_UNUSED(extra))
+/**
+ * Splits a complex number like "1.5+2j", "(1.5 + 2j)", "-3j" or "4"
+ * into its real and imaginary parts. The parts keep their signs, and
+ * an imaginary part of just a sign, as in "1-j", is returned as the
+ * sign alone. Returns false if the string isn't shaped like a complex number.
+ */
+static bool split_complex(const char *begin, const char *end,
+                const char *&real_begin, const char *&real_end,
+                const char *&imag_begin, const char *&imag_end, bool &out_has_imag)
 {
-    throw std::runtime_error("TODO: implement string_to_complex_float32_single");
+    trim_range(begin, end);
+    if (begin < end && *begin == '(') {
+        if (end[-1] != ')') {
+            return false;
+        }
+        ++begin;
+        --end;
+        trim_range(begin, end);
+    }
+    real_begin = real_end = imag_begin = imag_end = begin;
+    out_has_imag = false;
+    if (begin == end) {
+        return false;
+    }
+    if (end[-1] != 'j' && end[-1] != 'J' && end[-1] != 'i') {
+        // No imaginary part
+        real_end = end;
+        return true;
+    }
+    --end;
+    // The imaginary part starts at the last sign which isn't part of an exponent
+    const char *split = end;
+    while (split > begin) {
+        --split;
+        if ((*split == '+' || *split == '-') &&
+                    !(split > begin && (split[-1] == 'e' || split[-1] == 'E'))) {
+            break;
+        }
+    }
+    if (split > begin) {
+        real_end = split;
+        trim_range(real_begin, real_end);
+    } else {
+        real_end = real_begin;
+    }
+    imag_begin = split;
+    imag_end = end;
+    out_has_imag = true;
+    return true;
 }
 
-static void string_to_complex_float64_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                ckernel_prefix *DYND_UNUSED(extra))
+template<class T>
+static void string_to_complex(char *dst, const char *begin, const char *end, assign_error_mode errmode)
 {
-    throw std::runtime_error("TODO: implement string_to_complex_float64_single");
+    const char *real_begin, *real_end, *imag_begin, *imag_end;
+    double real = 0, imag = 0;
+    bool has_imag;
+    bool valid = split_complex(begin, end, real_begin, real_end, imag_begin, imag_end, has_imag);
+    if (valid && real_begin != real_end) {
+        valid = parse_float64(real_begin, real_end, real);
+    }
+    if (valid && has_imag) {
+        bool negative = false;
+        if (*imag_begin == '+' || *imag_begin == '-') {
+            // Allow spaces between the sign and the value, as in "1 + 2j"
+            negative = (*imag_begin == '-');
+            ++imag_begin;
+            trim_range(imag_begin, imag_end);
+        }
+        if (imag_begin == imag_end) {
+            // A bare imaginary unit, as in "j", "-j" or "1+j"
+            imag = 1;
+        } else {
+            valid = parse_float64(imag_begin, imag_end, imag);
+        }
+        if (negative) {
+            imag = -imag;
+        }
+    }
+    if (!valid && errmode != assign_error_none) {
+        raise_string_cast_error(ndt::make_type<dynd_complex<T> >(), begin, end);
+    }
+    T real_value, imag_value;
+    if (sizeof(T) == sizeof(float)) {
+        assign_float64_to_float32(reinterpret_cast<float *>(&real_value), real, errmode);
+        assign_float64_to_float32(reinterpret_cast<float *>(&imag_value), imag, errmode);
+    } else {
+        real_value = static_cast<T>(real);
+        imag_value = static_cast<T>(imag);
+    }
+    *reinterpret_cast<dynd_complex<T> *>(dst) = dynd_complex<T>(real_value, imag_value);
 }
 
-static unary_single_operation_t static_string_to_builtin_kernels[builtin_type_id_count-2] = {
-        &string_to_bool_single,
-        &string_to_int<int8_t>::single,
-        &string_to_int<int16_t>::single,
-        &string_to_int<int32_t>::single,
-        &string_to_int<int64_t>::single,
-        &string_to_int128_single,
-        &string_to_uint<uint8_t>::single,
-        &string_to_uint<uint16_t>::single,
-        &string_to_uint<uint32_t>::single,
-        &string_to_uint<uint64_t>::single,
-        &string_to_uint128_single,
-        &string_to_float16_single,
-        &string_to_float32_single,
-        &string_to_float64_single,
-        &string_to_float128_single,
-        &string_to_complex_float32_single,
-        &string_to_complex_float64_single
+typedef void (*utf8_to_builtin_parse_t)(char *dst, const char *begin, const char *end,
+                assign_error_mode errmode);
+
+static utf8_to_builtin_parse_t static_utf8_to_builtin_parsers[builtin_type_id_count-2] = {
+        &string_to_bool,
+        &string_to_int<int8_t>::parse,
+        &string_to_int<int16_t>::parse,
+        &string_to_int<int32_t>::parse,
+        &string_to_int<int64_t>::parse,
+        &string_to_int128,
+        &string_to_uint<uint8_t>::parse,
+        &string_to_uint<uint16_t>::parse,
+        &string_to_uint<uint32_t>::parse,
+        &string_to_uint<uint64_t>::parse,
+        &string_to_uint128,
+        &string_to_float16,
+        &string_to_float32,
+        &string_to_float64,
+        &string_to_float128,
+        &string_to_complex<float>,
+        &string_to_complex<double>
     };
 
+namespace {
+    struct string_to_builtin_kernel_extra {
+        typedef string_to_builtin_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        utf8_to_builtin_parse_t parse;
+        const base_string_type *src_string_tp;
+        assign_error_mode errmode;
+        // True when the string bytes can be parsed in place
+        bool src_utf8;
+        const char *src_metadata;
+
+        inline void convert(char *dst, const char *src)
+        {
+            if (src_utf8) {
+                const char *begin, *end;
+                src_string_tp->get_string_range(&begin, &end, src_metadata, src);
+                parse(dst, begin, end, errmode);
+            } else {
+                string s = src_string_tp->get_utf8_string(src_metadata, src, errmode);
+                parse(dst, s.data(), s.data() + s.size(), errmode);
+            }
+        }
+
+        static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            reinterpret_cast<extra_type *>(extra)->convert(dst, src);
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                e->convert(dst, src);
+            }
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            if (e->src_string_tp) {
+                base_type_decref(e->src_string_tp);
+            }
+        }
+    };
+} // anonymous namespace
+
+/////////////////////////////////////////
+// string to builtin assignment
+
 size_t dynd::make_string_to_builtin_assignment_kernel(
                 ckernel_builder *out, size_t offset_out,
                 type_id_t dst_type_id,
@@ -438,14 +740,28 @@ size_t dynd::make_string_to_builtin_assignment_kernel(
     }
 
     if (dst_type_id >= bool_type_id && dst_type_id <= complex_float64_type_id) {
-        offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
         out->ensure_capacity_leaf(offset_out + sizeof(string_to_builtin_kernel_extra));
         string_to_builtin_kernel_extra *e = out->get_at<string_to_builtin_kernel_extra>(offset_out);
-        e->base.set_function<unary_single_operation_t>(static_string_to_builtin_kernels[dst_type_id-bool_type_id]);
+        switch (kernreq) {
+            case kernel_request_single:
+                e->base.set_function<unary_single_operation_t>(&string_to_builtin_kernel_extra::single);
+                break;
+            case kernel_request_strided:
+                e->base.set_function<unary_strided_operation_t>(&string_to_builtin_kernel_extra::strided);
+                break;
+            default: {
+                stringstream ss;
+                ss << "make_string_to_builtin_assignment_kernel: unrecognized request " << (int)kernreq;
+                throw runtime_error(ss.str());
+            }
+        }
         e->base.destructor = string_to_builtin_kernel_extra::destruct;
+        e->parse = static_utf8_to_builtin_parsers[dst_type_id-bool_type_id];
         // The kernel data owns this reference
         e->src_string_tp = static_cast<const base_string_type *>(ndt::type(src_string_tp).release());
         e->errmode = errmode;
+        string_encoding_t encoding = e->src_string_tp->get_encoding();
+        e->src_utf8 = (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii);
         e->src_metadata = src_metadata;
         return offset_out + sizeof(string_to_builtin_kernel_extra);
     } else {
@@ -456,7 +772,72 @@ size_t dynd::make_string_to_builtin_assignment_kernel(
 }
 
 /////////////////////////////////////////
-// string to builtin assignment
+// builtin to string assignment
+
+/**
+ * Formats a builtin value directly into `out`, which must have room for
+ * max_formatted_number_size characters. Returns the end of the characters
+ * written, or NULL if the type is one which is printed through iostreams.
+ */
+static char *format_builtin(type_id_t type_id, char *out, const char *src)
+{
+    switch (type_id) {
+        case bool_type_id:
+            if (*src) {
+                memcpy(out, "true", 4);
+                return out + 4;
+            } else {
+                memcpy(out, "false", 5);
+                return out + 5;
+            }
+        case int8_type_id:
+            return format_int64(out, *reinterpret_cast<const int8_t *>(src));
+        case int16_type_id:
+            return format_int64(out, *reinterpret_cast<const int16_t *>(src));
+        case int32_type_id:
+            return format_int64(out, *reinterpret_cast<const int32_t *>(src));
+        case int64_type_id:
+            return format_int64(out, *reinterpret_cast<const int64_t *>(src));
+        case uint8_type_id:
+            return format_uint64(out, *reinterpret_cast<const uint8_t *>(src));
+        case uint16_type_id:
+            return format_uint64(out, *reinterpret_cast<const uint16_t *>(src));
+        case uint32_type_id:
+            return format_uint64(out, *reinterpret_cast<const uint32_t *>(src));
+        case uint64_type_id:
+            return format_uint64(out, *reinterpret_cast<const uint64_t *>(src));
+        case float32_type_id:
+            return format_float32(out, *reinterpret_cast<const float *>(src));
+        case float64_type_id:
+            return format_float64(out, *reinterpret_cast<const double *>(src));
+        default:
+            return NULL;
+    }
+}
+
+static bool is_directly_formatted(type_id_t type_id)
+{
+    switch (type_id) {
+        case bool_type_id:
+        case int8_type_id:
+        case int16_type_id:
+        case int32_type_id:
+        case int64_type_id:
+        case uint8_type_id:
+        case uint16_type_id:
+        case uint32_type_id:
+        case uint64_type_id:
+        case float32_type_id:
+        case float64_type_id:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The number of values the strided kernel formats into its stack
+// buffer before copying them into the string memory block together
+enum { builtin_to_string_chunk_size = 128 };
 
 namespace {
     struct builtin_to_string_kernel_extra {
@@ -466,20 +847,75 @@ namespace {
         const base_string_type *dst_string_tp;
         type_id_t src_type_id;
         assign_error_mode errmode;
+        // True when the formatted characters can be placed in the
+        // destination's memory block as they are
+        bool dst_utf8_blockref;
         const char *dst_metadata;
 
         static void single(char *dst, const char *src,
                             ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
+            char buf[max_formatted_number_size];
+            char *buf_end = format_builtin(e->src_type_id, buf, src);
+            if (buf_end == NULL) {
+                stringstream ss;
+                ndt::type(e->src_type_id).print_data(ss, NULL, src);
+                e->dst_string_tp->set_utf8_string(e->dst_metadata, dst, e->errmode, ss.str());
+            } else if (e->dst_utf8_blockref) {
+                const string_type_metadata *md = reinterpret_cast<const string_type_metadata *>(e->dst_metadata);
+                memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(md->blockref);
+                char *dst_begin = NULL, *dst_end = NULL;
+                allocator->allocate(md->blockref, buf_end - buf, 1, &dst_begin, &dst_end);
+                memcpy(dst_begin, buf, buf_end - buf);
+                reinterpret_cast<string_type_data *>(dst)->begin = dst_begin;
+                reinterpret_cast<string_type_data *>(dst)->end = dst_end;
+            } else {
+                e->dst_string_tp->set_utf8_string(e->dst_metadata, dst, e->errmode, buf, buf_end);
+            }
+        }
 
-            // TODO: There are much faster ways to do this, but it's very generic!
-            //       Also, for floating point values, a printing scheme like Python's,
-            //       where it prints the shortest string that's guaranteed to parse to
-            //       the same float number, would be better.
-            stringstream ss;
-            ndt::type(e->src_type_id).print_data(ss, NULL, src);
-            e->dst_string_tp->set_utf8_string(e->dst_metadata, dst, e->errmode, ss.str());
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            if (!e->dst_utf8_blockref) {
+                for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                    single(dst, src, extra);
+                }
+                return;
+            }
+
+            // Format a chunk of values into a buffer, make one allocation
+            // for all of them, then point the strings into it
+            const string_type_metadata *md = reinterpret_cast<const string_type_metadata *>(e->dst_metadata);
+            memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(md->blockref);
+            type_id_t src_type_id = e->src_type_id;
+            char buf[builtin_to_string_chunk_size * max_formatted_number_size];
+            intptr_t ends[builtin_to_string_chunk_size];
+            while (count > 0) {
+                size_t chunk_count = count < (size_t)builtin_to_string_chunk_size
+                                ? count : (size_t)builtin_to_string_chunk_size;
+                char *buf_end = buf;
+                const char *chunk_src = src;
+                for (size_t i = 0; i != chunk_count; ++i, chunk_src += src_stride) {
+                    buf_end = format_builtin(src_type_id, buf_end, chunk_src);
+                    ends[i] = buf_end - buf;
+                }
+                char *dst_begin = NULL, *dst_end = NULL;
+                allocator->allocate(md->blockref, buf_end - buf, 1, &dst_begin, &dst_end);
+                memcpy(dst_begin, buf, buf_end - buf);
+                intptr_t begin_offset = 0;
+                for (size_t i = 0; i != chunk_count; ++i, dst += dst_stride) {
+                    string_type_data *d = reinterpret_cast<string_type_data *>(dst);
+                    d->begin = dst_begin + begin_offset;
+                    d->end = dst_begin + ends[i];
+                    begin_offset = ends[i];
+                }
+                src = chunk_src;
+                count -= chunk_count;
+            }
         }
 
         static void destruct(ckernel_prefix *extra)
@@ -506,15 +942,25 @@ size_t dynd::make_builtin_to_string_assignment_kernel(
     }
 
     if (src_type_id >= 0 && src_type_id < builtin_type_id_count) {
-        offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+        bool direct = is_directly_formatted(src_type_id);
+        if (!direct || kernreq != kernel_request_strided) {
+            offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+        }
         out->ensure_capacity_leaf(offset_out + sizeof(builtin_to_string_kernel_extra));
         builtin_to_string_kernel_extra *e = out->get_at<builtin_to_string_kernel_extra>(offset_out);
-        e->base.set_function<unary_single_operation_t>(builtin_to_string_kernel_extra::single);
+        if (direct && kernreq == kernel_request_strided) {
+            e->base.set_function<unary_strided_operation_t>(builtin_to_string_kernel_extra::strided);
+        } else {
+            e->base.set_function<unary_single_operation_t>(builtin_to_string_kernel_extra::single);
+        }
         e->base.destructor = builtin_to_string_kernel_extra::destruct;
         // The kernel data owns this reference
         e->dst_string_tp = static_cast<const base_string_type *>(ndt::type(dst_string_tp).release());
         e->src_type_id = src_type_id;
         e->errmode = errmode;
+        string_encoding_t encoding = e->dst_string_tp->get_encoding();
+        e->dst_utf8_blockref = direct && dst_string_tp.get_type_id() == string_type_id &&
+                        (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii);
         e->dst_metadata = dst_metadata;
         return offset_out + sizeof(builtin_to_string_kernel_extra);
     } else {
@@ -528,17 +974,11 @@ size_t dynd::make_builtin_to_string_assignment_kernel(
 void dynd::assign_utf8_string_to_builtin(type_id_t dst_type_id, char *dst,
                 const char *str_begin, const char *str_end, assign_error_mode errmode)
 {
-    ndt::type dt = ndt::make_string(string_encoding_utf_8);
-    string_type_data d;
-    string_type_metadata md;
-    d.begin = const_cast<char *>(str_begin);
-    d.end = const_cast<char *>(str_end);
-    md.blockref = NULL;
-
-    assignment_ckernel_builder k;
-    make_string_to_builtin_assignment_kernel(&k, 0,
-                    dst_type_id,
-                    dt, reinterpret_cast<const char *>(&md),
-                    kernel_request_single, errmode, &eval::default_eval_context);
-    k(dst, reinterpret_cast<const char *>(&d));
+    if (dst_type_id >= bool_type_id && dst_type_id <= complex_float64_type_id) {
+        static_utf8_to_builtin_parsers[dst_type_id-bool_type_id](dst, str_begin, str_end, errmode);
+    } else {
+        stringstream ss;
+        ss << "assign_utf8_string_to_builtin: destination type id " << dst_type_id << " is not builtin";
+        throw runtime_error(ss.str());
+    }
 }
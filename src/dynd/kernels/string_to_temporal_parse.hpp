@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+// This file is an internal implementation detail of the string to
+// date, time and datetime assignment kernels
+
+#ifndef _DYND__STRING_TO_TEMPORAL_PARSE_HPP_
+#define _DYND__STRING_TO_TEMPORAL_PARSE_HPP_
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <dynd/types/base_string_type.hpp>
+#include <dynd/string_encodings.hpp>
+
+namespace dynd { namespace detail {
+
+/**
+ * Parses the string at `src` into `dst` for a string to date, time or
+ * datetime kernel. The kernel data `e` has the fields
+ *
+ *   src_string_dt, src_metadata, errmode   - the source string
+ *   src_utf8                               - whether it can be parsed in place
+ *   iso8601_hits, iso8601_misses           - the fast path counters
+ *
+ * and provides ``value_type``, ``type_name()``, ``parse_iso8601_fixed``,
+ * ``parse_general`` and ``store``.
+ *
+ * "NA" is checked first, and counts as neither a hit nor a miss of
+ * the fixed width ISO 8601 fast path, so leading missing values
+ * don't turn the fast path off.
+ */
+template<class E>
+inline void parse_temporal_string(E *e, char *dst, const char *src)
+{
+    const char *begin, *end;
+    std::string s;
+    if (e->src_utf8) {
+        e->src_string_dt->get_string_range(&begin, &end, e->src_metadata, src);
+    } else {
+        s = e->src_string_dt->get_utf8_string(e->src_metadata, src, e->errmode);
+        begin = s.data();
+        end = begin + s.size();
+    }
+    typename E::value_type value;
+    // TODO: properly distinguish e.g. "date" and "option[date]" with respect to NA support
+    if (end - begin == 2 && begin[0] == 'N' && begin[1] == 'A') {
+        value.set_to_na();
+        e->store(dst, value);
+        return;
+    }
+    // Stay on the fast path until it misses as often as it hits,
+    // so data in another format stops paying for it
+    if (e->iso8601_misses <= e->iso8601_hits) {
+        if (e->parse_iso8601_fixed(begin, end, value)) {
+            ++e->iso8601_hits;
+            e->store(dst, value);
+            return;
+        }
+        ++e->iso8601_misses;
+    }
+    if (!e->parse_general(begin, end, value)) {
+        std::stringstream ss;
+        ss << "Unable to parse ";
+        print_escaped_utf8_string(ss, begin, end);
+        ss << " as a " << E::type_name();
+        throw std::invalid_argument(ss.str());
+    }
+    e->store(dst, value);
+}
+
+}} // namespace dynd::detail
+
+#endif // _DYND__STRING_TO_TEMPORAL_PARSE_HPP_
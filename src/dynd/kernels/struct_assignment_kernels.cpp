@@ -11,6 +11,7 @@
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/struct_assignment_kernels.hpp>
+#include <dynd/shortvector.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -46,6 +47,35 @@ namespace {
             }
         }
 
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const field_items *fi = reinterpret_cast<const field_items *>(e + 1);
+            size_t field_count = e->field_count;
+            ckernel_prefix *echild;
+            unary_strided_operation_t opchild;
+
+            // Assign the fields a chunk of records at a time, so each child
+            // kernel runs over many values while the chunk stays in cache
+            while (count > 0) {
+                size_t chunk_size = min(count, DYND_BUFFER_CHUNK_SIZE);
+                for (size_t i = 0; i < field_count; ++i) {
+                    const field_items& item = fi[i];
+                    echild  = reinterpret_cast<ckernel_prefix *>(eraw + item.child_kernel_offset);
+                    opchild = echild->get_function<unary_strided_operation_t>();
+                    opchild(dst + item.dst_data_offset, dst_stride,
+                                    src + item.src_data_offset, src_stride,
+                                    chunk_size, echild);
+                }
+                dst += dst_stride * chunk_size;
+                src += src_stride * chunk_size;
+                count -= chunk_size;
+            }
+        }
+
         static void destruct(ckernel_prefix *extra)
         {
             char *eraw = reinterpret_cast<char *>(extra);
@@ -64,6 +94,91 @@ namespace {
             }
         }
     };
+
+    /**
+     * Creates a struct_kernel_extra assigning the fields described by the
+     * arrays, one entry per destination field. Runs of POD fields with the
+     * same type on both sides, laid out back to back in the same way in
+     * both, are copied together as one block of bytes.
+     */
+    size_t make_struct_fields_assignment_kernel(
+                    ckernel_builder *out_ckb, size_t ckb_offset, size_t field_count,
+                    const ndt::type *dst_field_tps, const char *const *dst_field_metadata,
+                    const size_t *dst_data_offsets,
+                    const ndt::type *src_field_tps, const char *const *src_field_metadata,
+                    const size_t *src_data_offsets,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx)
+    {
+        // Group the fields into runs, where each run is either a single
+        // field or a block of POD bytes
+        vector<size_t> run_starts;
+        for (size_t i = 0; i != field_count; ++i) {
+            if (i > 0) {
+                const ndt::type& prev_tp = dst_field_tps[i - 1];
+                size_t prev_size = prev_tp.get_data_size();
+                if (prev_tp.is_pod() && prev_tp == src_field_tps[i - 1] &&
+                        dst_field_tps[i].is_pod() && dst_field_tps[i] == src_field_tps[i] &&
+                        dst_data_offsets[i] == dst_data_offsets[i - 1] + prev_size &&
+                        src_data_offsets[i] == src_data_offsets[i - 1] + prev_size) {
+                    continue;
+                }
+            }
+            run_starts.push_back(i);
+        }
+        size_t run_count = run_starts.size();
+        run_starts.push_back(field_count);
+
+        size_t extra_size = sizeof(struct_kernel_extra) +
+                        run_count * sizeof(struct_kernel_extra::field_items);
+        out_ckb->ensure_capacity(ckb_offset + extra_size);
+        struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
+        switch (kernreq) {
+            case kernel_request_single:
+                e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
+                break;
+            case kernel_request_strided:
+                e->base.set_function<unary_strided_operation_t>(&struct_kernel_extra::strided);
+                break;
+            default: {
+                stringstream ss;
+                ss << "make_struct_assignment_kernel: unrecognized request " << (int)kernreq;
+                throw runtime_error(ss.str());
+            }
+        }
+        e->base.destructor = &struct_kernel_extra::destruct;
+        e->field_count = run_count;
+
+        // Create the kernels and offsets for copying each run
+        size_t current_offset = ckb_offset + extra_size;
+        struct_kernel_extra::field_items *fi;
+        for (size_t r = 0; r != run_count; ++r) {
+            size_t i = run_starts[r], i_end = run_starts[r + 1];
+            out_ckb->ensure_capacity(current_offset);
+            // Adding another kernel may have invalidated 'e', so get it again
+            e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
+            fi = reinterpret_cast<struct_kernel_extra::field_items *>(e + 1) + r;
+            fi->child_kernel_offset = current_offset - ckb_offset;
+            fi->dst_data_offset = dst_data_offsets[i];
+            fi->src_data_offset = src_data_offsets[i];
+            if (i_end - i > 1) {
+                size_t data_size = dst_data_offsets[i_end - 1] +
+                                dst_field_tps[i_end - 1].get_data_size() - dst_data_offsets[i];
+                size_t data_alignment = dst_field_tps[i].get_data_alignment();
+                for (size_t j = i + 1; j != i_end; ++j) {
+                    data_alignment = min(data_alignment, dst_field_tps[j].get_data_alignment());
+                }
+                current_offset = make_pod_typed_data_assignment_kernel(out_ckb, current_offset,
+                                data_size, data_alignment, kernreq);
+            } else {
+                current_offset = ::make_assignment_kernel(out_ckb, current_offset,
+                                dst_field_tps[i], dst_field_metadata[i],
+                                src_field_tps[i], src_field_metadata[i],
+                                kernreq, errmode, ectx);
+            }
+        }
+        return current_offset;
+    }
 } // anonymous namespace
 
 /////////////////////////////////////////
@@ -88,39 +203,21 @@ size_t dynd::make_struct_identical_assignment_kernel(
                         kernreq);
     }
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
     const base_struct_type *sd = static_cast<const base_struct_type *>(val_struct_tp.extended());
     size_t field_count = sd->get_field_count();
-
-    size_t extra_size = sizeof(struct_kernel_extra) +
-                    field_count * sizeof(struct_kernel_extra::field_items);
-    out_ckb->ensure_capacity(ckb_offset + extra_size);
-    struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
-    e->base.destructor = &struct_kernel_extra::destruct;
-    e->field_count = field_count;
-
-    const size_t *dst_data_offsets = sd->get_data_offsets(dst_metadata);
-    const size_t *src_data_offsets = sd->get_data_offsets(src_metadata);
-
-    // Create the kernels and dst offsets for copying individual fields
-    size_t current_offset = ckb_offset + extra_size;
-    struct_kernel_extra::field_items *fi;
+    const size_t *metadata_offsets = sd->get_metadata_offsets();
+    shortvector<const char *> dst_field_metadata(field_count), src_field_metadata(field_count);
     for (size_t i = 0; i != field_count; ++i) {
-        out_ckb->ensure_capacity(current_offset);
-        // Adding another kernel may have invalidated 'e', so get it again
-        e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-        fi = reinterpret_cast<struct_kernel_extra::field_items *>(e + 1) + i;
-        fi->child_kernel_offset = current_offset - ckb_offset;
-        fi->dst_data_offset = dst_data_offsets[i];
-        fi->src_data_offset = src_data_offsets[i];
-        current_offset = ::make_assignment_kernel(out_ckb, current_offset,
-                        sd->get_field_types()[i], dst_metadata + sd->get_metadata_offsets()[i],
-                        sd->get_field_types()[i], src_metadata + sd->get_metadata_offsets()[i],
-                        kernel_request_single, errmode, ectx);
+        dst_field_metadata[i] = dst_metadata + metadata_offsets[i];
+        src_field_metadata[i] = src_metadata + metadata_offsets[i];
     }
-    return current_offset;
+
+    return make_struct_fields_assignment_kernel(out_ckb, ckb_offset, field_count,
+                    sd->get_field_types(), dst_field_metadata.get(),
+                    sd->get_data_offsets(dst_metadata),
+                    sd->get_field_types(), src_field_metadata.get(),
+                    sd->get_data_offsets(src_metadata),
+                    kernreq, errmode, ectx);
 }
 
 /////////////////////////////////////////
@@ -154,16 +251,6 @@ size_t dynd::make_struct_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
-    size_t extra_size = sizeof(struct_kernel_extra) +
-                    field_count * sizeof(struct_kernel_extra::field_items);
-    out_ckb->ensure_capacity(ckb_offset + extra_size);
-    struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
-    e->base.destructor = &struct_kernel_extra::destruct;
-    e->field_count = field_count;
-
     // Match up the fields
     const string *dst_field_names = dst_sd->get_field_names();
     const string *src_field_names = src_sd->get_field_names();
@@ -182,30 +269,28 @@ size_t dynd::make_struct_assignment_kernel(
     }
 
     const ndt::type *src_field_types = src_sd->get_field_types();
-    const ndt::type *dst_field_types = dst_sd->get_field_types();
     const size_t *src_data_offsets = src_sd->get_data_offsets(src_metadata);
-    const size_t *dst_data_offsets = dst_sd->get_data_offsets(dst_metadata);
     const size_t *src_metadata_offsets = src_sd->get_metadata_offsets();
     const size_t *dst_metadata_offsets = dst_sd->get_metadata_offsets();
 
-    // Create the kernels and dst offsets for copying individual fields
-    size_t current_offset = ckb_offset + extra_size;
-    struct_kernel_extra::field_items *fi;
+    // Gather the source fields into destination field order
+    vector<ndt::type> src_reordered_tps(field_count);
+    shortvector<size_t> src_reordered_data_offsets(field_count);
+    shortvector<const char *> dst_field_metadata(field_count), src_field_metadata(field_count);
     for (size_t i = 0; i != field_count; ++i) {
         size_t i_src = field_reorder[i];
-        out_ckb->ensure_capacity(current_offset);
-        // Ensuring capacity may have invalidated 'e', so get it again
-        e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-        fi = reinterpret_cast<struct_kernel_extra::field_items *>(e + 1) + i;
-        fi->child_kernel_offset = current_offset - ckb_offset;
-        fi->dst_data_offset = dst_data_offsets[i];
-        fi->src_data_offset = src_data_offsets[i_src];
-        current_offset = ::make_assignment_kernel(out_ckb, current_offset,
-                        dst_field_types[i], dst_metadata + dst_metadata_offsets[i],
-                        src_field_types[i_src], src_metadata + src_metadata_offsets[i_src],
-                        kernel_request_single, errmode, ectx);
+        src_reordered_tps[i] = src_field_types[i_src];
+        src_reordered_data_offsets[i] = src_data_offsets[i_src];
+        dst_field_metadata[i] = dst_metadata + dst_metadata_offsets[i];
+        src_field_metadata[i] = src_metadata + src_metadata_offsets[i_src];
     }
-    return current_offset;
+
+    return make_struct_fields_assignment_kernel(out_ckb, ckb_offset, field_count,
+                    dst_sd->get_field_types(), dst_field_metadata.get(),
+                    dst_sd->get_data_offsets(dst_metadata),
+                    field_count ? &src_reordered_tps[0] : NULL, src_field_metadata.get(),
+                    src_reordered_data_offsets.get(),
+                    kernreq, errmode, ectx);
 }
 
 /////////////////////////////////////////
@@ -230,35 +315,22 @@ size_t dynd::make_broadcast_to_struct_assignment_kernel(
     const base_struct_type *dst_sd = static_cast<const base_struct_type *>(dst_struct_tp.extended());
     size_t field_count = dst_sd->get_field_count();
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
-    size_t extra_size = sizeof(struct_kernel_extra) +
-                    field_count * sizeof(struct_kernel_extra::field_items);
-    out_ckb->ensure_capacity(ckb_offset + extra_size);
-    struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
-    e->base.destructor = &struct_kernel_extra::destruct;
-    e->field_count = field_count;
-
-    const ndt::type *dst_field_types = dst_sd->get_field_types();
-    const size_t *dst_data_offsets = dst_sd->get_data_offsets(dst_metadata);
     const size_t *dst_metadata_offsets = dst_sd->get_metadata_offsets();
 
-    // Create the kernels and dst offsets for copying individual fields
-    size_t current_offset = ckb_offset + extra_size;
-    struct_kernel_extra::field_items *fi;
+    // Every field is assigned from the same source value
+    vector<ndt::type> src_field_tps(field_count, src_tp);
+    shortvector<size_t> src_data_offsets(field_count);
+    shortvector<const char *> dst_field_metadata(field_count), src_field_metadata(field_count);
     for (size_t i = 0; i != field_count; ++i) {
-        out_ckb->ensure_capacity(current_offset);
-        // Ensuring capacity may have invalidated 'e', so get it again
-        e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-        fi = reinterpret_cast<struct_kernel_extra::field_items *>(e + 1) + i;
-        fi->child_kernel_offset = current_offset - ckb_offset;
-        fi->dst_data_offset = dst_data_offsets[i];
-        fi->src_data_offset = 0;
-        current_offset = ::make_assignment_kernel(out_ckb, current_offset,
-                        dst_field_types[i], dst_metadata + dst_metadata_offsets[i],
-                        src_tp, src_metadata,
-                        kernel_request_single, errmode, ectx);
+        src_data_offsets[i] = 0;
+        dst_field_metadata[i] = dst_metadata + dst_metadata_offsets[i];
+        src_field_metadata[i] = src_metadata;
     }
-    return current_offset;
+
+    return make_struct_fields_assignment_kernel(out_ckb, ckb_offset, field_count,
+                    dst_sd->get_field_types(), dst_field_metadata.get(),
+                    dst_sd->get_data_offsets(dst_metadata),
+                    field_count ? &src_field_tps[0] : NULL, src_field_metadata.get(),
+                    src_data_offsets.get(),
+                    kernreq, errmode, ectx);
 }
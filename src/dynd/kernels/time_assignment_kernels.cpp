@@ -6,6 +6,8 @@
 #include <dynd/kernels/time_assignment_kernels.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/types/cstruct_type.hpp>
+#include <dynd/types/time_parser.hpp>
+#include "string_to_temporal_parse.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -18,28 +20,57 @@ namespace {
         typedef string_to_time_kernel_extra extra_type;
 
         ckernel_prefix base;
-        const base_string_type *src_string_tp;
+        const base_string_type *src_string_dt;
         const char *src_metadata;
         assign_error_mode errmode;
 
+        // Whether the string bytes are UTF-8, so can be parsed in place
+        bool src_utf8;
+        // How often the fixed width ISO 8601 fast path has matched
+        intptr_t iso8601_hits, iso8601_misses;
+
+        typedef time_hmst value_type;
+
+        static const char *type_name() {
+            return "time";
+        }
+
+        inline bool parse_iso8601_fixed(const char *begin, const char *end, time_hmst& value) const {
+            return string_to_time_iso8601_fixed(begin, end, value);
+        }
+
+        inline bool parse_general(const char *begin, const char *end, time_hmst& value) const {
+            return string_to_time(begin, end, value);
+        }
+
+        inline void store(char *dst, const time_hmst& value) const {
+            *reinterpret_cast<int64_t *>(dst) = value.to_ticks();
+        }
+
+        inline void parse(char *dst, const char *src)
+        {
+            detail::parse_temporal_string(this, dst, src);
+        }
+
         static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            reinterpret_cast<extra_type *>(extra)->parse(dst, src);
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
-            const string& s = e->src_string_tp->get_utf8_string(e->src_metadata, src, e->errmode);
-            time_hmst hmst;
-            // TODO: properly distinguish "time" and "option[time]" with respect to NA support
-            if (s == "NA") {
-                hmst.set_to_na();
-            } else {
-                hmst.set_from_str(s);
+            for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                e->parse(dst, src);
             }
-            *reinterpret_cast<int64_t *>(dst) = hmst.to_ticks();
         }
 
         static void destruct(ckernel_prefix *extra)
         {
             extra_type *e = reinterpret_cast<extra_type *>(extra);
-            base_type_xdecref(e->src_string_tp);
+            base_type_xdecref(e->src_string_dt);
         }
     };
 } // anonymous namespace
@@ -58,15 +89,30 @@ size_t dynd::make_string_to_time_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
-    out->ensure_capacity(offset_out + sizeof(string_to_time_kernel_extra));
+    out->ensure_capacity_leaf(offset_out + sizeof(string_to_time_kernel_extra));
     string_to_time_kernel_extra *e = out->get_at<string_to_time_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&string_to_time_kernel_extra::single);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(&string_to_time_kernel_extra::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(&string_to_time_kernel_extra::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_string_to_time_assignment_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
     e->base.destructor = &string_to_time_kernel_extra::destruct;
     // The kernel data owns a reference to this type
-    e->src_string_tp = static_cast<const base_string_type *>(ndt::type(src_string_tp).release());
+    e->src_string_dt = static_cast<const base_string_type *>(ndt::type(src_string_tp).release());
     e->src_metadata = src_metadata;
     e->errmode = errmode;
+    string_encoding_t encoding = e->src_string_dt->get_encoding();
+    e->src_utf8 = (encoding == string_encoding_utf_8 || encoding == string_encoding_ascii);
+    e->iso8601_hits = 0;
+    e->iso8601_misses = 0;
     return offset_out + sizeof(string_to_time_kernel_extra);
 }
 
@@ -4,6 +4,7 @@
 //
 
 #include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 #include <dynd/types/base_memory_type.hpp>
 #include <dynd/array.hpp>
 #include <dynd/exceptions.hpp>
@@ -49,17 +50,16 @@ void free_array_memory_block(memory_block_data *memblock)
     }
 
     // Finally free the memory block itself
-    free(reinterpret_cast<void *>(memblock));
+    free_memory_block_data(array_memory_block_type, memblock);
 }
 
 }} // namespace dynd::detail
 
 memory_block_ptr dynd::make_array_memory_block(size_t metadata_size)
 {
-    char *result = (char *)malloc(sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_memory_block_data(array_memory_block_type,
+                    sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size,
+                    sizeof(void *));
     // Zero out all the metadata to start
     memset(result + sizeof(memory_block_data), 0, sizeof(array_preamble) + metadata_size);
     return memory_block_ptr(new (result) memory_block_data(1, array_memory_block_type), false);
@@ -68,12 +68,13 @@ memory_block_ptr dynd::make_array_memory_block(size_t metadata_size)
 memory_block_ptr dynd::make_array_memory_block(size_t metadata_size, size_t extra_size,
                     size_t extra_alignment, char **out_extra_ptr)
 {
+    // Large data gets the large allocation alignment, which the block itself
+    // is allocated with so the data offset keeps it
+    extra_alignment = max(get_allocation_alignment(extra_size, extra_alignment), sizeof(void *));
     size_t extra_offset = inc_to_alignment(sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size,
                                         extra_alignment);
-    char *result = (char *)malloc(extra_offset + extra_size);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_memory_block_data(array_memory_block_type,
+                    extra_offset + extra_size, extra_alignment);
     // Zero out all the metadata to start
     memset(result + sizeof(memory_block_data), 0, sizeof(array_preamble) + metadata_size);
     // Return a pointer to the extra allocated memory
@@ -108,7 +109,7 @@ memory_block_ptr dynd::make_array_memory_block(const ndt::type& tp, intptr_t ndi
             static_cast<const base_memory_type*>(dtp.extended())->data_zeroinit(data_ptr, data_size);
         }
         else {
-            memset(data_ptr, 0, data_size);
+            first_touch_zeroinit(data_ptr, data_size);
         }
     }
 
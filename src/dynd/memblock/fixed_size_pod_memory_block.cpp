@@ -4,8 +4,10 @@
 //
 
 #include <cstdlib>
+#include <algorithm>
 
 #include <dynd/memblock/fixed_size_pod_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -14,7 +16,7 @@ namespace dynd { namespace detail {
 
 void free_fixed_size_pod_memory_block(memory_block_data *memblock)
 {
-    free(reinterpret_cast<void *>(memblock));
+    free_memory_block_data(fixed_size_pod_memory_block_type, memblock);
 }
 
 }} // namespace dynd::detail
@@ -22,13 +24,12 @@ void free_fixed_size_pod_memory_block(memory_block_data *memblock)
 memory_block_ptr dynd::make_fixed_size_pod_memory_block(intptr_t size_bytes, intptr_t alignment, char **out_datapointer)
 {
     // Calculate the aligned starting point for the data
+    alignment = max((intptr_t)get_allocation_alignment(size_bytes, alignment), (intptr_t)sizeof(void *));
     intptr_t start = (intptr_t)(((uintptr_t)sizeof(memory_block_data) + (uintptr_t)(alignment - 1))
                         & ~((uintptr_t)(alignment - 1)));
     // Allocate it
-    char *result = (char *)malloc(start + size_bytes);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_memory_block_data(fixed_size_pod_memory_block_type,
+                    start + size_bytes, alignment);
     // Give back the data pointer
     *out_datapointer = result + start;
     // Use placement new to initialize and return the memory block
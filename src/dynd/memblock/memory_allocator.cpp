@@ -0,0 +1,267 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include <dynd/memblock/memory_allocator.hpp>
+#include <dynd/eval/parallel_tasks.hpp>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#include <intrin.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#ifdef DYND_USE_STD_ATOMIC
+#include <atomic>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+#ifdef DYND_USE_STD_ATOMIC
+    typedef std::atomic<uint64_t> atomic_counter;
+
+    inline void counter_add(atomic_counter& c, uint64_t value) {
+        c += value;
+    }
+#elif defined(_WIN32)
+    typedef volatile int64_t atomic_counter;
+
+    inline void counter_add(atomic_counter& c, uint64_t value) {
+        _InterlockedExchangeAdd64((volatile __int64 *)&c, (__int64)value);
+    }
+#else
+    typedef volatile uint64_t atomic_counter;
+
+    inline void counter_add(atomic_counter& c, uint64_t value) {
+        __sync_fetch_and_add(&c, value);
+    }
+#endif
+
+    /** The counters for one memory block type */
+    struct memory_block_counters {
+        atomic_counter allocation_count;
+        atomic_counter allocated_bytes;
+        atomic_counter free_count;
+    };
+
+    const int memory_block_type_count = memmap_memory_block_type + 1;
+    memory_block_counters counters[memory_block_type_count];
+
+    void *default_allocate(size_t size_bytes, size_t alignment)
+    {
+        // Zero sized allocations still return a unique pointer
+        size_bytes = max(size_bytes, (size_t)1);
+#if defined(_WIN32)
+        return _aligned_malloc(size_bytes, alignment);
+#else
+        if (alignment <= 2 * sizeof(void *)) {
+            // malloc memory is already aligned this much
+            return malloc(size_bytes);
+        } else {
+            void *result = NULL;
+            if (posix_memalign(&result, alignment, size_bytes) != 0) {
+                return NULL;
+            }
+            return result;
+        }
+#endif
+    }
+
+    void default_free(void *ptr)
+    {
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+
+    const memory_allocator_api default_memory_allocator = {
+        &default_allocate,
+        &default_free
+    };
+
+    const memory_allocator_api *current_memory_allocator = &default_memory_allocator;
+    bool huge_pages_enabled = false;
+    intptr_t first_touch_threads = 1;
+
+    /**
+     * The minimum number of bytes each thread zeroes in
+     * first_touch_zeroinit, so smaller regions aren't split.
+     */
+    const size_t first_touch_min_bytes_per_thread = 8 * 1024 * 1024;
+    /** Each thread of first_touch_zeroinit starts on a multiple of this */
+    const size_t first_touch_page_size = 4096;
+
+    struct first_touch_task_data {
+        char *data;
+        size_t size_bytes;
+        size_t chunk_size;
+    };
+
+    void first_touch_task(intptr_t task_index, void *task_data)
+    {
+        const first_touch_task_data *td = reinterpret_cast<const first_touch_task_data *>(task_data);
+        size_t begin = task_index * td->chunk_size;
+        if (begin < td->size_bytes) {
+            memset(td->data + begin, 0, min(td->chunk_size, td->size_bytes - begin));
+        }
+    }
+} // anonymous namespace
+
+const memory_allocator_api *dynd::get_default_memory_allocator()
+{
+    return &default_memory_allocator;
+}
+
+const memory_allocator_api *dynd::get_memory_allocator()
+{
+    return current_memory_allocator;
+}
+
+const memory_allocator_api *dynd::set_memory_allocator(const memory_allocator_api *api)
+{
+    const memory_allocator_api *prev = current_memory_allocator;
+    current_memory_allocator = (api != NULL) ? api : &default_memory_allocator;
+    return prev;
+}
+
+bool dynd::set_huge_pages_enabled(bool enabled)
+{
+    bool prev = huge_pages_enabled;
+    huge_pages_enabled = enabled;
+    return prev;
+}
+
+bool dynd::get_huge_pages_enabled()
+{
+    return huge_pages_enabled;
+}
+
+intptr_t dynd::set_first_touch_threads(intptr_t thread_count)
+{
+    if (thread_count < 1) {
+        stringstream ss;
+        ss << "the first touch thread count must be at least 1, got " << thread_count;
+        throw runtime_error(ss.str());
+    }
+    intptr_t prev = first_touch_threads;
+    first_touch_threads = thread_count;
+    return prev;
+}
+
+intptr_t dynd::get_first_touch_threads()
+{
+    return first_touch_threads;
+}
+
+namespace {
+    /**
+     * Each allocation is preceded by a header recording where the
+     * allocator's memory starts and which allocator it came from, so it
+     * is freed correctly even after set_memory_allocator changes the
+     * current allocator.
+     */
+    struct allocation_header {
+        void *raw_ptr;
+        const memory_allocator_api *allocator;
+    };
+
+    inline allocation_header *get_allocation_header(void *ptr) {
+        return reinterpret_cast<allocation_header *>(ptr) - 1;
+    }
+} // anonymous namespace
+
+char *dynd::allocate_memory_block_data(memory_block_type_t mbt, size_t size_bytes, size_t alignment)
+{
+    alignment = max(get_allocation_alignment(size_bytes, alignment), sizeof(void *));
+    // The header goes in front, padded to keep the requested alignment
+    size_t header_size = (sizeof(allocation_header) + alignment - 1) & ~(alignment - 1);
+    size_t raw_size = header_size + size_bytes;
+    bool huge = huge_pages_enabled && raw_size >= DYND_HUGE_PAGE_SIZE;
+    const memory_allocator_api *allocator = current_memory_allocator;
+    char *raw = reinterpret_cast<char *>(allocator->allocate(raw_size,
+                    huge ? max(alignment, DYND_HUGE_PAGE_SIZE) : alignment));
+    if (raw == NULL) {
+        throw bad_alloc();
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (huge) {
+        // Only advise whole huge pages. This is a hint, so a failure is ignored
+        madvise(raw, raw_size & ~(DYND_HUGE_PAGE_SIZE - 1), MADV_HUGEPAGE);
+    }
+#endif
+    char *result = raw + header_size;
+    allocation_header *header = get_allocation_header(result);
+    header->raw_ptr = raw;
+    header->allocator = allocator;
+    if ((int)mbt < memory_block_type_count) {
+        counter_add(counters[mbt].allocation_count, 1);
+        counter_add(counters[mbt].allocated_bytes, size_bytes);
+    }
+    return result;
+}
+
+void dynd::free_memory_block_data(memory_block_type_t mbt, void *ptr)
+{
+    if (ptr != NULL) {
+        const allocation_header *header = get_allocation_header(ptr);
+        header->allocator->free(header->raw_ptr);
+        if ((int)mbt < memory_block_type_count) {
+            counter_add(counters[mbt].free_count, 1);
+        }
+    }
+}
+
+void dynd::first_touch_zeroinit(char *data, size_t size_bytes)
+{
+    if (first_touch_threads <= 1) {
+        memset(data, 0, size_bytes);
+        return;
+    }
+    intptr_t thread_count = min(first_touch_threads,
+                    (intptr_t)(size_bytes / first_touch_min_bytes_per_thread));
+    if (thread_count <= 1) {
+        memset(data, 0, size_bytes);
+        return;
+    }
+    first_touch_task_data td;
+    td.data = data;
+    td.size_bytes = size_bytes;
+    // Round each thread's range up to whole pages
+    td.chunk_size = (size_bytes + thread_count - 1) / thread_count;
+    td.chunk_size = (td.chunk_size + first_touch_page_size - 1) & ~(first_touch_page_size - 1);
+    eval::parallel_run_tasks(thread_count, &first_touch_task, &td);
+}
+
+memory_allocation_counts dynd::get_memory_allocation_counts(memory_block_type_t mbt)
+{
+    memory_allocation_counts result;
+    memset(&result, 0, sizeof(result));
+    if ((int)mbt < memory_block_type_count) {
+        result.allocation_count = counters[mbt].allocation_count;
+        result.allocated_bytes = counters[mbt].allocated_bytes;
+        result.free_count = counters[mbt].free_count;
+    }
+    return result;
+}
+
+void dynd::reset_memory_allocation_counts()
+{
+    for (int i = 0; i < memory_block_type_count; ++i) {
+        counters[i].allocation_count = 0;
+        counters[i].allocated_bytes = 0;
+        counters[i].free_count = 0;
+    }
+}
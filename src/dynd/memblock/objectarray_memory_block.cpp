@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include <dynd/memblock/objectarray_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -27,7 +28,7 @@ namespace {
         intptr_t m_stride;
         size_t m_total_allocated_count;
         bool m_finalized;
-        /** The malloc'd memory */
+        /** The allocated memory */
         vector<memory_chunk> m_memory_handles;
 
         /**
@@ -40,11 +41,12 @@ namespace {
             memory_chunk& mc = m_memory_handles.back();
             mc.used_count = 0;
             mc.capacity_count = count;
-            char *memory = reinterpret_cast<char *>(malloc(m_stride * count));
-            mc.memory = memory;
-            if (memory == NULL) {
+            try {
+                mc.memory = allocate_memory_block_data(objectarray_memory_block_type,
+                                m_stride * count, 2 * sizeof(void *));
+            } catch(...) {
                 m_memory_handles.pop_back();
-                throw bad_alloc();
+                throw;
             }
             m_total_allocated_count += count;
         }
@@ -68,7 +70,7 @@ namespace {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
                 memory_chunk& mc = m_memory_handles[i];
                 m_dt.extended()->data_destruct_strided(m_metadata, mc.memory, m_stride, mc.used_count);
-                free(mc.memory);
+                free_memory_block_data(objectarray_memory_block_type, mc.memory);
             }
         }
     };
@@ -134,7 +136,7 @@ static char *resize(memory_block_data *self, char *previous_allocated, size_t co
             // If the old memory only had the memory being resized,
             // free it completely.
             if (previous_allocated == mc->memory) {
-                free(mc->memory);
+                free_memory_block_data(objectarray_memory_block_type, mc->memory);
                 // Remove the second-last element of the vector
                 emb->m_memory_handles.erase(
                             emb->m_memory_handles.begin() +
@@ -190,7 +192,7 @@ static void reset(memory_block_data *self)
             memory_chunk& mc = emb->m_memory_handles[i];
             emb->m_dt.extended()->data_destruct_strided(
                             emb->m_metadata, mc.memory, emb->m_stride, mc.used_count);
-            free(mc.memory);
+            free_memory_block_data(objectarray_memory_block_type, mc.memory);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include <dynd/memblock/zeroinit_memory_block.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -18,24 +19,28 @@ namespace {
         /** Every memory block object needs this at the front */
         memory_block_data m_mbd;
         intptr_t m_total_allocated_capacity;
-        /** The malloc'd memory */
+        /** The allocated memory */
         vector<char *> m_memory_handles;
-        /** The current malloc'd memory being doled out */
+        /** The current allocated memory being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
+        /** The alignment of the most recent allocation, which resize keeps */
+        intptr_t m_last_alignment;
 
         /**
          * Allocates some new memory from which to dole out
          * more. Adds it to the memory handles vector.
          */
-        void append_memory(intptr_t capacity_bytes)
+        void append_memory(intptr_t capacity_bytes, intptr_t alignment)
         {
             m_memory_handles.push_back(NULL);
-            m_memory_begin = reinterpret_cast<char *>(malloc(capacity_bytes));
-            m_memory_handles.back() = m_memory_begin;
-            if (m_memory_begin == NULL) {
+            try {
+                m_memory_begin = allocate_memory_block_data(zeroinit_memory_block_type,
+                                capacity_bytes, max((size_t)alignment, 2 * sizeof(void *)));
+            } catch(...) {
                 m_memory_handles.pop_back();
-                throw bad_alloc();
+                throw;
             }
+            m_memory_handles.back() = m_memory_begin;
             m_memory_current = m_memory_begin;
             m_memory_end = m_memory_current + capacity_bytes;
             m_total_allocated_capacity += capacity_bytes;
@@ -43,15 +48,15 @@ namespace {
 
         zeroinit_memory_block(intptr_t initial_capacity_bytes)
             : m_mbd(1, zeroinit_memory_block_type), m_total_allocated_capacity(0),
-                    m_memory_handles()
+                    m_memory_handles(), m_last_alignment(1)
         {
-            append_memory(initial_capacity_bytes);
+            append_memory(initial_capacity_bytes, 1);
         }
 
         ~zeroinit_memory_block()
         {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
-                free(m_memory_handles[i]);
+                free_memory_block_data(zeroinit_memory_block_type, m_memory_handles[i]);
             }
         }
     };
@@ -82,14 +87,14 @@ static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alig
     if (end > emb->m_memory_end) {
         emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes), alignment);
         begin = emb->m_memory_begin;
         end = begin + size_bytes;
     }
 
     // Indicate where to allocate the next memory
     emb->m_memory_current = end;
+    emb->m_last_alignment = alignment;
 
     // Zero-initialize the memory
     memset(begin, 0, end - begin);
@@ -120,12 +125,11 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
         }
         *inout_end = end;
     } else {
-        // If it doesn't fit, need to copy to newly malloc'd memory
+        // If it doesn't fit, need to copy to newly allocated memory
 		char *old_current = *inout_begin, *old_end = *inout_end;
         intptr_t old_size_bytes = *inout_end - *inout_begin;
         // Allocate memory to double the amount used so far, or the requested size, whichever is larger
-        // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes), emb->m_last_alignment);
         memcpy(emb->m_memory_begin, *inout_begin, old_size_bytes);
         end = emb->m_memory_begin + size_bytes;
         emb->m_memory_current = end;
@@ -161,7 +165,7 @@ static void reset(memory_block_data *self)
         // If there are more than one allocated memory chunks,
         // throw them all away except the last
         for (size_t i = 0, i_end = emb->m_memory_handles.size() - 1; i != i_end; ++i) {
-            free(emb->m_memory_handles[i]);
+            free_memory_block_data(zeroinit_memory_block_type, emb->m_memory_handles[i]);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -0,0 +1,149 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dynd/number_formatting.hpp>
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+# define snprintf _snprintf
+#endif
+
+using namespace std;
+using namespace dynd;
+
+// The two digit strings for 00 through 99
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+char *dynd::format_uint64(char *out, uint64_t value)
+{
+    // Generate the digits backwards, two at a time
+    char buf[20];
+    char *p = buf + sizeof(buf);
+    while (value >= 100) {
+        unsigned int i = (unsigned int)(value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        p[0] = digit_pairs[i];
+        p[1] = digit_pairs[i + 1];
+    }
+    if (value >= 10) {
+        unsigned int i = (unsigned int)value * 2;
+        p -= 2;
+        p[0] = digit_pairs[i];
+        p[1] = digit_pairs[i + 1];
+    } else {
+        *--p = (char)('0' + value);
+    }
+    size_t size = buf + sizeof(buf) - p;
+    memcpy(out, p, size);
+    return out + size;
+}
+
+char *dynd::format_int64(char *out, int64_t value)
+{
+    if (value < 0) {
+        *out++ = '-';
+        // Negate as unsigned, so the minimum value works too
+        return format_uint64(out, ~(uint64_t)value + 1);
+    } else {
+        return format_uint64(out, (uint64_t)value);
+    }
+}
+
+static inline bool is_finite(double value)
+{
+    // Infinity minus infinity, like anything involving NaN, is NaN
+    return value - value == 0;
+}
+
+static inline bool has_sign_bit(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) != 0;
+}
+
+static char *format_nonfinite(char *out, double value)
+{
+    if (value != value) {
+        memcpy(out, "nan", 3);
+        return out + 3;
+    } else if (value > 0) {
+        memcpy(out, "inf", 3);
+        return out + 3;
+    } else {
+        memcpy(out, "-inf", 4);
+        return out + 4;
+    }
+}
+
+/**
+ * Formats with snprintf at increasing precision until the
+ * text parses back to the same value. Starting at the number of
+ * decimal digits guaranteed to survive a round trip (DBL_DIG or
+ * FLT_DIG) gives the shortest such text, because every decimal
+ * with at most that many digits rounds back to itself.
+ */
+template<class T>
+static char *format_float_roundtrip(char *out, T value, int min_precision, int max_precision)
+{
+    char buf[max_formatted_number_size];
+    int size = 0;
+    for (int precision = min_precision; precision <= max_precision; ++precision) {
+        size = snprintf(buf, sizeof(buf), "%.*g", precision, (double)value);
+        // Parsing uses the same locale as snprintf, so the
+        // check is valid even if the decimal point isn't '.'
+        if (precision == max_precision || (T)strtod(buf, NULL) == value) {
+            break;
+        }
+    }
+    for (int i = 0; i < size; ++i) {
+        char c = buf[i];
+        if ((c < '0' || c > '9') && c != '-' && c != '+' && c != 'e') {
+            c = '.';
+        }
+        out[i] = c;
+    }
+    return out + size;
+}
+
+char *dynd::format_float64(char *out, double value)
+{
+    if (!is_finite(value)) {
+        return format_nonfinite(out, value);
+    }
+    // Integers within the "%.15g" fixed notation range
+    // are formatted directly
+    if (value > -1e15 && value < 1e15 && value == (double)(int64_t)value &&
+                    (value != 0 || !has_sign_bit(value))) {
+        return format_int64(out, (int64_t)value);
+    }
+    return format_float_roundtrip<double>(out, value, 15, 17);
+}
+
+char *dynd::format_float32(char *out, float value)
+{
+    if (!is_finite(value)) {
+        return format_nonfinite(out, value);
+    }
+    if (value > -1e6f && value < 1e6f && value == (float)(int32_t)value &&
+                    (value != 0 || !has_sign_bit(value))) {
+        return format_int64(out, (int32_t)value);
+    }
+    return format_float_roundtrip<float>(out, value, 6, 9);
+}
@@ -4,14 +4,20 @@
 //
 
 #include <sstream>
+#include <cstring>
 
 #include <dynd/type.hpp>
 #include <dynd/string_encodings.hpp>
+#include <dynd/cpu_features.hpp>
 #include <dynd/types/char_type.hpp>
 #include <dynd/types/fixedbytes_type.hpp>
 
 #include <utf8.h>
 
+#if defined(DYND_X86_SIMD)
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 using namespace dynd;
 
@@ -144,6 +150,8 @@ namespace {
         utf8::internal::utf_error err = utf8::internal::UTF8_OK;
         switch (length) {
             case 0:
+                // Skip the invalid lead octet
+                ++it;
                 return ERROR_SUBSTITUTE_CODEPOINT;
             case 1:
                 err = utf8::internal::get_sequence_1(it, end, cp);
@@ -168,10 +176,12 @@ namespace {
                     return cp;
                 }
                 else {
+                    ++it;
                     return ERROR_SUBSTITUTE_CODEPOINT;
                 }
             }
             else {
+                ++it;
                 return ERROR_SUBSTITUTE_CODEPOINT;
             }
         } else {
@@ -390,6 +400,236 @@ append_unicode_codepoint_t dynd::get_append_unicode_codepoint_function(string_en
     }
 }
 
+namespace {
+    inline int count_trailing_zeros(uint32_t bits)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(bits);
+#else
+        int n = 0;
+        while ((bits & 1) == 0) {
+            bits >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+#if defined(DYND_X86_SIMD)
+    // Returns a bitmask with the bytes of every non-ASCII
+    // code unit in the 16 bytes of v set
+    template<class T>
+    struct simd_non_ascii;
+
+    template<>
+    struct simd_non_ascii<uint8_t> {
+        static inline int mask(__m128i v) {
+            return _mm_movemask_epi8(v);
+        }
+    };
+
+    template<>
+    struct simd_non_ascii<uint16_t> {
+        static inline int mask(__m128i v) {
+            __m128i high = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xff80)));
+            return 0xffff ^ _mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128()));
+        }
+    };
+
+    template<>
+    struct simd_non_ascii<uint32_t> {
+        static inline int mask(__m128i v) {
+            __m128i high = _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xffffff80u)));
+            return 0xffff ^ _mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128()));
+        }
+    };
+#endif
+
+    /**
+     * Returns the number of code units at the start of [begin, end)
+     * which are ASCII. These are the same code point in every encoding,
+     * so runs of them can be converted without decoding.
+     */
+    template<class T>
+    inline intptr_t ascii_prefix_length(const T *begin, const T *end)
+    {
+        const T *it = begin;
+#if defined(DYND_X86_SIMD)
+        const intptr_t units_per_block = 16 / sizeof(T);
+        for (; end - it >= units_per_block; it += units_per_block) {
+            int mask = simd_non_ascii<T>::mask(
+                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(it)));
+            if (mask != 0) {
+                return (it - begin) + count_trailing_zeros(mask) / sizeof(T);
+            }
+        }
+#else
+        if (sizeof(T) == 1) {
+            for (; end - it >= 8; it += 8) {
+                uint64_t word;
+                memcpy(&word, it, 8);
+                if ((word & 0x8080808080808080ULL) != 0) {
+                    break;
+                }
+            }
+        }
+#endif
+        while (it < end && (*it & ~static_cast<T>(0x7f)) == 0) {
+            ++it;
+        }
+        return it - begin;
+    }
+
+    // Widens or narrows a run of ASCII code units
+    template<class D, class S>
+    inline void copy_ascii_units(D *dst, const S *src, intptr_t count)
+    {
+        for (intptr_t i = 0; i < count; ++i) {
+            dst[i] = static_cast<D>(src[i]);
+        }
+    }
+
+    template<class T>
+    inline void copy_ascii_units(T *dst, const T *src, intptr_t count)
+    {
+        memcpy(dst, src, count * sizeof(T));
+    }
+
+    // The number of bytes appending cp to a string of the encoding produces
+    inline intptr_t encoded_codepoint_size(uint32_t cp, string_encoding_t encoding)
+    {
+        switch (encoding) {
+            case string_encoding_utf_8:
+                return (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+            case string_encoding_utf_16:
+                return (cp > 0xffff) ? 4 : 2;
+            default:
+                return string_encoding_char_size_table[encoding];
+        }
+    }
+
+    template<class S>
+    intptr_t transcoded_size_loop(string_encoding_t dst_encoding, const char *begin,
+                    const char *end, next_unicode_codepoint_t next_fn)
+    {
+        intptr_t dst_charsize = string_encoding_char_size_table[dst_encoding];
+        intptr_t size = 0;
+        while (begin < end) {
+            intptr_t n = ascii_prefix_length(reinterpret_cast<const S *>(begin),
+                            reinterpret_cast<const S *>(end));
+            begin += n * sizeof(S);
+            size += n * dst_charsize;
+            if (begin < end) {
+                size += encoded_codepoint_size(next_fn(begin, end), dst_encoding);
+            }
+        }
+        return size;
+    }
+
+    template<class D, class S>
+    char *transcode_loop(char *dst, char *dst_end, const char *src, const char *src_end,
+                    next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn)
+    {
+        while (src < src_end) {
+            intptr_t n = ascii_prefix_length(reinterpret_cast<const S *>(src),
+                            reinterpret_cast<const S *>(src_end));
+            copy_ascii_units(reinterpret_cast<D *>(dst), reinterpret_cast<const S *>(src), n);
+            src += n * sizeof(S);
+            dst += n * sizeof(D);
+            if (src < src_end) {
+                append_fn(next_fn(src, src_end), dst, dst_end);
+            }
+        }
+        return dst;
+    }
+
+    template<class S>
+    char *transcode_from(intptr_t dst_charsize, char *dst, char *dst_end,
+                    const char *src, const char *src_end,
+                    next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn)
+    {
+        switch (dst_charsize) {
+            case 1:
+                return transcode_loop<uint8_t, S>(dst, dst_end, src, src_end, next_fn, append_fn);
+            case 2:
+                return transcode_loop<uint16_t, S>(dst, dst_end, src, src_end, next_fn, append_fn);
+            default:
+                return transcode_loop<uint32_t, S>(dst, dst_end, src, src_end, next_fn, append_fn);
+        }
+    }
+} // anonymous namespace
+
+intptr_t dynd::get_transcoded_string_size(string_encoding_t dst_encoding,
+                string_encoding_t src_encoding, const char *begin, const char *end,
+                assign_error_mode errmode)
+{
+    next_unicode_codepoint_t next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
+    // Validate the destination encoding
+    get_append_unicode_codepoint_function(dst_encoding, errmode);
+    switch (string_encoding_char_size_table[src_encoding]) {
+        case 1:
+            return transcoded_size_loop<uint8_t>(dst_encoding, begin, end, next_fn);
+        case 2:
+            return transcoded_size_loop<uint16_t>(dst_encoding, begin, end, next_fn);
+        default:
+            return transcoded_size_loop<uint32_t>(dst_encoding, begin, end, next_fn);
+    }
+}
+
+char *dynd::transcode_string(string_encoding_t dst_encoding, char *dst, intptr_t dst_size,
+                string_encoding_t src_encoding, const char *src_begin, const char *src_end,
+                assign_error_mode errmode)
+{
+    if (dst_encoding == src_encoding && errmode != assign_error_none) {
+        // Measuring the size validated the input, and there
+        // are no substitutions to make
+        memcpy(dst, src_begin, src_end - src_begin);
+        return dst + (src_end - src_begin);
+    }
+    next_unicode_codepoint_t next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
+    append_unicode_codepoint_t append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
+    intptr_t dst_charsize = string_encoding_char_size_table[dst_encoding];
+    char *dst_end = dst + dst_size;
+    switch (string_encoding_char_size_table[src_encoding]) {
+        case 1:
+            return transcode_from<uint8_t>(dst_charsize, dst, dst_end,
+                            src_begin, src_end, next_fn, append_fn);
+        case 2:
+            return transcode_from<uint16_t>(dst_charsize, dst, dst_end,
+                            src_begin, src_end, next_fn, append_fn);
+        default:
+            return transcode_from<uint32_t>(dst_charsize, dst, dst_end,
+                            src_begin, src_end, next_fn, append_fn);
+    }
+}
+
+const char *dynd::find_fixedstring_end(string_encoding_t encoding,
+                const char *begin, const char *end)
+{
+    switch (string_encoding_char_size_table[encoding]) {
+        case 1: {
+            const char *nul = reinterpret_cast<const char *>(memchr(begin, 0, end - begin));
+            return nul ? nul : end;
+        }
+        case 2: {
+            const uint16_t *it = reinterpret_cast<const uint16_t *>(begin);
+            const uint16_t *it_end = reinterpret_cast<const uint16_t *>(end);
+            while (it < it_end && *it != 0) {
+                ++it;
+            }
+            return reinterpret_cast<const char *>(it);
+        }
+        default: {
+            const uint32_t *it = reinterpret_cast<const uint32_t *>(begin);
+            const uint32_t *it_end = reinterpret_cast<const uint32_t *>(end);
+            while (it < it_end && *it != 0) {
+                ++it;
+            }
+            return reinterpret_cast<const char *>(it);
+        }
+    }
+}
+
 template<next_unicode_codepoint_t next_fn>
 std::string string_range_as_utf8_string_templ(const char *begin, const char *end)
 {
@@ -13,6 +13,7 @@
 #include <dynd/typed_data_assign.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/assignment_kernel_cache.hpp>
 #include <dynd/diagnostics.hpp>
 
 using namespace std;
@@ -173,6 +174,12 @@ void dynd::typed_data_copy(const ndt::type& tp,
     size_t data_size = tp.get_data_size();
     if (tp.is_pod()) {
         memcpy(dst_data, src_data, data_size);
+    } else if (assignment_kernel_cache *cache = get_thread_assignment_kernel_cache()) {
+        assignment_kernel_cache::borrowed_kernel k(*cache, tp, dst_metadata,
+                        tp, src_metadata,
+                        kernel_request_single,
+                        assign_error_none, &eval::default_eval_context);
+        k(dst_data, src_data);
     } else {
         assignment_ckernel_builder k;
         make_assignment_kernel(&k, 0, tp, dst_metadata,
@@ -206,6 +213,16 @@ void dynd::typed_data_assign(const ndt::type& dst_tp, const char *dst_metadata,
         }
     }
 
+    // Repeated assignments between the same arrays reuse the kernel
+    if (assignment_kernel_cache *cache = get_thread_assignment_kernel_cache()) {
+        assignment_kernel_cache::borrowed_kernel k(*cache, dst_tp, dst_metadata,
+                        src_tp, src_metadata,
+                        kernel_request_single,
+                        errmode, ectx);
+        k(dst_data, src_data);
+        return;
+    }
+
     assignment_ckernel_builder k;
     make_assignment_kernel(&k, 0, dst_tp, dst_metadata,
                     src_tp, src_metadata,
@@ -6,6 +6,7 @@
 #include <dynd/type.hpp>
 #include <dynd/types/base_struct_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/hash_kernels.hpp>
 #include <dynd/shortvector.hpp>
 
 using namespace std;
@@ -15,6 +16,55 @@ using namespace dynd;
 base_struct_type::~base_struct_type() {
 }
 
+void base_struct_type::init_field_name_lookup()
+{
+    const string *field_names = get_field_names();
+    // Keep the table at most half full
+    size_t table_size = 4;
+    while (table_size < 2 * m_field_count) {
+        table_size *= 2;
+    }
+    m_field_name_table.assign(table_size, -1);
+    size_t mask = table_size - 1;
+    for (size_t i = 0; i != m_field_count; ++i) {
+        const string& name = field_names[i];
+        size_t slot = (size_t)hash_bytes(name.data(), name.size()) & mask;
+        for (;;) {
+            intptr_t j = m_field_name_table[slot];
+            if (j == -1) {
+                m_field_name_table[slot] = i;
+                break;
+            } else if (field_names[j] == name) {
+                // With duplicate names, the first field wins
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+}
+
+intptr_t base_struct_type::get_field_index(const char *name_begin, const char *name_end) const
+{
+    if (m_field_name_table.empty()) {
+        return -1;
+    }
+    const string *field_names = get_field_names();
+    size_t size = name_end - name_begin;
+    size_t mask = m_field_name_table.size() - 1;
+    size_t slot = (size_t)hash_bytes(name_begin, size) & mask;
+    for (;;) {
+        intptr_t i = m_field_name_table[slot];
+        if (i == -1) {
+            return -1;
+        }
+        const string& name = field_names[i];
+        if (name.size() == size && memcmp(name.data(), name_begin, size) == 0) {
+            return i;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
 void base_struct_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
                 const char *metadata, const char *DYND_UNUSED(data)) const
 {
@@ -11,6 +11,7 @@
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
+#include <dynd/kernels/hash_kernels.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/gfunc/make_callable.hpp>
@@ -46,6 +47,109 @@ namespace {
         }
     };
 
+    // Equivalence of two values under the sorting_less comparison
+    struct equivalent_value {
+        const cmp& m_less;
+        const vector<const char *>& m_values;
+        const char *m_data;
+
+        equivalent_value(const cmp& less, const vector<const char *>& values, const char *data)
+            : m_less(less), m_values(values), m_data(data) {}
+        bool operator()(intptr_t i) const {
+            return !m_less(m_data, m_values[i]) && !m_less(m_values[i], m_data);
+        }
+    };
+
+    /**
+     * Collects the unique values of a type, using a hash table
+     * when the type supports hashing, and a sorted set otherwise.
+     */
+    class unique_values {
+        cmp m_less;
+        bool m_hashed;
+        hash_ckernel_builder m_hash;
+        hash_index_table m_table;
+        vector<const char *> m_values;
+        set<const char *, cmp> m_set;
+
+        // Non-copyable
+        unique_values(const unique_values&);
+        unique_values& operator=(const unique_values&);
+    public:
+        unique_values(const ndt::type& tp, const char *metadata,
+                        comparison_ckernel_builder& less, size_t expected_count)
+            : m_less(less.get_function(), less.get()),
+              m_hashed(is_hash_kernel_supported(tp)), m_set(m_less)
+        {
+            if (m_hashed) {
+                make_hash_kernel(&m_hash, 0, tp, metadata, &eval::default_eval_context);
+                m_table.reset(expected_count);
+            }
+        }
+
+        /**
+         * Adds the value if it isn't already present. Returns NULL
+         * if it was added, otherwise the equivalent value already
+         * present.
+         */
+        const char *insert(const char *data) {
+            if (m_hashed) {
+                intptr_t i = m_table.find_or_insert(m_hash(data), m_values.size(),
+                                equivalent_value(m_less, m_values, data));
+                if (i < 0) {
+                    m_values.push_back(data);
+                    return NULL;
+                } else {
+                    return m_values[i];
+                }
+            } else {
+                pair<set<const char *, cmp>::iterator, bool> r = m_set.insert(data);
+                return r.second ? NULL : *r.first;
+            }
+        }
+
+        /** Returns the unique values in sorted order */
+        void get_sorted(vector<const char *>& out) {
+            if (m_hashed) {
+                out = m_values;
+                std::sort(out.begin(), out.end(), m_less);
+            } else {
+                out.assign(m_set.begin(), m_set.end());
+            }
+        }
+    };
+
+    // Matches a value against the category at a sorted index
+    struct category_match {
+        const char *m_src;
+        const char *m_categories;
+        intptr_t m_stride;
+        ckernel_prefix *m_src_less_cat, *m_cat_less_src;
+
+        category_match(const char *src, const char *categories, intptr_t stride,
+                        ckernel_prefix *src_less_cat, ckernel_prefix *cat_less_src)
+            : m_src(src), m_categories(categories), m_stride(stride),
+              m_src_less_cat(src_less_cat), m_cat_less_src(cat_less_src) {}
+        bool src_less(intptr_t i) const {
+            return m_src_less_cat->get_function<binary_single_predicate_t>()(
+                                m_src, m_categories + i * m_stride, m_src_less_cat) != 0;
+        }
+        bool cat_less(intptr_t i) const {
+            return m_cat_less_src->get_function<binary_single_predicate_t>()(
+                                m_categories + i * m_stride, m_src, m_cat_less_src) != 0;
+        }
+        bool operator()(intptr_t i) const {
+            return !src_less(i) && !cat_less(i);
+        }
+    };
+
+    // Never matches, for filling a hash table with values known to be unique
+    struct no_match {
+        bool operator()(intptr_t) const {
+            return false;
+        }
+    };
+
     // Assign from a categorical type to some other type
     struct categorical_to_other_kernel_extra {
         typedef categorical_to_other_kernel_extra extra_type;
@@ -95,14 +199,52 @@ namespace {
         ckernel_prefix base;
         const categorical_type *dst_cat_tp;
         const char *src_metadata;
+        // A sorting_less kernel for (src, category) follows at (e + 1),
+        // and this is the offset of one for (category, src)
+        size_t cat_less_src_offset;
+        // The offset of a hash kernel for the source, or zero when
+        // the category type isn't hashable
+        size_t hash_offset;
+
+        inline static uint32_t lookup(const char *src, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const categorical_type *cat_tp = e->dst_cat_tp;
+            category_match match(src, cat_tp->m_categories.get_readonly_originptr(),
+                            reinterpret_cast<const strided_dim_type_metadata *>(
+                                            cat_tp->m_categories.get_ndo_meta())->stride,
+                            reinterpret_cast<ckernel_prefix *>(e + 1),
+                            reinterpret_cast<ckernel_prefix *>(eraw + e->cat_less_src_offset));
+            if (e->hash_offset != 0) {
+                ckernel_prefix *ehash = reinterpret_cast<ckernel_prefix *>(eraw + e->hash_offset);
+                uint64_t hash = ehash->get_function<hash_single_operation_t>()(src, ehash);
+                intptr_t i = cat_tp->m_category_lookup.find(hash, match);
+                if (i >= 0) {
+                    return (uint32_t)cat_tp->m_category_index_to_value[i];
+                }
+            } else {
+                intptr_t first = 0, last = cat_tp->get_category_count();
+                while (first < last) {
+                    intptr_t trial = first + (last - first) / 2;
+                    if (match.src_less(trial)) {
+                        last = trial;
+                    } else if (match.cat_less(trial)) {
+                        first = trial + 1;
+                    } else {
+                        return (uint32_t)cat_tp->m_category_index_to_value[trial];
+                    }
+                }
+            }
+            // Produces the error for unrecognized values
+            return cat_tp->get_value_from_category(e->src_metadata, src);
+        }
 
         // Assign from an input matching the category type to a categorical type
         template<typename UIntType>
         inline static void single(char *dst, const char *src, ckernel_prefix *extra)
         {
-            extra_type *e = reinterpret_cast<extra_type *>(extra);
-            uint32_t src_val = e->dst_cat_tp->get_value_from_category(e->src_metadata, src);
-            *reinterpret_cast<UIntType *>(dst) = src_val;
+            *reinterpret_cast<UIntType *>(dst) = lookup(src, extra);
         }
 
         // Some compilers are finicky about getting single<T> as a function pointer, so this...
@@ -118,10 +260,27 @@ namespace {
 
         static void destruct(ckernel_prefix *extra)
         {
+            char *eraw = reinterpret_cast<char *>(extra);
             extra_type *e = reinterpret_cast<extra_type *>(extra);
             if (e->dst_cat_tp != NULL) {
                 base_type_decref(e->dst_cat_tp);
             }
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(e + 1);
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+            if (e->cat_less_src_offset != 0) {
+                echild = reinterpret_cast<ckernel_prefix *>(eraw + e->cat_less_src_offset);
+                if (echild->destructor) {
+                    echild->destructor(echild);
+                }
+            }
+            if (e->hash_offset != 0) {
+                echild = reinterpret_cast<ckernel_prefix *>(eraw + e->hash_offset);
+                if (echild->destructor) {
+                    echild->destructor(echild);
+                }
+            }
         }
     };
 
@@ -169,7 +328,7 @@ namespace {
 } // anoymous namespace
 
 /** This function converts the set of char* pointers into a strided immutable nd::array of the categories */
-static nd::array make_sorted_categories(const set<const char *, cmp>& uniques,
+static nd::array make_sorted_categories(const vector<const char *>& uniques,
                 const ndt::type& element_tp, const char *metadata)
 {
     nd::array categories = nd::make_strided_array(uniques.size(), element_tp);
@@ -182,7 +341,7 @@ static nd::array make_sorted_categories(const set<const char *, cmp>& uniques,
 
     intptr_t stride = reinterpret_cast<const strided_dim_type_metadata *>(categories.get_ndo_meta())->stride;
     char *dst_ptr = categories.get_readwrite_originptr();
-    for (set<const char *, cmp>::const_iterator it = uniques.begin(); it != uniques.end(); ++it) {
+    for (vector<const char *>::const_iterator it = uniques.begin(); it != uniques.end(); ++it) {
         k(dst_ptr, *it);
         dst_ptr += stride;
     }
@@ -232,8 +391,7 @@ categorical_type::categorical_type(const nd::array& categories, bool presorted)
                         m_category_tp, categories_element_metadata,
                         comparison_type_sorting_less, &eval::default_eval_context);
 
-        cmp less(k.get_function(), k.get());
-        set<const char *, cmp> uniques(less);
+        unique_values uniques(m_category_tp, categories_element_metadata, k, category_count);
 
         m_value_to_category_index.resize(category_count);
         m_category_index_to_value.resize(category_count);
@@ -244,9 +402,7 @@ categorical_type::categorical_type(const nd::array& categories, bool presorted)
             const char *category_value = categories.get_readonly_originptr() +
                             i * categories_stride;
 
-            if (uniques.find(category_value) == uniques.end()) {
-                uniques.insert(category_value);
-            } else {
+            if (uniques.insert(category_value) != NULL) {
                 stringstream ss;
                 ss << "categories must be unique: category value ";
                 m_category_tp.print_data(ss, categories_element_metadata, category_value);
@@ -254,8 +410,6 @@ categorical_type::categorical_type(const nd::array& categories, bool presorted)
                 throw std::runtime_error(ss.str());
             }
         }
-        // TODO: Putting everything in a set already caused a sort operation to occur,
-        //       there's no reason we should need a second sort.
         std::sort(m_category_index_to_value.begin(), m_category_index_to_value.end(),
                         sorter(categories.get_readonly_originptr(), categories_stride,
                             k.get_function(), k.get()));
@@ -265,10 +419,29 @@ categorical_type::categorical_type(const nd::array& categories, bool presorted)
             m_value_to_category_index[m_category_index_to_value[i]] = i;
         }
 
-        m_categories = make_sorted_categories(uniques, m_category_tp,
+        vector<const char *> sorted_values(category_count);
+        for (size_t i = 0; i != (size_t)category_count; ++i) {
+            sorted_values[i] = categories.get_readonly_originptr() +
+                            m_category_index_to_value[i] * categories_stride;
+        }
+        m_categories = make_sorted_categories(sorted_values, m_category_tp,
                         categories_element_metadata);
     }
 
+    if (is_hash_kernel_supported(m_category_tp)) {
+        // Hash the sorted categories for constant time lookup when assigning
+        hash_ckernel_builder h;
+        make_hash_kernel(&h, 0, m_category_tp, get_category_metadata(),
+                        &eval::default_eval_context);
+        const char *category_data = m_categories.get_readonly_originptr();
+        intptr_t category_stride = reinterpret_cast<const strided_dim_type_metadata *>(
+                        m_categories.get_ndo_meta())->stride;
+        m_category_lookup.reset(category_count);
+        for (intptr_t i = 0; i != category_count; ++i) {
+            m_category_lookup.find_or_insert(h(category_data + i * category_stride), i, no_match());
+        }
+    }
+
     // Use the number of categories to set which underlying integer storage to use
     if (category_count <= 256) {
         m_storage_type = ndt::make_type<uint8_t>();
@@ -426,7 +599,7 @@ size_t categorical_type::make_assignment_kernel(
         // assign from the same category value type
         else if (src_tp == m_category_tp) {
             offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
-            out->ensure_capacity_leaf(offset_out + sizeof(category_to_categorical_kernel_extra));
+            out->ensure_capacity(offset_out + sizeof(category_to_categorical_kernel_extra));
             category_to_categorical_kernel_extra *e =
                             out->get_at<category_to_categorical_kernel_extra>(offset_out);
             switch (m_storage_type.get_type_id()) {
@@ -449,7 +622,26 @@ size_t categorical_type::make_assignment_kernel(
             // The kernel type owns a reference to this type
             e->dst_cat_tp = static_cast<const categorical_type *>(ndt::type(dst_tp).release());
             e->src_metadata = src_metadata;
-            return offset_out + sizeof(category_to_categorical_kernel_extra);
+            e->cat_less_src_offset = 0;
+            e->hash_offset = 0;
+            // Match values with sorting_less, and look them up by hash when possible
+            size_t child_offset = ::make_comparison_kernel(out,
+                            offset_out + sizeof(category_to_categorical_kernel_extra),
+                            src_tp, src_metadata, m_category_tp, get_category_metadata(),
+                            comparison_type_sorting_less, ectx);
+            out->ensure_capacity(child_offset);
+            e = out->get_at<category_to_categorical_kernel_extra>(offset_out);
+            e->cat_less_src_offset = child_offset - offset_out;
+            child_offset = ::make_comparison_kernel(out, child_offset,
+                            m_category_tp, get_category_metadata(), src_tp, src_metadata,
+                            comparison_type_sorting_less, ectx);
+            if (!is_hash_kernel_supported(m_category_tp)) {
+                return child_offset;
+            }
+            out->ensure_capacity(child_offset);
+            e = out->get_at<category_to_categorical_kernel_extra>(offset_out);
+            e->hash_offset = child_offset - offset_out;
+            return make_hash_kernel(out, child_offset, src_tp, src_metadata, ectx);
         } else if (src_tp.value_type() != m_category_tp &&
                         src_tp.value_type().get_type_id() != categorical_type_id) {
             // Make a convert type to the category type, and have it do the chaining
@@ -556,19 +748,18 @@ ndt::type dynd::ndt::factor_categorical(const nd::array& values)
                     iter.get_uniform_dtype(), iter.metadata(),
                     comparison_type_sorting_less, &eval::default_eval_context);
 
-    cmp less(k.get_function(), k.get());
-    set<const char *, cmp> uniques(less);
+    unique_values uniques(iter.get_uniform_dtype(), iter.metadata(), k, 0);
 
     if (!iter.empty()) {
         do {
-            if (uniques.find(iter.data()) == uniques.end()) {
-                uniques.insert(iter.data());
-            }
+            uniques.insert(iter.data());
         } while (iter.next());
     }
 
-    // Copy the values (now sorted and unique) into a new nd::array
-    nd::array categories = make_sorted_categories(uniques,
+    // Copy the values, sorted and unique, into a new nd::array
+    vector<const char *> sorted_values;
+    uniques.get_sorted(sorted_values);
+    nd::array categories = make_sorted_categories(sorted_values,
                     iter.get_uniform_dtype(), iter.metadata());
 
     return ndt::type(new categorical_type(categories, true), false);
@@ -53,6 +53,7 @@ cstruct_type::cstruct_type(size_t field_count, const ndt::type *field_types,
     m_members.metadata_size = metadata_offset;
     m_members.data_size = inc_to_alignment(data_offset, m_members.data_alignment);
 
+    init_field_name_lookup();
     create_array_properties();
 }
 
@@ -62,13 +63,8 @@ cstruct_type::~cstruct_type()
 
 intptr_t cstruct_type::get_field_index(const std::string& field_name) const
 {
-    // TODO: Put a map<> or unordered_map<> in the type to accelerate this lookup
-    vector<string>::const_iterator i = find(m_field_names.begin(), m_field_names.end(), field_name);
-    if (i != m_field_names.end()) {
-        return i - m_field_names.begin();
-    } else {
-        return -1;
-    }
+    return base_struct_type::get_field_index(field_name.data(),
+                    field_name.data() + field_name.size());
 }
 
 void cstruct_type::print_data(std::ostream& o, const char *metadata, const char *data) const
@@ -546,6 +542,7 @@ cstruct_type::cstruct_type(int, int)
     m_members.data_alignment = (uint8_t)m_field_types[0].get_data_alignment();
     m_members.metadata_size = m_field_types[0].get_metadata_size();
     m_members.data_size = m_field_types[0].get_data_size();
+    init_field_name_lookup();
     // Leave m_array_properties so there is no reference loop
 }
 
@@ -429,6 +429,34 @@ bool parse::parse_iso8601_dashes_date(const char *&begin, const char *end,
     return sbs.succeed();
 }
 
+// YYYY-MM-DD
+bool parse::parse_iso8601_fixed_date(const char *&begin, const char *end,
+                                     date_ymd &out_ymd)
+{
+    if (end - begin < 10 || begin[4] != '-' || begin[7] != '-') {
+        return false;
+    }
+    // Gather the digits YYYYMMDD into one word, first digit lowest
+    const unsigned char *s = reinterpret_cast<const unsigned char *>(begin);
+    uint64_t chars = (uint64_t)s[0] | ((uint64_t)s[1] << 8) |
+                     ((uint64_t)s[2] << 16) | ((uint64_t)s[3] << 24) |
+                     ((uint64_t)s[5] << 32) | ((uint64_t)s[6] << 40) |
+                     ((uint64_t)s[8] << 48) | ((uint64_t)s[9] << 56);
+    int ymd;
+    if (!parse_8digit_packed_int(chars, ymd)) {
+        return false;
+    }
+    int year = ymd / 10000, month = (ymd / 100) % 100, day = ymd % 100;
+    if (!date_ymd::is_valid(year, month, day)) {
+        return false;
+    }
+    out_ymd.year = year;
+    out_ymd.month = month;
+    out_ymd.day = day;
+    begin += 10;
+    return true;
+}
+
 // YYYYMMDD
 static bool parse_iso8601_nodashes_date(const char *&begin, const char *end,
                                         date_ymd &out_ymd)
@@ -658,3 +686,9 @@ bool dynd::string_to_date(const char *begin, const char *end, date_ymd &out_ymd,
         return false;
     }
 }
+
+bool dynd::string_to_date_iso8601_fixed(const char *begin, const char *end,
+                                        date_ymd &out_ymd)
+{
+    return end - begin == 10 && parse_iso8601_fixed_date(begin, end, out_ymd);
+}
@@ -323,41 +323,63 @@ void date_type::get_dynamic_array_functions(
 ///////// property accessor kernels (used by property_type)
 
 namespace {
-    void get_property_kernel_year_single(char *dst, const char *src,
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        date_ymd ymd;
-        ymd.set_from_days(*reinterpret_cast<const int32_t *>(src));
-        *reinterpret_cast<int32_t *>(dst) = ymd.year;
-    }
+    // Each field computes one int32 property from the date's days value
+    struct date_year_field {
+        static inline int32_t get(int32_t days) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(days, year, month, day);
+            return year;
+        }
+    };
 
-    void get_property_kernel_month_single(char *dst, const char *src,
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        date_ymd ymd;
-        ymd.set_from_days(*reinterpret_cast<const int32_t *>(src));
-        *reinterpret_cast<int32_t *>(dst) = ymd.month;
-    }
+    struct date_month_field {
+        static inline int32_t get(int32_t days) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(days, year, month, day);
+            return month;
+        }
+    };
 
-    void get_property_kernel_day_single(char *dst, const char *src,
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        date_ymd ymd;
-        ymd.set_from_days(*reinterpret_cast<const int32_t *>(src));
-        *reinterpret_cast<int32_t *>(dst) = ymd.day;
-    }
+    struct date_day_field {
+        static inline int32_t get(int32_t days) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(days, year, month, day);
+            return day;
+        }
+    };
 
-    void get_property_kernel_weekday_single(char *dst, const char *src,
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        int32_t days = *reinterpret_cast<const int32_t *>(src);
-        // 1970-01-05 is Monday
-        int weekday = (int)((days - 4) % 7);
-        if (weekday < 0) {
-            weekday += 7;
+    struct date_weekday_field {
+        static inline int32_t get(int32_t days) {
+            return date_ymd::days_to_weekday(days);
         }
-        *reinterpret_cast<int32_t *>(dst) = weekday;
-    }
+    };
+
+    template<class Field>
+    struct date_field_property_kernel {
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *DYND_UNUSED(extra))
+        {
+            *reinterpret_cast<int32_t *>(dst) = Field::get(*reinterpret_cast<const int32_t *>(src));
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *DYND_UNUSED(extra))
+        {
+            if (dst_stride == sizeof(int32_t) && src_stride == sizeof(int32_t)) {
+                // Contiguous data, in a loop the compiler can vectorize
+                int32_t *dst_ptr = reinterpret_cast<int32_t *>(dst);
+                const int32_t *src_ptr = reinterpret_cast<const int32_t *>(src);
+                for (size_t i = 0; i != count; ++i) {
+                    dst_ptr[i] = Field::get(src_ptr[i]);
+                }
+            } else {
+                for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                    *reinterpret_cast<int32_t *>(dst) = Field::get(*reinterpret_cast<const int32_t *>(src));
+                }
+            }
+        }
+    };
 
     void get_property_kernel_days_after_1970_int64_single(char *dst, const char *src,
                     ckernel_prefix *DYND_UNUSED(extra))
@@ -370,6 +392,15 @@ namespace {
         }
     }
 
+    void get_property_kernel_days_after_1970_int64_strided(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride,
+                    size_t count, ckernel_prefix *extra)
+    {
+        for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+            get_property_kernel_days_after_1970_int64_single(dst, src, extra);
+        }
+    }
+
     void set_property_kernel_days_after_1970_int64_single(char *dst, const char *src,
                     ckernel_prefix *DYND_UNUSED(extra))
     {
@@ -381,11 +412,40 @@ namespace {
         }
     }
 
+    inline void set_ymd_from_days(date_ymd *dst_struct, int32_t days)
+    {
+        int32_t year, month, day;
+        date_ymd::days_to_ymd(days, year, month, day);
+        dst_struct->year = static_cast<int16_t>(year);
+        dst_struct->month = static_cast<int8_t>(month);
+        dst_struct->day = static_cast<int8_t>(day);
+    }
+
     void get_property_kernel_struct_single(char *dst, const char *src,
                     ckernel_prefix *DYND_UNUSED(extra))
     {
-        date_ymd *dst_struct = reinterpret_cast<date_ymd *>(dst);
-        dst_struct->set_from_days(*reinterpret_cast<const int32_t *>(src));
+        set_ymd_from_days(reinterpret_cast<date_ymd *>(dst), *reinterpret_cast<const int32_t *>(src));
+    }
+
+    /**
+     * Produces the year, month and day together in one pass over
+     * the dates, for code which needs all of them.
+     */
+    void get_property_kernel_struct_strided(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride,
+                    size_t count, ckernel_prefix *DYND_UNUSED(extra))
+    {
+        if (dst_stride == sizeof(date_ymd) && src_stride == sizeof(int32_t)) {
+            date_ymd *dst_ptr = reinterpret_cast<date_ymd *>(dst);
+            const int32_t *src_ptr = reinterpret_cast<const int32_t *>(src);
+            for (size_t i = 0; i != count; ++i) {
+                set_ymd_from_days(dst_ptr + i, src_ptr[i]);
+            }
+        } else {
+            for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                set_ymd_from_days(reinterpret_cast<date_ymd *>(dst), *reinterpret_cast<const int32_t *>(src));
+            }
+        }
     }
 
     void set_property_kernel_struct_single(char *dst, const char *src,
@@ -462,32 +522,55 @@ size_t date_type::make_elwise_property_getter_kernel(
                 const char *DYND_UNUSED(src_metadata), size_t src_property_index,
                 kernel_request_t kernreq, const eval::eval_context *DYND_UNUSED(ectx)) const
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+    out->ensure_capacity_leaf(offset_out + sizeof(ckernel_prefix));
     ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
+    unary_single_operation_t single = NULL;
+    unary_strided_operation_t strided = NULL;
     switch (src_property_index) {
         case dateprop_year:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_year_single);
-            return offset_out + sizeof(ckernel_prefix);
+            single = &date_field_property_kernel<date_year_field>::single;
+            strided = &date_field_property_kernel<date_year_field>::strided;
+            break;
         case dateprop_month:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_month_single);
-            return offset_out + sizeof(ckernel_prefix);
+            single = &date_field_property_kernel<date_month_field>::single;
+            strided = &date_field_property_kernel<date_month_field>::strided;
+            break;
         case dateprop_day:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_day_single);
-            return offset_out + sizeof(ckernel_prefix);
+            single = &date_field_property_kernel<date_day_field>::single;
+            strided = &date_field_property_kernel<date_day_field>::strided;
+            break;
         case dateprop_weekday:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_weekday_single);
-            return offset_out + sizeof(ckernel_prefix);
+            single = &date_field_property_kernel<date_weekday_field>::single;
+            strided = &date_field_property_kernel<date_weekday_field>::strided;
+            break;
         case dateprop_days_after_1970_int64:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_days_after_1970_int64_single);
-            return offset_out + sizeof(ckernel_prefix);
+            single = &get_property_kernel_days_after_1970_int64_single;
+            strided = &get_property_kernel_days_after_1970_int64_strided;
+            break;
         case dateprop_struct:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_struct_single);
-            return offset_out + sizeof(ckernel_prefix);
-        default:
+            single = &get_property_kernel_struct_single;
+            strided = &get_property_kernel_struct_strided;
+            break;
+        default: {
             stringstream ss;
             ss << "dynd date type given an invalid property index" << src_property_index;
             throw runtime_error(ss.str());
+        }
+    }
+    switch (kernreq) {
+        case kernel_request_single:
+            e->set_function<unary_single_operation_t>(single);
+            break;
+        case kernel_request_strided:
+            e->set_function<unary_strided_operation_t>(strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "date_type::make_elwise_property_getter_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
     }
+    return offset_out + sizeof(ckernel_prefix);
 }
 
 size_t date_type::make_elwise_property_setter_kernel(
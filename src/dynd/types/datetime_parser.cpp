@@ -157,3 +157,22 @@ bool dynd::string_to_datetime(const char *begin, const char *end,
         return false;
     }
 }
+
+bool dynd::string_to_datetime_iso8601_fixed(const char *begin, const char *end,
+                                            datetime_struct &out_dt)
+{
+    datetime_struct dt;
+    if (!parse_iso8601_fixed_date(begin, end, dt.ymd)) {
+        return false;
+    }
+    if (begin == end || (*begin != 'T' && *begin != ' ')) {
+        return false;
+    }
+    ++begin;
+    if (parse_iso8601_fixed_time(begin, end, dt.hmst) && begin == end) {
+        out_dt = dt;
+        return true;
+    } else {
+        return false;
+    }
+}
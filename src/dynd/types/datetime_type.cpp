@@ -381,151 +381,134 @@ namespace {
         }
     };
 
-    void get_property_kernel_struct_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        throw runtime_error("TODO: get_property_kernel_struct_single");
-    }
-
-    void set_property_kernel_struct_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
-                    ckernel_prefix *DYND_UNUSED(extra))
-    {
-        throw runtime_error("TODO: set_property_kernel_struct_single");
-    }
-
-    void get_property_kernel_date_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
+    inline void check_property_timezone(ckernel_prefix *extra)
     {
         const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            *reinterpret_cast<int32_t *>(dst) =
-                static_cast<int32_t>(*reinterpret_cast<const int64_t *>(src) /
-                                     (24 * 60 * 60 * 10000000LL));
-        } else {
-            throw runtime_error("datetime date property only implemented for UTC and abstract timezones");
+        datetime_tz_t tz = e->datetime_tp->get_timezone();
+        if (tz != tz_utc && tz != tz_abstract) {
+            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
         }
     }
 
-    void get_property_kernel_year_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
+    inline void set_struct_from_ticks(datetime_struct *dst_struct, int64_t ticks)
     {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            date_ymd ymd;
-            ymd.set_from_ticks(*reinterpret_cast<const int64_t *>(src));
-            *reinterpret_cast<int32_t *>(dst) = ymd.year;
+        int32_t days = date_ymd::ticks_to_days(ticks);
+        int32_t year, month, day;
+        date_ymd::days_to_ymd(days, year, month, day);
+        dst_struct->ymd.year = static_cast<int16_t>(year);
+        dst_struct->ymd.month = static_cast<int8_t>(month);
+        dst_struct->ymd.day = static_cast<int8_t>(day);
+        if (days != DYND_DATE_NA) {
+            dst_struct->hmst.set_from_ticks(ticks - days * DYND_TICKS_PER_DAY);
         } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
+            // days * DYND_TICKS_PER_DAY would overflow for NA
+            dst_struct->hmst.set_to_na();
         }
     }
 
-    void get_property_kernel_month_single(char *dst, const char *src,
+    void get_property_kernel_struct_single(char *dst, const char *src,
                     ckernel_prefix *extra)
     {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            date_ymd ymd;
-            ymd.set_from_ticks(*reinterpret_cast<const int64_t *>(src));
-            *reinterpret_cast<int32_t *>(dst) = ymd.month;
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
-        }
+        check_property_timezone(extra);
+        set_struct_from_ticks(reinterpret_cast<datetime_struct *>(dst),
+                        *reinterpret_cast<const int64_t *>(src));
     }
 
-    void get_property_kernel_day_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
+    /**
+     * Produces all the fields of the datetimes in one pass, for code
+     * which needs several of them.
+     */
+    void get_property_kernel_struct_strided(char *dst, intptr_t dst_stride,
+                    const char *src, intptr_t src_stride,
+                    size_t count, ckernel_prefix *extra)
     {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            date_ymd ymd;
-            ymd.set_from_ticks(*reinterpret_cast<const int64_t *>(src));
-            *reinterpret_cast<int32_t *>(dst) = ymd.day;
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
+        check_property_timezone(extra);
+        for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+            set_struct_from_ticks(reinterpret_cast<datetime_struct *>(dst),
+                            *reinterpret_cast<const int64_t *>(src));
         }
     }
 
-    void get_property_kernel_hour_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
+    void set_property_kernel_struct_single(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
+                    ckernel_prefix *DYND_UNUSED(extra))
     {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            int64_t hour =
-                *reinterpret_cast<const int64_t *>(src) % DYND_TICKS_PER_DAY;
-            if (hour < 0) {
-                hour += DYND_TICKS_PER_DAY;
-            }
-            hour /= DYND_TICKS_PER_HOUR;
-            *reinterpret_cast<int32_t *>(dst) = static_cast<int32_t>(hour);
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
-        }
+        throw runtime_error("TODO: set_property_kernel_struct_single");
     }
 
-    void get_property_kernel_minute_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
-    {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            int64_t minute =
-                *reinterpret_cast<const int64_t *>(src) % DYND_TICKS_PER_HOUR;
-            if (minute < 0) {
-                minute += DYND_TICKS_PER_HOUR;
-            }
-            minute /= DYND_TICKS_PER_MINUTE;
-            *reinterpret_cast<int32_t *>(dst) = static_cast<int32_t>(minute);
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
+    // Each field computes one int32 property from the datetime's ticks value
+    struct datetime_date_field {
+        static inline int32_t get(int64_t ticks) {
+            return date_ymd::ticks_to_days(ticks);
         }
-    }
+    };
 
-    void get_property_kernel_second_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
-    {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            int64_t second =
-                *reinterpret_cast<const int64_t *>(src) % DYND_TICKS_PER_MINUTE;
-            if (second < 0) {
-                second += DYND_TICKS_PER_MINUTE;
-            }
-            second /= DYND_TICKS_PER_SECOND;
-            *reinterpret_cast<int32_t *>(dst) = static_cast<int32_t>(second);
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
+    struct datetime_year_field {
+        static inline int32_t get(int64_t ticks) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(date_ymd::ticks_to_days(ticks), year, month, day);
+            return year;
         }
-    }
+    };
 
-    void get_property_kernel_tick_single(char *dst, const char *src,
-                    ckernel_prefix *extra)
-    {
-        const datetime_property_kernel_extra *e = reinterpret_cast<datetime_property_kernel_extra *>(extra);
-        const datetime_type *dd = e->datetime_tp;
-        datetime_tz_t tz = dd->get_timezone();
-        if (tz == tz_utc || tz == tz_abstract) {
-            int64_t tick = *reinterpret_cast<const int64_t *>(src) % 10000000LL;
-            if (tick < 0) {
-                tick += 10000000LL;
+    struct datetime_month_field {
+        static inline int32_t get(int64_t ticks) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(date_ymd::ticks_to_days(ticks), year, month, day);
+            return month;
+        }
+    };
+
+    struct datetime_day_field {
+        static inline int32_t get(int64_t ticks) {
+            int32_t year, month, day;
+            date_ymd::days_to_ymd(date_ymd::ticks_to_days(ticks), year, month, day);
+            return day;
+        }
+    };
+
+    // Gets the ticks modulo `Period`, divided by `Unit`
+    template<int64_t Period, int64_t Unit>
+    struct datetime_time_field {
+        static inline int32_t get(int64_t ticks) {
+            int64_t rem = ticks % Period;
+            rem += Period * (rem < 0);
+            return static_cast<int32_t>(rem / Unit);
+        }
+    };
+
+    typedef datetime_time_field<DYND_TICKS_PER_DAY, DYND_TICKS_PER_HOUR> datetime_hour_field;
+    typedef datetime_time_field<DYND_TICKS_PER_HOUR, DYND_TICKS_PER_MINUTE> datetime_minute_field;
+    typedef datetime_time_field<DYND_TICKS_PER_MINUTE, DYND_TICKS_PER_SECOND> datetime_second_field;
+    typedef datetime_time_field<DYND_TICKS_PER_SECOND, 1> datetime_tick_field;
+
+    template<class Field>
+    struct datetime_field_property_kernel {
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *extra)
+        {
+            check_property_timezone(extra);
+            *reinterpret_cast<int32_t *>(dst) = Field::get(*reinterpret_cast<const int64_t *>(src));
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            check_property_timezone(extra);
+            if (dst_stride == sizeof(int32_t) && src_stride == sizeof(int64_t)) {
+                // Contiguous data, in a loop the compiler can vectorize
+                int32_t *dst_ptr = reinterpret_cast<int32_t *>(dst);
+                const int64_t *src_ptr = reinterpret_cast<const int64_t *>(src);
+                for (size_t i = 0; i != count; ++i) {
+                    dst_ptr[i] = Field::get(src_ptr[i]);
+                }
+            } else {
+                for (size_t i = 0; i != count; ++i, dst += dst_stride, src += src_stride) {
+                    *reinterpret_cast<int32_t *>(dst) = Field::get(*reinterpret_cast<const int64_t *>(src));
+                }
             }
-            *reinterpret_cast<int32_t *>(dst) = static_cast<int32_t>(tick);
-        } else {
-            throw runtime_error("datetime property access only implemented for UTC and abstract timezones");
         }
-    }
+    };
 } // anonymous namespace
 
 namespace {
@@ -595,40 +578,65 @@ size_t datetime_type::make_elwise_property_getter_kernel(
                 const char *DYND_UNUSED(src_metadata), size_t src_property_index,
                 kernel_request_t kernreq, const eval::eval_context *DYND_UNUSED(ectx)) const
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+    out->ensure_capacity_leaf(offset_out + sizeof(datetime_property_kernel_extra));
     datetime_property_kernel_extra *e = out->get_at<datetime_property_kernel_extra>(offset_out);
+    unary_single_operation_t single = NULL;
+    unary_strided_operation_t strided = NULL;
     switch (src_property_index) {
         case datetimeprop_struct:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_struct_single);
+            single = &get_property_kernel_struct_single;
+            strided = &get_property_kernel_struct_strided;
             break;
         case datetimeprop_date:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_date_single);
+            single = &datetime_field_property_kernel<datetime_date_field>::single;
+            strided = &datetime_field_property_kernel<datetime_date_field>::strided;
             break;
         case datetimeprop_year:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_year_single);
+            single = &datetime_field_property_kernel<datetime_year_field>::single;
+            strided = &datetime_field_property_kernel<datetime_year_field>::strided;
             break;
         case datetimeprop_month:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_month_single);
+            single = &datetime_field_property_kernel<datetime_month_field>::single;
+            strided = &datetime_field_property_kernel<datetime_month_field>::strided;
             break;
         case datetimeprop_day:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_day_single);
+            single = &datetime_field_property_kernel<datetime_day_field>::single;
+            strided = &datetime_field_property_kernel<datetime_day_field>::strided;
             break;
         case datetimeprop_hour:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_hour_single);
+            single = &datetime_field_property_kernel<datetime_hour_field>::single;
+            strided = &datetime_field_property_kernel<datetime_hour_field>::strided;
             break;
         case datetimeprop_minute:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_minute_single);
+            single = &datetime_field_property_kernel<datetime_minute_field>::single;
+            strided = &datetime_field_property_kernel<datetime_minute_field>::strided;
             break;
         case datetimeprop_second:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_second_single);
+            single = &datetime_field_property_kernel<datetime_second_field>::single;
+            strided = &datetime_field_property_kernel<datetime_second_field>::strided;
             break;
         case datetimeprop_tick:
-            e->base.set_function<unary_single_operation_t>(&get_property_kernel_tick_single);
+            single = &datetime_field_property_kernel<datetime_tick_field>::single;
+            strided = &datetime_field_property_kernel<datetime_tick_field>::strided;
             break;
-        default:
+        default: {
             stringstream ss;
             ss << "dynd date type given an invalid property index" << src_property_index;
             throw runtime_error(ss.str());
+        }
+    }
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "datetime_type::make_elwise_property_getter_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
     }
     e->base.destructor = &datetime_property_kernel_extra::destruct;
     e->datetime_tp = static_cast<const datetime_type *>(ndt::type(this, true).release());
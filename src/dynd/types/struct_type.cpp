@@ -40,6 +40,7 @@ struct_type::struct_type(const std::vector<ndt::type>& field_types, const std::v
     }
     m_members.metadata_size = metadata_offset;
 
+    init_field_name_lookup();
     create_array_properties();
 }
 
@@ -49,13 +50,8 @@ struct_type::~struct_type()
 
 intptr_t struct_type::get_field_index(const std::string& field_name) const
 {
-    // TODO: Put a map<> or unordered_map<> in the type to accelerate this lookup
-    vector<string>::const_iterator i = find(m_field_names.begin(), m_field_names.end(), field_name);
-    if (i != m_field_names.end()) {
-        return i - m_field_names.begin();
-    } else {
-        return -1;
-    }
+    return base_struct_type::get_field_index(field_name.data(),
+                    field_name.data() + field_name.size());
 }
 
 size_t struct_type::get_default_data_size(intptr_t ndim, const intptr_t *shape) const
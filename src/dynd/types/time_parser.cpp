@@ -93,6 +93,60 @@ static bool parse_flex_time(const char *&begin, const char *end, time_hmst &out_
     }
 }
 
+// HH:MM, HH:MM:SS, or HH:MM:SS.SSS
+bool parse::parse_iso8601_fixed_time(const char *&begin, const char *end,
+                                     time_hmst &out_hmst)
+{
+    if (end - begin < 5 || begin[2] != ':') {
+        return false;
+    }
+    const unsigned char *s = reinterpret_cast<const unsigned char *>(begin);
+    bool has_second = end - begin >= 8 && begin[5] == ':';
+    // Gather the digits into one word as "00HHMMSS", first digit lowest,
+    // with "00" for the seconds if there are none
+    uint64_t chars = 0x3030ULL | ((uint64_t)s[0] << 16) | ((uint64_t)s[1] << 24) |
+                     ((uint64_t)s[3] << 32) | ((uint64_t)s[4] << 40);
+    if (has_second) {
+        chars |= ((uint64_t)s[6] << 48) | ((uint64_t)s[7] << 56);
+    } else {
+        chars |= 0x3030000000000000ULL;
+    }
+    int hms;
+    if (!parse_8digit_packed_int(chars, hms)) {
+        return false;
+    }
+    const char *pos = begin + (has_second ? 8 : 5);
+    int tick = 0;
+    if (has_second && pos < end && *pos == '.') {
+        ++pos;
+        // Require at least one digit after the decimal place
+        if (!(pos < end && isdigit(*pos))) {
+            return false;
+        }
+        // Up to seven digits of ticks, truncating any more
+        int i = 0;
+        for (; i < 7 && pos < end && isdigit(*pos); ++i, ++pos) {
+            tick = tick * 10 + (*pos - '0');
+        }
+        for (; i < 7; ++i) {
+            tick *= 10;
+        }
+        while (pos < end && isdigit(*pos)) {
+            ++pos;
+        }
+    }
+    int hour = hms / 10000, minute = (hms / 100) % 100, second = hms % 100;
+    if (!time_hmst::is_valid(hour, minute, second, tick)) {
+        return false;
+    }
+    out_hmst.hour = hour;
+    out_hmst.minute = minute;
+    out_hmst.second = second;
+    out_hmst.tick = tick;
+    begin = pos;
+    return true;
+}
+
 // Matches various AM/PM indicators, and adjusts the hour value
 bool parse::parse_time_ampm(const char *&begin, const char *end, int& inout_hour)
 {
@@ -164,3 +218,15 @@ bool dynd::string_to_time(const char *begin, const char *end, time_hmst &out_hms
         return false;
     }
 }
+
+bool dynd::string_to_time_iso8601_fixed(const char *begin, const char *end,
+                                        time_hmst &out_hmst)
+{
+    time_hmst hmst;
+    if (parse_iso8601_fixed_time(begin, end, hmst) && begin == end) {
+        out_hmst = hmst;
+        return true;
+    } else {
+        return false;
+    }
+}
@@ -114,7 +114,7 @@ void var_dim_type::process_strided(const char *metadata, const char *data,
     const var_dim_type_metadata *md = reinterpret_cast<const var_dim_type_metadata *>(metadata);
     const var_dim_type_data *d = reinterpret_cast<const var_dim_type_data *>(data);
     out_dt = m_element_tp;
-    out_origin = d->begin;
+    out_origin = d->begin + md->offset;
     out_stride = md->stride;
     out_dim_size = d->size;
 }
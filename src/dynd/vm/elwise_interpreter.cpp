@@ -0,0 +1,822 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+
+#include <dynd/vm/elwise_interpreter.hpp>
+#include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/cpu_features.hpp>
+
+#if defined(DYND_X86_SIMD)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    // The elements of bool registers are 0 or 1
+    typedef uint8_t bool_reg;
+
+    template<class T>
+    struct is_simd_type {
+        static const bool value = false;
+    };
+
+#if defined(DYND_X86_SIMD)
+    template<>
+    struct is_simd_type<float> {
+        static const bool value = true;
+    };
+
+    template<>
+    struct is_simd_type<double> {
+        static const bool value = true;
+    };
+
+    template<class T>
+    struct simd;
+
+    template<>
+    struct simd<float> {
+        typedef __m128 type;
+        static const intptr_t width = 4;
+        static inline type load(const float *p) { return _mm_loadu_ps(p); }
+        static inline void store(float *p, type v) { _mm_storeu_ps(p, v); }
+        static inline type add(type x, type y) { return _mm_add_ps(x, y); }
+        static inline type sub(type x, type y) { return _mm_sub_ps(x, y); }
+        static inline type mul(type x, type y) { return _mm_mul_ps(x, y); }
+        static inline type div(type x, type y) { return _mm_div_ps(x, y); }
+        static inline type min(type x, type y) { return _mm_min_ps(x, y); }
+        static inline type max(type x, type y) { return _mm_max_ps(x, y); }
+        static inline type sqrt(type x) { return _mm_sqrt_ps(x); }
+        static inline type abs(type x) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x); }
+    };
+
+    template<>
+    struct simd<double> {
+        typedef __m128d type;
+        static const intptr_t width = 2;
+        static inline type load(const double *p) { return _mm_loadu_pd(p); }
+        static inline void store(double *p, type v) { _mm_storeu_pd(p, v); }
+        static inline type add(type x, type y) { return _mm_add_pd(x, y); }
+        static inline type sub(type x, type y) { return _mm_sub_pd(x, y); }
+        static inline type mul(type x, type y) { return _mm_mul_pd(x, y); }
+        static inline type div(type x, type y) { return _mm_div_pd(x, y); }
+        static inline type min(type x, type y) { return _mm_min_pd(x, y); }
+        static inline type max(type x, type y) { return _mm_max_pd(x, y); }
+        static inline type sqrt(type x) { return _mm_sqrt_pd(x); }
+        static inline type abs(type x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+    };
+#endif
+
+    // The opcode loops are over contiguous registers. Operations which have
+    // `vectorized` set provide a `simd_operate` used for whole SIMD vectors.
+
+    template<class OP, bool vectorized = OP::vectorized>
+    struct unary_opcode {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type D;
+            typedef typename OP::src_type S;
+            D *d = reinterpret_cast<D *>(dst);
+            const S *s0 = reinterpret_cast<const S *>(src[0]);
+            for (intptr_t i = 0; i < count; ++i) {
+                d[i] = OP::operate(s0[i]);
+            }
+        }
+    };
+
+    template<class OP, bool vectorized = OP::vectorized>
+    struct binary_opcode {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type D;
+            typedef typename OP::src_type S;
+            D *d = reinterpret_cast<D *>(dst);
+            const S *s0 = reinterpret_cast<const S *>(src[0]);
+            const S *s1 = reinterpret_cast<const S *>(src[1]);
+            for (intptr_t i = 0; i < count; ++i) {
+                d[i] = OP::operate(s0[i], s1[i]);
+            }
+        }
+    };
+
+    template<class OP, bool vectorized = OP::vectorized>
+    struct ternary_opcode {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type D;
+            typedef typename OP::src_type S;
+            D *d = reinterpret_cast<D *>(dst);
+            const S *s0 = reinterpret_cast<const S *>(src[0]);
+            const S *s1 = reinterpret_cast<const S *>(src[1]);
+            const S *s2 = reinterpret_cast<const S *>(src[2]);
+            for (intptr_t i = 0; i < count; ++i) {
+                d[i] = OP::operate(s0[i], s1[i], s2[i]);
+            }
+        }
+    };
+
+#if defined(DYND_X86_SIMD)
+    template<class OP>
+    struct unary_opcode<OP, true> {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type T;
+            typedef simd<T> V;
+            T *d = reinterpret_cast<T *>(dst);
+            const T *s0 = reinterpret_cast<const T *>(src[0]);
+            intptr_t i = 0;
+            for (; i + V::width <= count; i += V::width) {
+                V::store(d + i, OP::simd_operate(V::load(s0 + i)));
+            }
+            for (; i < count; ++i) {
+                d[i] = OP::operate(s0[i]);
+            }
+        }
+    };
+
+    template<class OP>
+    struct binary_opcode<OP, true> {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type T;
+            typedef simd<T> V;
+            T *d = reinterpret_cast<T *>(dst);
+            const T *s0 = reinterpret_cast<const T *>(src[0]);
+            const T *s1 = reinterpret_cast<const T *>(src[1]);
+            intptr_t i = 0;
+            for (; i + V::width <= count; i += V::width) {
+                V::store(d + i, OP::simd_operate(V::load(s0 + i), V::load(s1 + i)));
+            }
+            for (; i < count; ++i) {
+                d[i] = OP::operate(s0[i], s1[i]);
+            }
+        }
+    };
+
+    template<class OP>
+    struct ternary_opcode<OP, true> {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            typedef typename OP::dst_type T;
+            typedef simd<T> V;
+            T *d = reinterpret_cast<T *>(dst);
+            const T *s0 = reinterpret_cast<const T *>(src[0]);
+            const T *s1 = reinterpret_cast<const T *>(src[1]);
+            const T *s2 = reinterpret_cast<const T *>(src[2]);
+            intptr_t i = 0;
+            for (; i + V::width <= count; i += V::width) {
+                V::store(d + i, OP::simd_operate(V::load(s0 + i), V::load(s1 + i), V::load(s2 + i)));
+            }
+            for (; i < count; ++i) {
+                d[i] = OP::operate(s0[i], s1[i], s2[i]);
+            }
+        }
+    };
+#endif
+
+    template<class T>
+    struct copy_opcode {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            if (dst != src[0]) {
+                memcpy(dst, src[0], count * sizeof(T));
+            }
+        }
+    };
+
+    template<class T>
+    struct select_opcode {
+        static void func(char *dst, const char * const *src, intptr_t count)
+        {
+            T *d = reinterpret_cast<T *>(dst);
+            const bool_reg *cond = reinterpret_cast<const bool_reg *>(src[0]);
+            const T *s1 = reinterpret_cast<const T *>(src[1]);
+            const T *s2 = reinterpret_cast<const T *>(src[2]);
+            for (intptr_t i = 0; i < count; ++i) {
+                d[i] = cond[i] ? s1[i] : s2[i];
+            }
+        }
+    };
+
+    template<class T>
+    struct addition {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x + y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::add(x, y);
+        }
+#endif
+    };
+
+    template<class T>
+    struct subtraction {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x - y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::sub(x, y);
+        }
+#endif
+    };
+
+    template<class T>
+    struct multiplication {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x * y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::mul(x, y);
+        }
+#endif
+    };
+
+    template<class T>
+    struct division {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x / y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::div(x, y);
+        }
+#endif
+    };
+
+    // This is a multiply followed by an add, rounded twice
+    template<class T>
+    struct multiply_add {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y, T z) {
+            return x * y + z;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y, V z) {
+            return simd<T>::add(simd<T>::mul(x, y), z);
+        }
+#endif
+    };
+
+    // These match the SSE2 instructions, returning y if either is NaN
+    template<class T>
+    struct minimum {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x < y ? x : y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::min(x, y);
+        }
+#endif
+    };
+
+    template<class T>
+    struct maximum {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x, T y) {
+            return x > y ? x : y;
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x, V y) {
+            return simd<T>::max(x, y);
+        }
+#endif
+    };
+
+    inline int32_t abs_value(int32_t x) { return x < 0 ? -x : x; }
+    inline int64_t abs_value(int64_t x) { return x < 0 ? -x : x; }
+    inline uint32_t abs_value(uint32_t x) { return x; }
+    inline uint64_t abs_value(uint64_t x) { return x; }
+    inline float abs_value(float x) { return fabsf(x); }
+    inline double abs_value(double x) { return fabs(x); }
+
+    template<class T>
+    struct absolute {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x) {
+            return abs_value(x);
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x) {
+            return simd<T>::abs(x);
+        }
+#endif
+    };
+
+    template<class T>
+    struct square_root {
+        typedef T dst_type;
+        typedef T src_type;
+        static const bool vectorized = is_simd_type<T>::value;
+        static inline T operate(T x) {
+            return sqrt(x);
+        }
+#if defined(DYND_X86_SIMD)
+        template<class V>
+        static inline V simd_operate(V x) {
+            return simd<T>::sqrt(x);
+        }
+#endif
+    };
+
+#define DYND_VM_COMPARISON(NAME, OPERATOR) \
+    template<class T> \
+    struct NAME { \
+        typedef bool_reg dst_type; \
+        typedef T src_type; \
+        static const bool vectorized = false; \
+        static inline bool_reg operate(T x, T y) { \
+            return x OPERATOR y; \
+        } \
+    }
+
+    DYND_VM_COMPARISON(compare_less, <);
+    DYND_VM_COMPARISON(compare_less_equal, <=);
+    DYND_VM_COMPARISON(compare_equal, ==);
+    DYND_VM_COMPARISON(compare_not_equal, !=);
+    DYND_VM_COMPARISON(compare_greater_equal, >=);
+    DYND_VM_COMPARISON(compare_greater, >);
+
+#undef DYND_VM_COMPARISON
+
+    template<class D, class S>
+    struct cast_value {
+        static inline D cast(S s) {
+            return static_cast<D>(s);
+        }
+    };
+
+    template<class S>
+    struct cast_value<bool_reg, S> {
+        static inline bool_reg cast(S s) {
+            return s != 0;
+        }
+    };
+
+    template<class D, class S>
+    struct cast {
+        typedef D dst_type;
+        typedef S src_type;
+        static const bool vectorized = false;
+        static inline D operate(S s) {
+            return cast_value<D, S>::cast(s);
+        }
+    };
+
+    /** The opcodes supported for all the numeric types, including complex */
+    template<class T>
+    vm::elwise_opcode_function_t get_numeric_opcode_function(vm::opcode_t opcode)
+    {
+        switch (opcode) {
+            case vm::opcode_copy:
+                return &copy_opcode<T>::func;
+            case vm::opcode_add:
+                return &binary_opcode<addition<T> >::func;
+            case vm::opcode_subtract:
+                return &binary_opcode<subtraction<T> >::func;
+            case vm::opcode_multiply:
+                return &binary_opcode<multiplication<T> >::func;
+            case vm::opcode_divide:
+                return &binary_opcode<division<T> >::func;
+            case vm::opcode_equal:
+                return &binary_opcode<compare_equal<T> >::func;
+            case vm::opcode_not_equal:
+                return &binary_opcode<compare_not_equal<T> >::func;
+            case vm::opcode_select:
+                return &select_opcode<T>::func;
+            case vm::opcode_muladd:
+                return &ternary_opcode<multiply_add<T> >::func;
+            default:
+                return NULL;
+        }
+    }
+
+    template<class T>
+    vm::elwise_opcode_function_t get_sqrt_function()
+    {
+        return NULL;
+    }
+
+    template<>
+    vm::elwise_opcode_function_t get_sqrt_function<float>()
+    {
+        return &unary_opcode<square_root<float> >::func;
+    }
+
+    template<>
+    vm::elwise_opcode_function_t get_sqrt_function<double>()
+    {
+        return &unary_opcode<square_root<double> >::func;
+    }
+
+    /** The opcodes supported for the real types */
+    template<class T>
+    vm::elwise_opcode_function_t get_real_opcode_function(vm::opcode_t opcode)
+    {
+        switch (opcode) {
+            case vm::opcode_min:
+                return &binary_opcode<minimum<T> >::func;
+            case vm::opcode_max:
+                return &binary_opcode<maximum<T> >::func;
+            case vm::opcode_abs:
+                return &unary_opcode<absolute<T> >::func;
+            case vm::opcode_sqrt:
+                return get_sqrt_function<T>();
+            case vm::opcode_less:
+                return &binary_opcode<compare_less<T> >::func;
+            case vm::opcode_less_equal:
+                return &binary_opcode<compare_less_equal<T> >::func;
+            case vm::opcode_greater_equal:
+                return &binary_opcode<compare_greater_equal<T> >::func;
+            case vm::opcode_greater:
+                return &binary_opcode<compare_greater<T> >::func;
+            default:
+                return get_numeric_opcode_function<T>(opcode);
+        }
+    }
+
+    vm::elwise_opcode_function_t get_bool_opcode_function(vm::opcode_t opcode)
+    {
+        switch (opcode) {
+            case vm::opcode_copy:
+                return &copy_opcode<bool_reg>::func;
+            case vm::opcode_equal:
+                return &binary_opcode<compare_equal<bool_reg> >::func;
+            case vm::opcode_not_equal:
+                return &binary_opcode<compare_not_equal<bool_reg> >::func;
+            case vm::opcode_select:
+                return &select_opcode<bool_reg>::func;
+            default:
+                return NULL;
+        }
+    }
+
+    /**
+     * Gets the function for an opcode whose type is given by `tp`, the type
+     * of all its registers except for bool comparison results and conditions.
+     */
+    vm::elwise_opcode_function_t get_typed_opcode_function(vm::opcode_t opcode, const ndt::type& tp)
+    {
+        switch (tp.get_type_id()) {
+            case bool_type_id:
+                return get_bool_opcode_function(opcode);
+            case int32_type_id:
+                return get_real_opcode_function<int32_t>(opcode);
+            case int64_type_id:
+                return get_real_opcode_function<int64_t>(opcode);
+            case uint32_type_id:
+                return get_real_opcode_function<uint32_t>(opcode);
+            case uint64_type_id:
+                return get_real_opcode_function<uint64_t>(opcode);
+            case float32_type_id:
+                return get_real_opcode_function<float>(opcode);
+            case float64_type_id:
+                return get_real_opcode_function<double>(opcode);
+            case complex_float32_type_id:
+                return get_numeric_opcode_function<dynd_complex<float> >(opcode);
+            case complex_float64_type_id:
+                return get_numeric_opcode_function<dynd_complex<double> >(opcode);
+            default:
+                return NULL;
+        }
+    }
+
+    template<class D>
+    vm::elwise_opcode_function_t get_cast_function(const ndt::type& src_tp)
+    {
+        switch (src_tp.get_type_id()) {
+            case bool_type_id:
+                return &unary_opcode<cast<D, bool_reg> >::func;
+            case int32_type_id:
+                return &unary_opcode<cast<D, int32_t> >::func;
+            case int64_type_id:
+                return &unary_opcode<cast<D, int64_t> >::func;
+            case uint32_type_id:
+                return &unary_opcode<cast<D, uint32_t> >::func;
+            case uint64_type_id:
+                return &unary_opcode<cast<D, uint64_t> >::func;
+            case float32_type_id:
+                return &unary_opcode<cast<D, float> >::func;
+            case float64_type_id:
+                return &unary_opcode<cast<D, double> >::func;
+            default:
+                return NULL;
+        }
+    }
+
+    vm::elwise_opcode_function_t get_cast_function(const ndt::type& dst_tp, const ndt::type& src_tp)
+    {
+        switch (dst_tp.get_type_id()) {
+            case bool_type_id:
+                return get_cast_function<bool_reg>(src_tp);
+            case int32_type_id:
+                return get_cast_function<int32_t>(src_tp);
+            case int64_type_id:
+                return get_cast_function<int64_t>(src_tp);
+            case uint32_type_id:
+                return get_cast_function<uint32_t>(src_tp);
+            case uint64_type_id:
+                return get_cast_function<uint64_t>(src_tp);
+            case float32_type_id:
+                return get_cast_function<float>(src_tp);
+            case float64_type_id:
+                return get_cast_function<double>(src_tp);
+            default:
+                return NULL;
+        }
+    }
+} // anonymous namespace
+
+vm::elwise_opcode_function_t dynd::vm::get_elwise_opcode_function(opcode_t opcode,
+                const ndt::type& dst_tp, const ndt::type *src_tp)
+{
+    switch (opcode) {
+        case opcode_less:
+        case opcode_less_equal:
+        case opcode_equal:
+        case opcode_not_equal:
+        case opcode_greater_equal:
+        case opcode_greater:
+            if (dst_tp.get_type_id() != bool_type_id || src_tp[0] != src_tp[1]) {
+                return NULL;
+            }
+            return get_typed_opcode_function(opcode, src_tp[0]);
+        case opcode_select:
+            if (src_tp[0].get_type_id() != bool_type_id || src_tp[1] != dst_tp || src_tp[2] != dst_tp) {
+                return NULL;
+            }
+            return get_typed_opcode_function(opcode, dst_tp);
+        case opcode_cast:
+            return get_cast_function(dst_tp, src_tp[0]);
+        default:
+            if (opcode < 0 || opcode >= opcode_count) {
+                return NULL;
+            }
+            for (int i = 0; i < opcode_info[opcode].arity; ++i) {
+                if (src_tp[i] != dst_tp) {
+                    return NULL;
+                }
+            }
+            return get_typed_opcode_function(opcode, dst_tp);
+    }
+}
+
+namespace {
+    /** Copies `count` elements of `size` bytes between strided buffers */
+    inline void copy_strided(char *dst, intptr_t dst_stride, const char *src, intptr_t src_stride,
+                    size_t size, intptr_t count)
+    {
+        switch (size) {
+            case 4:
+                for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+                    *reinterpret_cast<uint32_t *>(dst) = *reinterpret_cast<const uint32_t *>(src);
+                }
+                break;
+            case 8:
+                for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+                    *reinterpret_cast<uint64_t *>(dst) = *reinterpret_cast<const uint64_t *>(src);
+                }
+                break;
+            default:
+                for (intptr_t i = 0; i < count; ++i, dst += dst_stride, src += src_stride) {
+                    memcpy(dst, src, size);
+                }
+                break;
+        }
+    }
+} // anonymous namespace
+
+dynd::vm::elwise_interpreter::elwise_interpreter(const elwise_program& ep, const ndt::type *src_tp,
+                const char **src_metadata, const eval::eval_context *ectx)
+    : m_program(ep), m_funcs(),
+        m_regs(m_program.get_register_types(), elwise_max_chunk_size, elwise_max_register_bytes),
+        m_reg_ptrs(m_regs.get_registers()), m_input_kernels(ep.get_input_count()),
+        m_converts_input(ep.get_input_count())
+{
+    const vector<ndt::type>& regtypes = m_program.get_register_types();
+    const vector<int>& program = m_program.get_program();
+    for (size_t ip = 0; ip < program.size(); ip += 2 + opcode_info[program[ip]].arity) {
+        opcode_t opcode = static_cast<opcode_t>(program[ip]);
+        int arity = opcode_info[opcode].arity;
+        ndt::type op_src_tp[max_opcode_arity];
+        for (int j = 0; j < arity; ++j) {
+            op_src_tp[j] = regtypes[program[ip + 2 + j]];
+        }
+        elwise_opcode_function_t func = get_elwise_opcode_function(opcode,
+                        regtypes[program[ip + 1]], op_src_tp);
+        if (func == NULL) {
+            stringstream ss;
+            ss << "elwise_interpreter: opcode " << opcode_info[opcode].name;
+            ss << " is not supported with output type " << regtypes[program[ip + 1]];
+            ss << " and input types (";
+            for (int j = 0; j < arity; ++j) {
+                ss << op_src_tp[j] << (j != arity - 1 ? ", " : ")");
+            }
+            throw runtime_error(ss.str());
+        }
+        m_funcs.push_back(func);
+    }
+
+    for (int i = 0; i < ep.get_input_count(); ++i) {
+        m_converts_input[i] = (src_tp != NULL && src_tp[i] != regtypes[i + 1]);
+        if (m_converts_input[i]) {
+            make_assignment_kernel(&m_input_kernels[i], 0, regtypes[i + 1], NULL,
+                            src_tp[i], src_metadata[i], kernel_request_strided,
+                            assign_error_default, ectx);
+        }
+    }
+}
+
+void dynd::vm::elwise_interpreter::execute(intptr_t count)
+{
+    const vector<int>& program = m_program.get_program();
+    const char *src[max_opcode_arity];
+    for (size_t k = 0, ip = 0; k < m_funcs.size(); ++k) {
+        int arity = opcode_info[program[ip]].arity;
+        for (int j = 0; j < arity; ++j) {
+            src[j] = m_reg_ptrs[program[ip + 2 + j]];
+        }
+        m_funcs[k](m_reg_ptrs[program[ip + 1]], src, count);
+        ip += 2 + arity;
+    }
+}
+
+void dynd::vm::elwise_interpreter::run_single(char *dst, const char * const *src)
+{
+    const vector<char *>& registers = m_regs.get_registers();
+    for (int i = 0; i < m_program.get_input_count(); ++i) {
+        if (m_converts_input[i]) {
+            m_reg_ptrs[i + 1] = registers[i + 1];
+            m_input_kernels[i](registers[i + 1], 0, src[i], 0, 1);
+        } else {
+            m_reg_ptrs[i + 1] = const_cast<char *>(src[i]);
+        }
+    }
+    m_reg_ptrs[0] = dst;
+    execute(1);
+}
+
+void dynd::vm::elwise_interpreter::run(char *dst, intptr_t dst_stride,
+                const char * const *src, const intptr_t *src_stride, intptr_t count)
+{
+    const vector<ndt::type>& regtypes = m_program.get_register_types();
+    const vector<char *>& registers = m_regs.get_registers();
+    int input_count = m_program.get_input_count();
+    intptr_t block_size = get_block_size();
+    intptr_t dst_size = regtypes[0].get_data_size();
+    bool dst_in_place = (dst_stride == dst_size);
+    m_reg_ptrs[0] = registers[0];
+    for (intptr_t pos = 0; pos < count; pos += block_size) {
+        intptr_t block_count = min(block_size, count - pos);
+        // Point the registers at contiguous inputs, or gather the others
+        for (int i = 0; i < input_count; ++i) {
+            const char *ptr = src[i] + pos * src_stride[i];
+            intptr_t size = regtypes[i + 1].get_data_size();
+            if (m_converts_input[i]) {
+                m_reg_ptrs[i + 1] = registers[i + 1];
+                m_input_kernels[i](registers[i + 1], size, ptr, src_stride[i], block_count);
+            } else if (src_stride[i] == size) {
+                m_reg_ptrs[i + 1] = const_cast<char *>(ptr);
+            } else {
+                m_reg_ptrs[i + 1] = registers[i + 1];
+                copy_strided(registers[i + 1], size, ptr, src_stride[i], size, block_count);
+            }
+        }
+        if (dst_in_place) {
+            m_reg_ptrs[0] = dst + pos * dst_stride;
+        }
+        execute(block_count);
+        if (!dst_in_place) {
+            copy_strided(dst + pos * dst_stride, dst_stride, registers[0], dst_size,
+                            dst_size, block_count);
+        }
+    }
+}
+
+namespace {
+    struct elwise_program_expr_kernel {
+        ckernel_prefix base;
+        vm::elwise_interpreter *interp;
+
+        static void single(char *dst, const char * const *src, ckernel_prefix *extra)
+        {
+            reinterpret_cast<elwise_program_expr_kernel *>(extra)->interp->run_single(dst, src);
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char * const *src, const intptr_t *src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            reinterpret_cast<elwise_program_expr_kernel *>(extra)->interp->run(
+                            dst, dst_stride, src, src_stride, count);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            delete reinterpret_cast<elwise_program_expr_kernel *>(extra)->interp;
+        }
+    };
+} // anonymous namespace
+
+size_t dynd::vm::make_elwise_program_expr_kernel(ckernel_builder *out, size_t offset_out,
+                const elwise_program& ep, const ndt::type *src_tp, const char **src_metadata,
+                kernel_request_t kernreq, const eval::eval_context *ectx)
+{
+    out->ensure_capacity_leaf(offset_out + sizeof(elwise_program_expr_kernel));
+    elwise_program_expr_kernel *e = out->get_at<elwise_program_expr_kernel>(offset_out);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<expr_single_operation_t>(&elwise_program_expr_kernel::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<expr_strided_operation_t>(&elwise_program_expr_kernel::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_elwise_program_expr_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
+    e->interp = new elwise_interpreter(ep, src_tp, src_metadata, ectx);
+    e->base.destructor = &elwise_program_expr_kernel::destruct;
+    return offset_out + sizeof(elwise_program_expr_kernel);
+}
+
+namespace {
+    struct elwise_program_ckernel_deferred_data {
+        vm::elwise_program ep;
+    };
+
+    void delete_elwise_program_ckernel_deferred_data(void *self_data_ptr)
+    {
+        delete reinterpret_cast<elwise_program_ckernel_deferred_data *>(self_data_ptr);
+    }
+
+    intptr_t instantiate_elwise_program_ckernel(void *self_data_ptr,
+                    dynd::ckernel_builder *out_ckb, intptr_t ckb_offset,
+                    const char *const *dynd_metadata, uint32_t kerntype,
+                    const eval::eval_context *ectx)
+    {
+        const vm::elwise_program& ep =
+                        reinterpret_cast<elwise_program_ckernel_deferred_data *>(self_data_ptr)->ep;
+        return vm::make_elwise_program_expr_kernel(out_ckb, ckb_offset, ep,
+                        &ep.get_register_types()[1], const_cast<const char **>(dynd_metadata) + 1,
+                        (kernel_request_t)kerntype, ectx);
+    }
+} // anonymous namespace
+
+void dynd::vm::make_elwise_program_ckernel_deferred(const elwise_program& ep, ckernel_deferred& out_ckd)
+{
+    // Check the program is supported now rather than at instantiation
+    elwise_interpreter check(ep);
+
+    elwise_program_ckernel_deferred_data *data = new elwise_program_ckernel_deferred_data;
+    data->ep = ep;
+    out_ckd.ckernel_funcproto = expr_operation_funcproto;
+    // The output and input registers come first in the register types
+    out_ckd.data_types_size = ep.get_input_count() + 1;
+    out_ckd.data_dynd_types = &data->ep.get_register_types()[0];
+    out_ckd.data_ptr = data;
+    out_ckd.instantiate_func = &instantiate_elwise_program_ckernel;
+    out_ckd.free_func = &delete_elwise_program_ckernel_deferred_data;
+}
@@ -5,6 +5,7 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <cstring>
 
 #include <dynd/vm/elwise_program.hpp>
 
@@ -16,7 +17,20 @@ const dynd::vm::opcode_info_t dynd::vm::opcode_info[opcode_count] = {
     {"add", 2},
     {"subtract", 2},
     {"multiply", 2},
-    {"divide", 2}
+    {"divide", 2},
+    {"min", 2},
+    {"max", 2},
+    {"abs", 1},
+    {"sqrt", 1},
+    {"less", 2},
+    {"less_equal", 2},
+    {"equal", 2},
+    {"not_equal", 2},
+    {"greater_equal", 2},
+    {"greater", 2},
+    {"select", 3},
+    {"muladd", 3},
+    {"cast", 1}
 };
 
 int dynd::vm::validate_elwise_program(int input_count, int reg_count, size_t program_size, const int *program)
@@ -78,6 +92,157 @@ int dynd::vm::validate_elwise_program(int input_count, int reg_count, size_t pro
     return instruction_count;
 }
 
+namespace {
+    struct elwise_program_composer {
+        int m_first_temp;
+        std::vector<ndt::type> m_temp_types;
+        std::vector<int> m_free_temps;
+        std::vector<int> m_program;
+
+        elwise_program_composer(int input_count)
+            : m_first_temp(input_count + 1)
+        {
+        }
+
+        int acquire_temp(const ndt::type& tp)
+        {
+            for (size_t i = 0; i < m_free_temps.size(); ++i) {
+                if (m_temp_types[m_free_temps[i] - m_first_temp] == tp) {
+                    int reg = m_free_temps[i];
+                    m_free_temps.erase(m_free_temps.begin() + i);
+                    return reg;
+                }
+            }
+            m_temp_types.push_back(tp);
+            return m_first_temp + (int)m_temp_types.size() - 1;
+        }
+
+        void release_temp(int reg)
+        {
+            if (reg >= m_first_temp) {
+                m_free_temps.push_back(reg);
+            }
+        }
+
+        /**
+         * Emits an instruction whose sources are already in `src_regs`,
+         * returning its destination register.
+         */
+        int emit_instruction(int opcode, const ndt::type& tp, const int *src_regs, bool is_root)
+        {
+            int arity = vm::opcode_info[opcode].arity;
+            // The temporaries are consumed here, so the
+            // result may go in one of them
+            for (int i = 0; i < arity; ++i) {
+                release_temp(src_regs[i]);
+            }
+            int dst_reg = is_root ? 0 : acquire_temp(tp);
+            m_program.push_back(opcode);
+            m_program.push_back(dst_reg);
+            m_program.insert(m_program.end(), src_regs, src_regs + arity);
+            return dst_reg;
+        }
+
+        /**
+         * Emits the instructions computing the value `reg` has in `ep` just
+         * before instruction position `ip`, whose inputs are mapped to the
+         * registers following `input_offset`. Returns the register holding it.
+         */
+        int emit_value(const vm::elwise_program& ep, int reg, size_t ip, int input_offset)
+        {
+            if (reg > 0 && reg <= ep.get_input_count()) {
+                return input_offset + reg;
+            }
+            const std::vector<int>& program = ep.get_program();
+            size_t writer = ep.find_register_writer(reg, ip);
+            if (writer == program.size()) {
+                stringstream ss;
+                ss << "DyND VM program reads register " << reg << " before writing to it";
+                throw runtime_error(ss.str());
+            }
+            int opcode = program[writer];
+            int arity = vm::opcode_info[opcode].arity;
+            int src_regs[vm::max_opcode_arity];
+            for (int i = 0; i < arity; ++i) {
+                src_regs[i] = emit_value(ep, program[writer + 2 + i], writer, input_offset);
+            }
+            return emit_instruction(opcode, ep.get_register_types()[reg], src_regs, false);
+        }
+    };
+} // anonymous namespace
+
+void dynd::vm::compose_elwise_program(opcode_t opcode, const ndt::type& tp,
+                const elwise_program * const *operands, elwise_program& out)
+{
+    int arity = vm::opcode_info[opcode].arity;
+    vector<ndt::type> regtypes(1, tp);
+    for (int i = 0; i < arity; ++i) {
+        if (operands[i] == NULL) {
+            regtypes.push_back(tp);
+        } else {
+            const vector<ndt::type>& op_regtypes = operands[i]->get_register_types();
+            regtypes.insert(regtypes.end(), op_regtypes.begin() + 1,
+                            op_regtypes.begin() + 1 + operands[i]->get_input_count());
+        }
+    }
+    int input_count = (int)regtypes.size() - 1;
+
+    elwise_program_composer c(input_count);
+    int src_regs[vm::max_opcode_arity];
+    for (int i = 0, input_offset = 0; i < arity; ++i) {
+        if (operands[i] == NULL) {
+            src_regs[i] = ++input_offset;
+        } else {
+            src_regs[i] = c.emit_value(*operands[i], 0, operands[i]->get_program().size(),
+                            input_offset);
+            input_offset += operands[i]->get_input_count();
+        }
+    }
+    c.emit_instruction(opcode, tp, src_regs, true);
+
+    regtypes.insert(regtypes.end(), c.m_temp_types.begin(), c.m_temp_types.end());
+    out.set(input_count, regtypes, c.m_program);
+}
+
+size_t dynd::vm::elwise_program::find_register_writer(int reg, size_t ip) const
+{
+    size_t writer = m_program.size();
+    for (size_t i = 0; i < ip; i += 2 + vm::opcode_info[m_program[i]].arity) {
+        if (m_program[i + 1] == reg) {
+            writer = i;
+        }
+    }
+    return writer;
+}
+
+static void print_expression_value(std::ostream& o, const vm::elwise_program& ep, int reg, size_t ip)
+{
+    if (reg > 0 && reg <= ep.get_input_count()) {
+        o << "op" << (reg - 1);
+        return;
+    }
+    const vector<int>& program = ep.get_program();
+    size_t writer = ep.find_register_writer(reg, ip);
+    if (writer == program.size()) {
+        o << "<uninitialized>";
+        return;
+    }
+    int arity = vm::opcode_info[program[writer]].arity;
+    o << vm::opcode_info[program[writer]].name << "(";
+    for (int i = 0; i < arity; ++i) {
+        print_expression_value(o, ep, program[writer + 2 + i], writer);
+        if (i != arity - 1) {
+            o << ", ";
+        }
+    }
+    o << ")";
+}
+
+void dynd::vm::elwise_program::print_expression(std::ostream& o) const
+{
+    print_expression_value(o, *this, 0, m_program.size());
+}
+
 static void print_register(std::ostream& o, int reg)
 {
     o << "r";
@@ -117,7 +282,7 @@ void dynd::vm::elwise_program::debug_print(std::ostream& o, const std::string& i
         int arity = vm::opcode_info[opcode].arity;
         // operation
         o << indent << "  " << vm::opcode_info[opcode].name << " ";
-        for (size_t i = 0, i_end = 12 - strlen(vm::opcode_info[opcode].name); i != i_end; ++i) {
+        for (size_t i = strlen(vm::opcode_info[opcode].name); i < 14; ++i) {
             o << " ";
         }
         // output
@@ -13,6 +13,10 @@
 #include <dynd/array.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
+#include <dynd/kernels/assignment_kernel_cache.hpp>
+#include <dynd/json_parser.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -530,3 +534,254 @@ INSTANTIATE_TYPED_TEST_CASE_P(Default, ArrayAssign, DefaultMemoryPairs);
 #ifdef DYND_CUDA
 INSTANTIATE_TYPED_TEST_CASE_P(CUDA, ArrayAssign, CUDAMemoryPairs);
 #endif // DYND_CUDA
+
+TEST(ArrayAssign, KernelCache) {
+    assignment_kernel_cache cache(2);
+    int32_t vals[] = {1, 2, 3};
+    nd::array a = nd::empty(3, "strided * float64");
+    nd::array b = vals;
+    for (int i = 0; i < 5; ++i) {
+        assignment_kernel_cache::borrowed_kernel k(cache, a.get_type(), a.get_ndo_meta(),
+                        b.get_type(), b.get_ndo_meta(), kernel_request_single,
+                        assign_error_none, &eval::default_eval_context);
+        k(a.get_readwrite_originptr(), b.get_readonly_originptr());
+    }
+    EXPECT_EQ(1u, cache.get_miss_count());
+    EXPECT_EQ(4u, cache.get_hit_count());
+    EXPECT_EQ(3, a(2).as<double>());
+
+    // A different error mode or request builds a new kernel
+    {
+        assignment_kernel_cache::borrowed_kernel k(cache, a.get_type(), a.get_ndo_meta(),
+                        b.get_type(), b.get_ndo_meta(), kernel_request_single,
+                        assign_error_overflow, &eval::default_eval_context);
+        // While borrowed, the same key builds another kernel
+        assignment_kernel_cache::borrowed_kernel k2(cache, a.get_type(), a.get_ndo_meta(),
+                        b.get_type(), b.get_ndo_meta(), kernel_request_single,
+                        assign_error_overflow, &eval::default_eval_context);
+        EXPECT_NE(k.get(), k2.get());
+        k2(a.get_readwrite_originptr(), b.get_readonly_originptr());
+    }
+    EXPECT_EQ(3u, cache.get_miss_count());
+
+    // Strided kernels
+    nd::array c = nd::empty(3, "strided * int64");
+    {
+        assignment_kernel_cache::borrowed_kernel k(cache, ndt::make_type<int64_t>(), NULL,
+                        ndt::make_type<int32_t>(), NULL, kernel_request_strided,
+                        assign_error_none, &eval::default_eval_context);
+        k(c.get_readwrite_originptr(), 8, b.get_readonly_originptr(), 4, 3);
+    }
+    EXPECT_EQ(2, c(1).as<int64_t>());
+
+    // Changed metadata at the same address doesn't match
+    double dvals[6] = {0, 0, 0, 0, 0, 0};
+    nd::array d = dvals;
+    nd::array v = d(irange(0, 3));
+    strided_dim_type_metadata *v_md = reinterpret_cast<strided_dim_type_metadata *>(
+                    const_cast<char *>(v.get_ndo_meta()));
+    uint64_t miss_count = cache.get_miss_count(), hit_count = cache.get_hit_count();
+    {
+        assignment_kernel_cache::borrowed_kernel k(cache, v.get_type(), v.get_ndo_meta(),
+                        b.get_type(), b.get_ndo_meta(), kernel_request_single,
+                        assign_error_none, &eval::default_eval_context);
+        k(v.get_readwrite_originptr(), b.get_readonly_originptr());
+    }
+    EXPECT_EQ(miss_count + 1, cache.get_miss_count());
+    EXPECT_EQ(2, d(1).as<double>());
+    // Every second element instead
+    v_md->stride = 2 * sizeof(double);
+    {
+        assignment_kernel_cache::borrowed_kernel k(cache, v.get_type(), v.get_ndo_meta(),
+                        b.get_type(), b.get_ndo_meta(), kernel_request_single,
+                        assign_error_none, &eval::default_eval_context);
+        k(v.get_readwrite_originptr(), b.get_readonly_originptr());
+    }
+    EXPECT_EQ(miss_count + 2, cache.get_miss_count());
+    EXPECT_EQ(hit_count, cache.get_hit_count());
+    EXPECT_EQ(2, d(2).as<double>());
+    EXPECT_EQ(3, d(4).as<double>());
+
+    // Metadata holding references, like the string field here, works too
+    nd::array s = nd::empty(ndt::make_cstruct(ndt::make_type<int32_t>(), "x",
+                    ndt::make_string(), "y"));
+    nd::array t = parse_json("{x : int32, y : string}", "{\"x\":5, \"y\":\"abc\"}");
+    cache.clear();
+    {
+        assignment_kernel_cache::borrowed_kernel k(cache, s.get_type(), s.get_ndo_meta(),
+                        t.get_type(), t.get_ndo_meta(), kernel_request_single,
+                        assign_error_none, &eval::default_eval_context);
+        k(s.get_readwrite_originptr(), t.get_readonly_originptr());
+    }
+    EXPECT_EQ(5, s(0).as<int>());
+    EXPECT_EQ("abc", s(1).as<string>());
+}
+
+TEST(ArrayAssign, RepeatedValAssign) {
+    // Repeated assignments between the same arrays go through
+    // the thread's kernel cache
+    nd::array a = nd::empty("{x : int32, y : float64}");
+    nd::array b = nd::empty("{x : int16, y : float32}");
+    for (int i = 0; i < 10; ++i) {
+        b(0).vals() = i;
+        b(1).vals() = i + 0.5;
+        a.vals() = b;
+        EXPECT_EQ(i, a(0).as<int>());
+        EXPECT_EQ(i + 0.5, a(1).as<double>());
+    }
+}
+
+TEST(ArrayAssign, CKernelBuilderPool) {
+    // Kernels bigger than the static data reuse pooled memory
+    vector<ndt::type> field_types(40, ndt::make_string());
+    vector<string> field_names;
+    for (int i = 0; i < 40; ++i) {
+        field_names.push_back(string(1, (char)('A' + i)));
+    }
+    ndt::type tp = ndt::make_cstruct(field_types.size(), &field_types[0], &field_names[0]);
+    nd::array a, b = nd::empty(tp);
+    for (int i = 0; i < 40; ++i) {
+        b(i).vals() = field_names[i];
+    }
+    ckernel_prefix *first = NULL;
+    for (int i = 0; i < 3; ++i) {
+        a = nd::empty(tp);
+        assignment_ckernel_builder k;
+        make_assignment_kernel(&k, 0, tp, a.get_ndo_meta(), tp, b.get_ndo_meta(),
+                        kernel_request_single, assign_error_none, &eval::default_eval_context);
+        k(a.get_readwrite_originptr(), b.get_readonly_originptr());
+        if (first == NULL) {
+            first = k.get();
+        }
+#ifdef DYND_USE_THREAD_LOCAL
+        EXPECT_EQ(first, k.get());
+#endif
+    }
+    EXPECT_EQ("N", a(13).as<string>());
+}
+
+TEST(ArrayAssign, BlockCheckedCasts) {
+    // Contiguous checked casts are validated a block at a time,
+    // with the error still reporting the offending value
+    intptr_t count = 1000;
+    nd::array a = nd::make_strided_array(count, ndt::make_type<int64_t>());
+    int64_t *a_data = reinterpret_cast<int64_t *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < count; ++i) {
+        a_data[i] = i - 500;
+    }
+    nd::array b = nd::make_strided_array(count, ndt::make_type<int16_t>());
+    b.val_assign(a, assign_error_overflow);
+    EXPECT_EQ(-500, b(0).as<int>());
+    EXPECT_EQ(499, b(999).as<int>());
+    a_data[700] = 40000;
+    try {
+        b.val_assign(a, assign_error_overflow);
+        FAIL() << "expected an overflow error";
+    } catch (const overflow_error& e) {
+        EXPECT_NE(string::npos, string(e.what()).find("40000"));
+    }
+    // Values before the offending one were assigned
+    EXPECT_EQ(199, b(699).as<int>());
+    nd::array c = nd::make_strided_array(count, ndt::make_type<uint8_t>());
+    EXPECT_THROW(c.val_assign(a, assign_error_overflow), overflow_error);
+
+    nd::array d = nd::make_strided_array(count, ndt::make_type<double>());
+    double *d_data = reinterpret_cast<double *>(d.get_readwrite_originptr());
+    for (intptr_t i = 0; i < count; ++i) {
+        d_data[i] = i * 0.5;
+    }
+    nd::array e = nd::make_strided_array(count, ndt::make_type<int32_t>());
+    e.val_assign(d, assign_error_overflow);
+    EXPECT_EQ(499, e(999).as<int>());
+    EXPECT_THROW(e.val_assign(d, assign_error_fractional), runtime_error);
+    d_data[1] = 1e10;
+    EXPECT_THROW(e.val_assign(d, assign_error_overflow), overflow_error);
+
+    nd::array f = nd::make_strided_array(count, ndt::make_type<float>());
+    d_data[1] = 0.5;
+    f.val_assign(d, assign_error_inexact);
+    EXPECT_EQ(499.5f, f(999).as<float>());
+    d_data[998] = 0.1;
+    EXPECT_THROW(f.val_assign(d, assign_error_inexact), runtime_error);
+    f.val_assign(d, assign_error_overflow);
+    d_data[998] = 1e300;
+    EXPECT_THROW(f.val_assign(d, assign_error_overflow), overflow_error);
+}
+
+TEST(ArrayAssign, CoalescedDimensions) {
+    // C-contiguous dimensions become a single loop
+    intptr_t shape[3] = {2, 3, 4};
+    nd::array a = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape);
+    nd::array b = nd::make_strided_array(ndt::make_type<int16_t>(), 3, shape);
+    int16_t *b_data = reinterpret_cast<int16_t *>(b.get_readwrite_originptr());
+    for (int i = 0; i < 24; ++i) {
+        b_data[i] = (int16_t)i;
+    }
+    assignment_ckernel_builder k;
+    make_assignment_kernel(&k, 0, a.get_type(), a.get_ndo_meta(),
+                    b.get_type(), b.get_ndo_meta(),
+                    kernel_request_single, assign_error_default, &eval::default_eval_context);
+    strided_assign_kernel_extra *e = reinterpret_cast<strided_assign_kernel_extra *>(k.get());
+    EXPECT_EQ(24, e->size);
+    EXPECT_EQ(4, e->dst_stride);
+    EXPECT_EQ(2, e->src_stride);
+    k(a.get_readwrite_originptr(), b.get_readonly_originptr());
+    EXPECT_EQ(0, a(0, 0, 0).as<int>());
+    EXPECT_EQ(23, a(1, 2, 3).as<int>());
+
+    // A sliced dimension keeps its own loop
+    nd::array c = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape);
+    c.vals() = 0;
+    c(irange(), irange(), irange().by(2)).vals() = b(irange(), irange(), irange() < 2);
+    EXPECT_EQ(1, c(1, 2, 2).as<int>() - c(1, 2, 0).as<int>());
+    EXPECT_EQ(21, c(1, 2, 2).as<int>());
+    EXPECT_EQ(0, c(1, 2, 3).as<int>());
+}
+
+TEST(ArrayAssign, StrideOrderedLoops) {
+    // Assign into a Fortran-order array and back
+    intptr_t shape[3] = {3, 4, 5};
+    int axis_perm[3] = {0, 1, 2};
+    nd::array a = nd::make_strided_array(ndt::make_type<int64_t>(), 3, shape);
+    int64_t *a_data = reinterpret_cast<int64_t *>(a.get_readwrite_originptr());
+    for (int i = 0; i < 60; ++i) {
+        a_data[i] = i;
+    }
+    nd::array f = nd::make_strided_array(ndt::make_type<int64_t>(), 3, shape,
+                    nd::read_access_flag|nd::write_access_flag, axis_perm);
+    f.vals() = a;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            for (int l = 0; l < 5; ++l) {
+                EXPECT_EQ(i * 20 + j * 5 + l, f(i, j, l).as<int>());
+            }
+        }
+    }
+    // Between two Fortran-order arrays, the loops are reversed
+    // and then coalesced into one
+    nd::array f2 = nd::make_strided_array(ndt::make_type<int64_t>(), 3, shape,
+                    nd::read_access_flag|nd::write_access_flag, axis_perm);
+    assignment_ckernel_builder k;
+    make_assignment_kernel(&k, 0, f2.get_type(), f2.get_ndo_meta(),
+                    f.get_type(), f.get_ndo_meta(),
+                    kernel_request_single, assign_error_default, &eval::default_eval_context);
+    strided_assign_kernel_extra *e = reinterpret_cast<strided_assign_kernel_extra *>(k.get());
+    EXPECT_EQ(60, e->size);
+    EXPECT_EQ(8, e->dst_stride);
+    EXPECT_EQ(8, e->src_stride);
+    k(f2.get_readwrite_originptr(), f.get_readonly_originptr());
+    EXPECT_EQ(59, f2(2, 3, 4).as<int>());
+    EXPECT_EQ(21, f2(1, 0, 1).as<int>());
+
+    nd::array c = nd::make_strided_array(ndt::make_type<int64_t>(), 3, shape);
+    c.vals() = f;
+    for (int i = 0; i < 60; ++i) {
+        EXPECT_EQ(i, c(i / 20, (i / 5) % 4, i % 5).as<int>());
+    }
+
+    // Broadcasting a lower-dimensional src
+    nd::array row = nd::make_strided_array(5, ndt::make_type<int64_t>());
+    row.vals() = 7;
+    f.vals() = row;
+    EXPECT_EQ(7, f(2, 3, 4).as<int>());
+}
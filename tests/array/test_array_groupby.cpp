@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/array_groupby.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/types/categorical_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ArrayGroupBy, ReduceNamed) {
+    int data[] = {1, 2, 3, 4, 5, 6};
+    const char *by[] = {"beta", "alpha", "beta", "beta", "alpha", "gamma"};
+    nd::array a;
+
+    a = nd::groupby_reduce(data, by, "sum");
+    ASSERT_EQ(3, a.get_dim_size());
+    EXPECT_EQ(ndt::make_type<int>(), a.get_dtype());
+    EXPECT_EQ(7, a(0).as<int>());
+    EXPECT_EQ(8, a(1).as<int>());
+    EXPECT_EQ(6, a(2).as<int>());
+
+    a = nd::groupby_reduce(data, by, "count");
+    EXPECT_EQ(ndt::make_type<int64_t>(), a.get_dtype());
+    EXPECT_EQ(2, a(0).as<int64_t>());
+    EXPECT_EQ(3, a(1).as<int64_t>());
+    EXPECT_EQ(1, a(2).as<int64_t>());
+
+    a = nd::groupby_reduce(data, by, "min");
+    EXPECT_EQ(2, a(0).as<int>());
+    EXPECT_EQ(1, a(1).as<int>());
+    EXPECT_EQ(6, a(2).as<int>());
+
+    a = nd::groupby_reduce(data, by, "max");
+    EXPECT_EQ(5, a(0).as<int>());
+    EXPECT_EQ(4, a(1).as<int>());
+    EXPECT_EQ(6, a(2).as<int>());
+
+    a = nd::groupby_reduce(data, by, "mean");
+    EXPECT_EQ(ndt::make_type<double>(), a.get_dtype());
+    EXPECT_EQ(3.5, a(0).as<double>());
+    EXPECT_EQ(8 / 3.0, a(1).as<double>());
+    EXPECT_EQ(6, a(2).as<double>());
+
+    EXPECT_THROW(nd::groupby_reduce(data, by, "median"), runtime_error);
+}
+
+TEST(ArrayGroupBy, ReduceEmptyGroups) {
+    double data[] = {1.5, -2, 3};
+    int by[] = {10, 30, 10};
+    int groups[] = {10, 20, 30};
+    ndt::type gt = ndt::make_categorical(groups);
+    nd::array a;
+
+    a = nd::groupby_reduce(data, by, "sum", gt);
+    EXPECT_EQ(4.5, a(0).as<double>());
+    EXPECT_EQ(0, a(1).as<double>());
+    EXPECT_EQ(-2, a(2).as<double>());
+
+    a = nd::groupby_reduce(data, by, "mean", gt);
+    EXPECT_EQ(2.25, a(0).as<double>());
+    EXPECT_TRUE(DYND_ISNAN(a(1).as<double>()));
+    EXPECT_EQ(-2, a(2).as<double>());
+
+    a = nd::groupby_reduce(data, by, "count", gt);
+    EXPECT_EQ(0, a(1).as<int64_t>());
+
+    // Min has no identity, so an empty group is an error
+    EXPECT_THROW(nd::groupby_reduce(data, by, "min", gt), runtime_error);
+}
+
+TEST(ArrayGroupBy, ReduceCKernelDeferred) {
+    // The int32 values are converted to float64 for the reduction
+    int data[] = {1, 2, 3, 4, 5};
+    int by[] = {0, 1, 0, 1, 1};
+    ckernel_deferred ckd;
+    kernels::make_builtin_reduction_ckernel_deferred(&ckd,
+                    kernels::builtin_reduction_prod, float64_type_id);
+    nd::array a = nd::groupby_reduce(data, by, ckd,
+                    kernels::make_builtin_reduction_identity(
+                        kernels::builtin_reduction_prod, float64_type_id));
+    EXPECT_EQ(ndt::make_type<double>(), a.get_dtype());
+    EXPECT_EQ(3, a(0).as<double>());
+    EXPECT_EQ(40, a(1).as<double>());
+
+    // Mismatched sizes
+    int by_short[] = {0, 1};
+    EXPECT_THROW(nd::groupby_reduce(data, by_short, ckd, nd::array()), runtime_error);
+}
+
+TEST(ArrayGroupBy, ReduceParallel) {
+    // Enough rows to be split across threads
+    const intptr_t count = 400000;
+    nd::array data = nd::empty(count, ndt::make_strided_dim(ndt::make_type<int64_t>()));
+    nd::array by = nd::empty(count, ndt::make_strided_dim(ndt::make_type<int32_t>()));
+    int64_t *data_ptr = reinterpret_cast<int64_t *>(data.get_readwrite_originptr());
+    int32_t *by_ptr = reinterpret_cast<int32_t *>(by.get_readwrite_originptr());
+    int64_t expected_sum[7] = {0, 0, 0, 0, 0, 0, 0};
+    int64_t expected_max[7] = {0, 0, 0, 0, 0, 0, 0};
+    for (intptr_t i = 0; i < count; ++i) {
+        data_ptr[i] = (i * 7919) % 1000;
+        by_ptr[i] = (int32_t)((i * 31) % 7);
+        expected_sum[by_ptr[i]] += data_ptr[i];
+        expected_max[by_ptr[i]] = max(expected_max[by_ptr[i]], data_ptr[i]);
+    }
+
+    eval::eval_context ectx;
+    ectx.thread_count = 4;
+    nd::array sum = nd::groupby_reduce(data, by, "sum", ndt::type(), &ectx);
+    nd::array mx = nd::groupby_reduce(data, by, "max", ndt::type(), &ectx);
+    nd::array cnt = nd::groupby_reduce(data, by, "count", ndt::type(), &ectx);
+    ASSERT_EQ(7, sum.get_dim_size());
+    int64_t total = 0;
+    for (int g = 0; g < 7; ++g) {
+        EXPECT_EQ(expected_sum[g], sum(g).as<int64_t>());
+        EXPECT_EQ(expected_max[g], mx(g).as<int64_t>());
+        total += cnt(g).as<int64_t>();
+    }
+    EXPECT_EQ(count, total);
+}
@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/array_search.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ArraySearch, BinarySearch) {
+    int32_t vals[] = {1, 3, 5, 7, 9};
+    nd::array a = vals;
+    for (int i = 0; i < 5; ++i) {
+        int32_t v = 2 * i + 1;
+        EXPECT_EQ(i, nd::binary_search(a, a(0).get_ndo_meta(), (const char *)&v));
+        v = 2 * i;
+        EXPECT_EQ(-1, nd::binary_search(a, a(0).get_ndo_meta(), (const char *)&v));
+    }
+
+    const char *str_vals[] = {"abc", "b", "bc", "x"};
+    nd::array s = str_vals;
+    nd::array needle = nd::array("bc").ucast(ndt::make_string()).eval();
+    EXPECT_EQ(2, nd::binary_search(s, needle.get_ndo_meta(), needle.get_readonly_originptr()));
+    needle = nd::array("bcd").ucast(ndt::make_string()).eval();
+    EXPECT_EQ(-1, nd::binary_search(s, needle.get_ndo_meta(), needle.get_readonly_originptr()));
+}
+
+TEST(ArraySearch, Bounds) {
+    double vals[] = {-1.5, 0.0, 0.0, 0.0, 2.5, numeric_limits<double>::quiet_NaN()};
+    nd::array a = vals;
+    nd::binary_searcher bs(a);
+    EXPECT_EQ(6, bs.get_size());
+    double v = 0.0;
+    EXPECT_EQ(1, bs.lower_bound((const char *)&v));
+    EXPECT_EQ(4, bs.upper_bound((const char *)&v));
+    EXPECT_EQ(1, bs.find((const char *)&v));
+    v = -0.0;
+    EXPECT_EQ(1, bs.lower_bound((const char *)&v));
+    EXPECT_EQ(4, bs.upper_bound((const char *)&v));
+    v = -10;
+    EXPECT_EQ(0, bs.lower_bound((const char *)&v));
+    EXPECT_EQ(0, bs.upper_bound((const char *)&v));
+    EXPECT_EQ(-1, bs.find((const char *)&v));
+    v = 10;
+    EXPECT_EQ(5, bs.lower_bound((const char *)&v));
+    EXPECT_EQ(5, bs.upper_bound((const char *)&v));
+    // NaN sorts at the end
+    v = numeric_limits<double>::quiet_NaN();
+    EXPECT_EQ(5, bs.lower_bound((const char *)&v));
+    EXPECT_EQ(6, bs.upper_bound((const char *)&v));
+    EXPECT_EQ(5, bs.find((const char *)&v));
+}
+
+TEST(ArraySearch, SearchSorted) {
+    int32_t vals[] = {10, 20, 20, 30};
+    nd::array a = vals;
+    nd::binary_searcher bs(a);
+
+    // The needles are converted to the element type
+    int64_t needles[2][3] = {{5, 10, 20}, {25, 30, 35}};
+    nd::array left = bs.searchsorted(needles);
+    ASSERT_EQ(ndt::make_strided_dim(ndt::make_type<intptr_t>(), 2), left.get_type());
+    EXPECT_EQ(0, left(0, 0).as<intptr_t>());
+    EXPECT_EQ(0, left(0, 1).as<intptr_t>());
+    EXPECT_EQ(1, left(0, 2).as<intptr_t>());
+    EXPECT_EQ(3, left(1, 0).as<intptr_t>());
+    EXPECT_EQ(3, left(1, 1).as<intptr_t>());
+    EXPECT_EQ(4, left(1, 2).as<intptr_t>());
+
+    nd::array right = bs.searchsorted(needles, nd::search_side_right);
+    EXPECT_EQ(0, right(0, 0).as<intptr_t>());
+    EXPECT_EQ(1, right(0, 1).as<intptr_t>());
+    EXPECT_EQ(3, right(0, 2).as<intptr_t>());
+    EXPECT_EQ(3, right(1, 0).as<intptr_t>());
+    EXPECT_EQ(4, right(1, 1).as<intptr_t>());
+    EXPECT_EQ(4, right(1, 2).as<intptr_t>());
+
+    // A scalar needle gives a scalar result
+    EXPECT_EQ(3, bs.searchsorted(25).as<intptr_t>());
+}
+
+TEST(ArraySearch, SearchSortedStrings) {
+    const char *vals[] = {"apple", "banana", "cherry"};
+    nd::array a = nd::array(vals).ucast(ndt::make_string()).eval();
+    nd::binary_searcher bs(a);
+
+    const char *needles[] = {"a", "banana", "bananas", "zebra"};
+    nd::array left = bs.searchsorted(needles);
+    EXPECT_EQ(0, left(0).as<intptr_t>());
+    EXPECT_EQ(1, left(1).as<intptr_t>());
+    EXPECT_EQ(2, left(2).as<intptr_t>());
+    EXPECT_EQ(3, left(3).as<intptr_t>());
+
+    nd::array right = bs.searchsorted(needles, nd::search_side_right);
+    EXPECT_EQ(2, right(1).as<intptr_t>());
+}
+
+TEST(ArraySearch, VarAndFixedDims) {
+    nd::array a = parse_json("var * int16", "[2, 4, 6, 8]");
+    nd::binary_searcher bs(a);
+    int16_t v = 6;
+    EXPECT_EQ(2, bs.find((const char *)&v));
+    v = 7;
+    EXPECT_EQ(-1, bs.find((const char *)&v));
+    EXPECT_EQ(3, bs.lower_bound((const char *)&v));
+
+    // A view of part of a var dimension
+    nd::array b = a(irange(1, 4));
+    nd::binary_searcher bs_b(b);
+    v = 4;
+    EXPECT_EQ(0, bs_b.find((const char *)&v));
+
+    nd::array c = parse_json("4 * float32", "[1.5, 2.5, 3.5, 4.5]");
+    nd::binary_searcher bs_c(c);
+    float f = 3.5f;
+    EXPECT_EQ(2, bs_c.find((const char *)&f));
+}
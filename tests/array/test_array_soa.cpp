@@ -0,0 +1,123 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/array_soa.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ArraySOA, MakeSOA) {
+    ndt::type tp = ndt::make_struct(ndt::make_type<int32_t>(), "x",
+                    ndt::make_type<double>(), "y");
+    EXPECT_EQ(ndt::make_struct(ndt::make_strided_dim(ndt::make_type<int32_t>()), "x",
+                    ndt::make_strided_dim(ndt::make_type<double>()), "y"),
+                    ndt::make_soa(tp));
+    EXPECT_THROW(ndt::make_soa(ndt::make_type<int>()), runtime_error);
+}
+
+TEST(ArraySOA, EmptySOA) {
+    ndt::type tp = ndt::make_cstruct(ndt::make_type<int8_t>(), "a",
+                    ndt::make_type<double>(), "b");
+    nd::array a = nd::empty_soa(10, tp);
+    EXPECT_EQ(ndt::make_soa(tp), a.get_type());
+    nd::array col_a = a.p("a"), col_b = a.p("b");
+    EXPECT_EQ(10, col_a.get_dim_size());
+    EXPECT_EQ(10, col_b.get_dim_size());
+    // Each column is contiguous and starts on a 64 byte boundary
+    EXPECT_EQ(1, reinterpret_cast<const strided_dim_type_metadata *>(col_a.get_ndo_meta())->stride);
+    EXPECT_EQ(8, reinterpret_cast<const strided_dim_type_metadata *>(col_b.get_ndo_meta())->stride);
+    EXPECT_EQ(0, (col_b.get_readonly_originptr() - col_a.get_readonly_originptr()) % 64);
+    EXPECT_LE(col_a.get_readonly_originptr() + 10, col_b.get_readonly_originptr());
+}
+
+TEST(ArraySOA, RoundTrip) {
+    // Enough records to span several blocks
+    const int count = 5000;
+    stringstream ss;
+    ss << "[";
+    for (int i = 0; i < count; ++i) {
+        ss << (i ? ", " : "") << "{\"x\": " << (i * 3 - 7) << ", \"y\": " << i << ".5, \"s\": \"s"
+           << (i % 13) << "\"}";
+    }
+    ss << "]";
+    stringstream tp_ss;
+    tp_ss << count << " * {x: int32, y: float64, s: string}";
+    nd::array aos = parse_json(ndt::type(tp_ss.str()), ss.str(), &eval::default_eval_context);
+
+    nd::array soa = nd::aos_to_soa(aos);
+    EXPECT_EQ(ndt::make_soa(aos.get_dtype()), soa.get_type());
+    nd::array x = soa.p("x");
+    ASSERT_EQ(count, x.get_dim_size());
+    EXPECT_EQ(4, reinterpret_cast<const strided_dim_type_metadata *>(x.get_ndo_meta())->stride);
+    const int32_t *x_ptr = reinterpret_cast<const int32_t *>(x.get_readonly_originptr());
+    for (int i = 0; i < count; ++i) {
+        ASSERT_EQ(i * 3 - 7, x_ptr[i]);
+    }
+    EXPECT_EQ(4999.5, soa.p("y")(count - 1).as<double>());
+    EXPECT_EQ("s7", soa.p("s")(20).as<string>());
+
+    // The default result records are a cstruct of the column types
+    nd::array back = nd::soa_to_aos(soa);
+    EXPECT_EQ(ndt::make_cstruct(ndt::make_type<int32_t>(), "x", ndt::make_type<double>(), "y",
+                    ndt::make_string(), "s"), back.get_dtype());
+    ASSERT_EQ(count, back.get_dim_size());
+    for (int i = 0; i < count; i += 97) {
+        EXPECT_EQ(i * 3 - 7, back(i, 0).as<int32_t>());
+        EXPECT_EQ(i + 0.5, back(i, 1).as<double>());
+        EXPECT_EQ(aos(i, 2).as<string>(), back(i, 2).as<string>());
+    }
+}
+
+TEST(ArraySOA, ReversedAOS) {
+    // A negative record stride, with enough records to span several blocks
+    const int count = 5000;
+    nd::array aos = nd::empty(count, ndt::make_strided_dim(ndt::make_cstruct(
+                    ndt::make_type<int32_t>(), "x", ndt::make_type<double>(), "y")));
+    for (int i = 0; i < count; ++i) {
+        aos(i, 0).vals() = i;
+        aos(i, 1).vals() = i + 0.5;
+    }
+    nd::array soa = nd::aos_to_soa(aos(irange().by(-1)));
+    for (int i = 0; i < count; i += 97) {
+        EXPECT_EQ(count - 1 - i, soa.p("x")(i).as<int32_t>());
+        EXPECT_EQ(count - 0.5 - i, soa.p("y")(i).as<double>());
+    }
+}
+
+TEST(ArraySOA, SOAToAOSConvert) {
+    nd::array soa = nd::empty_soa(3, ndt::make_struct(ndt::make_type<int16_t>(), "a",
+                    ndt::make_type<float>(), "b"));
+    soa.p("a").vals() = parse_json("3 * int16", "[1, 2, 3]");
+    soa.p("b").vals() = parse_json("3 * float32", "[0.5, 1.5, 2.5]");
+    // Fields are matched by name, and converted
+    nd::array aos = nd::soa_to_aos(soa, ndt::make_struct(ndt::make_type<double>(), "b",
+                    ndt::make_type<int64_t>(), "a"));
+    ASSERT_EQ(3, aos.get_dim_size());
+    EXPECT_EQ(0.5, aos(0, 0).as<double>());
+    EXPECT_EQ(1, aos(0, 1).as<int64_t>());
+    EXPECT_EQ(2.5, aos(2, 0).as<double>());
+    EXPECT_EQ(3, aos(2, 1).as<int64_t>());
+    EXPECT_THROW(nd::soa_to_aos(soa, ndt::make_struct(ndt::make_type<double>(), "b",
+                    ndt::make_type<int64_t>(), "c")), runtime_error);
+}
+
+TEST(ArraySOA, Errors) {
+    EXPECT_THROW(nd::aos_to_soa(parse_json("3 * int32", "[1, 2, 3]")), runtime_error);
+    EXPECT_THROW(nd::soa_to_aos(parse_json("3 * int32", "[1, 2, 3]")), runtime_error);
+    nd::array a = parse_json("{a: 2 * int32, b: 3 * int32}",
+                    "{\"a\": [1, 2], \"b\": [1, 2, 3]}");
+    EXPECT_THROW(nd::soa_to_aos(a), runtime_error);
+}
@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/array_sort.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(ArraySort, Int) {
+    int vals[] = {5, -3, 7, 5, 0, -3, 2};
+    nd::array a = vals;
+    nd::array s = nd::sort(a);
+    int expected[] = {-3, -3, 0, 2, 5, 5, 7};
+    ASSERT_EQ(7, s.get_dim_size());
+    EXPECT_EQ(ndt::make_type<int>(), s.get_dtype());
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(expected[i], s(i).as<int>());
+    }
+    // Equal values keep their order
+    nd::array idx = nd::argsort(a);
+    EXPECT_EQ(ndt::make_type<int64_t>(), idx.get_dtype());
+    int64_t expected_idx[] = {1, 5, 4, 6, 0, 3, 2};
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(expected_idx[i], idx(i).as<int64_t>());
+    }
+}
+
+TEST(ArraySort, Float) {
+    double vals[] = {3, numeric_limits<double>::quiet_NaN(), -1, -0.0, 0.0,
+                     -numeric_limits<double>::infinity()};
+    nd::array idx = nd::argsort(vals);
+    // NaN sorts last, and -0.0 equals 0.0
+    int64_t expected_idx[] = {5, 2, 3, 4, 0, 1};
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(expected_idx[i], idx(i).as<int64_t>());
+    }
+    float fvals[] = {2.5f, -7.25f, 1e-30f, -1e-30f};
+    nd::array s = nd::sort(fvals);
+    EXPECT_EQ(-7.25f, s(0).as<float>());
+    EXPECT_EQ(-1e-30f, s(1).as<float>());
+    EXPECT_EQ(1e-30f, s(2).as<float>());
+    EXPECT_EQ(2.5f, s(3).as<float>());
+}
+
+TEST(ArraySort, Axis) {
+    int vals[2][3] = {{3, 1, 2}, {0, 5, -1}};
+    nd::array a = vals;
+    nd::array s = nd::sort(a);
+    EXPECT_EQ(1, s(0, 0).as<int>());
+    EXPECT_EQ(2, s(0, 1).as<int>());
+    EXPECT_EQ(3, s(0, 2).as<int>());
+    EXPECT_EQ(-1, s(1, 0).as<int>());
+    EXPECT_EQ(0, s(1, 1).as<int>());
+    EXPECT_EQ(5, s(1, 2).as<int>());
+    s = nd::argsort(a, 0);
+    EXPECT_EQ(1, s(0, 0).as<int>());
+    EXPECT_EQ(0, s(0, 1).as<int>());
+    EXPECT_EQ(1, s(0, 2).as<int>());
+    EXPECT_EQ(0, s(1, 0).as<int>());
+    EXPECT_EQ(1, s(1, 1).as<int>());
+    EXPECT_EQ(0, s(1, 2).as<int>());
+    EXPECT_THROW(nd::sort(a, 2), axis_out_of_bounds);
+    EXPECT_THROW(nd::sort(nd::array(3)), runtime_error);
+}
+
+TEST(ArraySort, String) {
+    nd::array a = parse_json("5 * string",
+                    "[\"pear\", \"apple\", \"fig\", \"banana\", \"apple\"]");
+    nd::array s = nd::sort(a);
+    EXPECT_EQ("apple", s(0).as<string>());
+    EXPECT_EQ("apple", s(1).as<string>());
+    EXPECT_EQ("banana", s(2).as<string>());
+    EXPECT_EQ("fig", s(3).as<string>());
+    EXPECT_EQ("pear", s(4).as<string>());
+}
+
+TEST(ArraySort, DateAndStruct) {
+    nd::array a = parse_json("3 * date",
+                    "[\"2013-01-02\", \"1969-12-31\", \"2012-05-06\"]");
+    nd::array idx = nd::argsort(a);
+    EXPECT_EQ(1, idx(0).as<int64_t>());
+    EXPECT_EQ(2, idx(1).as<int64_t>());
+    EXPECT_EQ(0, idx(2).as<int64_t>());
+
+    // Sorts by the first field, then the second
+    a = parse_json("5 * {a: int16, b: float64}",
+                    "[{\"a\": 2, \"b\": 1.5}, {\"a\": 1, \"b\": 3}, {\"a\": 2, \"b\": -1},"
+                    " {\"a\": 1, \"b\": 2}, {\"a\": 2, \"b\": 1.5}]");
+    idx = nd::argsort(a);
+    int64_t expected_idx[] = {3, 1, 2, 0, 4};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(expected_idx[i], idx(i).as<int64_t>());
+    }
+    nd::array s = nd::sort(a);
+    EXPECT_EQ(1, s(0, 0).as<int>());
+    EXPECT_EQ(2, s(0, 1).as<double>());
+    EXPECT_EQ(2, s(4, 0).as<int>());
+    EXPECT_EQ(1.5, s(4, 1).as<double>());
+}
+
+TEST(ArraySort, ParallelComparison) {
+    // Complex values sort with the comparison kernel, split across threads
+    const intptr_t count = 300007;
+    nd::array a = nd::empty(count, ndt::make_strided_dim(ndt::make_type<dynd_complex<double> >()));
+    dynd_complex<double> *ptr = reinterpret_cast<dynd_complex<double> *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < count; ++i) {
+        ptr[i] = dynd_complex<double>((double)((i * 7919) % 1009), (double)(i % 3));
+    }
+    eval::eval_context ectx;
+    ectx.thread_count = 4;
+    nd::array idx = nd::argsort(a, -1, &ectx);
+    const int64_t *idx_ptr = reinterpret_cast<const int64_t *>(idx.get_readonly_originptr());
+    for (intptr_t i = 1; i < count; ++i) {
+        const dynd_complex<double>& x = ptr[idx_ptr[i - 1]], &y = ptr[idx_ptr[i]];
+        ASSERT_TRUE(x.real() < y.real() || (x.real() == y.real() &&
+                        (x.imag() < y.imag() || (x.imag() == y.imag() && idx_ptr[i - 1] < idx_ptr[i]))));
+    }
+}
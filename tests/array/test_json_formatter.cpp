@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 
 #include "inc_gtest.hpp"
 
@@ -91,3 +92,54 @@ TEST(JSONFormatter, UniformDim) {
     EXPECT_EQ("[\"testing\",\"one\",\"two\"]", format_json(n).as<string>());
 }
 
+
+TEST(JSONFormatter, Numbers) {
+    nd::array n;
+    // Floats use the shortest text which parses back to the same value
+    n = 0.1;
+    EXPECT_EQ("0.1", format_json(n).as<string>());
+    n = 1.0 / 3;
+    EXPECT_EQ("0.3333333333333333", format_json(n).as<string>());
+    n = 0.1f;
+    EXPECT_EQ("0.1", format_json(n).as<string>());
+    int64_t vals[] = {0, -1, 9223372036854775807LL, -9223372036854775807LL - 1};
+    n = vals;
+    EXPECT_EQ("[0,-1,9223372036854775807,-9223372036854775808]", format_json(n).as<string>());
+    n = (uint64_t)18446744073709551615ULL;
+    EXPECT_EQ("18446744073709551615", format_json(n).as<string>());
+}
+
+TEST(JSONFormatter, StructKeys) {
+    ndt::type field_types[2] = {ndt::make_type<int32_t>(), ndt::make_string()};
+    string field_names[2] = {"a\"b", "c/d\n"};
+    nd::array n = nd::make_strided_array(2, ndt::make_cstruct(2, field_types, field_names));
+    n(0, 0).vals() = 1;
+    n(0, 1).vals() = "x\ty";
+    n(1, 0).vals() = -2;
+    n(1, 1).vals() = "";
+    EXPECT_EQ("[{\"a\\\"b\":1,\"c\\/d\\n\":\"x\\ty\"},"
+              "{\"a\\\"b\":-2,\"c\\/d\\n\":\"\"}]",
+              format_json(n).as<string>());
+}
+
+TEST(JSONFormatter, FileDescriptor) {
+    nd::array n = parse_json("var * {a : int32, b : string}",
+                    "[{\"a\":1, \"b\":\"one\"}, {\"a\":2, \"b\":\"a longer string than the buffer\"},"
+                    " {\"a\":3, \"b\":\"three\"}]");
+    string expected = format_json(n).as<string>();
+
+    FILE *f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    // A tiny buffer so the output is flushed many times
+    format_json(fileno(f), n, 16);
+    fflush(f);
+    rewind(f);
+    string written;
+    char buf[256];
+    size_t count;
+    while ((count = fread(buf, 1, sizeof(buf), f)) > 0) {
+        written.append(buf, count);
+    }
+    fclose(f);
+    EXPECT_EQ(expected, written);
+}
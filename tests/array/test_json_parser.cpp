@@ -5,8 +5,10 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include "inc_gtest.hpp"
 
@@ -263,6 +265,37 @@ TEST(JSONParser, ListOfStruct) {
                     runtime_error);
 }
 
+TEST(JSONParser, StructFieldNames) {
+    ndt::type field_types[4] = {ndt::make_type<int32_t>(), ndt::make_type<int32_t>(),
+                    ndt::make_string(), ndt::make_type<int32_t>()};
+    string field_names[4] = {"a", "bb", "ccc", "d\"q"};
+    ndt::type sdt = ndt::make_cstruct(4, field_types, field_names);
+    nd::array n;
+
+    // In declared order, out of order, and with a field to skip
+    n = parse_json(sdt, "{\"a\":1, \"bb\":2, \"ccc\":\"x\", \"d\\\"q\":4}");
+    EXPECT_EQ(1, n(0).as<int>());
+    EXPECT_EQ(2, n(1).as<int>());
+    EXPECT_EQ("x", n(2).as<string>());
+    EXPECT_EQ(4, n(3).as<int>());
+    n = parse_json(sdt, "{\"d\\\"q\":8, \"ccc\":\"y\", \"extra\":[1, {\"a\":3}], \"bb\":6, \"a\":5}");
+    EXPECT_EQ(5, n(0).as<int>());
+    EXPECT_EQ(6, n(1).as<int>());
+    EXPECT_EQ("y", n(2).as<string>());
+    EXPECT_EQ(8, n(3).as<int>());
+
+    // Escaped names match the unescaped field name
+    n = parse_json(sdt, "{\"\\u0061\":1, \"b\\u0062\":2, \"ccc\":\"z\", \"d\\u0022q\":3}");
+    EXPECT_EQ(1, n(0).as<int>());
+    EXPECT_EQ(2, n(1).as<int>());
+    EXPECT_EQ(3, n(3).as<int>());
+
+    // Prefixes of field names don't match
+    EXPECT_THROW(parse_json(sdt, "{\"a\":1, \"b\":2, \"ccc\":\"x\", \"d\\\"q\":4}"), runtime_error);
+    EXPECT_THROW(parse_json(sdt, "{\"a\":1, \"bb\":2, \"ccc\":\"x\", \"d\\\"q\":4"), runtime_error);
+    EXPECT_THROW(parse_json(sdt, "{\"a\":1, \"bb\":2, \"ccc\":\"x\", \"d\\\"q"), runtime_error);
+}
+
 TEST(JSONParser, JSONDType) {
     nd::array n;
 
@@ -280,3 +313,175 @@ TEST(JSONParser, JSONDType) {
     EXPECT_EQ(12, n(1).as<int>());
     EXPECT_EQ("testing string", n(2).as<string>());
 }
+
+namespace {
+    // Collects the records of each batch as "id:name" strings
+    struct collected_batches {
+        vector<intptr_t> sizes;
+        vector<string> records;
+    };
+
+    void collect_batch(const nd::array& batch, void *callback_data)
+    {
+        collected_batches *c = reinterpret_cast<collected_batches *>(callback_data);
+        intptr_t size = batch.get_dim_size();
+        c->sizes.push_back(size);
+        for (intptr_t i = 0; i < size; ++i) {
+            stringstream ss;
+            ss << batch(i, 0).as<int>() << ":" << batch(i, 1).as<string>();
+            c->records.push_back(ss.str());
+        }
+    }
+} // anonymous namespace
+
+TEST(JSONParser, StreamLines) {
+    ndt::type sdt = ndt::make_cstruct(ndt::make_type<int>(), "id", ndt::make_string(), "name");
+    string json = "{\"id\":1, \"name\":\"a\"}\n"
+                  "\n"
+                  "{\"name\":\"b\\nc\", \"id\":2}\n"
+                  "{\"id\":3, \"name\":\"[,]\"}\n"
+                  "{\"id\":4, \"name\":\"dddd\"}\n"
+                  "{\"id\":5, \"name\":\"e\"}";
+
+    // Every way of splitting the input into two chunks gives the same result
+    for (size_t split = 0; split <= json.size(); ++split) {
+        collected_batches c;
+        json_stream_parser p(sdt, 2, &collect_batch, &c);
+        p.feed(json.substr(0, split));
+        p.feed(json.substr(split));
+        p.finish();
+        EXPECT_EQ(5, p.get_record_count());
+        ASSERT_EQ(3u, c.sizes.size());
+        EXPECT_EQ(2, c.sizes[0]);
+        EXPECT_EQ(2, c.sizes[1]);
+        EXPECT_EQ(1, c.sizes[2]);
+        ASSERT_EQ(5u, c.records.size());
+        EXPECT_EQ("1:a", c.records[0]);
+        EXPECT_EQ("2:b\nc", c.records[1]);
+        EXPECT_EQ("3:[,]", c.records[2]);
+        EXPECT_EQ("4:dddd", c.records[3]);
+        EXPECT_EQ("5:e", c.records[4]);
+    }
+}
+
+TEST(JSONParser, StreamArray) {
+    ndt::type sdt = ndt::make_cstruct(ndt::make_type<int>(), "id", ndt::make_string(), "name");
+    string json = " [ {\"id\":1, \"name\":\"a\\\"]\"},\n"
+                  "{\"id\":2, \"name\":\"b\", \"extra\":[1, {\"x\":2}]} ,"
+                  "{\"id\":3, \"name\":\"c\"} ] ";
+
+    // Feed it a byte at a time
+    collected_batches c;
+    json_stream_parser p(sdt, 2, &collect_batch, &c, json_stream_array);
+    for (size_t i = 0; i < json.size(); ++i) {
+        p.feed(json.data() + i, json.data() + i + 1);
+    }
+    p.finish();
+    ASSERT_EQ(2u, c.sizes.size());
+    ASSERT_EQ(3u, c.records.size());
+    EXPECT_EQ("1:a\"]", c.records[0]);
+    EXPECT_EQ("2:b", c.records[1]);
+    EXPECT_EQ("3:c", c.records[2]);
+
+    // An empty array produces no batches
+    collected_batches c_empty;
+    json_stream_parser p_empty(sdt, 2, &collect_batch, &c_empty, json_stream_array);
+    p_empty.feed(string("[ ]"));
+    p_empty.finish();
+    EXPECT_EQ(0u, c_empty.sizes.size());
+}
+
+TEST(JSONParser, StreamErrors) {
+    ndt::type sdt = ndt::make_cstruct(ndt::make_type<int>(), "id", ndt::make_string(), "name");
+    collected_batches c;
+
+    json_stream_parser p_bad(sdt, 4, &collect_batch, &c);
+    EXPECT_THROW(p_bad.feed(string("{\"id\":1, \"name\":\"a\"}\n{\"id\":\"x\", \"name\":\"b\"}\n")),
+                    runtime_error);
+
+    json_stream_parser p_unterminated(sdt, 4, &collect_batch, &c, json_stream_array);
+    p_unterminated.feed(string("[{\"id\":1, \"name\":\"a\"}"));
+    EXPECT_THROW(p_unterminated.finish(), runtime_error);
+
+    json_stream_parser p_trailing_comma(sdt, 4, &collect_batch, &c, json_stream_array);
+    EXPECT_THROW(p_trailing_comma.feed(string("[{\"id\":1, \"name\":\"a\"}, ]")), runtime_error);
+
+    json_stream_parser p_not_array(sdt, 4, &collect_batch, &c, json_stream_array);
+    EXPECT_THROW(p_not_array.feed(string("{\"id\":1, \"name\":\"a\"}")), runtime_error);
+}
+
+static string make_parallel_json_input(intptr_t count)
+{
+    stringstream ss;
+    ss << "[";
+    for (intptr_t i = 0; i < count; ++i) {
+        if (i != 0) {
+            ss << ",\n";
+        }
+        // Strings containing structural characters and escapes
+        ss << "{\"id\": " << i << ", \"name\": \"n[" << i << "],{\\\"\\\\\", \"vals\": [" << i << ", " << -i << "]}";
+    }
+    ss << " ]";
+    return ss.str();
+}
+
+TEST(JSONParser, ParallelVarDim) {
+    eval::eval_context ectx;
+    ectx.thread_count = 4;
+    ndt::type tp = ndt::type("var * {id : int64, name : string, vals : 2 * int32}");
+    string json = make_parallel_json_input(1000);
+
+    nd::array a = nd::empty(tp);
+    parse_json_parallel(a, json.data(), json.data() + json.size(), &ectx);
+    nd::array b = parse_json(tp, json, &eval::default_eval_context);
+    ASSERT_EQ(1000, a.get_dim_size());
+    for (intptr_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(b(i, 0).as<int64_t>(), a(i, 0).as<int64_t>());
+        EXPECT_EQ(b(i, 1).as<string>(), a(i, 1).as<string>());
+        EXPECT_EQ(b(i, 2, 1).as<int32_t>(), a(i, 2, 1).as<int32_t>());
+    }
+    EXPECT_EQ(999, a(999, 0).as<int64_t>());
+    EXPECT_EQ("n[999],{\"\\", a(999, 1).as<string>());
+    EXPECT_EQ(-999, a(999, 2, 1).as<int32_t>());
+
+    // A POD element type is parsed in place
+    nd::array c = nd::empty("var * int32");
+    string ints = "[1, 2, 3, 4, 5, 6, 7]";
+    parse_json_parallel(c, ints.data(), ints.data() + ints.size(), &ectx);
+    ASSERT_EQ(7, c.get_dim_size());
+    EXPECT_EQ(7, c(6).as<int32_t>());
+
+    nd::array d = nd::empty("var * int32");
+    string empty_list = " [ ] ";
+    parse_json_parallel(d, empty_list.data(), empty_list.data() + empty_list.size(), &ectx);
+    EXPECT_EQ(0, d.get_dim_size());
+}
+
+TEST(JSONParser, ParallelFixedDim) {
+    eval::eval_context ectx;
+    ectx.thread_count = 3;
+    string json = "[[1, 2], [3, 4], [5, 6], [7, 8]]";
+    nd::array a = nd::empty("4 * 2 * float64");
+    parse_json_parallel(a, json.data(), json.data() + json.size(), &ectx);
+    EXPECT_EQ(8, a(3, 1).as<double>());
+
+    nd::array b = nd::empty("3 * 2 * float64");
+    EXPECT_THROW(parse_json_parallel(b, json.data(), json.data() + json.size(), &ectx),
+                    runtime_error);
+    nd::array c = nd::empty("5 * 2 * float64");
+    EXPECT_THROW(parse_json_parallel(c, json.data(), json.data() + json.size(), &ectx),
+                    runtime_error);
+}
+
+TEST(JSONParser, ParallelErrors) {
+    eval::eval_context ectx;
+    ectx.thread_count = 4;
+    const char *bad_inputs[] = {"[1, 2,]", "[1,, 2]", "[1, 2", "[1, 2}", "{\"a\": 1}",
+                    "[1, 2] 3", "[1, \"x\"]", "[1 2]", "[\"abc]"};
+    for (size_t i = 0; i < sizeof(bad_inputs) / sizeof(bad_inputs[0]); ++i) {
+        nd::array a = nd::empty("var * int32");
+        const char *json = bad_inputs[i];
+        EXPECT_THROW(parse_json_parallel(a, json, json + strlen(json), &ectx),
+                        runtime_error) << json;
+    }
+}
@@ -7,6 +7,8 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
+#include <vector>
+#include <limits>
 
 #include "inc_gtest.hpp"
 
@@ -610,3 +612,473 @@ TEST(Reduction, BuiltinSum_Lift3D_StridedStridedStrided_ReduceBroadcastReduce) {
     EXPECT_EQ(7.f - 0.5f + 2.125f + 0.25f,
               b(2).as<float>());
 }
+
+TEST(Reduction, BuiltinSum_Lift1D_Parallel) {
+    // Start with a float64 reduction ckernel_deferred
+    nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+    kernels::make_builtin_sum_reduction_ckernel_deferred(
+                    reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                    float64_type_id);
+
+    // Lift it to a one-dimensional strided float64 reduction ckernel_deferred.
+    // Each thread starts its accumulator from the identity, so it must
+    // be a true identity here.
+    ckernel_deferred ckd;
+    bool reduction_dimflags[1] = {true};
+    lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                    ndt::type("strided * float64"), nd::array(), false,
+                    1, reduction_dimflags, true, true, false, nd::array(0.));
+
+    // Enough data that it gets split across the threads, with integer
+    // values so the sum is exact regardless of the order
+    intptr_t size = 1000003;
+    nd::array a = nd::empty(size, ndt::type("strided * float64"));
+    double *a_data = reinterpret_cast<double *>(a.get_readwrite_originptr());
+    double expected = 0.;
+    for (intptr_t i = 0; i < size; ++i) {
+        a_data[i] = (double)(i % 7) - 2;
+        expected += a_data[i];
+    }
+    nd::array b = nd::empty(ndt::make_type<double>());
+
+    eval::eval_context ectx;
+    ectx.thread_count = 4;
+    assignment_ckernel_builder ckb;
+    const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &ectx);
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(expected, b.as<double>());
+
+    // Also reduce a reversed view, so the src stride is negative
+    ckb.reset();
+    a = a(irange().by(-1));
+    dynd_metadata[1] = a.get_ndo_meta();
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &ectx);
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(expected, b.as<double>());
+}
+
+TEST(Reduction, BuiltinSum_Lift2D_StridedStrided_ReduceReduce_KeepDim_Parallel) {
+    // Start with an int64 reduction ckernel_deferred
+    nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+    kernels::make_builtin_sum_reduction_ckernel_deferred(
+                    reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                    int64_type_id);
+
+    // Lift it to a two-dimensional strided int64 reduction ckernel_deferred
+    ckernel_deferred ckd;
+    bool reduction_dimflags[2] = {true, true};
+    lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                    ndt::type("strided * strided * int64"), nd::array(), true,
+                    2, reduction_dimflags, true, true, false, nd::array());
+
+    intptr_t rows = 1001, cols = 513;
+    nd::array a = nd::empty(rows, cols, ndt::type("strided * strided * int64"));
+    int64_t *a_data = reinterpret_cast<int64_t *>(a.get_readwrite_originptr());
+    int64_t expected = 0;
+    for (intptr_t i = 0; i < rows * cols; ++i) {
+        a_data[i] = i * 3 - 17;
+        expected += a_data[i];
+    }
+    nd::array b = nd::empty(1, 1, ndt::type("strided * strided * int64"));
+    ASSERT_EQ(ckd.data_dynd_types[0], b.get_type());
+
+    eval::eval_context ectx;
+    ectx.thread_count = 3;
+    assignment_ckernel_builder ckb;
+    const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &ectx);
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(expected, b(0, 0).as<int64_t>());
+}
+
+TEST(Reduction, BuiltinReduction_Kernel_Contiguous) {
+    assignment_strided_ckernel_builder ckb;
+    // Sizes which exercise the unrolled loops and their tails
+    const size_t count = 1037;
+
+    vector<double> f64(count);
+    vector<float> f32(count);
+    vector<int32_t> i32(count);
+    vector<uint32_t> u32(count);
+    vector<int64_t> i64(count);
+    for (size_t i = 0; i < count; ++i) {
+        f64[i] = (double)((int)(i * 7919 % 1001) - 500) * 0.25;
+        f32[i] = (float)f64[i];
+        i32[i] = (int32_t)(i * 2654435761u);
+        u32[i] = (uint32_t)(i * 2654435761u);
+        i64[i] = (int64_t)i * 3000000000LL - 1000;
+    }
+    double ef64 = 0, emin64 = f64[0], emax64 = f64[0];
+    int32_t ei32 = 0, emini32 = i32[0], emaxi32 = i32[0];
+    uint32_t eu32 = 0, eminu32 = u32[0];
+    int64_t ei64 = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ef64 += f64[i];
+        emin64 = min(emin64, f64[i]);
+        emax64 = max(emax64, f64[i]);
+        ei32 = (int32_t)((uint32_t)ei32 + (uint32_t)i32[i]);
+        emini32 = min(emini32, i32[i]);
+        emaxi32 = max(emaxi32, i32[i]);
+        eu32 += u32[i];
+        eminu32 = min(eminu32, u32[i]);
+        ei64 += i64[i];
+    }
+
+    // sum
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    float64_type_id, kernel_request_strided);
+    double sf64 = 1;
+    ckb((char *)&sf64, 0, (const char *)&f64[0], sizeof(double), count);
+    EXPECT_EQ(1 + ef64, sf64);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    float32_type_id, kernel_request_strided);
+    float sf32 = 1;
+    ckb((char *)&sf32, 0, (const char *)&f32[0], sizeof(float), count);
+    EXPECT_EQ((float)(1 + ef64), sf32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    int32_type_id, kernel_request_strided);
+    int32_t si32 = 0;
+    ckb((char *)&si32, 0, (const char *)&i32[0], sizeof(int32_t), count);
+    EXPECT_EQ(ei32, si32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    uint32_type_id, kernel_request_strided);
+    uint32_t su32 = 0;
+    ckb((char *)&su32, 0, (const char *)&u32[0], sizeof(uint32_t), count);
+    EXPECT_EQ(eu32, su32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    int64_type_id, kernel_request_strided);
+    int64_t si64 = 0;
+    ckb((char *)&si64, 0, (const char *)&i64[0], sizeof(int64_t), count);
+    EXPECT_EQ(ei64, si64);
+
+    // min/max, starting from the first element since there's no identity
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_min,
+                    float64_type_id, kernel_request_strided);
+    double mf64 = f64[0];
+    ckb((char *)&mf64, 0, (const char *)&f64[1], sizeof(double), count - 1);
+    EXPECT_EQ(emin64, mf64);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_max,
+                    float32_type_id, kernel_request_strided);
+    float mf32 = f32[0];
+    ckb((char *)&mf32, 0, (const char *)&f32[1], sizeof(float), count - 1);
+    EXPECT_EQ((float)emax64, mf32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_min,
+                    int32_type_id, kernel_request_strided);
+    int32_t mi32 = i32[0];
+    ckb((char *)&mi32, 0, (const char *)&i32[1], sizeof(int32_t), count - 1);
+    EXPECT_EQ(emini32, mi32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_max,
+                    int32_type_id, kernel_request_strided);
+    mi32 = i32[0];
+    ckb((char *)&mi32, 0, (const char *)&i32[1], sizeof(int32_t), count - 1);
+    EXPECT_EQ(emaxi32, mi32);
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_min,
+                    uint32_type_id, kernel_request_strided);
+    uint32_t mu32 = u32[0];
+    ckb((char *)&mu32, 0, (const char *)&u32[1], sizeof(uint32_t), count - 1);
+    EXPECT_EQ(eminu32, mu32);
+
+    // A NaN anywhere, in the vectorized part or the tail, propagates
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_max,
+                    float64_type_id, kernel_request_strided);
+    size_t nan_positions[3] = {0, count / 2, count - 1};
+    for (int k = 0; k < 3; ++k) {
+        vector<double> nan_f64(f64);
+        nan_f64[nan_positions[k]] = numeric_limits<double>::quiet_NaN();
+        mf64 = -1000;
+        ckb((char *)&mf64, 0, (const char *)&nan_f64[0], sizeof(double), count);
+        EXPECT_TRUE(mf64 != mf64);
+    }
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_min,
+                    float32_type_id, kernel_request_strided);
+    for (int k = 0; k < 3; ++k) {
+        vector<float> nan_f32(f32);
+        nan_f32[nan_positions[k]] = numeric_limits<float>::quiet_NaN();
+        mf32 = 1000;
+        ckb((char *)&mf32, 0, (const char *)&nan_f32[0], sizeof(float), count);
+        EXPECT_TRUE(mf32 != mf32);
+    }
+}
+
+TEST(Reduction, BuiltinReduction_Kernel_Nonzero) {
+    assignment_strided_ckernel_builder ckb;
+    // Large enough that the per-byte counters must be flushed
+    const size_t count = 70001;
+    vector<int8_t> a(count, 0);
+    int64_t expected = 0;
+    for (size_t i = 0; i < count; i += 3) {
+        a[i] = (int8_t)(i % 256);
+        if (a[i] != 0) {
+            ++expected;
+        }
+    }
+
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_count_nonzero,
+                    int8_type_id, kernel_request_strided);
+    int64_t c = 5;
+    ckb((char *)&c, 0, (const char *)&a[0], 1, count);
+    EXPECT_EQ(5 + expected, c);
+    // A strided source goes through the generic loop
+    c = 0;
+    ckb((char *)&c, 0, (const char *)&a[0], 3, (count + 2) / 3);
+    EXPECT_EQ(expected, c);
+
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_any,
+                    int8_type_id, kernel_request_strided);
+    dynd_bool r = false;
+    ckb((char *)&r, 0, (const char *)&a[1], 1, 2);
+    EXPECT_FALSE(r);
+    ckb((char *)&r, 0, (const char *)&a[0], 1, count);
+    EXPECT_TRUE(r);
+    vector<int8_t> zeros(count, 0);
+    zeros[count - 1] = 1;
+    r = false;
+    ckb((char *)&r, 0, (const char *)&zeros[0], 1, count - 1);
+    EXPECT_FALSE(r);
+    ckb((char *)&r, 0, (const char *)&zeros[0], 1, count);
+    EXPECT_TRUE(r);
+
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_all,
+                    int8_type_id, kernel_request_strided);
+    vector<int8_t> ones(count, -1);
+    r = true;
+    ckb((char *)&r, 0, (const char *)&ones[0], 1, count);
+    EXPECT_TRUE(r);
+    ones[100] = 0;
+    ckb((char *)&r, 0, (const char *)&ones[0], 1, count);
+    EXPECT_FALSE(r);
+
+    // count_nonzero treats negative zero as zero
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_count_nonzero,
+                    float64_type_id, kernel_request_strided);
+    double f64[4] = {0.0, -0.0, 1.5, numeric_limits<double>::quiet_NaN()};
+    c = 0;
+    ckb((char *)&c, 0, (const char *)&f64[0], sizeof(double), 4);
+    EXPECT_EQ(2, c);
+}
+
+TEST(Reduction, BuiltinReduction_Kernel_OtherTypes) {
+    assignment_ckernel_builder ckb;
+
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_prod,
+                    int16_type_id, kernel_request_single);
+    int16_t p16 = 3, a16 = -7;
+    ckb((char *)&p16, (const char *)&a16);
+    EXPECT_EQ(-21, p16);
+
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    int128_type_id, kernel_request_single);
+    dynd_int128 s128(0x1ULL, 0xffffffffffffffffULL), a128 = 1;
+    ckb((char *)&s128, (const char *)&a128);
+    EXPECT_EQ(dynd_int128(0x2ULL, 0ULL), s128);
+
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_max,
+                    float16_type_id, kernel_request_single);
+    dynd_float16 m16(1.5f), af16(2.25f);
+    ckb((char *)&m16, (const char *)&af16);
+    EXPECT_EQ(2.25f, (float)m16);
+
+    ckb.reset();
+    kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_all,
+                    complex_float64_type_id, kernel_request_single);
+    dynd_bool r = true;
+    dynd_complex<double> c(0, 1);
+    ckb((char *)&r, (const char *)&c);
+    EXPECT_TRUE(r);
+    c = 0;
+    ckb((char *)&r, (const char *)&c);
+    EXPECT_FALSE(r);
+
+    // Operations which aren't defined for a type raise an error
+    ckb.reset();
+    EXPECT_THROW(kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_sum,
+                    bool_type_id, kernel_request_single), type_error);
+    EXPECT_THROW(kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_prod,
+                    int128_type_id, kernel_request_single), type_error);
+    EXPECT_THROW(kernels::make_builtin_reduction_ckernel(&ckb, 0, kernels::builtin_reduction_min,
+                    complex_float32_type_id, kernel_request_single), type_error);
+}
+
+TEST(Reduction, BuiltinCountNonzero_Lift1D_WithIdentity) {
+    nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+    kernels::make_builtin_reduction_ckernel_deferred(
+                    reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                    kernels::builtin_reduction_count_nonzero, int32_type_id);
+
+    ckernel_deferred ckd;
+    bool reduction_dimflags[1] = {true};
+    lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                    ndt::type("strided * int32"), nd::array(), false,
+                    1, reduction_dimflags, true, true, false,
+                    kernels::make_builtin_reduction_identity(
+                        kernels::builtin_reduction_count_nonzero, int32_type_id));
+
+    int32_t vals0[6] = {3, 0, -1, 0, 0, 12};
+    nd::array a = vals0;
+    ASSERT_EQ(ckd.data_dynd_types[1], a.get_type());
+    nd::array b = nd::empty(ndt::make_type<int64_t>());
+    ASSERT_EQ(ckd.data_dynd_types[0], b.get_type());
+
+    assignment_ckernel_builder ckb;
+    const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &eval::default_eval_context);
+
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(3, b.as<int64_t>());
+}
+
+TEST(Reduction, BuiltinMin_Lift1D_NoIdentity) {
+    nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+    kernels::make_builtin_reduction_ckernel_deferred(
+                    reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                    kernels::builtin_reduction_min, float64_type_id);
+
+    ckernel_deferred ckd;
+    bool reduction_dimflags[1] = {true};
+    lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                    ndt::type("strided * float64"), nd::array(), false,
+                    1, reduction_dimflags, true, true, false, nd::array());
+
+    double vals0[5] = {1.5, -22., 3.75, 1.125, -3.375};
+    nd::array a = vals0;
+    nd::array b = nd::empty(ndt::make_type<double>());
+
+    assignment_ckernel_builder ckb;
+    const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &eval::default_eval_context);
+
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(-22., b.as<double>());
+}
+
+TEST(Reduction, BuiltinSum_Kernel_Algorithms) {
+    assignment_strided_ckernel_builder ckb;
+    const size_t count = 1000000;
+    vector<double> a(count, 0.1);
+
+    // Pairwise summation keeps the error growth logarithmic
+    kernels::make_builtin_sum_reduction_ckernel(&ckb, 0, float64_type_id,
+                    kernel_request_strided, kernels::sum_algorithm_pairwise);
+    double s = 0;
+    ckb((char *)&s, 0, (const char *)&a[0], sizeof(double), count);
+    EXPECT_NEAR(100000.0, s, 1e-8);
+
+    // Compensated summation recovers the small values between two
+    // large values which cancel
+    ckb.reset();
+    kernels::make_builtin_sum_reduction_ckernel(&ckb, 0, float64_type_id,
+                    kernel_request_strided, kernels::sum_algorithm_kahan);
+    s = 0;
+    ckb((char *)&s, 0, (const char *)&a[0], sizeof(double), count);
+    EXPECT_NEAR(100000.0, s, 1e-9);
+    double b[4] = {1.0, 1e100, 1.0, -1e100};
+    s = 0;
+    ckb((char *)&s, 0, (const char *)&b[0], sizeof(double), 4);
+    EXPECT_EQ(2.0, s);
+
+    ckb.reset();
+    kernels::make_builtin_sum_reduction_ckernel(&ckb, 0, complex_float64_type_id,
+                    kernel_request_strided, kernels::sum_algorithm_kahan);
+    dynd_complex<double> c[4] = {dynd_complex<double>(1.0, 1e100), dynd_complex<double>(1e100, 1.0),
+                                 dynd_complex<double>(1.0, -1e100), dynd_complex<double>(-1e100, 1.0)};
+    dynd_complex<double> sc = 0;
+    ckb((char *)&sc, 0, (const char *)&c[0], sizeof(dynd_complex<double>), 4);
+    EXPECT_EQ(dynd_complex<double>(2.0, 2.0), sc);
+
+    // Integer sums are exact with any algorithm
+    ckb.reset();
+    kernels::make_builtin_sum_reduction_ckernel(&ckb, 0, int32_type_id,
+                    kernel_request_strided, kernels::sum_algorithm_pairwise);
+    int32_t i32[3] = {1, -2, 12}, si32 = 0;
+    ckb((char *)&si32, 0, (const char *)&i32[0], sizeof(int32_t), 3);
+    EXPECT_EQ(11, si32);
+}
+
+TEST(Reduction, BuiltinSum_Lift1D_Kahan) {
+    nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+    kernels::make_builtin_sum_reduction_ckernel_deferred(
+                    reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                    float64_type_id, kernels::sum_algorithm_kahan);
+
+    ckernel_deferred ckd;
+    bool reduction_dimflags[1] = {true};
+    lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                    ndt::type("strided * float64"), nd::array(), false,
+                    1, reduction_dimflags, true, true, false, nd::array(0.));
+
+    double vals0[6] = {1.0, 1e100, 1.0, -1e100, 0.5, 0.25};
+    nd::array a = vals0;
+    nd::array b = nd::empty(ndt::make_type<double>());
+
+    assignment_ckernel_builder ckb;
+    const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &eval::default_eval_context);
+
+    ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    EXPECT_EQ(2.75, b.as<double>());
+}
+
+namespace {
+    double kahan_sum_1d(const nd::array& a) {
+        nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+        kernels::make_builtin_sum_reduction_ckernel_deferred(
+                        reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                        float64_type_id, kernels::sum_algorithm_kahan);
+
+        ckernel_deferred ckd;
+        bool reduction_dimflags[1] = {true};
+        lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                        ndt::type("strided * float64"), nd::array(), false,
+                        1, reduction_dimflags, true, true, false, nd::array(0.));
+
+        nd::array b = nd::empty(ndt::make_type<double>());
+        assignment_ckernel_builder ckb;
+        const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+        ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                             kernel_request_single, &eval::default_eval_context);
+        ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+        return b.as<double>();
+    }
+} // anonymous namespace
+
+TEST(Reduction, BuiltinSum_Lift1D_Kahan_Inf) {
+    double inf = numeric_limits<double>::infinity();
+    double vals0[4] = {1.0, inf, 0.5, 2.0};
+    EXPECT_EQ(inf, kahan_sum_1d(vals0));
+    double vals1[4] = {1.0, -inf, 0.5, 2.0};
+    EXPECT_EQ(-inf, kahan_sum_1d(vals1));
+}
+
+TEST(Reduction, BuiltinSum_Lift1D_Kahan_Overflow) {
+    double big = numeric_limits<double>::max();
+    double vals0[4] = {big, big, 1.0, 1.0};
+    EXPECT_EQ(numeric_limits<double>::infinity(), kahan_sum_1d(vals0));
+}
+
+TEST(Reduction, BuiltinSum_Lift1D_Kahan_NaN) {
+    double vals0[4] = {1.0, numeric_limits<double>::quiet_NaN(), 0.5, 2.0};
+    EXPECT_TRUE(DYND_ISNAN(kahan_sum_1d(vals0)));
+}
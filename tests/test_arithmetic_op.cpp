@@ -4,12 +4,15 @@
 //
 
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <cmath>
 #include <inc_gtest.hpp>
 
 #include <dynd/array.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/eval/eval_elwise_vm.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -360,3 +363,110 @@ TEST(ArithmeticOp, Buffered) {
     EXPECT_EQ(6, a.as<double>());
 }
 */
+
+TEST(ArithmeticOp, FusedExpressionTree) {
+    // Large enough to take several chunks
+    const intptr_t count = 10007;
+    nd::array a = nd::make_strided_array(count, ndt::make_type<double>());
+    nd::array b = nd::make_strided_array(count, ndt::make_type<double>());
+    nd::array c = nd::make_strided_array(count, ndt::make_type<double>());
+    nd::array d = nd::make_strided_array(count, ndt::make_type<double>());
+    for (intptr_t i = 0; i < count; ++i) {
+        a(i).vals() = 0.5 * i;
+        b(i).vals() = 3.0;
+        c(i).vals() = i - 100.0;
+        d(i).vals() = 0.25;
+    }
+
+    nd::array expr = a * b + c * d;
+    vm::elwise_program ep;
+    vector<nd::array> inputs;
+    ASSERT_TRUE(eval::compile_elwise_expr(expr, ep, inputs));
+    EXPECT_EQ(4u, inputs.size());
+    EXPECT_EQ(3, ep.get_instruction_count());
+    // The two products need separate temporaries, the sum goes to the output
+    EXPECT_EQ(7u, ep.get_register_types().size());
+
+    nd::array e = expr.eval();
+    EXPECT_EQ(ndt::make_strided_dim(ndt::make_type<double>()), e.get_type());
+    for (intptr_t i = 0; i < count; i += 97) {
+        EXPECT_EQ(0.5 * i * 3.0 + (i - 100.0) * 0.25, e(i).as<double>());
+    }
+
+    // Temporaries are reused once consumed
+    expr = ((a - b) * c - d) / a;
+    ASSERT_TRUE(eval::compile_elwise_expr(expr, ep, inputs));
+    EXPECT_EQ(5u, inputs.size());
+    EXPECT_EQ(4, ep.get_instruction_count());
+    EXPECT_EQ(7u, ep.get_register_types().size());
+    e = expr.eval();
+    for (intptr_t i = 1; i < count; i += 97) {
+        EXPECT_DOUBLE_EQ(((0.5 * i - 3.0) * (i - 100.0) - 0.25) / (0.5 * i), e(i).as<double>());
+    }
+}
+
+TEST(ArithmeticOp, FusedBroadcastAndConvert) {
+    int32_t v0[3][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}};
+    double v1[4] = {1.5, -2, 0.5, 4};
+    nd::array a = v0, b = v1;
+    // The int32 input is converted as it is read, and the scalar broadcast
+    nd::array e = (a * b + nd::array(10.0) - b).eval();
+    EXPECT_EQ(ndt::make_strided_dim(ndt::make_type<double>(), 2), e.get_type());
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_EQ(v0[i][j] * v1[j] + 10.0 - v1[j], e(i, j).as<double>());
+        }
+    }
+
+    // Non-contiguous inputs
+    nd::array f = (a(irange(), irange().by(2)) * a(irange(), irange(1, 4, 2)) + a(irange(), irange(0, 1))).eval();
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            EXPECT_EQ(v0[i][2 * j] * v0[i][2 * j + 1] + v0[i][0], f(i, j).as<int32_t>());
+        }
+    }
+}
+
+TEST(ArithmeticOp, FusedExpressionKernel) {
+    int32_t v0[3][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}};
+    double v1[4] = {1.5, -2, 0.5, 4};
+    nd::array a = v0, b = v1;
+    nd::array expr = a * b - b / nd::array(2.0);
+    stringstream ss;
+    ss << expr.get_type();
+    EXPECT_NE(string::npos, ss.str().find("expr=subtract(multiply(op0, op1), divide(op2, op3))"));
+
+    // Assigning through the expr kernels rather than eval(), into
+    // a non-contiguous destination
+    nd::array c = nd::empty(3, 8, "M * N * float64");
+    c.vals() = 0;
+    c(irange(), irange().by(2)).vals() = expr;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_EQ(v0[i][j] * v1[j] - v1[j] / 2, c(i, 2 * j).as<double>());
+            EXPECT_EQ(0, c(i, 2 * j + 1).as<double>());
+        }
+    }
+
+    // Beyond the number of operands one expression handles,
+    // part of the tree is evaluated separately
+    nd::array d = b;
+    for (int i = 0; i < 9; ++i) {
+        d = d * nd::array(2.0) + b;
+    }
+    nd::array g = nd::empty(8, "M * float64");
+    g.vals() = 0;
+    g(irange().by(2)).vals() = d;
+    for (int j = 0; j < 4; ++j) {
+        EXPECT_EQ(1023 * v1[j], g(2 * j).as<double>());
+        EXPECT_EQ(0, g(2 * j + 1).as<double>());
+    }
+
+    // Two trees which fit on their own, but not together
+    nd::array t0 = b * b + b * b + b, t1 = b - b * b - b * b;
+    g(irange().by(2)).vals() = t0 * t1;
+    for (int j = 0; j < 4; ++j) {
+        double x = v1[j];
+        EXPECT_EQ((x * x + x * x + x) * (x - x * x - x * x), g(2 * j).as<double>());
+    }
+}
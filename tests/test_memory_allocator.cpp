@@ -0,0 +1,162 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/memblock/memory_allocator.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/zeroinit_memory_block.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    int test_allocate_count = 0, test_free_count = 0;
+
+    void *test_allocate(size_t size_bytes, size_t alignment) {
+        ++test_allocate_count;
+        return get_default_memory_allocator()->allocate(size_bytes, alignment);
+    }
+
+    void test_free(void *ptr) {
+        ++test_free_count;
+        get_default_memory_allocator()->free(ptr);
+    }
+
+    const memory_allocator_api test_allocator = {&test_allocate, &test_free};
+} // anonymous namespace
+
+TEST(MemoryAllocator, LargeAlignment) {
+    // Large data is aligned to the large allocation alignment
+    nd::array a = nd::empty(10001, ndt::make_strided_dim(ndt::make_type<double>()));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a.get_readonly_originptr()) % DYND_LARGE_ALLOCATION_ALIGNMENT);
+    a = nd::empty(DYND_LARGE_ALLOCATION_SIZE, ndt::make_strided_dim(ndt::make_type<int8_t>()));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a.get_readonly_originptr()) % DYND_LARGE_ALLOCATION_ALIGNMENT);
+    // Small data keeps the alignment of its type
+    a = nd::empty(3, ndt::make_strided_dim(ndt::make_type<int64_t>()));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a.get_readonly_originptr()) % sizeof(int64_t));
+
+    EXPECT_EQ(8u, get_allocation_alignment(100, 8));
+    EXPECT_EQ(64u, get_allocation_alignment(DYND_LARGE_ALLOCATION_SIZE, 8));
+    EXPECT_EQ(128u, get_allocation_alignment(DYND_LARGE_ALLOCATION_SIZE, 128));
+}
+
+TEST(MemoryAllocator, Counts) {
+    memory_allocation_counts before = get_memory_allocation_counts(array_memory_block_type);
+    {
+        nd::array a = nd::empty(1000, ndt::make_strided_dim(ndt::make_type<int32_t>()));
+        memory_allocation_counts after = get_memory_allocation_counts(array_memory_block_type);
+        EXPECT_EQ(before.allocation_count + 1, after.allocation_count);
+        EXPECT_LE(before.allocated_bytes + 4000, after.allocated_bytes);
+        EXPECT_EQ(before.free_count, after.free_count);
+    }
+    EXPECT_EQ(before.free_count + 1, get_memory_allocation_counts(array_memory_block_type).free_count);
+
+    before = get_memory_allocation_counts(pod_memory_block_type);
+    make_pod_memory_block(12345);
+    memory_allocation_counts after = get_memory_allocation_counts(pod_memory_block_type);
+    EXPECT_EQ(before.allocation_count + 1, after.allocation_count);
+    EXPECT_EQ(before.allocated_bytes + 12345, after.allocated_bytes);
+    EXPECT_EQ(before.free_count + 1, after.free_count);
+
+    reset_memory_allocation_counts();
+    EXPECT_EQ(0u, get_memory_allocation_counts(pod_memory_block_type).allocation_count);
+    EXPECT_EQ(0u, get_memory_allocation_counts(pod_memory_block_type).allocated_bytes);
+}
+
+TEST(MemoryAllocator, PODBlockChunkAlignment) {
+    memory_block_ptr blocks[2] = {make_pod_memory_block(16), make_zeroinit_memory_block(16)};
+    for (int i = 0; i < 2; ++i) {
+        memory_block_pod_allocator_api *api = get_memory_block_pod_allocator_api(blocks[i].get());
+        char *begin, *end;
+        api->allocate(blocks[i].get(), 3, 1, &begin, &end);
+        // These don't fit in the first chunk, so the new chunks must keep the alignment
+        api->allocate(blocks[i].get(), 100, 128, &begin, &end);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(begin) % 128);
+        api->allocate(blocks[i].get(), 8, 256, &begin, &end);
+        api->resize(blocks[i].get(), 10000, &begin, &end);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(begin) % 256);
+        EXPECT_EQ(10000, end - begin);
+    }
+}
+
+TEST(MemoryAllocator, Pluggable) {
+    test_allocate_count = 0;
+    test_free_count = 0;
+    const memory_allocator_api *prev = set_memory_allocator(&test_allocator);
+    EXPECT_EQ(get_default_memory_allocator(), prev);
+    EXPECT_EQ(&test_allocator, get_memory_allocator());
+    {
+        nd::array a = parse_json("3 * string", "[\"a\", \"b\", \"c\"]");
+        EXPECT_EQ("b", a(1).as<string>());
+        EXPECT_LE(2, test_allocate_count);
+    }
+    EXPECT_EQ(test_allocate_count, test_free_count);
+    EXPECT_EQ(&test_allocator, set_memory_allocator(NULL));
+    EXPECT_EQ(get_default_memory_allocator(), get_memory_allocator());
+}
+
+TEST(MemoryAllocator, FreedByAllocatingAllocator) {
+    test_allocate_count = 0;
+    test_free_count = 0;
+    // Memory from the default allocator, freed after switching allocators
+    nd::array a = nd::empty(100, ndt::make_strided_dim(ndt::make_type<int32_t>()));
+    set_memory_allocator(&test_allocator);
+    a = nd::array();
+    EXPECT_EQ(0, test_free_count);
+    // Memory from the test allocator, freed after switching back
+    nd::array b = nd::empty(100, ndt::make_strided_dim(ndt::make_type<int32_t>()));
+    memory_block_ptr pmb = make_pod_memory_block(100);
+    set_memory_allocator(NULL);
+    EXPECT_EQ(2, test_allocate_count);
+    b = nd::array();
+    pmb = memory_block_ptr();
+    EXPECT_EQ(2, test_free_count);
+}
+
+TEST(MemoryAllocator, HugePages) {
+    EXPECT_FALSE(get_huge_pages_enabled());
+    EXPECT_FALSE(set_huge_pages_enabled(true));
+    nd::array a = nd::empty(DYND_HUGE_PAGE_SIZE, ndt::make_strided_dim(ndt::make_type<int8_t>()));
+    EXPECT_TRUE(set_huge_pages_enabled(false));
+    // The allocation starts on a huge page, with the memory block just after
+    // the allocation header
+    EXPECT_LE(reinterpret_cast<uintptr_t>(a.get_memblock().get()) % DYND_HUGE_PAGE_SIZE,
+                    DYND_LARGE_ALLOCATION_ALIGNMENT);
+    memset(a.get_readwrite_originptr(), 3, DYND_HUGE_PAGE_SIZE);
+    EXPECT_EQ(3, a(DYND_HUGE_PAGE_SIZE - 1).as<int>());
+}
+
+TEST(MemoryAllocator, FirstTouchZeroinit) {
+    EXPECT_EQ(1, get_first_touch_threads());
+    EXPECT_THROW(set_first_touch_threads(0), runtime_error);
+    size_t size = 40 * 1024 * 1024 + 123;
+    vector<char> buf(size, 1);
+    // The default is a plain memset
+    first_touch_zeroinit(&buf[0], size);
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(0, buf[size - 1]);
+
+    EXPECT_EQ(1, set_first_touch_threads(4));
+    memset(&buf[0], 1, size);
+    first_touch_zeroinit(&buf[0], size);
+    for (size_t i = 0; i < size; i += 4093) {
+        ASSERT_EQ(0, buf[i]);
+    }
+    EXPECT_EQ(0, buf[size - 1]);
+
+    // Large zeroinit arrays are zeroed this way
+    nd::array a = nd::empty(1000000, ndt::make_strided_dim(ndt::make_string()));
+    EXPECT_EQ("", a(999999).as<string>());
+    EXPECT_EQ(4, set_first_touch_threads(1));
+}
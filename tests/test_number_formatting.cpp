@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <limits>
+#include <cstdlib>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/number_formatting.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static string fmt_int(int64_t value)
+{
+    char buf[max_formatted_number_size];
+    return string(buf, format_int64(buf, value));
+}
+
+static string fmt_uint(uint64_t value)
+{
+    char buf[max_formatted_number_size];
+    return string(buf, format_uint64(buf, value));
+}
+
+static string fmt_f64(double value)
+{
+    char buf[max_formatted_number_size];
+    return string(buf, format_float64(buf, value));
+}
+
+static string fmt_f32(float value)
+{
+    char buf[max_formatted_number_size];
+    return string(buf, format_float32(buf, value));
+}
+
+TEST(NumberFormatting, Integers) {
+    EXPECT_EQ("0", fmt_int(0));
+    EXPECT_EQ("7", fmt_int(7));
+    EXPECT_EQ("10", fmt_int(10));
+    EXPECT_EQ("-99", fmt_int(-99));
+    EXPECT_EQ("100", fmt_int(100));
+    EXPECT_EQ("-12345", fmt_int(-12345));
+    EXPECT_EQ("9223372036854775807", fmt_int(numeric_limits<int64_t>::max()));
+    EXPECT_EQ("-9223372036854775808", fmt_int(numeric_limits<int64_t>::min()));
+    EXPECT_EQ("18446744073709551615", fmt_uint(numeric_limits<uint64_t>::max()));
+    EXPECT_EQ("1000000000", fmt_uint(1000000000u));
+}
+
+TEST(NumberFormatting, Float64) {
+    EXPECT_EQ("0", fmt_f64(0.0));
+    EXPECT_EQ("-0", fmt_f64(-0.0));
+    EXPECT_EQ("1", fmt_f64(1.0));
+    EXPECT_EQ("-42", fmt_f64(-42.0));
+    EXPECT_EQ("3.125", fmt_f64(3.125));
+    EXPECT_EQ("0.1", fmt_f64(0.1));
+    EXPECT_EQ("0.30000000000000004", fmt_f64(0.1 + 0.2));
+    EXPECT_EQ("3.141592653589793", fmt_f64(3.141592653589793));
+    EXPECT_EQ("1e+20", fmt_f64(1e20));
+    EXPECT_EQ("1.5e-07", fmt_f64(1.5e-7));
+    EXPECT_EQ("inf", fmt_f64(numeric_limits<double>::infinity()));
+    EXPECT_EQ("-inf", fmt_f64(-numeric_limits<double>::infinity()));
+    EXPECT_EQ("nan", fmt_f64(numeric_limits<double>::quiet_NaN()));
+
+    // Every value parses back exactly
+    double vals[] = {numeric_limits<double>::max(), numeric_limits<double>::min(),
+                     numeric_limits<double>::denorm_min(), 1.0 / 3, 2.0 / 3, 1e15 + 0.5,
+                     123456789012345678.0, -9.87654321e-300};
+    for (size_t i = 0; i < sizeof(vals) / sizeof(vals[0]); ++i) {
+        string s = fmt_f64(vals[i]);
+        EXPECT_EQ(vals[i], strtod(s.c_str(), NULL)) << s;
+    }
+}
+
+TEST(NumberFormatting, Float32) {
+    EXPECT_EQ("0", fmt_f32(0.0f));
+    EXPECT_EQ("3.5", fmt_f32(3.5f));
+    EXPECT_EQ("0.1", fmt_f32(0.1f));
+    EXPECT_EQ("16777216", fmt_f32(16777216.0f));
+    EXPECT_EQ("1e+10", fmt_f32(1e10f));
+    EXPECT_EQ("inf", fmt_f32(numeric_limits<float>::infinity()));
+
+    float vals[] = {numeric_limits<float>::max(), numeric_limits<float>::min(),
+                    1.0f / 3, 2.0f / 3, 1234567.8f, -9.876543e-30f};
+    for (size_t i = 0; i < sizeof(vals) / sizeof(vals[0]); ++i) {
+        string s = fmt_f32(vals[i]);
+        EXPECT_EQ(vals[i], (float)strtod(s.c_str(), NULL)) << s;
+    }
+}
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <limits>
+#include <vector>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
@@ -13,6 +15,7 @@
 #include <dynd/types/fixedstring_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/convert_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
 #include <dynd/array_range.hpp>
 
 using namespace std;
@@ -163,6 +166,71 @@ TEST(CategoricalDType, FactorInt) {
     EXPECT_EQ(ndt::make_categorical(int_cats), di);
 }
 
+TEST(CategoricalDType, FactorFloat) {
+    // Signed zeros are one category, as are all the NaNs
+    double a_vals[] = {1.5, -0.0, 0.0, numeric_limits<double>::quiet_NaN(), 1.5,
+                    -numeric_limits<double>::quiet_NaN(), 0.0};
+    ndt::type da = ndt::factor_categorical(a_vals);
+    const categorical_type *cd = static_cast<const categorical_type *>(da.extended());
+    ASSERT_EQ(3u, cd->get_category_count());
+    nd::array cats = cd->get_categories();
+    EXPECT_EQ(0.0, cats(0).as<double>());
+    EXPECT_EQ(1.5, cats(1).as<double>());
+    EXPECT_NE(cats(2).as<double>(), cats(2).as<double>());
+
+    nd::array a = nd::array(a_vals).ucast(da).eval();
+    EXPECT_EQ(1.5, a(0).as<double>());
+    EXPECT_EQ(0.0, a(1).as<double>());
+    EXPECT_NE(a(3).as<double>(), a(3).as<double>());
+    EXPECT_NE(a(5).as<double>(), a(5).as<double>());
+}
+
+TEST(CategoricalDType, FactorStruct) {
+    ndt::type d = ndt::make_cstruct(ndt::make_string(), "name", ndt::make_type<int32_t>(), "id");
+    nd::array a = nd::make_strided_array(5, d);
+    const char *name_vals[] = {"x", "y", "x", "x", "y"};
+    int32_t id_vals[] = {1, 1, 1, 2, 1};
+    a.p("name").vals() = name_vals;
+    a.p("id").vals() = id_vals;
+
+    ndt::type da = ndt::factor_categorical(a);
+    const categorical_type *cd = static_cast<const categorical_type *>(da.extended());
+    ASSERT_EQ(3u, cd->get_category_count());
+
+    nd::array b = a.ucast(da).eval();
+    EXPECT_EQ(b(0).p("ints").as<int>(), b(2).p("ints").as<int>());
+    EXPECT_NE(b(0).p("ints").as<int>(), b(3).p("ints").as<int>());
+    nd::array c = b.ucast(d).eval();
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(name_vals[i], c(i).p("name").as<string>());
+        EXPECT_EQ(id_vals[i], c(i).p("id").as<int32_t>());
+    }
+}
+
+TEST(CategoricalDType, FactorStringMany) {
+    // Enough categories to need 16-bit storage
+    vector<string> a_vals;
+    for (int i = 0; i < 3000; ++i) {
+        stringstream ss;
+        ss << "value" << (i * 7919) % 1000;
+        a_vals.push_back(ss.str());
+    }
+    nd::array a = nd::make_strided_array(a_vals.size(), ndt::make_string());
+    for (size_t i = 0; i < a_vals.size(); ++i) {
+        a(i).vals() = a_vals[i];
+    }
+
+    ndt::type da = ndt::factor_categorical(a);
+    const categorical_type *cd = static_cast<const categorical_type *>(da.extended());
+    EXPECT_EQ(1000u, cd->get_category_count());
+    EXPECT_EQ(ndt::make_type<uint16_t>(), cd->get_storage_type());
+
+    nd::array b = a.ucast(da).eval();
+    for (size_t i = 0; i < a_vals.size(); ++i) {
+        EXPECT_EQ(a_vals[i], b(i).as<string>());
+    }
+}
+
 TEST(CategoricalDType, Values) {
     const char *a_vals[] = {"foo", "bar", "baz"};
     nd::array a = nd::make_strided_array(3, ndt::make_fixedstring(3, string_encoding_ascii));
@@ -322,3 +390,19 @@ TEST(CategoricalDType, AssignFromOther) {
     EXPECT_EQ(3, a(5).as<int>());
 }
 
+TEST(CategoricalDType, AssignUnknown) {
+    const char *cats_vals[] = {"bar", "foo", "foot"};
+    ndt::type cd = ndt::make_categorical(cats_vals);
+    nd::array a = nd::empty(cd);
+    a.vals() = "foot";
+    EXPECT_EQ("foot", a.as<string>());
+    EXPECT_THROW(a.vals() = "fo", runtime_error);
+    EXPECT_THROW(a.vals() = "food", runtime_error);
+
+    int int_cats_vals[] = {3, 6, 100};
+    ndt::type icd = ndt::make_categorical(int_cats_vals);
+    nd::array b = nd::empty(icd);
+    b.vals() = 100;
+    EXPECT_EQ(100, b.as<int>());
+    EXPECT_THROW(b.vals() = 5, runtime_error);
+}
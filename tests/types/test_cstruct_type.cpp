@@ -399,3 +399,29 @@ TEST(CStructDType, SingleCompare) {
     EXPECT_THROW((b >= a), not_comparable_error);
     EXPECT_THROW((b > a), not_comparable_error);
 }
+
+TEST(CStructDType, FieldIndex) {
+    vector<ndt::type> field_types;
+    vector<string> field_names;
+    for (int i = 0; i < 100; ++i) {
+        stringstream ss;
+        ss << "f" << i;
+        field_types.push_back(ndt::make_type<int32_t>());
+        field_names.push_back(ss.str());
+    }
+    ndt::type tp = ndt::make_cstruct(field_types.size(), &field_types[0], &field_names[0]);
+    const base_struct_type *bsd = static_cast<const base_struct_type *>(tp.extended());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i, bsd->get_field_index(field_names[i]));
+        const char *name = field_names[i].c_str();
+        EXPECT_EQ(i, bsd->get_field_index(name, name + field_names[i].size()));
+    }
+    EXPECT_EQ(-1, bsd->get_field_index("f100"));
+    EXPECT_EQ(-1, bsd->get_field_index("f"));
+    EXPECT_EQ(-1, bsd->get_field_index(""));
+
+    tp = ndt::make_struct(field_types, field_names);
+    bsd = static_cast<const base_struct_type *>(tp.extended());
+    EXPECT_EQ(57, bsd->get_field_index("f57"));
+    EXPECT_EQ(-1, bsd->get_field_index("g57"));
+}
@@ -6,11 +6,13 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/types/date_type.hpp>
 #include <dynd/types/date_util.hpp>
+#include <dynd/types/date_parser.hpp>
 #include <dynd/types/property_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixedstring_type.hpp>
@@ -158,6 +160,48 @@ TEST(DateDType, DateProperties) {
     EXPECT_EQ(25, a.p("day")(2).as<int32_t>());
 }
 
+TEST(DateDType, DatePropertiesStrided) {
+    // Compare the strided property kernels against date_ymd::set_from_days
+    // over a range of days spanning many 400 year cycles, both ways from 1970
+    const intptr_t count = 200000;
+    nd::array a = nd::empty(count, ndt::make_strided_dim(ndt::make_date()));
+    int32_t *days = reinterpret_cast<int32_t *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < count; ++i) {
+        days[i] = static_cast<int32_t>((i - count / 2) * 53 + i % 7);
+    }
+    days[17] = DYND_DATE_NA;
+    days[18] = -719528;
+    days[19] = -719529;
+
+    nd::array year = a.p("year").eval(), month = a.p("month").eval();
+    nd::array day = a.p("day").eval(), weekday = a.f("weekday").eval();
+    nd::array ymd = a.f("to_struct").eval();
+    const int32_t *year_ptr = reinterpret_cast<const int32_t *>(year.get_readonly_originptr());
+    const int32_t *month_ptr = reinterpret_cast<const int32_t *>(month.get_readonly_originptr());
+    const int32_t *day_ptr = reinterpret_cast<const int32_t *>(day.get_readonly_originptr());
+    const int32_t *weekday_ptr = reinterpret_cast<const int32_t *>(weekday.get_readonly_originptr());
+    const date_ymd *ymd_ptr = reinterpret_cast<const date_ymd *>(ymd.get_readonly_originptr());
+    for (intptr_t i = 0; i < count; ++i) {
+        date_ymd expected;
+        expected.set_from_days(days[i]);
+        ASSERT_EQ(expected.year, year_ptr[i]) << "days " << days[i];
+        ASSERT_EQ(expected.month, month_ptr[i]) << "days " << days[i];
+        ASSERT_EQ(expected.day, day_ptr[i]) << "days " << days[i];
+        ASSERT_EQ(expected.year, ymd_ptr[i].year) << "days " << days[i];
+        ASSERT_EQ(expected.month, ymd_ptr[i].month) << "days " << days[i];
+        ASSERT_EQ(expected.day, ymd_ptr[i].day) << "days " << days[i];
+        if (days[i] != DYND_DATE_NA) {
+            ASSERT_EQ(expected.get_weekday(), weekday_ptr[i]) << "days " << days[i];
+        }
+    }
+
+    // A non-contiguous view uses the general strided loop
+    nd::array b = a(irange().by(3));
+    year = b.p("year").eval();
+    EXPECT_EQ(year(5).as<int32_t>(), a(15).p("year").as<int32_t>());
+    EXPECT_EQ(a(300).p("day").as<int32_t>(), b(100).p("day").eval().as<int32_t>());
+}
+
 TEST(DateDType, DatePropertyConvertOfString) {
     nd::array a, b, c;
     const char *strs[] = {"1931-12-12", "2013-05-14", "2012-12-25"};
@@ -949,3 +993,65 @@ TEST(DateYMD, TwoDigitYear_SlidingWindow) {
     EXPECT_EQ(2093, date_ymd::resolve_2digit_year_sliding_window(93, 20));
     EXPECT_EQ(2093, date_ymd::resolve_2digit_year(93, 20));
 }
+
+TEST(DateYMD, StringToDateISO8601Fixed) {
+    // The fast path agrees with string_to_date wherever it accepts a string
+    const char *strs[] = {"1979-03-22", "0000-01-01", "9999-12-31", "2000-02-29",
+                          "1900-02-29", "2013-13-01", "2013-00-10", "2013-04-31",
+                          "2013-4-30", "2013/04/30", "20130430", "2013-04-3x",
+                          " 2013-04-30", "2013-04-30 ", "2013-04-30T00", "+02013-04-30",
+                          "2013-0:-01", "2013-04-0/"};
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        const char *begin = strs[i], *end = begin + strlen(begin);
+        date_ymd fast, general;
+        bool fast_ok = string_to_date_iso8601_fixed(begin, end, fast);
+        bool general_ok = string_to_date(begin, end, general, date_parse_no_ambig, 70);
+        EXPECT_EQ(i < 4, fast_ok) << strs[i];
+        if (fast_ok) {
+            ASSERT_TRUE(general_ok) << strs[i];
+            EXPECT_EQ(general.to_days(), fast.to_days()) << strs[i];
+        }
+    }
+}
+
+TEST(DateDType, StringToDateMixedFormats) {
+    // Strings starting in ISO 8601, then falling back to other formats,
+    // go through both the fast path and the general parser
+    const char *strs[] = {"2013-01-02", "1969-12-31", "NA", "Mar 22, 1979",
+                          "1979/03/22", "20130102", "2012-02-29", "22 Mar 1979",
+                          "1979-03-22", "Fri, 2014-02-14"};
+    nd::array a = nd::array(strs).ucast(ndt::make_date()).eval();
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        date_ymd ymd;
+        if (strcmp(strs[i], "NA") == 0) {
+            ymd.set_to_na();
+        } else {
+            ymd.set_from_str(strs[i]);
+        }
+        EXPECT_EQ(ymd.to_days(), a(i).view_scalars<int32_t>().as<int32_t>()) << strs[i];
+    }
+
+    // A string the fast path rejects still reports a parse error
+    const char *bad[] = {"2013-01-02", "2013-02-30"};
+    EXPECT_THROW(nd::array(bad).ucast(ndt::make_date()).eval(), invalid_argument);
+}
+
+TEST(DateDType, StringToDateLeadingNA) {
+    // Leading NAs are parsed before, and don't count against, the fast path
+    const char *strs[] = {"NA", "NA", "NA", "2013-01-02", "NA", "1969-12-31",
+                          "Mar 22, 1979", "2012-02-29"};
+    nd::array a = nd::array(strs).ucast(ndt::make_date()).eval();
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        date_ymd ymd;
+        if (strcmp(strs[i], "NA") == 0) {
+            ymd.set_to_na();
+        } else {
+            ymd.set_from_str(strs[i]);
+        }
+        EXPECT_EQ(ymd.to_days(), a(i).view_scalars<int32_t>().as<int32_t>()) << strs[i];
+    }
+
+    const char *bad[] = {"NA", "2013-02-30"};
+    EXPECT_THROW(nd::array(bad).ucast(ndt::make_date()).eval(), invalid_argument);
+}
+
@@ -6,10 +6,12 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/types/datetime_type.hpp>
+#include <dynd/types/datetime_parser.hpp>
 #include <dynd/types/property_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixedstring_type.hpp>
@@ -148,6 +150,50 @@ TEST(DateTimeDType, Properties) {
     EXPECT_EQ(1236540, n.p("tick").as<int32_t>());
 }
 
+TEST(DateTimeDType, PropertiesStrided) {
+    const char *strs[] = {"1963-02-28T16:12:14.123654", "1969-12-31T23:59:59.9999999",
+                          "1600-02-29T00:00:00", "2100-03-01T12:30:00"};
+    nd::array n = nd::array(strs).ucast(ndt::type("datetime")).eval();
+    int32_t year[] = {1963, 1969, 1600, 2100};
+    int32_t month[] = {2, 12, 2, 3};
+    int32_t day[] = {28, 31, 29, 1};
+    int32_t hour[] = {16, 23, 0, 12};
+    nd::array y = n.p("year").eval(), m = n.p("month").eval();
+    nd::array d = n.p("day").eval(), h = n.p("hour").eval();
+    nd::array s = n.f("to_struct").eval();
+    EXPECT_EQ(ndt::make_strided_dim(datetime_struct::type()), s.get_type());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(year[i], y(i).as<int32_t>());
+        EXPECT_EQ(month[i], m(i).as<int32_t>());
+        EXPECT_EQ(day[i], d(i).as<int32_t>());
+        EXPECT_EQ(hour[i], h(i).as<int32_t>());
+        EXPECT_EQ(year[i], s(i).p("year").as<int32_t>());
+        EXPECT_EQ(month[i], s(i).p("month").as<int32_t>());
+        EXPECT_EQ(day[i], s(i).p("day").as<int32_t>());
+        EXPECT_EQ(hour[i], s(i).p("hour").as<int32_t>());
+    }
+    EXPECT_EQ(59, s(1).p("second").as<int32_t>());
+    EXPECT_EQ(9999999, s(1).p("tick").as<int32_t>());
+    // The date of a time before 1970 rounds down
+    EXPECT_EQ("1969-12-31", n(1).p("date").as<string>());
+}
+
+TEST(DateTimeDType, NAToStruct) {
+    const char *strs[] = {"NA", "2001-02-03T04:05:06"};
+    nd::array n = nd::array(strs).ucast(ndt::type("datetime")).eval();
+    nd::array s = n.f("to_struct").eval();
+    const datetime_struct *dts = reinterpret_cast<const datetime_struct *>(s.get_readonly_originptr());
+    EXPECT_TRUE(dts[0].ymd.is_na());
+    EXPECT_TRUE(dts[0].hmst.is_na());
+    EXPECT_FALSE(dts[1].is_na());
+    EXPECT_EQ(4, dts[1].hmst.hour);
+    // The single element kernel too
+    nd::array s0 = n(0).f("to_struct").eval();
+    dts = reinterpret_cast<const datetime_struct *>(s0.get_readonly_originptr());
+    EXPECT_TRUE(dts->ymd.is_na());
+    EXPECT_TRUE(dts->hmst.is_na());
+}
+
 TEST(DateTimeStruct, FromToString) {
     datetime_struct dts;
 
@@ -170,3 +216,30 @@ TEST(DateTimeStruct, FromToString) {
     dts.set_from_str("1994-10-20 T 11:15");
     EXPECT_EQ("1994-10-20T11:15", dts.to_str());
 }
+
+TEST(DateTimeStruct, StringToDateTimeISO8601Fixed) {
+    // The fast path agrees with string_to_datetime wherever it accepts a string
+    const char *strs[] = {"1963-02-28T16:12:14.123654", "2000-02-29 00:00",
+                          "1969-12-31T23:59:59.9999999", "1963-02-28T16:12",
+                          "1963-02-28T16", "1963-02-28 T16:12", "1963-02-28T4:12",
+                          "1963-02-30T16:12", "1963-02-28T16:12 PM"};
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        const char *begin = strs[i], *end = begin + strlen(begin);
+        datetime_struct fast, general;
+        bool fast_ok = string_to_datetime_iso8601_fixed(begin, end, fast);
+        bool general_ok = string_to_datetime(begin, end, general, date_parse_no_ambig, 70);
+        EXPECT_EQ(i < 4, fast_ok) << strs[i];
+        if (fast_ok) {
+            ASSERT_TRUE(general_ok) << strs[i];
+            EXPECT_EQ(general.to_ticks(), fast.to_ticks()) << strs[i];
+        }
+    }
+
+    const char *mixed[] = {"1963-02-28T16:12:14", "Fri Dec 19 15:10:11 1997", "NA"};
+    nd::array a = nd::array(mixed).ucast(ndt::type("datetime")).eval();
+    EXPECT_EQ(1963, a(0).p("year").as<int32_t>());
+    EXPECT_EQ(14, a(0).p("second").as<int32_t>());
+    EXPECT_EQ(1997, a(1).p("year").as<int32_t>());
+    EXPECT_EQ(15, a(1).p("hour").as<int32_t>());
+}
+
@@ -6,6 +6,9 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
@@ -383,6 +386,132 @@ TEST(StringType, StringToInteger) {
     EXPECT_THROW(nd::array("18446744073709551616").ucast<uint64_t>().eval(), runtime_error);
 }
 
+TEST(StringType, StringToIntegerDigits) {
+    // Long digit runs, leading zeros and whitespace
+    EXPECT_EQ(1234567890123456789LL, nd::array("1234567890123456789").ucast<int64_t>().as<int64_t>());
+    EXPECT_EQ(-12345678, nd::array(" -12345678 ").ucast<int32_t>().as<int32_t>());
+    EXPECT_EQ(42, nd::array("000000000000000000000042").ucast<int32_t>().as<int32_t>());
+    EXPECT_EQ(10000000000000000000ULL, nd::array("10000000000000000000").ucast<uint64_t>().as<uint64_t>());
+    EXPECT_THROW(nd::array("99999999999999999999").ucast<uint64_t>().eval(), runtime_error);
+    EXPECT_THROW(nd::array("12345678x").ucast<int64_t>().eval(), runtime_error);
+    EXPECT_THROW(nd::array("1234:678").ucast<int64_t>().eval(), runtime_error);
+    EXPECT_EQ(1234, nd::array("1234:678").ucast<int64_t>(0, assign_error_none).as<int64_t>());
+}
+
+TEST(StringType, StringToInt128) {
+    EXPECT_EQ(dynd_int128(0ULL, 12345ULL), nd::array("12345").ucast<dynd_int128>().as<dynd_int128>());
+    EXPECT_EQ(-dynd_int128(0ULL, 12345ULL), nd::array("-12345").ucast<dynd_int128>().as<dynd_int128>());
+    // 2^64
+    EXPECT_EQ(dynd_int128(1ULL, 0ULL),
+                    nd::array("18446744073709551616").ucast<dynd_int128>().as<dynd_int128>());
+    // The boundaries, 2^127 - 1 and -2^127
+    EXPECT_EQ(dynd_int128(0x7fffffffffffffffULL, 0xffffffffffffffffULL),
+                    nd::array("170141183460469231731687303715884105727").ucast<dynd_int128>().as<dynd_int128>());
+    EXPECT_EQ(dynd_int128(0x8000000000000000ULL, 0ULL),
+                    nd::array("-170141183460469231731687303715884105728").ucast<dynd_int128>().as<dynd_int128>());
+    EXPECT_THROW(nd::array("170141183460469231731687303715884105728").ucast<dynd_int128>().eval(),
+                    runtime_error);
+    EXPECT_THROW(nd::array("12a").ucast<dynd_int128>().eval(), runtime_error);
+
+    EXPECT_EQ(dynd_uint128(0xffffffffffffffffULL, 0xffffffffffffffffULL),
+                    nd::array("340282366920938463463374607431768211455").ucast<dynd_uint128>().as<dynd_uint128>());
+    EXPECT_THROW(nd::array("340282366920938463463374607431768211456").ucast<dynd_uint128>().eval(),
+                    runtime_error);
+    EXPECT_THROW(nd::array("-1").ucast<dynd_uint128>().eval(), runtime_error);
+}
+
+TEST(StringType, StringToFloat64Rounding) {
+    // The parsed values must match strtod, which rounds correctly
+    const char *vals[] = {"0", "-0", "1", "0.1", "-2.5", "3.14159", "1e22", "1e23",
+                          "123456789012345", "1234567890123456789", "0.30000000000000004",
+                          "2.2250738585072014e-308", "4.9e-324", "1.7976931348623157e308",
+                          "9007199254740993", "1.5e-10", "+7.25", ".5", "5.", "0x1p4"};
+    for (size_t i = 0; i < sizeof(vals) / sizeof(vals[0]); ++i) {
+        double expected = strtod(vals[i], NULL);
+        double value = nd::array(vals[i]).ucast<double>().as<double>();
+        EXPECT_EQ(0, memcmp(&expected, &value, sizeof(double))) << vals[i];
+    }
+    EXPECT_EQ(0.25f, nd::array(" 0.25 ").ucast<float>().as<float>());
+    EXPECT_THROW(nd::array("1.5x").ucast<double>().eval(), runtime_error);
+    EXPECT_THROW(nd::array("1e").ucast<double>().eval(), runtime_error);
+    EXPECT_EQ(1.5, nd::array("1.5x").ucast<double>(0, assign_error_none).as<double>());
+}
+
+TEST(StringType, StringToComplex) {
+    EXPECT_EQ(dynd_complex<double>(1.5, 2), nd::array("1.5+2j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(1.5, 2), nd::array("(1.5 + 2j)").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(1e-3, -2.5e2), nd::array("1e-3-2.5e+2j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(0, -3), nd::array("-3j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(4, 0), nd::array(" 4 ").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(1, -1), nd::array("1-j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(0, 1), nd::array("j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(0, -1), nd::array("-j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(0, 1), nd::array("+j").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<double>(0, 1), nd::array("(j)").ucast<dynd_complex<double> >().as<dynd_complex<double> >());
+    EXPECT_EQ(dynd_complex<float>(0.5f, 0.25f), nd::array("0.5+0.25j").ucast<dynd_complex<float> >().as<dynd_complex<float> >());
+    EXPECT_THROW(nd::array("1+2k").ucast<dynd_complex<double> >().eval(), runtime_error);
+    EXPECT_THROW(nd::array("(1+2j").ucast<dynd_complex<double> >().eval(), runtime_error);
+}
+
+TEST(StringType, StringToNumberArrays) {
+    // Strided conversion of a string array, and of fixedstring
+    // and utf-16 strings which aren't parsed in place
+    const char *vals[] = {"1", " 22", "333 ", "-4444"};
+    nd::array a = nd::array(vals).ucast(ndt::make_string()).eval();
+    nd::array b = a.ucast<int32_t>().eval();
+    EXPECT_EQ(22, b(1).as<int32_t>());
+    EXPECT_EQ(-4444, b(3).as<int32_t>());
+    b = a.ucast(ndt::make_fixedstring(6, string_encoding_ascii)).eval().ucast<int16_t>().eval();
+    EXPECT_EQ(333, b(2).as<int16_t>());
+    b = a.ucast(ndt::make_string(string_encoding_utf_16)).eval().ucast<double>().eval();
+    EXPECT_EQ(-4444., b(3).as<double>());
+    try {
+        nd::array("12x").ucast(ndt::make_string(string_encoding_utf_16)).ucast<int32_t>().eval();
+        FAIL() << "expected a parse error";
+    } catch (const runtime_error& e) {
+        EXPECT_EQ("cannot cast string \"12x\" to int32", string(e.what()));
+    }
+}
+
+TEST(StringType, NumberToString) {
+    EXPECT_EQ("-123", nd::array(-123).ucast(ndt::make_string()).as<string>());
+    EXPECT_EQ("18446744073709551615",
+                    nd::array(18446744073709551615ULL).ucast(ndt::make_string()).as<string>());
+    EXPECT_EQ("true", nd::array(true).ucast(ndt::make_string()).as<string>());
+    // Floating point values print the shortest round trip representation
+    EXPECT_EQ("0.1", nd::array(0.1).ucast(ndt::make_string()).as<string>());
+    EXPECT_EQ("0.3333333333333333", nd::array(1.0 / 3).ucast(ndt::make_string()).as<string>());
+    EXPECT_EQ("0.1", nd::array(0.1f).ucast(ndt::make_string()).as<string>());
+    EXPECT_EQ("1e+100", nd::array(1e100).ucast(ndt::make_string()).as<string>());
+    // Types printed through iostreams
+    EXPECT_EQ("12345", nd::array(dynd_int128(0ULL, 12345ULL)).ucast(ndt::make_string()).as<string>());
+    // Other string types
+    EXPECT_EQ("-7", nd::array(-7).ucast(ndt::make_fixedstring(8)).as<string>());
+    EXPECT_EQ("2.5", nd::array(2.5).ucast(ndt::make_string(string_encoding_utf_16)).as<string>());
+}
+
+TEST(StringType, NumberArrayToString) {
+    // Large enough to be formatted in several chunks
+    nd::array a = nd::make_strided_array(1000, ndt::make_type<int64_t>());
+    int64_t *a_data = reinterpret_cast<int64_t *>(a.get_readwrite_originptr());
+    for (int i = 0; i < 1000; ++i) {
+        a_data[i] = i * 1001 - 500000;
+    }
+    nd::array b = a(irange().by(3)).ucast(ndt::make_string()).eval();
+    ASSERT_EQ(334, b.get_dim_size());
+    for (int i = 0; i < 334; ++i) {
+        stringstream ss;
+        ss << (i * 3 * 1001 - 500000);
+        EXPECT_EQ(ss.str(), b(i).as<string>());
+    }
+    double vals[] = {1.5, -0.25, 1e-7, 123456789.0};
+    b = nd::array(vals).ucast(ndt::make_string()).eval();
+    EXPECT_EQ("1.5", b(0).as<string>());
+    EXPECT_EQ("-0.25", b(1).as<string>());
+    EXPECT_EQ("1e-07", b(2).as<string>());
+    EXPECT_EQ("123456789", b(3).as<string>());
+}
+
 TEST(StringType, StringToFloat32SpecialValues) {
     // +NaN with default payload
     EXPECT_EQ(0x7fc00000u, nd::array("NaN").ucast<float>().view_scalars<uint32_t>().as<uint32_t>());
@@ -431,6 +560,94 @@ TEST(StringType, StringEncodeError) {
                     string_encode_error);
 }
 
+TEST(StringType, TranscodeMixedRuns) {
+    // Long ASCII runs go through the block paths, with multi-byte
+    // characters, including one outside the BMP, in between
+    std::string s = "The quick brown fox jumps over the lazy dog \xc3\xa9"
+                    "abcdefghijklmnopqrstuvwxyz0123456789\xe4\xb8\xad-"
+                    "\xf0\x9f\x98\x80 and more ASCII text at the end";
+    nd::array a = nd::array(s).ucast(ndt::make_string(string_encoding_utf_8)).eval();
+    string_encoding_t encodings[] = {string_encoding_utf_8, string_encoding_utf_16,
+                    string_encoding_utf_32};
+    for (int i = 0; i < 3; ++i) {
+        nd::array b = a.ucast(ndt::make_string(encodings[i])).eval();
+        EXPECT_EQ(s, b.as<std::string>());
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_EQ(s, b.ucast(ndt::make_string(encodings[j])).eval().as<std::string>());
+            EXPECT_EQ(s, b.ucast(ndt::make_fixedstring(128, encodings[j])).eval().as<std::string>());
+        }
+    }
+
+    // The exact output size of each encoding
+    nd::array b = a.ucast(ndt::make_string(string_encoding_utf_16)).eval();
+    const string_type_data *d = reinterpret_cast<const string_type_data *>(b.get_readonly_originptr());
+    EXPECT_EQ(2 * 116, d->end - d->begin);
+    b = a.ucast(ndt::make_string(string_encoding_utf_32)).eval();
+    d = reinterpret_cast<const string_type_data *>(b.get_readonly_originptr());
+    EXPECT_EQ(4 * 115, d->end - d->begin);
+
+    // Characters which don't fit the destination encoding
+    EXPECT_THROW(a.ucast(ndt::make_string(string_encoding_ucs_2)).eval(), string_encode_error);
+    EXPECT_THROW(a.ucast(ndt::make_string(string_encoding_ascii)).eval(), string_encode_error);
+    b = a.ucast(ndt::make_string(string_encoding_ascii), 0, assign_error_none).eval();
+    std::string expected = s;
+    expected.replace(expected.find("\xf0"), 4, "?");
+    expected.replace(expected.find("\xe4"), 3, "?");
+    expected.replace(expected.find("\xc3"), 2, "?");
+    EXPECT_EQ(expected, b.as<std::string>());
+}
+
+TEST(StringType, TranscodeToFixedString) {
+    nd::array a = nd::array("abcdefghij\xc3\xa9").ucast(ndt::make_string(string_encoding_utf_8)).eval();
+    // Exactly fits, without a terminating null
+    EXPECT_EQ("abcdefghij\xc3\xa9",
+                    a.ucast(ndt::make_fixedstring(12, string_encoding_utf_8)).eval().as<std::string>());
+    EXPECT_EQ("abcdefghij\xc3\xa9",
+                    a.ucast(ndt::make_fixedstring(11, string_encoding_utf_16)).eval().as<std::string>());
+    // Too small
+    EXPECT_THROW(a.ucast(ndt::make_fixedstring(11, string_encoding_utf_8)).eval(), runtime_error);
+    EXPECT_EQ("abcdefghij", a.ucast(ndt::make_fixedstring(10, string_encoding_utf_32),
+                    0, assign_error_none).eval().as<std::string>());
+
+    // A null-padded source stops at the first null
+    nd::array f = a.ucast(ndt::make_fixedstring(16, string_encoding_utf_16)).eval();
+    EXPECT_EQ("abcdefghij\xc3\xa9",
+                    f.ucast(ndt::make_string(string_encoding_utf_32)).eval().as<std::string>());
+    EXPECT_EQ("abcdefghij\xc3\xa9",
+                    f.ucast(ndt::make_fixedstring(11, string_encoding_utf_32)).eval().as<std::string>());
+}
+
+TEST(StringType, StridedStringAssign) {
+    // Enough strings to span several allocation chunks
+    const intptr_t count = 300;
+    nd::array a = nd::make_strided_array(count, ndt::make_string(string_encoding_utf_8));
+    nd::array f = nd::make_strided_array(count, ndt::make_fixedstring(8, string_encoding_utf_8));
+    std::vector<std::string> vals(count);
+    for (intptr_t i = 0; i < count; ++i) {
+        stringstream ss;
+        ss << ((i % 3 == 0) ? "\xc3\xa9" : "x") << i;
+        vals[i] = ss.str();
+        a(i).vals() = vals[i];
+        f(i).vals() = vals[i];
+    }
+
+    string_encoding_t encodings[] = {string_encoding_utf_8, string_encoding_utf_16,
+                    string_encoding_utf_32};
+    for (int j = 0; j < 3; ++j) {
+        nd::array b = a.ucast(ndt::make_string(encodings[j])).eval();
+        nd::array c = f.ucast(ndt::make_string(encodings[j])).eval();
+        for (intptr_t i = 0; i < count; ++i) {
+            EXPECT_EQ(vals[i], b(i).as<std::string>());
+            EXPECT_EQ(vals[i], c(i).as<std::string>());
+        }
+        // The strings of a chunk are allocated together
+        const string_type_data *d = reinterpret_cast<const string_type_data *>(b.get_readonly_originptr());
+        for (intptr_t i = 0; i < 100; ++i) {
+            EXPECT_EQ(d[i].end, d[i + 1].begin);
+        }
+    }
+}
+
 TEST(StringType, Comparisons) {
     nd::array a, b;
 
@@ -231,6 +231,61 @@ TEST(StructDType, FromCStructAssign) {
     EXPECT_EQ(8,    b(1,1).as<short>());
 }
 
+TEST(StructDType, StridedAssignManyRecords) {
+    // Enough records for several chunks of the strided struct kernel, with
+    // runs of adjacent POD fields around a string field
+    ndt::type dt = ndt::make_cstruct(ndt::make_type<int32_t>(), "a", ndt::make_type<int32_t>(), "b",
+                    ndt::make_string(), "c", ndt::make_type<int16_t>(), "d",
+                    ndt::make_type<int16_t>(), "e");
+    const intptr_t count = 300;
+    nd::array a = nd::make_strided_array(count, dt);
+    for (intptr_t i = 0; i < count; ++i) {
+        a(i, 0).vals() = (int32_t)i;
+        a(i, 1).vals() = (int32_t)(-3 * i);
+        stringstream ss;
+        ss << "s" << i;
+        a(i, 2).vals() = ss.str();
+        a(i, 3).vals() = (int16_t)(i % 100);
+        a(i, 4).vals() = (int16_t)(7 - i);
+    }
+
+    // Identical struct assignment
+    nd::array b = nd::make_strided_array(count, dt);
+    b.vals() = a;
+    for (intptr_t i = 0; i < count; ++i) {
+        ASSERT_EQ(i, b(i, 0).as<int32_t>());
+        ASSERT_EQ(-3 * i, b(i, 1).as<int32_t>());
+        ASSERT_EQ(a(i, 2).as<string>(), b(i, 2).as<string>());
+        ASSERT_EQ(i % 100, b(i, 3).as<int16_t>());
+        ASSERT_EQ(7 - i, b(i, 4).as<int16_t>());
+    }
+
+    // Reordered and converted fields, from a non-contiguous source
+    vector<ndt::type> field_types;
+    vector<string> field_names;
+    field_types.push_back(ndt::make_type<int16_t>());
+    field_names.push_back("d");
+    field_types.push_back(ndt::make_type<int16_t>());
+    field_names.push_back("e");
+    field_types.push_back(ndt::make_type<double>());
+    field_names.push_back("b");
+    field_types.push_back(ndt::make_string());
+    field_names.push_back("c");
+    field_types.push_back(ndt::make_type<int64_t>());
+    field_names.push_back("a");
+    ndt::type dt2 = ndt::make_struct(field_types, field_names);
+    nd::array a_step = a(irange().by(2));
+    nd::array c = nd::make_strided_array(count / 2, dt2);
+    c.vals() = a_step;
+    for (intptr_t i = 0; i < count / 2; ++i) {
+        ASSERT_EQ((2 * i) % 100, c(i, 0).as<int16_t>());
+        ASSERT_EQ(7 - 2 * i, c(i, 1).as<int16_t>());
+        ASSERT_EQ(-6 * i, c(i, 2).as<double>());
+        ASSERT_EQ(a(2 * i, 2).as<string>(), c(i, 3).as<string>());
+        ASSERT_EQ(2 * i, c(i, 4).as<int64_t>());
+    }
+}
+
 TEST(StructDType, SingleCompare) {
     nd::array a, b;
     ndt::type sdt = ndt::make_struct(ndt::make_type<int32_t>(), "a",
@@ -6,10 +6,12 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 #include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
 #include <dynd/types/time_type.hpp>
+#include <dynd/types/time_parser.hpp>
 #include <dynd/types/property_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixedstring_type.hpp>
@@ -162,3 +164,28 @@ TEST(TimeHMST, SetFromStr_Errors) {
     EXPECT_THROW(hmst.set_from_str("08:00:"), invalid_argument);
     EXPECT_THROW(hmst.set_from_str("08:00:00."), invalid_argument);
 }
+
+TEST(TimeHMST, StringToTimeISO8601Fixed) {
+    // The fast path agrees with string_to_time wherever it accepts a string
+    const char *strs[] = {"00:00", "23:59:60", "12:34:56.7", "12:34:56.789012345678",
+                          "12:34:56.0000001", "24:00", "12:60", "1:30", "12:30 pm",
+                          "12:34:56.", "12:34:5", "12:34:56 ", "12-34-56"};
+    for (size_t i = 0; i < sizeof(strs) / sizeof(strs[0]); ++i) {
+        const char *begin = strs[i], *end = begin + strlen(begin);
+        time_hmst fast, general;
+        bool fast_ok = string_to_time_iso8601_fixed(begin, end, fast);
+        bool general_ok = string_to_time(begin, end, general);
+        EXPECT_EQ(i < 5, fast_ok) << strs[i];
+        if (fast_ok) {
+            ASSERT_TRUE(general_ok) << strs[i];
+            EXPECT_EQ(general.to_ticks(), fast.to_ticks()) << strs[i];
+        }
+    }
+
+    const char *mixed[] = {"12:34:56.7", "3:30 pm", "NA", "00:00"};
+    nd::array a = nd::array(mixed).ucast(ndt::make_time(tz_abstract)).eval();
+    EXPECT_EQ("12:34:56.7", a(0).as<string>());
+    EXPECT_EQ("15:30", a(1).as<string>());
+    EXPECT_EQ("00:00", a(3).as<string>());
+}
+
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+
+#include "inc_gtest.hpp"
+
+#include "dynd/vm/elwise_interpreter.hpp"
+#include "dynd/kernels/expr_kernel_generator.hpp"
+
+using namespace std;
+using namespace dynd;
+
+static vm::elwise_program make_select_program()
+{
+    ndt::type d = ndt::make_type<double>();
+    vector<ndt::type> regtypes(5, d);
+    regtypes.push_back(ndt::make_type<dynd_bool>());
+    // x < y ? min(x, y) * sqrt(abs(x)) + y : max(x, y)
+    int program[] = {vm::opcode_less, 5, 1, 2,
+                     vm::opcode_min, 3, 1, 2,
+                     vm::opcode_abs, 4, 1,
+                     vm::opcode_sqrt, 4, 4,
+                     vm::opcode_muladd, 3, 3, 4, 2,
+                     vm::opcode_max, 4, 1, 2,
+                     vm::opcode_select, 0, 5, 3, 4};
+    vector<int> program_vec(program, program + sizeof(program) / sizeof(int));
+    return vm::elwise_program(2, regtypes, program_vec);
+}
+
+static double select_program_value(double x, double y)
+{
+    return x < y ? min(x, y) * sqrt(fabs(x)) + y : max(x, y);
+}
+
+TEST(VMElwiseInterpreter, Opcodes) {
+    vm::elwise_interpreter interp(make_select_program());
+    // More elements than fit in one block, with x strided
+    const intptr_t count = 3 * interp.get_block_size() + 7;
+    vector<double> x(2 * count), y(count), out(count), out_strided(3 * count);
+    for (intptr_t i = 0; i < count; ++i) {
+        x[2 * i] = (i % 37) - 18.5;
+        y[i] = (i % 11) - 5;
+    }
+    const char *src[2] = {reinterpret_cast<const char *>(&x[0]),
+                          reinterpret_cast<const char *>(&y[0])};
+    intptr_t src_stride[2] = {2 * sizeof(double), sizeof(double)};
+    interp.run(reinterpret_cast<char *>(&out[0]), sizeof(double), src, src_stride, count);
+    interp.run(reinterpret_cast<char *>(&out_strided[0]), 3 * sizeof(double), src, src_stride, count);
+    for (intptr_t i = 0; i < count; ++i) {
+        double expected = select_program_value(x[2 * i], y[i]);
+        EXPECT_DOUBLE_EQ(expected, out[i]);
+        EXPECT_DOUBLE_EQ(expected, out_strided[3 * i]);
+    }
+
+    // A single element
+    double x1 = 4, y1 = 5, out1 = 0;
+    src[0] = reinterpret_cast<const char *>(&x1);
+    src[1] = reinterpret_cast<const char *>(&y1);
+    interp.run_single(reinterpret_cast<char *>(&out1), src);
+    EXPECT_EQ(13, out1);
+}
+
+TEST(VMElwiseInterpreter, Cast) {
+    // (int32)(bool)x + y, with y converted from int16 as it's read
+    vector<ndt::type> regtypes(4, ndt::make_type<int32_t>());
+    regtypes[1] = ndt::make_type<double>();
+    regtypes.push_back(ndt::make_type<dynd_bool>());
+    int program[] = {vm::opcode_cast, 4, 1,
+                     vm::opcode_cast, 3, 4,
+                     vm::opcode_add, 0, 3, 2};
+    vector<int> program_vec(program, program + 10);
+    vm::elwise_program ep(2, regtypes, program_vec);
+    ndt::type src_tp[2] = {ndt::make_type<double>(), ndt::make_type<int16_t>()};
+    const char *src_metadata[2] = {NULL, NULL};
+    vm::elwise_interpreter interp(ep, src_tp, src_metadata);
+
+    double x[5] = {0, 1.5, -2, 0, 3};
+    int16_t y[5] = {10, 20, 30, 40, 50};
+    int32_t out[5];
+    const char *src[2] = {reinterpret_cast<const char *>(x), reinterpret_cast<const char *>(y)};
+    intptr_t src_stride[2] = {sizeof(double), sizeof(int16_t)};
+    interp.run(reinterpret_cast<char *>(out), sizeof(int32_t), src, src_stride, 5);
+    EXPECT_EQ(10, out[0]);
+    EXPECT_EQ(21, out[1]);
+    EXPECT_EQ(31, out[2]);
+    EXPECT_EQ(40, out[3]);
+    EXPECT_EQ(51, out[4]);
+}
+
+TEST(VMElwiseInterpreter, UnsupportedOpcode) {
+    // sqrt isn't defined for integers
+    vector<ndt::type> regtypes(2, ndt::make_type<int32_t>());
+    int program[] = {vm::opcode_sqrt, 0, 1};
+    vector<int> program_vec(program, program + 3);
+    vm::elwise_program ep(1, regtypes, program_vec);
+    const ndt::type& tp = ep.get_register_types()[0];
+    EXPECT_EQ(NULL, vm::get_elwise_opcode_function(vm::opcode_sqrt, tp, &tp));
+    EXPECT_THROW(vm::elwise_interpreter interp(ep), runtime_error);
+}
+
+TEST(VMElwiseInterpreter, CKernelDeferred) {
+    ckernel_deferred ckd;
+    vm::make_elwise_program_ckernel_deferred(make_select_program(), ckd);
+    ASSERT_EQ(expr_operation_funcproto, (deferred_ckernel_funcproto_t)ckd.ckernel_funcproto);
+    ASSERT_EQ(3, ckd.data_types_size);
+    EXPECT_EQ(ndt::make_type<double>(), ckd.data_dynd_types[0]);
+    EXPECT_EQ(ndt::make_type<double>(), ckd.data_dynd_types[1]);
+    EXPECT_EQ(ndt::make_type<double>(), ckd.data_dynd_types[2]);
+
+    const char *dynd_metadata[3] = {NULL, NULL, NULL};
+    double x[3] = {-4, 9, 2}, y[3] = {1, 3, 5}, out[3] = {0, 0, 0};
+    const char *src[2] = {reinterpret_cast<const char *>(x), reinterpret_cast<const char *>(y)};
+
+    // Instantiate a single ckernel
+    ckernel_builder ckb;
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_single, &eval::default_eval_context);
+    expr_single_operation_t single = ckb.get()->get_function<expr_single_operation_t>();
+    single(reinterpret_cast<char *>(out), src, ckb.get());
+    EXPECT_EQ(-7, out[0]);
+
+    // Instantiate a strided ckernel
+    ckb.reset();
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata,
+                         kernel_request_strided, &eval::default_eval_context);
+    intptr_t src_stride[2] = {sizeof(double), sizeof(double)};
+    expr_strided_operation_t strided = ckb.get()->get_function<expr_strided_operation_t>();
+    strided(reinterpret_cast<char *>(out), sizeof(double), src, src_stride, 3, ckb.get());
+    EXPECT_EQ(-7, out[0]);
+    EXPECT_EQ(9, out[1]);
+    EXPECT_DOUBLE_EQ(2 * sqrt(2.0) + 5, out[2]);
+}
@@ -4,6 +4,7 @@
 //
 
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
@@ -47,3 +48,35 @@ TEST(VMElwiseProgram, Validation) {
     program4[1] = 1;
     EXPECT_THROW(vm::validate_elwise_program(1, 3, 8, program4), runtime_error);
 }
+
+TEST(VMElwiseProgram, Compose) {
+    ndt::type d = ndt::make_type<double>();
+    // (r1 * r2) as one program
+    vector<ndt::type> regtypes(3, d);
+    int program1[] = {vm::opcode_multiply, 0, 1, 2};
+    vector<int> program(program1, program1 + 4);
+    vm::elwise_program mul(2, regtypes, program);
+
+    // (r1 * r2) - ((r3 * r4) + r5)
+    const vm::elwise_program *operands[2] = {&mul, NULL};
+    vm::elwise_program sum;
+    vm::compose_elwise_program(vm::opcode_add, d, operands, sum);
+    operands[1] = &sum;
+    vm::elwise_program ep;
+    vm::compose_elwise_program(vm::opcode_subtract, d, operands, ep);
+
+    EXPECT_EQ(5, ep.get_input_count());
+    EXPECT_EQ(4, ep.get_instruction_count());
+    // Two temporaries, because the first product is held while
+    // the second operand is computed in the other
+    EXPECT_EQ(8u, ep.get_register_types().size());
+    int expected[] = {vm::opcode_multiply, 6, 1, 2,
+                      vm::opcode_multiply, 7, 3, 4,
+                      vm::opcode_add, 7, 7, 5,
+                      vm::opcode_subtract, 0, 6, 7};
+    EXPECT_EQ(vector<int>(expected, expected + 16), ep.get_program());
+
+    stringstream ss;
+    ep.print_expression(ss);
+    EXPECT_EQ("subtract(multiply(op0, op1), add(multiply(op2, op3), op4))", ss.str());
+}